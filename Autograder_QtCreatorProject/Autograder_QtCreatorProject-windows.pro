@@ -107,6 +107,7 @@ unix:!macx {
     QMAKE_CXXFLAGS += -Wno-dangling-field
     QMAKE_CXXFLAGS += -Wno-unused-const-variable
     LIBS += -ldl
+    LIBS += -lpthread   # for thread that reads from Java back-end pipe
 }
 
 # increase system stack size (helpful for recursive programs)
@@ -0,0 +1,133 @@
+/*
+ * Test file for verifying the Stanford C++ lib collection functionality.
+ */
+
+#include "testcases.h"
+#include "btreemap.h"
+#include "hashset.h"
+#include "queue.h"
+#include "random.h"
+#include "assertions.h"
+#include "gtest-marty.h"
+#include <map>
+#include <string>
+
+TEST_CATEGORY(BTreeMapTests, "BTreeMap tests");
+
+TIMED_TEST(BTreeMapTests, aliasTest_BTreeMap, TEST_TIMEOUT_DEFAULT) {
+    // put values that live in the same map; adding a key shifts entries
+    // within a leaf and moves them to a new leaf when it splits
+    BTreeMap<int, std::string> bmap;
+    std::map<int, std::string> expected;
+    for (int i = 0; i < 2000; i += 2) {
+        bmap.put(i, integerToString(i));
+        expected[i] = integerToString(i);
+    }
+    setRandomSeed(106);
+    for (int i = 1; i < 2000; i += 2) {
+        int j = randomInteger(0, 999) * 2;
+        bmap.put(i, bmap[j]);
+        expected[i] = expected[j];
+    }
+    assertEqualsInt("aliased puts size", (int) expected.size(), bmap.size());
+    for (const std::pair<const int, std::string>& entry : expected) {
+        std::string value = bmap.get(entry.first);
+        assertEqualsString("aliased put value of " + integerToString(entry.first),
+                           entry.second, value);
+    }
+
+    bmap.removeAll(bmap);
+    assertTrue("removeAll of itself", bmap.isEmpty());
+}
+
+TIMED_TEST(BTreeMapTests, compareTest_BTreeMap, TEST_TIMEOUT_DEFAULT) {
+    BTreeMap<std::string, int> map1 {{"a", 1}, {"b", 2}, {"c", 3}};
+    BTreeMap<std::string, int> map2 {{"a", 1}, {"b", 2}, {"d", 1}};
+    BTreeMap<std::string, int> map3;
+    compareTestHelper(map1, map2, "BTreeMap", /* compareTo */ -1);
+    compareTestHelper(map2, map1, "BTreeMap", /* compareTo */  1);
+    compareTestHelper(map1, map3, "BTreeMap", /* compareTo */  1);
+    compareTestHelper(map1, map1, "BTreeMap", /* compareTo */  0);
+}
+
+TIMED_TEST(BTreeMapTests, firstLastKeyTest_BTreeMap, TEST_TIMEOUT_DEFAULT) {
+    BTreeMap<int, int> map;
+    for (int i = 0; i < 1000; i++) {
+        map.put(i * 37 % 1000, i);
+    }
+    assertEqualsInt("firstKey", 0, map.firstKey());
+    assertEqualsInt("lastKey", 999, map.lastKey());
+    map.remove(0);
+    map.remove(999);
+    assertEqualsInt("firstKey after remove", 1, map.firstKey());
+    assertEqualsInt("lastKey after remove", 998, map.lastKey());
+}
+
+TIMED_TEST(BTreeMapTests, forEachTest_BTreeMap, TEST_TIMEOUT_DEFAULT) {
+    BTreeMap<int, int> map {{40, 1}, {10, 2}, {30, 3}, {20, 4}};
+    Queue<int> expected {10, 20, 30, 40};
+    for (int key : map) {
+        int exp = expected.dequeue();
+        assertEqualsInt("map foreach", exp, key);
+    }
+    assertTrue("foreach covered all keys", expected.isEmpty());
+}
+
+TIMED_TEST(BTreeMapTests, hashCodeTest_BTreeMap, TEST_TIMEOUT_DEFAULT) {
+    BTreeMap<std::string, int> map {{"a", 1}, {"b", 2}};
+    BTreeMap<std::string, int> map2 {{"b", 2}, {"a", 1}};
+    HashSet<BTreeMap<std::string, int> > hashmap {map, map2};
+    assertEqualsInt("hashset size", 1, hashmap.size());
+}
+
+TIMED_TEST(BTreeMapTests, initializerListTest_BTreeMap, TEST_TIMEOUT_DEFAULT) {
+    BTreeMap<std::string, int> map {{"a", 10}, {"b", 20}, {"c", 30}};
+    assertEqualsString("init list", "{\"a\":10, \"b\":20, \"c\":30}", map.toString());
+    map += {{"d", 40}, {"e", 50}};
+    assertEqualsString("after +=", "{\"a\":10, \"b\":20, \"c\":30, \"d\":40, \"e\":50}", map.toString());
+    map -= {{"b", 20}, {"c", 99}};
+    assertEqualsString("after -=", "{\"a\":10, \"c\":30, \"d\":40, \"e\":50}", map.toString());
+    map *= {{"a", 10}, {"d", 40}, {"z", 0}};
+    assertEqualsString("after *=", "{\"a\":10, \"d\":40}", map.toString());
+}
+
+TIMED_TEST(BTreeMapTests, randomTest_BTreeMap, TEST_TIMEOUT_DEFAULT) {
+    BTreeMap<int, std::string> map;
+    std::map<int, std::string> expected;
+    for (int i = 0; i < 20000; i++) {
+        int key = randomInteger(0, 2000);
+        if (randomChance(0.6)) {
+            map[key] = integerToString(i);
+            expected[key] = integerToString(i);
+        } else {
+            map.remove(key);
+            expected.erase(key);
+        }
+    }
+    assertEqualsInt("size", (int) expected.size(), map.size());
+    assertTrue("contents", map.toStlMap() == expected);
+    BTreeMap<int, std::string> copy = map;
+    for (auto& entry : expected) {
+        map.remove(entry.first);
+    }
+    assertTrue("empty after removing all", map.isEmpty());
+    assertTrue("copy unchanged", copy.toStlMap() == expected);
+}
+
+TIMED_TEST(BTreeMapTests, randomKeyTest_BTreeMap, TEST_TIMEOUT_DEFAULT) {
+    BTreeMap<std::string, int> map {{"a", 1}, {"b", 2}, {"c", 3}};
+    for (int i = 0; i < 20; i++) {
+        assertTrue("randomKey", map.containsKey(randomKey(map)));
+    }
+}
+
+TIMED_TEST(BTreeMapTests, subMapTest_BTreeMap, TEST_TIMEOUT_DEFAULT) {
+    BTreeMap<int, int> map;
+    for (int i = 0; i < 500; i += 5) {
+        map.put(i, i * i);
+    }
+    BTreeMap<int, int> range = map.subMap(12, 30);
+    assertEqualsString("subMap", "{15:225, 20:400, 25:625}", range.toString());
+    assertTrue("empty subMap", map.subMap(501, 600).isEmpty());
+    assertEqualsInt("whole subMap", map.size(), map.subMap(0, 500).size());
+}
@@ -0,0 +1,70 @@
+/*
+ * Test file for verifying the Stanford C++ lib collection functionality.
+ */
+
+#include "testcases.h"
+#include "btreeset.h"
+#include "hashset.h"
+#include "queue.h"
+#include "assertions.h"
+#include "gtest-marty.h"
+#include <string>
+
+TEST_CATEGORY(BTreeSetTests, "BTreeSet tests");
+
+TIMED_TEST(BTreeSetTests, compareTest_BTreeSet, TEST_TIMEOUT_DEFAULT) {
+    BTreeSet<int> set1;
+    set1 += 7, 5, 1, 2, 8;
+    BTreeSet<int> set2;
+    set2 += 1, 2, 3, 4;
+    BTreeSet<int> set3;
+    compareTestHelper(set1, set2, "BTreeSet", /* compareTo */  1);
+    compareTestHelper(set2, set1, "BTreeSet", /* compareTo */ -1);
+    compareTestHelper(set1, set3, "BTreeSet", /* compareTo */  1);
+    compareTestHelper(set2, set3, "BTreeSet", /* compareTo */  1);
+}
+
+TIMED_TEST(BTreeSetTests, firstLastTest_BTreeSet, TEST_TIMEOUT_DEFAULT) {
+    BTreeSet<int> set;
+    for (int i = 0; i < 1000; i++) {
+        set.add(i * 37 % 1000);
+    }
+    assertEqualsInt("first", 0, set.first());
+    assertEqualsInt("last", 999, set.last());
+    set -= 0, 999;
+    assertEqualsInt("first after remove", 1, set.first());
+    assertEqualsInt("last after remove", 998, set.last());
+}
+
+TIMED_TEST(BTreeSetTests, forEachTest_BTreeSet, TEST_TIMEOUT_DEFAULT) {
+    BTreeSet<int> set {40, 10, 30, 20};
+    Queue<int> expected {10, 20, 30, 40};
+    for (int n : set) {
+        int exp = expected.dequeue();
+        assertEqualsInt("set foreach", exp, n);
+    }
+}
+
+TIMED_TEST(BTreeSetTests, hashCodeTest_BTreeSet, TEST_TIMEOUT_DEFAULT) {
+    BTreeSet<int> set {69, 42};
+    BTreeSet<int> set2 {42, 69};
+    HashSet<BTreeSet<int> > hashset {set, set2};
+    assertEqualsInt("hashset size", 1, hashset.size());
+}
+
+TIMED_TEST(BTreeSetTests, initializerListTest_BTreeSet, TEST_TIMEOUT_DEFAULT) {
+    BTreeSet<int> set {10, 20, 30};
+    set += {40, 50};
+    assertEqualsString("after +=", "{10, 20, 30, 40, 50}", set.toString());
+    assertEqualsString("-", "{10, 30, 40}", (set - BTreeSet<int> {20, 50}).toString());
+    assertEqualsString("*", "{20, 50}", (set * BTreeSet<int> {20, 50, 60}).toString());
+    set *= {0, 10, 40, 99};
+    assertEqualsString("after *=", "{10, 40}", set.toString());
+    assertTrue("isSubsetOf", set.isSubsetOf({10, 20, 40}));
+}
+
+TIMED_TEST(BTreeSetTests, subSetTest_BTreeSet, TEST_TIMEOUT_DEFAULT) {
+    BTreeSet<std::string> set {"apple", "banana", "cherry", "date", "fig"};
+    assertEqualsString("subSet", "{\"banana\", \"cherry\"}", set.subSet("b", "d").toString());
+    assertTrue("empty subSet", set.subSet("g", "z").isEmpty());
+}
@@ -0,0 +1,234 @@
+/*
+ * Test file for verifying the Stanford C++ lib bulk operations.
+ */
+
+#include "testcases.h"
+#include "bulkops.h"
+#include "grid.h"
+#include "random.h"
+#include "vector.h"
+#include "assertions.h"
+#include "gtest-marty.h"
+#include <string>
+
+TEST_CATEGORY(BulkOpsTests, "bulk operation tests");
+
+/*
+ * Returns a vector of n random ints, some of them negative.  The lengths
+ * used in these tests are chosen so that some elements are left over after
+ * the whole SIMD registers, which are handled separately.
+ */
+static Vector<int> randomInts(int n) {
+    Vector<int> v;
+    for (int i = 0; i < n; i++) {
+        v.add(randomInteger(-1000, 1000));
+    }
+    return v;
+}
+
+static Grid<double> randomGrid(int rows, int cols) {
+    Grid<double> grid(rows, cols);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            grid[r][c] = randomInteger(-100, 100) / 8.0;
+        }
+    }
+    return grid;
+}
+
+TIMED_TEST(BulkOpsTests, axpyTest_BulkOps, TEST_TIMEOUT_DEFAULT) {
+    for (int n = 0; n < 40; n++) {
+        Vector<int> x = randomInts(n);
+        Vector<int> y = randomInts(n);
+        Vector<int> expected = y;
+        for (int i = 0; i < n; i++) {
+            expected[i] += 3 * x[i];
+        }
+        axpy(3, x, y);
+        assertEqualsString("axpy Vector<int> " + integerToString(n), expected.toString(), y.toString());
+    }
+
+    Grid<double> x = randomGrid(7, 9);
+    Grid<double> y = randomGrid(7, 9);
+    Grid<double> expected = y;
+    for (int r = 0; r < 7; r++) {
+        for (int c = 0; c < 9; c++) {
+            expected[r][c] += 0.5 * x[r][c];
+        }
+    }
+    axpy(0.5, x, y);
+    assertTrue("axpy Grid<double>", expected == y);
+}
+
+TIMED_TEST(BulkOpsTests, convolveTest_BulkOps, TEST_TIMEOUT_DEFAULT) {
+    Grid<double> grid = randomGrid(11, 13);
+    Grid<double> blur(3, 3, 1.0 / 9);
+    Grid<double> edge {{0, 1}, {-1, 0}};
+    for (const Grid<double>& kernel : {blur, edge}) {
+        Grid<double> expected(11, 13);
+        int centerRow = kernel.numRows() / 2;
+        int centerCol = kernel.numCols() / 2;
+        for (int r = 0; r < 11; r++) {
+            for (int c = 0; c < 13; c++) {
+                double sum = 0;
+                for (int kr = 0; kr < kernel.numRows(); kr++) {
+                    for (int kc = 0; kc < kernel.numCols(); kc++) {
+                        int row = r + kr - centerRow;
+                        int col = c + kc - centerCol;
+                        if (grid.inBounds(row, col)) {
+                            sum += kernel[kr][kc] * grid[row][col];
+                        }
+                    }
+                }
+                expected[r][c] = sum;
+            }
+        }
+        Grid<double> result = convolve(grid, kernel);
+        assertEqualsInt("convolve numRows", 11, result.numRows());
+        assertEqualsInt("convolve numCols", 13, result.numCols());
+        for (int r = 0; r < 11; r++) {
+            for (int c = 0; c < 13; c++) {
+                assertEqualsDouble("convolve", expected[r][c], result[r][c]);
+            }
+        }
+    }
+}
+
+TIMED_TEST(BulkOpsTests, elementwiseTest_BulkOps, TEST_TIMEOUT_DEFAULT) {
+    for (int n = 0; n < 40; n++) {
+        Vector<int> x = randomInts(n);
+        Vector<int> sum = randomInts(n);
+        Vector<int> difference = sum;
+        Vector<int> product = sum;
+        Vector<int> expectedSum = sum;
+        Vector<int> expectedDifference = sum;
+        Vector<int> expectedProduct = sum;
+        for (int i = 0; i < n; i++) {
+            expectedSum[i] += x[i];
+            expectedDifference[i] -= x[i];
+            expectedProduct[i] *= x[i];
+        }
+        addElements(sum, x);
+        subtractElements(difference, x);
+        multiplyElements(product, x);
+        assertEqualsString("addElements", expectedSum.toString(), sum.toString());
+        assertEqualsString("subtractElements", expectedDifference.toString(), difference.toString());
+        assertEqualsString("multiplyElements", expectedProduct.toString(), product.toString());
+    }
+
+    // long elements use the plain loops
+    Grid<long> y {{1, 2, 3}, {4, 5, 6}};
+    Grid<long> x {{6, 5, 4}, {3, 2, 1}};
+    multiplyElements(y, x);
+    assertEqualsString("multiplyElements Grid<long>", "{{6, 10, 12}, {12, 10, 6}}", y.toString());
+}
+
+TIMED_TEST(BulkOpsTests, errorTest_BulkOps, TEST_TIMEOUT_DEFAULT) {
+    Vector<double> v1(5);
+    Vector<double> v2(6);
+    try {
+        addElements(v1, v2);
+        assertFail("addElements should throw when sizes differ");
+    } catch (ErrorException&) {
+        // expected
+    }
+    Grid<int> g1(2, 3);
+    Grid<int> g2(3, 2);
+    try {
+        axpy(2, g1, g2);
+        assertFail("axpy should throw when dimensions differ");
+    } catch (ErrorException&) {
+        // expected
+    }
+
+    Vector<int> empty;
+    assertEqualsInt("sumElements empty", 0, sumElements(empty));
+    try {
+        minElement(empty);
+        assertFail("minElement should throw when empty");
+    } catch (ErrorException&) {
+        // expected
+    }
+}
+
+TIMED_TEST(BulkOpsTests, fillTest_BulkOps, TEST_TIMEOUT_DEFAULT) {
+    for (int n = 0; n < 40; n++) {
+        Vector<int> v = randomInts(n);
+        fill(v, -3);
+        Vector<int> expected;
+        for (int i = 0; i < n; i++) {
+            expected.add(-3);
+        }
+        assertEqualsString("fill Vector<int> " + integerToString(n), expected.toString(), v.toString());
+    }
+
+    Vector<long> longs {1, 2, 3};
+    fill(longs, 7);
+    assertEqualsString("fill Vector<long>", "{7, 7, 7}", longs.toString());
+
+    Grid<double> grid = randomGrid(7, 9);
+    Grid<double> expected(7, 9, 2.5);
+    fill(grid, 2.5);
+    assertTrue("fill Grid<double>", expected == grid);
+}
+
+TIMED_TEST(BulkOpsTests, reduceTest_BulkOps, TEST_TIMEOUT_DEFAULT) {
+    for (int n = 1; n < 100; n++) {
+        Vector<int> v = randomInts(n);
+        int sum = 0;
+        int min = v[0];
+        int max = v[0];
+        for (int value : v) {
+            sum += value;
+            min = std::min(min, value);
+            max = std::max(max, value);
+        }
+        assertEqualsInt("sumElements " + integerToString(n), sum, sumElements(v));
+        assertEqualsInt("minElement " + integerToString(n), min, minElement(v));
+        assertEqualsInt("maxElement " + integerToString(n), max, maxElement(v));
+    }
+
+    Grid<double> grid = randomGrid(9, 11);
+    grid[4][5] = 1000;
+    grid[8][10] = -1000;
+    double sum = 0;
+    for (double value : grid) {
+        sum += value;
+    }
+    assertEqualsDouble("sumElements Grid<double>", sum, sumElements(grid));
+    assertEqualsDouble("maxElement Grid<double>", 1000, maxElement(grid));
+    assertEqualsDouble("minElement Grid<double>", -1000, minElement(grid));
+}
+
+TIMED_TEST(BulkOpsTests, scaleTest_BulkOps, TEST_TIMEOUT_DEFAULT) {
+    for (int n = 0; n < 40; n++) {
+        Vector<int> v = randomInts(n);
+        Vector<int> expected = v;
+        for (int i = 0; i < n; i++) {
+            expected[i] *= -7;
+        }
+        scale(v, -7);
+        assertEqualsString("scale Vector<int>", expected.toString(), v.toString());
+    }
+
+    Grid<double> grid {{1, 2.5}, {-4, 8}};
+    scale(grid, 0.5);
+    assertEqualsString("scale Grid<double>", "{{0.5, 1.25}, {-2, 4}}", grid.toString());
+}
+
+TIMED_TEST(BulkOpsTests, transposeTest_BulkOps, TEST_TIMEOUT_DEFAULT) {
+    // larger than one tile in each direction, and not a multiple of it
+    Grid<double> grid = randomGrid(45, 70);
+    Grid<double> t = transpose(grid);
+    assertEqualsInt("transpose numRows", 70, t.numRows());
+    assertEqualsInt("transpose numCols", 45, t.numCols());
+    for (int r = 0; r < 45; r++) {
+        for (int c = 0; c < 70; c++) {
+            assertTrue("transpose", t[c][r] == grid[r][c]);
+        }
+    }
+    assertTrue("transpose twice", transpose(t) == grid);
+
+    Grid<int> empty;
+    assertEqualsInt("transpose empty", 0, transpose(empty).size());
+}
@@ -7,8 +7,10 @@
 #include "hashcode.h"
 #include "hashset.h"
 #include "queue.h"
+#include "vector.h"
 #include "assertions.h"
 #include "gtest-marty.h"
+#include <deque>
 #include <initializer_list>
 #include <iostream>
 #include <sstream>
@@ -33,6 +35,54 @@ TIMED_TEST(DequeTests, compareTest_Deque, TEST_TIMEOUT_DEFAULT) {
     assertEqualsString("sdeque", "{{}, {\"a\", \"ab\", \"bc\"}, {\"a\", \"b\", \"c\"}}", sdeque.toString());
 }
 
+/*
+ * A value type with no default constructor, which dequeueN must not need.
+ */
+struct DequeTicket {
+    explicit DequeTicket(int number) : number(number) {}
+    int number;
+};
+
+TIMED_TEST(DequeTests, dequeueNTest_Deque, TEST_TIMEOUT_DEFAULT) {
+    Deque<int> deq;
+    for (int i = 0; i < 10; i++) {
+        deq.addFront(i);
+    }
+    Vector<int> front = deq.dequeueN(4);
+    assertEqualsString("dequeueN from wrapped deque", "{9, 8, 7, 6}", front.toString());
+    assertEqualsString("after dequeueN", "{5, 4, 3, 2, 1, 0}", deq.toString());
+    try {
+        deq.dequeueN(7);
+        assertFail("dequeueN more than size should throw");
+    } catch (ErrorException&) {
+        // expected
+    }
+
+    Deque<DequeTicket> tickets;
+    for (int i = 0; i < 5; i++) {
+        tickets.addBack(DequeTicket(i));
+    }
+    Vector<DequeTicket> served = tickets.dequeueN(3);
+    assertEqualsInt("dequeueN without default constructor size", 3, served.size());
+    assertEqualsInt("dequeueN without default constructor first", 0, served[0].number);
+    assertEqualsInt("dequeueN without default constructor last", 2, served[2].number);
+    assertEqualsInt("dequeueN without default constructor leaves", 2, tickets.size());
+}
+
+TIMED_TEST(DequeTests, enqueueAllTest_Deque, TEST_TIMEOUT_DEFAULT) {
+    Deque<std::string> deq;
+    deq.addFront("b");
+    deq.addFront("a");
+    deq.enqueueAll({"c", "d"});
+    assertEqualsString("enqueueAll", "{\"a\", \"b\", \"c\", \"d\"}", deq.toString());
+    deq.enqueueAll(deq);
+    assertEqualsInt("enqueueAll self size", 8, deq.size());
+    assertEqualsString("enqueueAll self back", "d", deq.back());
+    Vector<std::string> firstFive = deq.dequeueN(5);
+    assertEqualsString("enqueueAll self middle", "a", firstFive[4]);
+    assertEqualsString("after dequeueN", "{\"b\", \"c\", \"d\"}", deq.toString());
+}
+
 TIMED_TEST(DequeTests, forEachTest_Deque, TEST_TIMEOUT_DEFAULT) {
     Deque<int> deq;
     deq.addBack(1);
@@ -69,6 +119,36 @@ TIMED_TEST(DequeTests, initializerListTest_Deque, TEST_TIMEOUT_DEFAULT) {
     assertEqualsString("deque initializer list", "{10, 20, 30}", deque.toString());
 }
 
+TIMED_TEST(DequeTests, ringBufferTest_Deque, TEST_TIMEOUT_DEFAULT) {
+    // add and remove at both ends so that the elements wrap around in both
+    // directions and the buffer grows while wrapped, checking against std::deque
+    Deque<int> deq;
+    std::deque<int> expected;
+    for (int i = 0; i < 1000; i++) {
+        if (i % 2 == 0) {
+            deq.addFront(i);
+            expected.push_front(i);
+        } else {
+            deq.addBack(i);
+            expected.push_back(i);
+        }
+        if (i % 5 == 0) {
+            int back = deq.dequeueBack();
+            assertEqualsInt("ring buffer dequeueBack", expected.back(), back);
+            expected.pop_back();
+        } else if (i % 7 == 0) {
+            int front = deq.dequeueFront();
+            assertEqualsInt("ring buffer dequeueFront", expected.front(), front);
+            expected.pop_front();
+        }
+    }
+    assertTrue("ring buffer contents", deq.toStlDeque() == expected);
 
-
-
+    // iterators are random-access and can modify the elements
+    for (int& n : deq) {
+        n = -n;
+    }
+    assertEqualsInt("ring buffer modified", -expected[0], *deq.begin());
+    assertEqualsInt("ring buffer iterator distance", deq.size(), (int) (deq.end() - deq.begin()));
+    assertEqualsInt("ring buffer iterator index", -expected[10], deq.begin()[10]);
+}
@@ -62,6 +62,31 @@ TIMED_TEST(GridTests, hashCodeTest_Grid, TEST_TIMEOUT_DEFAULT) {
     assertEqualsInt("hashset of grid size", 2, hashgrid.size());
 }
 
+TIMED_TEST(GridTests, indexCheckTest_Grid, TEST_TIMEOUT_DEFAULT) {
+    Grid<int> grid(2, 3);
+    int bad[][2] = {{-1, 0}, {0, -1}, {2, 0}, {0, 3}};
+    for (int i = 0; i < 4; i++) {
+        try {
+            grid[bad[i][0]][bad[i][1]] = 1;
+            assertFail("operator [][] should reject index " + integerToString(i));
+        } catch (ErrorException&) {
+            // expected
+        }
+        try {
+            grid.get(bad[i][0], bad[i][1]);
+            assertFail("get should reject index " + integerToString(i));
+        } catch (ErrorException&) {
+            // expected
+        }
+    }
+    try {
+        grid[2].data();
+        assertFail("row data should reject row 2");
+    } catch (ErrorException&) {
+        // expected
+    }
+}
+
 TIMED_TEST(GridTests, initializerListTest_Grid, TEST_TIMEOUT_DEFAULT) {
     Grid<int> grid {{10, 20, 30}, {40, 50, 60}};
     assertEqualsInt("init list Grid numRows", 2, grid.numRows());
@@ -99,3 +124,24 @@ TIMED_TEST(GridTests, randomElementTest_Grid, TEST_TIMEOUT_DEFAULT) {
     assertTrue("must choose e sometimes", counts["e"] > 0);
     assertTrue("must choose f sometimes", counts["f"] > 0);
 }
+
+TIMED_TEST(GridTests, rowViewTest_Grid, TEST_TIMEOUT_DEFAULT) {
+    Grid<int> grid {{1, 2, 3}, {4, 5, 6}};
+    assertTrue("data is row-major", grid.data() + 3 == &grid[1][0]);
+    assertTrue("row data", grid[1].data() == &grid[1][0]);
+    assertEqualsInt("row size", 3, grid[1].size());
+    int sum = 0;
+    for (int& n : grid[1]) {
+        n *= 10;
+        sum += n;
+    }
+    assertEqualsInt("row for-each sum", 150, sum);
+    assertEqualsString("after row for-each", "{{1, 2, 3}, {40, 50, 60}}", grid.toString());
+
+    const Grid<int>& cgrid = grid;
+    const int* row0 = cgrid[0].data();
+    assertEqualsInt("const row data", 3, row0[2]);
+    assertEqualsInt("getUnchecked", 50, grid.getUnchecked(1, 1));
+    grid.setUnchecked(0, 2, 7);
+    assertEqualsInt("setUnchecked", 7, grid[0][2]);
+}
@@ -0,0 +1,163 @@
+/*
+ * Test file for verifying the Stanford C++ lib hashing functions.
+ */
+
+#include "testcases.h"
+#include "hashcode.h"
+#include "random.h"
+#include "strlib.h"
+#include "assertions.h"
+#include "gtest-marty.h"
+#include <cstring>
+#include <set>
+#include <string>
+
+TEST_CATEGORY(HashCodeTests, "hashCode tests");
+
+/*
+ * Fills the given array with random bytes.  The lengths hashed in these
+ * tests run past 64 bytes so that they cover inputs that never reach the
+ * four 32-byte lanes of hashBytes, inputs that use the lanes once or twice,
+ * and every tail of 0-31 bytes left over after the lanes.
+ */
+static void randomBytes(unsigned char* bytes, int n) {
+    for (int i = 0; i < n; i++) {
+        bytes[i] = (unsigned char) randomInteger(0, 255);
+    }
+}
+
+static const int MAX_LENGTH = 96;
+
+TIMED_TEST(HashCodeTests, hashBytesAlignmentTest_HashCode, TEST_TIMEOUT_DEFAULT) {
+    unsigned char bytes[MAX_LENGTH];
+    unsigned char shifted[MAX_LENGTH + 8];
+    randomBytes(bytes, MAX_LENGTH);
+    for (int offset = 1; offset < 8; offset++) {
+        memcpy(shifted + offset, bytes, MAX_LENGTH);
+        for (int length = 0; length <= MAX_LENGTH; length++) {
+            unsigned long long expected = hashBytes(bytes, length);
+            unsigned long long actual = hashBytes(shifted + offset, length);
+            assertTrue("hashBytes of " + integerToString(length) + " bytes at offset "
+                       + integerToString(offset), expected == actual);
+        }
+    }
+}
+
+TIMED_TEST(HashCodeTests, hashBytesLengthTest_HashCode, TEST_TIMEOUT_DEFAULT) {
+    // the same bytes cut at different lengths must all hash differently,
+    // even when the extra bytes are all zero
+    unsigned char bytes[MAX_LENGTH];
+    unsigned char zeros[MAX_LENGTH] = {0};
+    randomBytes(bytes, MAX_LENGTH);
+    std::set<unsigned long long> hashes;
+    std::set<unsigned long long> zeroHashes;
+    for (int length = 0; length <= MAX_LENGTH; length++) {
+        hashes.insert(hashBytes(bytes, length));
+        zeroHashes.insert(hashBytes(zeros, length));
+    }
+    assertEqualsInt("distinct hashes of prefixes", MAX_LENGTH + 1, (int) hashes.size());
+    assertEqualsInt("distinct hashes of zero prefixes", MAX_LENGTH + 1, (int) zeroHashes.size());
+
+    std::string s = "hello";
+    int hash = hashCode(s);
+    int cstringHash = hashCode(s.c_str());
+    assertEqualsInt("hashCode of string and C string", hash, cstringHash);
+}
+
+TIMED_TEST(HashCodeTests, hashBytesTailTest_HashCode, TEST_TIMEOUT_DEFAULT) {
+    // every byte of the input, in the lanes or in the tail, must affect the
+    // hash, and no byte past the end may
+    unsigned char bytes[MAX_LENGTH + 1];
+    randomBytes(bytes, MAX_LENGTH + 1);
+    for (int length = 0; length <= MAX_LENGTH; length++) {
+        unsigned long long hash = hashBytes(bytes, length);
+        for (int i = 0; i < length; i++) {
+            bytes[i] ^= 0x01;
+            unsigned long long flipped = hashBytes(bytes, length);
+            bytes[i] ^= 0x01;
+            assertTrue("flipping byte " + integerToString(i) + " of " + integerToString(length)
+                       + " changes hash", flipped != hash);
+        }
+        bytes[length] ^= 0xff;
+        unsigned long long pastEnd = hashBytes(bytes, length);
+        bytes[length] ^= 0xff;
+        assertTrue("byte past end of " + integerToString(length) + " does not change hash",
+                   pastEnd == hash);
+    }
+}
+
+TIMED_TEST(HashCodeTests, hashMixTest_HashCode, TEST_TIMEOUT_DEFAULT) {
+    // nearby and strided keys must not collide, and each input bit must
+    // flip about half of the output bits
+    std::set<unsigned long long> hashes;
+    for (unsigned long long i = 0; i < 1000; i++) {
+        hashes.insert(hashMix(i));
+        hashes.insert(hashMix(i << 32));
+    }
+    assertEqualsInt("distinct hashMix of small and strided keys", 1999, (int) hashes.size());
+
+    for (int bit = 0; bit < 64; bit++) {
+        int flips = 0;
+        for (unsigned long long value = 0; value < 64; value++) {
+            unsigned long long diff = hashMix(value * 0x9e3779b97f4a7c15ULL)
+                    ^ hashMix((value * 0x9e3779b97f4a7c15ULL) ^ (1ULL << bit));
+            for (; diff != 0; diff &= diff - 1) {
+                flips++;
+            }
+        }
+        // 64 trials of 64 bits: the expected number of flips is 2048
+        assertTrue("flipping input bit " + integerToString(bit) + " flips about half the output",
+                   flips > 1800 && flips < 2300);
+    }
+
+    // equal integers hash alike whatever their integer type
+    int fromInt = hashCode(97);
+    int fromChar = hashCode('a');
+    int fromLongLong = hashCode(97LL);
+    int fromUnsigned = hashCode(97U);
+    assertEqualsInt("hashCode of int and char", fromInt, fromChar);
+    assertEqualsInt("hashCode of int and long long", fromInt, fromLongLong);
+    assertEqualsInt("hashCode of int and unsigned", fromInt, fromUnsigned);
+    int zero = hashCode(0.0);
+    int negativeZero = hashCode(-0.0);
+    assertEqualsInt("hashCode of 0.0 and -0.0", zero, negativeZero);
+}
+
+TIMED_TEST(HashCodeTests, hashSpreadTest_HashCode, TEST_TIMEOUT_DEFAULT) {
+    // hash codes that differ only in their high bits must reach different
+    // low bits, since that is all a small hash table looks at
+    std::set<unsigned int> lowBits;
+    for (int i = 0; i < 256; i++) {
+        lowBits.insert(hashSpread(i << 20) & 0xfff);
+    }
+    assertTrue("hashSpread of high-bit hash codes spreads into low bits",
+               lowBits.size() > 240);
+    int code = hashCode(std::string("spread"));
+    unsigned int once = hashSpread(code);
+    unsigned int again = hashSpread(code);
+    assertEqualsInt("hashSpread is deterministic", (int) once, (int) again);
+}
+
+TIMED_TEST(HashCodeTests, hashSeedTest_HashCode, TEST_TIMEOUT_DEFAULT) {
+    // the seed is fixed for the life of the process, so hashes are too
+    unsigned long long seed = hashSeed64();
+    unsigned char bytes[MAX_LENGTH];
+    randomBytes(bytes, MAX_LENGTH);
+    unsigned long long bytesHash = hashBytes(bytes, MAX_LENGTH);
+    unsigned long long mixHash = hashMix(12345);
+    for (int i = 0; i < 100; i++) {
+        assertTrue("hashSeed64 is stable", hashSeed64() == seed);
+        assertTrue("hashBytes is stable", hashBytes(bytes, MAX_LENGTH) == bytesHash);
+        assertTrue("hashMix is stable", hashMix(12345) == mixHash);
+    }
+
+    if (seed == 0) {
+        // unseeded hashes are the same in every run and every build;
+        // hashMix(0) is the first output of SplitMix64 seeded with 0
+        assertEqualsInt("unseeded hashSeed", 5381, hashSeed());
+        assertTrue("unseeded hashMix(0)", hashMix(0) == 0xe220a8397b1dcdafULL);
+    } else {
+        int folded = hashSeed();
+        assertTrue("seeded hashSeed is nonnegative", folded >= 0);
+    }
+}
@@ -12,11 +12,158 @@
 #include "strlib.h"
 #include <initializer_list>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
 
 TEST_CATEGORY(HashMapTests, "HashMap tests");
 
+TIMED_TEST(HashMapTests, aliasTest_HashMap, TEST_TIMEOUT_DEFAULT) {
+    // put a value that lives in the same map under a new key; inserting the
+    // new key moves entries around (and sometimes grows the table), which
+    // must not change the value being stored
+    HashMap<int, std::string> hmap;
+    std::map<int, std::string> expected;
+    setRandomSeed(106);
+    for (int i = 0; i < 2000; i++) {
+        if (hmap.isEmpty()) {
+            hmap.put(i, integerToString(i));
+            expected[i] = integerToString(i);
+            continue;
+        }
+        int j = randomInteger(0, i - 1);
+        if (!hmap.containsKey(j)) {
+            j = expected.begin()->first;
+        }
+        hmap.put(i, hmap[j]);
+        expected[i] = expected[j];
+        if (i % 3 == 0) {
+            // overwrite an existing key with another entry's value
+            int k = randomInteger(0, i);
+            if (hmap.containsKey(k)) {
+                hmap.put(k, hmap[j] + "x");
+                expected[k] = expected[j] + "x";
+            }
+        }
+    }
+    assertEqualsInt("aliased puts size", (int) expected.size(), hmap.size());
+    for (const std::pair<const int, std::string>& entry : expected) {
+        std::string value = hmap.get(entry.first);
+        assertEqualsString("aliased put value of " + integerToString(entry.first),
+                           entry.second, value);
+    }
+}
+
+/*
+ * A key whose hash code is the same for every value, so that every entry
+ * of a HashMap lands in one long probe sequence.
+ */
+struct CollidingKey {
+    int value;
+};
+
+bool operator ==(const CollidingKey& k1, const CollidingKey& k2) {
+    return k1.value == k2.value;
+}
+
+int hashCode(const CollidingKey& /* key */) {
+    return 42;
+}
+
+TIMED_TEST(HashMapTests, collisionTest_HashMap, TEST_TIMEOUT_DEFAULT) {
+    HashMap<CollidingKey, int> hmap;
+    for (int i = 0; i < 300; i++) {
+        CollidingKey key = {i};
+        hmap.put(key, i * 10);
+    }
+    assertEqualsInt("colliding keys size after puts", 300, hmap.size());
+
+    // remove every other key from the middle of the probe sequence
+    for (int i = 0; i < 300; i += 2) {
+        CollidingKey key = {i};
+        hmap.remove(key);
+    }
+    assertEqualsInt("colliding keys size after removes", 150, hmap.size());
+    for (int i = 0; i < 300; i++) {
+        CollidingKey key = {i};
+        bool found = hmap.containsKey(key);
+        assertEquals("colliding key " + integerToString(i) + " present", i % 2 == 1, found);
+        if (found) {
+            int value = hmap.get(key);
+            assertEqualsInt("colliding key " + integerToString(i) + " value", i * 10, value);
+        }
+    }
+
+    // put the removed keys back with new values; the others must not move
+    for (int i = 0; i < 300; i += 2) {
+        CollidingKey key = {i};
+        hmap[key] = -i;
+    }
+    assertEqualsInt("colliding keys size after re-adding", 300, hmap.size());
+    int count = 0;
+    for (const CollidingKey& key : hmap) {
+        int value = hmap.get(key);
+        int expected = key.value % 2 == 1 ? key.value * 10 : -key.value;
+        assertEqualsInt("colliding key " + integerToString(key.value) + " value after re-adding",
+                        expected, value);
+        count++;
+    }
+    assertEqualsInt("colliding keys iteration count", 300, count);
+}
+
+TIMED_TEST(HashMapTests, deleteHeavyTest_HashMap, TEST_TIMEOUT_DEFAULT) {
+    // churn a small set of keys through many puts and removes, more removes
+    // than puts, checking the map against std::map throughout
+    HashMap<int, int> hmap;
+    std::map<int, int> expected;
+    setRandomSeed(106);
+    for (int op = 0; op < 20000; op++) {
+        int key = randomInteger(0, 499);
+        if (randomChance(0.4)) {
+            hmap.put(key, op);
+            expected[key] = op;
+        } else {
+            hmap.remove(key);
+            expected.erase(key);
+        }
+        if (op % 1000 == 999) {
+            assertEqualsInt("size after " + integerToString(op + 1) + " operations",
+                            (int) expected.size(), hmap.size());
+            for (int k = 0; k < 500; k++) {
+                bool found = hmap.containsKey(k);
+                assertEquals("containsKey " + integerToString(k), expected.count(k) == 1, found);
+                if (found) {
+                    int value = hmap.get(k);
+                    assertEqualsInt("get " + integerToString(k), expected[k], value);
+                }
+            }
+        }
+    }
+
+    // remove everything; the table must be usable afterward
+    for (int k = 0; k < 500; k++) {
+        hmap.remove(k);
+    }
+    assertEqualsInt("size after removing all", 0, hmap.size());
+    assertTrue("isEmpty after removing all", hmap.isEmpty());
+    int count = 0;
+    for (int key : hmap) {
+        (void) key;
+        count++;
+    }
+    assertEqualsInt("iteration count after removing all", 0, count);
+    hmap.put(7, 70);
+    int value = hmap.get(7);
+    assertEqualsInt("get after refilling", 70, value);
+
+    // removing a map from itself shifts entries under the iterator
+    for (int k = 0; k < 1000; k++) {
+        hmap.put(k, -k);
+    }
+    hmap.removeAll(hmap);
+    assertTrue("removeAll of itself", hmap.isEmpty());
+}
+
 TIMED_TEST(HashMapTests, forEachTest_HashMap, TEST_TIMEOUT_DEFAULT) {
     HashMap<std::string, int> hmap;
     hmap["a"] = 1;
@@ -32,6 +179,38 @@ TIMED_TEST(HashMapTests, forEachTest_HashMap, TEST_TIMEOUT_DEFAULT) {
     }
 }
 
+TIMED_TEST(HashMapTests, growthTest_HashMap, TEST_TIMEOUT_DEFAULT) {
+    // add keys one at a time so that the table fills to its load limit and
+    // grows many times; every key must survive each rehash
+    HashMap<std::string, int> hmap;
+    for (int i = 0; i < 2000; i++) {
+        hmap.put(integerToString(i), i);
+        assertEqualsInt("size while growing", i + 1, hmap.size());
+        if ((i & (i + 1)) == 0 || i % 97 == 0) {
+            // check all keys just before each power of two, and now and then
+            for (int k = 0; k <= i; k++) {
+                int value = hmap.get(integerToString(k));
+                assertEqualsInt("value of " + integerToString(k) + " after adding " + integerToString(i),
+                                k, value);
+            }
+        }
+    }
+    assertFalse("containsKey of key never added", hmap.containsKey("2000"));
+    int count = 0;
+    for (const std::string& key : hmap) {
+        (void) key;
+        count++;
+    }
+    assertEqualsInt("iteration count after growing", 2000, count);
+
+    // a map built from the grown one's keys in a different order is equal
+    HashMap<std::string, int> copy;
+    for (const std::string& key : hmap) {
+        copy[key] = hmap[key];
+    }
+    assertTrue("grown map equals its copy", hmap == copy);
+}
+
 TIMED_TEST(HashMapTests, hashCodeTest_HashMap, TEST_TIMEOUT_DEFAULT) {
     HashMap<int, int> hmap;
     hmap.add(69, 96);
@@ -60,7 +239,11 @@ TIMED_TEST(HashMapTests, hashCodeTest_HashMap, TEST_TIMEOUT_DEFAULT) {
     v2.add("c");
     ngram.put(key1, v1);
     ngram.put(key2, v2);
-    assertEqualsString("hashmap of hashset of vector", "{{}:{\"a\", \"b\"}, {{\"fooo\"}}:{\"c\"}}", ngram.toString());
+    // HashMap makes no guarantee about the order of its keys
+    std::string ngramString = ngram.toString();
+    assertTrue("hashmap of hashset of vector",
+               ngramString == "{{}:{\"a\", \"b\"}, {{\"fooo\"}}:{\"c\"}}"
+               || ngramString == "{{{\"fooo\"}}:{\"c\"}, {}:{\"a\", \"b\"}}");
 
     // hash code of hash collections after they are deep-copied
     HashMap<int, int> hmapcode;
@@ -160,7 +343,8 @@ TIMED_TEST(HashMapTests, streamExtractTest_HashMap, TEST_TIMEOUT_DEFAULT) {
     std::istringstream hmstream("{1:10, 2:20, 3:30}");
     HashMap<int, int> hm;
     hmstream >> hm;
-    assertEqualsString("hm", "{1:10, 2:20, 3:30}", hm.toString());
+    HashMap<int, int> expected {{1, 10}, {2, 20}, {3, 30}};
+    assertTrue("hm", hm == expected);
 }
 
 TIMED_TEST(HashMapTests, streamExtractTest_HashMap2bad, TEST_TIMEOUT_DEFAULT) {
@@ -0,0 +1,58 @@
+/*
+ * Test file for verifying the Stanford C++ lib collection functionality.
+ */
+
+#include "testcases.h"
+#include "indexedpriorityqueue.h"
+#include "random.h"
+#include "assertions.h"
+#include "gtest-marty.h"
+#include <map>
+#include <string>
+
+TEST_CATEGORY(IndexedPriorityQueueTests, "IndexedPriorityQueue tests");
+
+TIMED_TEST(IndexedPriorityQueueTests, basicTest_IndexedPriorityQueue, TEST_TIMEOUT_DEFAULT) {
+    valuePriorityQueueTestHelper<IndexedPriorityQueue<std::string>, IndexedPriorityQueue<int> >();
+}
+
+/*
+ * Applies random enqueues, priority changes and removals to a queue with the
+ * given heap arity, then checks that it dequeues everything in order.
+ */
+template <int Arity>
+static void randomTestHelper() {
+    IndexedPriorityQueue<int, Arity> pq;
+    std::map<int, int> expected;       // value -> priority
+    for (int i = 0; i < 2000; i++) {
+        int value = randomInteger(0, 99);
+        int priority = randomInteger(0, 50);
+        if (!expected.count(value)) {
+            pq.enqueue(value, priority);
+        } else if (randomChance(0.5)) {
+            pq.changePriority(value, priority);
+        } else {
+            pq.remove(value);
+            expected.erase(value);
+            continue;
+        }
+        expected[value] = priority;
+    }
+    assertEqualsInt("size", (int) expected.size(), pq.size());
+    double last = -1;
+    while (!pq.isEmpty()) {
+        double priority = pq.peekPriority();
+        int value = pq.dequeue();
+        assertTrue("heap order", last <= priority);
+        assertEqualsInt("priority", expected[value], (int) priority);
+        expected.erase(value);
+        last = priority;
+    }
+    assertTrue("all dequeued", expected.empty());
+}
+
+TIMED_TEST(IndexedPriorityQueueTests, randomTest_IndexedPriorityQueue, TEST_TIMEOUT_DEFAULT) {
+    randomTestHelper<2>();
+    randomTestHelper<3>();
+    randomTestHelper<4>();
+}
@@ -120,3 +120,37 @@ TIMED_TEST(LinkedHashMapTests, initializerListTest_LinkedHashMap, TEST_TIMEOUT_D
     assertFalse("after *=, LinkedHashMap containsKey a", hmap.containsKey("a"));
     assertEqualsInt("after -, LinkedHashMap get b", 20, hmap.get("b"));
 }
+
+TIMED_TEST(LinkedHashMapTests, removeTest_LinkedHashMap, TEST_TIMEOUT_DEFAULT) {
+    LinkedHashMap<std::string, int> lhmap {{"a", 1}, {"b", 2}, {"c", 3}, {"d", 4}};
+    lhmap.put("b", 20);
+    assertEqualsString("re-put keeps order", "{\"a\":1, \"b\":20, \"c\":3, \"d\":4}", lhmap.toString());
+    lhmap.remove("a");
+    lhmap.remove("c");
+    lhmap.remove("notfound");
+    assertEqualsString("after removes", "{\"b\":20, \"d\":4}", lhmap.toString());
+    lhmap["a"]++;
+    lhmap["d"] += 10;
+    assertEqualsString("after operator []", "{\"b\":20, \"d\":14, \"a\":1}", lhmap.toString());
+
+    // remove every other key from a large map, then check the order of the rest
+    LinkedHashMap<int, int> big;
+    int N = 100000;
+    for (int i = N - 1; i >= 0; i--) {
+        big.put(i, -i);
+    }
+    for (int i = 0; i < N; i += 2) {
+        big.remove(i);
+    }
+    assertEqualsInt("big size", N / 2, big.size());
+    int expected = N - 1;
+    for (int key : big) {
+        assertEqualsInt("big order", expected, key);
+        assertEqualsInt("big value", -expected, big.get(key));
+        expected -= 2;
+    }
+    assertEqualsInt("big visited all", -1, expected);
+
+    big.removeAll(big);
+    assertTrue("removeAll of itself", big.isEmpty());
+}
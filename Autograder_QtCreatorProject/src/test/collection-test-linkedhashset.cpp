@@ -68,3 +68,16 @@ TIMED_TEST(LinkedHashSetTests, initializerListTest_LinkedHashSet, TEST_TIMEOUT_D
     std::cout << "LinkedHashSet *={} list = " << lhset << std::endl;
     std::cout << "at end,   LinkedHashSet = " << lhset << std::endl;
 }
+
+TIMED_TEST(LinkedHashSetTests, removeTest_LinkedHashSet, TEST_TIMEOUT_DEFAULT) {
+    LinkedHashSet<int> lhset {30, 10, 40, 66, -1, 42, 99};
+    lhset.add(40);
+    lhset.remove(10);
+    lhset.remove(42);
+    lhset.remove(1000);
+    lhset.add(10);
+    assertEqualsString("after removes", "{30, 40, 66, -1, 99, 10}", lhset.toString());
+    assertEqualsInt("after removes size", 6, lhset.size());
+    assertTrue("after removes contains 40", lhset.contains(40));
+    assertFalse("after removes contains 42", lhset.contains(42));
+}
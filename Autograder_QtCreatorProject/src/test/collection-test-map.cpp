@@ -7,15 +7,40 @@
 #include "hashcode.h"
 #include "hashset.h"
 #include "queue.h"
+#include "strlib.h"
 #include "assertions.h"
 #include "gtest-marty.h"
 #include <initializer_list>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 TEST_CATEGORY(MapTests, "Map tests");
 
+TIMED_TEST(MapTests, arenaTest_Map, TEST_TIMEOUT_DEFAULT) {
+    Arena arena;
+    Map<std::string, int> map(arena);
+    for (int i = 0; i < 1000; i++) {
+        map.put(integerToString(i), i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        map.remove(integerToString(i));
+    }
+    size_t capacity = arena.getCapacity();
+    for (int i = 0; i < 1000; i += 2) {
+        map.put(integerToString(i), i);    // reuses the removed nodes
+    }
+    assertEqualsInt("capacity after re-adding", (int) capacity, (int) arena.getCapacity());
+    Map<std::string, int> copy = map;
+    map.clear();
+    assertEqualsInt("copy size", 1000, copy.size());
+    assertEqualsInt("copy[\"999\"]", 999, copy["999"]);
+    assertTrue("cleared", map.isEmpty());
+}
+
 TIMED_TEST(MapTests, compareTest_Map, TEST_TIMEOUT_DEFAULT) {
     // TODO
 }
@@ -31,6 +56,39 @@ TIMED_TEST(MapTests, forEachTest_Map, TEST_TIMEOUT_DEFAULT) {
     }
 }
 
+TIMED_TEST(MapTests, fromSortedTest_Map, TEST_TIMEOUT_DEFAULT) {
+    std::vector<std::pair<int, std::string> > pairs;
+    for (int i = 0; i < 1000; i++) {
+        pairs.push_back(std::make_pair(i * 2, integerToString(i)));
+    }
+    Map<int, std::string> map = Map<int, std::string>::fromSorted(pairs.begin(), pairs.end());
+    assertEqualsInt("size", 1000, map.size());
+    assertEqualsString("get", "500", map.get(1000));
+    map.put(1, "odd");
+    map.remove(0);
+    assertEqualsString("first key after changes", "1", integerToString(map.keys()[0]));
+
+    std::vector<std::pair<int, std::string> > unsorted {{3, "c"}, {1, "a"}, {2, "b"}, {1, "z"}};
+    Map<int, std::string> map2(unsorted.begin(), unsorted.end());
+    assertEqualsString("range constructor", "{1:\"z\", 2:\"b\", 3:\"c\"}", map2.toString());
+    try {
+        Map<int, std::string>::fromSorted(unsorted.begin(), unsorted.end());
+        assertFail("fromSorted should reject unsorted keys");
+    } catch (ErrorException&) {
+        // expected
+    }
+
+    // pairs whose member types convert to the map's key and value types
+    std::vector<std::pair<const char*, short> > converting {{"b", 2}, {"a", 1}, {"c", 3}};
+    Map<std::string, int> map3(converting.begin(), converting.end());
+    assertEqualsString("range constructor with converting pairs",
+                       "{\"a\":1, \"b\":2, \"c\":3}", map3.toString());
+    std::vector<std::pair<const char*, short> > convertingSorted {{"a", 1}, {"b", 2}, {"c", 3}};
+    Map<std::string, int> map4 = Map<std::string, int>::fromSorted(convertingSorted.begin(),
+                                                                   convertingSorted.end());
+    assertTrue("fromSorted with converting pairs", map3 == map4);
+}
+
 TIMED_TEST(MapTests, hashCodeTest_Map, TEST_TIMEOUT_DEFAULT) {
     HashSet<Map<int, int> > hashmap;
     Map<int, int> map;
@@ -58,6 +116,43 @@ TIMED_TEST(MapTests, initializerListTest_Map, TEST_TIMEOUT_DEFAULT) {
     std::cout << "at end,   Map = " << map << std::endl;
 }
 
+TIMED_TEST(MapTests, mergeTest_Map, TEST_TIMEOUT_DEFAULT) {
+    std::map<int, int> stl1;
+    std::map<int, int> stl2;
+    for (int i = 0; i < 3000; i++) {
+        stl1[i * 3 % 2000] = i % 4;
+        stl2[i * 7 % 2500] = i % 3;
+    }
+    Map<int, int> map1(stl1.begin(), stl1.end());
+    Map<int, int> map2(stl2.begin(), stl2.end());
+
+    std::map<int, int> expected = stl1;
+    for (auto& entry : stl2) {
+        expected[entry.first] = entry.second;
+    }
+    assertTrue("putAll", (map1 + map2).toStlMap() == expected);
+
+    expected.clear();
+    for (auto& entry : stl1) {
+        if (stl2.count(entry.first) == 0 || stl2[entry.first] != entry.second) {
+            expected.insert(entry);
+        }
+    }
+    assertTrue("removeAll", (map1 - map2).toStlMap() == expected);
+
+    expected.clear();
+    for (auto& entry : stl1) {
+        if (stl2.count(entry.first) != 0 && stl2[entry.first] == entry.second) {
+            expected.insert(entry);
+        }
+    }
+    Map<int, int> intersection = map1 * map2;
+    assertTrue("retainAll", intersection.toStlMap() == expected);
+    intersection.put(-1, 0);
+    intersection.remove(expected.begin()->first);
+    assertEqualsInt("size after changes", (int) expected.size(), intersection.size());
+}
+
 TIMED_TEST(MapTests, randomKeyTest_Map, TEST_TIMEOUT_DEFAULT) {
     Map<std::string, int> counts;
     int RUNS = 200;
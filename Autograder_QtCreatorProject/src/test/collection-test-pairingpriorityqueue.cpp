@@ -0,0 +1,63 @@
+/*
+ * Test file for verifying the Stanford C++ lib collection functionality.
+ */
+
+#include "testcases.h"
+#include "pairingpriorityqueue.h"
+#include "random.h"
+#include "assertions.h"
+#include "gtest-marty.h"
+#include <map>
+#include <string>
+
+TEST_CATEGORY(PairingPriorityQueueTests, "PairingPriorityQueue tests");
+
+TIMED_TEST(PairingPriorityQueueTests, basicTest_PairingPriorityQueue, TEST_TIMEOUT_DEFAULT) {
+    valuePriorityQueueTestHelper<PairingPriorityQueue<std::string>, PairingPriorityQueue<int> >();
+}
+
+/*
+ * Dequeues now and then while the queue is being built, so that the
+ * pairwise merging of the root's children is exercised on heaps of many
+ * shapes, then checks that a copy is equal and independent.
+ */
+TIMED_TEST(PairingPriorityQueueTests, randomTest_PairingPriorityQueue, TEST_TIMEOUT_DEFAULT) {
+    PairingPriorityQueue<int> pq;
+    std::map<int, int> expected;       // value -> priority
+    for (int i = 0; i < 2000; i++) {
+        int value = randomInteger(0, 99);
+        int priority = randomInteger(0, 50);
+        if (!expected.count(value)) {
+            pq.enqueue(value, priority);
+        } else if (randomChance(0.5)) {
+            pq.changePriority(value, priority);
+        } else {
+            pq.remove(value);
+            expected.erase(value);
+            continue;
+        }
+        expected[value] = priority;
+        if (randomChance(0.1)) {
+            int first = pq.dequeue();
+            for (const auto& entry : expected) {
+                assertTrue("dequeued first", expected[first] <= entry.second);
+            }
+            expected.erase(first);
+        }
+    }
+    PairingPriorityQueue<int> copy = pq;
+    assertTrue("copy ==", copy == pq);
+    int size = pq.size();
+    assertEqualsInt("size", (int) expected.size(), size);
+    double last = -1;
+    while (!pq.isEmpty()) {
+        double priority = pq.peekPriority();
+        int value = pq.dequeue();
+        assertTrue("heap order", last <= priority);
+        assertEqualsInt("priority", expected[value], (int) priority);
+        expected.erase(value);
+        last = priority;
+    }
+    assertTrue("all dequeued", expected.empty());
+    assertEqualsInt("copy unaffected", size, copy.size());
+}
@@ -0,0 +1,218 @@
+/*
+ * Test file for verifying the Stanford C++ lib parallel operations.
+ * The tests use several threads even on a machine with one core, and
+ * small grain sizes, so that the work is really split between threads.
+ */
+
+#include "testcases.h"
+#include "parallel.h"
+#include "grid.h"
+#include "hashmap.h"
+#include "map.h"
+#include "random.h"
+#include "set.h"
+#include "strlib.h"
+#include "vector.h"
+#include "assertions.h"
+#include "gtest-marty.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <string>
+
+TEST_CATEGORY(ParallelTests, "parallel operation tests");
+
+static Vector<int> randomInts(int n) {
+    Vector<int> v;
+    for (int i = 0; i < n; i++) {
+        v.add(randomInteger(-100000, 100000));
+    }
+    return v;
+}
+
+TIMED_TEST(ParallelTests, exceptionTest_Parallel, TEST_TIMEOUT_DEFAULT) {
+    int oldThreadCount = getParallelThreadCount();
+    setParallelThreadCount(4);
+    Vector<int> v = randomInts(10000);
+    v[7777] = 123456;
+    try {
+        parallelMapAll(v, [](int value) {
+            if (value == 123456) {
+                error("found it");
+            }
+        }, 16);
+        assertFail("parallelMapAll should rethrow the function's exception");
+    } catch (ErrorException&) {
+        // expected
+    }
+
+    // the pool still works afterward
+    std::atomic<int> count(0);
+    parallelMapAll(v, [&count](int) {
+        count++;
+    }, 16);
+    assertEqualsInt("count after exception", 10000, count);
+    setParallelThreadCount(oldThreadCount);
+}
+
+TIMED_TEST(ParallelTests, mapAllTest_Parallel, TEST_TIMEOUT_DEFAULT) {
+    int oldThreadCount = getParallelThreadCount();
+    setParallelThreadCount(4);
+    Vector<int> v = randomInts(10000);
+    long long expected = 0;
+    for (int value : v) {
+        expected += value;
+    }
+    std::atomic<long long> sum(0);
+    parallelMapAll(v, [&sum](int value) {
+        sum += value;
+    }, 16);
+    assertTrue("parallelMapAll Vector", sum == expected);
+
+    Grid<int> grid(50, 70, 3);
+    std::atomic<int> gridSum(0);
+    parallelMapAll(grid, [&gridSum](const int& value) {
+        gridSum += value;
+    }, 16);
+    assertEqualsInt("parallelMapAll Grid", 50 * 70 * 3, gridSum);
+
+    Set<int> set;
+    HashMap<int, int> hashmap;
+    Map<std::string, int> map;
+    for (int i = 1; i <= 1000; i++) {
+        set.add(i);
+        hashmap.put(i, -i);
+        map.put(integerToString(i), i);
+    }
+    std::atomic<int> setSum(0);
+    parallelMapAll(set, [&setSum](int value) {
+        setSum += value;
+    }, 16);
+    assertEqualsInt("parallelMapAll Set", 500500, setSum);
+
+    std::atomic<int> mismatches(0);
+    parallelMapAll(hashmap, [&mismatches](int key, int value) {
+        if (value != -key) {
+            mismatches++;
+        }
+    }, 16);
+    parallelMapAll(map, [&mismatches](const std::string& key, int value) {
+        if (stringToInteger(key) != value) {
+            mismatches++;
+        }
+    }, 16);
+    assertEqualsInt("parallelMapAll Map, HashMap", 0, mismatches);
+
+    Vector<int> empty;
+    parallelMapAll(empty, [](int) {
+        assertFail("parallelMapAll called fn on an empty vector");
+    });
+    setParallelThreadCount(oldThreadCount);
+}
+
+TIMED_TEST(ParallelTests, reduceTest_Parallel, TEST_TIMEOUT_DEFAULT) {
+    int oldThreadCount = getParallelThreadCount();
+    setParallelThreadCount(4);
+    Vector<int> v = randomInts(10000);
+    int expected = 0;
+    int expectedMax = v[0];
+    for (int value : v) {
+        expected += value;
+        expectedMax = std::max(expectedMax, value);
+    }
+    assertEqualsInt("parallelReduce sum", expected, parallelReduce(v, 0, std::plus<int>(), 16));
+    assertEqualsInt("parallelReduce max", expectedMax, parallelReduce(v, v[0], [](int a, int b) {
+        return std::max(a, b);
+    }, 16));
+
+    // concatenation is not commutative, so this checks that order is kept
+    Vector<std::string> words;
+    std::string joined;
+    for (int i = 0; i < 500; i++) {
+        words.add(integerToString(i) + ",");
+        joined += integerToString(i) + ",";
+    }
+    assertEqualsString("parallelReduce concatenation", joined,
+                       parallelReduce(words, "", std::plus<std::string>(), 3));
+
+    Grid<double> grid(30, 40, 0.5);
+    assertEqualsDouble("parallelReduce Grid", 600, parallelReduce(grid, 0, std::plus<double>(), 16));
+
+    Vector<int> empty;
+    assertEqualsInt("parallelReduce empty", 42, parallelReduce(empty, 42, std::plus<int>()));
+    setParallelThreadCount(oldThreadCount);
+}
+
+TIMED_TEST(ParallelTests, sortTest_Parallel, TEST_TIMEOUT_DEFAULT) {
+    int oldThreadCount = getParallelThreadCount();
+    setParallelThreadCount(4);
+    for (int n : {0, 1, 5, 1000, 12345}) {
+        Vector<int> v = randomInts(n);
+        Vector<int> expected = v;
+        std::sort(expected.begin(), expected.end());
+        parallelSort(v, 16);
+        assertEqualsString("parallelSort " + integerToString(n), expected.toString(), v.toString());
+    }
+
+    // many duplicates, and a comparator
+    Vector<int> v;
+    for (int i = 0; i < 5000; i++) {
+        v.add(randomInteger(0, 20));
+    }
+    Vector<int> expected = v;
+    std::sort(expected.begin(), expected.end(), std::greater<int>());
+    parallelSort(v, std::greater<int>(), 16);
+    assertEqualsString("parallelSort descending", expected.toString(), v.toString());
+
+    Vector<std::string> words;
+    for (int i = 0; i < 2000; i++) {
+        words.add(integerToString(randomInteger(0, 100000)));
+    }
+    Vector<std::string> expectedWords = words;
+    std::sort(expectedWords.begin(), expectedWords.end());
+    parallelSort(words, 16);
+    assertEqualsString("parallelSort strings", expectedWords.toString(), words.toString());
+    setParallelThreadCount(oldThreadCount);
+}
+
+TIMED_TEST(ParallelTests, threadCountTest_Parallel, TEST_TIMEOUT_DEFAULT) {
+    int oldThreadCount = getParallelThreadCount();
+    assertTrue("default thread count", oldThreadCount >= 1);
+    setParallelThreadCount(3);
+    assertEqualsInt("thread count", 3, getParallelThreadCount());
+    setParallelThreadCount(1);
+    Vector<int> v = randomInts(1000);
+    Vector<int> expected = v;
+    std::sort(expected.begin(), expected.end());
+    parallelSort(v, 16);
+    assertEqualsString("parallelSort with 1 thread", expected.toString(), v.toString());
+    try {
+        setParallelThreadCount(0);
+        assertFail("setParallelThreadCount(0) should throw");
+    } catch (ErrorException&) {
+        // expected
+    }
+    setParallelThreadCount(oldThreadCount);
+}
+
+TIMED_TEST(ParallelTests, transformTest_Parallel, TEST_TIMEOUT_DEFAULT) {
+    int oldThreadCount = getParallelThreadCount();
+    setParallelThreadCount(4);
+    Vector<int> v = randomInts(10000);
+    Vector<int> expected = v;
+    for (int& value : expected) {
+        value = value * 2 + 1;
+    }
+    parallelTransform(v, [](int value) {
+        return value * 2 + 1;
+    }, 16);
+    assertEqualsString("parallelTransform Vector", expected.toString(), v.toString());
+
+    Grid<std::string> grid(20, 30, "a");
+    parallelTransform(grid, [](const std::string& s) {
+        return s + "b";
+    }, 16);
+    assertEqualsString("parallelTransform Grid", "ab", grid[19][29]);
+    assertEqualsInt("parallelTransform Grid count", 0, grid.size() - (int) std::count(grid.begin(), grid.end(), "ab"));
+    setParallelThreadCount(oldThreadCount);
+}
@@ -6,8 +6,10 @@
 #include "queue.h"
 #include "hashcode.h"
 #include "hashset.h"
+#include "vector.h"
 #include "assertions.h"
 #include "gtest-marty.h"
+#include <deque>
 #include <initializer_list>
 #include <iostream>
 #include <sstream>
@@ -35,6 +37,81 @@ TIMED_TEST(QueueTests, compareTest_Queue, TEST_TIMEOUT_DEFAULT) {
     assertEqualsString("sq", "{{1, 2, 1, 4, 7}, {1, 2, 1, 5}}", sq.toString());
 }
 
+/*
+ * A value type with no default constructor, which dequeueN must not need.
+ */
+struct QueueTicket {
+    explicit QueueTicket(int number) : number(number) {}
+    int number;
+};
+
+TIMED_TEST(QueueTests, dequeueNTest_Queue, TEST_TIMEOUT_DEFAULT) {
+    Queue<std::string> q {"a", "b", "c", "d", "e"};
+    Vector<std::string> first = q.dequeueN(3);
+    assertEqualsString("dequeueN result", "{\"a\", \"b\", \"c\"}", first.toString());
+    assertEqualsString("after dequeueN", "{\"d\", \"e\"}", q.toString());
+    Vector<std::string> none = q.dequeueN(0);
+    assertEqualsInt("dequeueN none", 0, none.size());
+    Vector<std::string> rest = q.dequeueN(2);
+    assertEqualsString("dequeueN rest", "{\"d\", \"e\"}", rest.toString());
+    assertTrue("empty after dequeueN", q.isEmpty());
+
+    // elements that wrap around the end of the ring buffer
+    Queue<int> wrapped;
+    for (int i = 0; i < 12; i++) {
+        wrapped.add(i);
+    }
+    wrapped.dequeueN(10);
+    for (int i = 12; i < 20; i++) {
+        wrapped.add(i);
+    }
+    Vector<int> wrappedFront = wrapped.dequeueN(10);
+    assertEqualsString("dequeueN wrapped", "{10, 11, 12, 13, 14, 15, 16, 17, 18, 19}",
+                       wrappedFront.toString());
+    assertEqualsInt("dequeueN wrapped leaves", 0, wrapped.size());
+
+    try {
+        q.add("x");
+        q.dequeueN(2);
+        assertFail("dequeueN more than size should throw");
+    } catch (ErrorException&) {
+        // expected
+    }
+    try {
+        q.dequeueN(-1);
+        assertFail("dequeueN negative should throw");
+    } catch (ErrorException&) {
+        // expected
+    }
+
+    Queue<QueueTicket> tickets;
+    for (int i = 0; i < 5; i++) {
+        tickets.enqueue(QueueTicket(i));
+    }
+    Vector<QueueTicket> served = tickets.dequeueN(3);
+    assertEqualsInt("dequeueN without default constructor size", 3, served.size());
+    assertEqualsInt("dequeueN without default constructor first", 0, served[0].number);
+    assertEqualsInt("dequeueN without default constructor last", 2, served[2].number);
+    assertEqualsInt("dequeueN without default constructor leaves", 2, tickets.size());
+}
+
+TIMED_TEST(QueueTests, enqueueAllTest_Queue, TEST_TIMEOUT_DEFAULT) {
+    Queue<int> q;
+    q.enqueueAll({1, 2, 3});
+    Vector<int> v {4, 5};
+    q.enqueueAll(v);
+    assertEqualsString("enqueueAll", "{1, 2, 3, 4, 5}", q.toString());
+
+    q.dequeue();
+    q.enqueueAll(q);
+    assertEqualsString("enqueueAll self", "{2, 3, 4, 5, 2, 3, 4, 5}", q.toString());
+
+    Queue<int> big;
+    big.enqueueAll(Vector<int>(100, 7));
+    assertEqualsInt("enqueueAll size", 100, big.size());
+    assertEqualsInt("enqueueAll back", 7, big.back());
+}
+
 TIMED_TEST(QueueTests, forEachTest_Queue, TEST_TIMEOUT_DEFAULT) {
     Queue<std::string> q;
     q.add("a");
@@ -58,3 +135,30 @@ TIMED_TEST(QueueTests, initializerListTest_Queue, TEST_TIMEOUT_DEFAULT) {
     Queue<int> queue {10, 20, 30};
     std::cout << "init list Queue = " << queue << std::endl;
 }
+
+TIMED_TEST(QueueTests, ringBufferTest_Queue, TEST_TIMEOUT_DEFAULT) {
+    // interleave adds and removes so that the elements wrap around and
+    // the buffer grows while wrapped, checking against std::deque
+    Queue<int> q;
+    std::deque<int> expected;
+    for (int i = 0; i < 1000; i++) {
+        q.add(i);
+        expected.push_back(i);
+        if (i % 3 == 0) {
+            int front = q.dequeue();
+            assertEqualsInt("ring buffer dequeue", expected.front(), front);
+            expected.pop_front();
+        }
+    }
+    assertEqualsInt("ring buffer size", (int) expected.size(), q.size());
+    assertEqualsInt("ring buffer front", expected.front(), q.front());
+    assertEqualsInt("ring buffer back", expected.back(), q.back());
+    assertTrue("ring buffer contents", q.toStlQueue() == std::queue<int>(expected));
+
+    Queue<int> copy = q;
+    Queue<int> moved = std::move(q);
+    assertTrue("ring buffer copy", copy == moved);
+    assertTrue("moved from is empty", q.isEmpty());
+    q.add(42);
+    assertEqualsInt("moved from reusable", 42, q.peek());
+}
@@ -6,16 +6,36 @@
 #include "set.h"
 #include "hashcode.h"
 #include "hashset.h"
+#include "map.h"
 #include "queue.h"
 #include "assertions.h"
 #include "gtest-marty.h"
+#include <functional>
 #include <initializer_list>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <string>
+#include <vector>
 
 TEST_CATEGORY(SetTests, "Set tests");
 
+TIMED_TEST(SetTests, arenaTest_Set, TEST_TIMEOUT_DEFAULT) {
+    Arena arena;
+    for (int i = 0; i < 10; i++) {
+        Set<int> set(arena);
+        for (int j = 0; j < 100; j++) {
+            set.add(j * 37 % 100);
+        }
+        assertEqualsInt("size", 100, set.size());
+        assertEqualsInt("first", 0, set.first());
+    }
+    arena.release();
+    Set<int> set(arena);
+    set += 3, 1, 2;
+    assertEqualsString("after release", "{1, 2, 3}", set.toString());
+}
+
 TIMED_TEST(SetTests, randomElementTest_Set, TEST_TIMEOUT_DEFAULT) {
     Map<std::string, int> counts;
     int RUNS = 200;
@@ -55,6 +75,24 @@ TIMED_TEST(SetTests, forEachTest_Set, TEST_TIMEOUT_DEFAULT) {
     }
 }
 
+TIMED_TEST(SetTests, fromSortedTest_Set, TEST_TIMEOUT_DEFAULT) {
+    Vector<std::string> words {"apple", "banana", "cherry", "date"};
+    Set<std::string> set = Set<std::string>::fromSorted(words.begin(), words.end());
+    assertEqualsString("fromSorted", "{\"apple\", \"banana\", \"cherry\", \"date\"}", set.toString());
+    set += "aardvark", "zebra";
+    assertEqualsString("first after add", "aardvark", set.first());
+
+    std::vector<int> unsorted {5, 3, 9, 3, 1};
+    Set<int> set2(unsorted.begin(), unsorted.end());
+    assertEqualsString("range constructor", "{1, 3, 5, 9}", set2.toString());
+    try {
+        Set<int>::fromSorted(unsorted.begin(), unsorted.end());
+        assertFail("fromSorted should reject unsorted elements");
+    } catch (ErrorException&) {
+        // expected
+    }
+}
+
 TIMED_TEST(SetTests, hashCodeTest_Set, TEST_TIMEOUT_DEFAULT) {
     HashSet<Set<int> > hashset;
     Set<int> set;
@@ -81,3 +119,49 @@ TIMED_TEST(SetTests, initializerListTest_Set, TEST_TIMEOUT_DEFAULT) {
     std::cout << "Set *={} list = " << set << std::endl;
     std::cout << "at end,   Set = " << set << std::endl;
 }
+
+TIMED_TEST(SetTests, mergeTest_Set, TEST_TIMEOUT_DEFAULT) {
+    std::set<int> stl1;
+    std::set<int> stl2;
+    for (int i = 0; i < 2000; i++) {
+        stl1.insert(i * 3 % 2000);
+        stl2.insert(i * 5 % 3000);
+    }
+    Set<int> set1(stl1.begin(), stl1.end());
+    Set<int> set2(stl2.begin(), stl2.end());
+    std::set<int> both;
+    std::set<int> onlyFirst;
+    for (int n : stl1) {
+        if (stl2.count(n) != 0) {
+            both.insert(n);
+        } else {
+            onlyFirst.insert(n);
+        }
+    }
+    std::set<int> either = stl1;
+    either.insert(stl2.begin(), stl2.end());
+    assertTrue("addAll", (set1 + set2).toStlSet() == either);
+    assertTrue("retainAll", (set1 * set2).toStlSet() == both);
+    assertTrue("removeAll", (set1 - set2).toStlSet() == onlyFirst);
+    Set<int> set3 = set1;
+    set3.removeAll(set3);
+    assertTrue("removeAll of itself", set3.isEmpty());
+
+    // small sets and sets with their own order are not merged
+    for (int n = 0; n < 5; n++) {
+        Set<int> small;
+        Map<int, int> smallMap;
+        for (int i = 0; i < n; i++) {
+            small.add(i);
+            smallMap.put(i, i * i);
+        }
+        small.removeAll(small);
+        assertTrue("removeAll of small set itself", small.isEmpty());
+        smallMap.removeAll(smallMap);
+        assertTrue("removeAll of small map itself", smallMap.isEmpty());
+    }
+    Set<int> reversed((std::greater<int>()));
+    reversed.addAll(set1);
+    reversed.removeAll(reversed);
+    assertTrue("removeAll of itself with comparator", reversed.isEmpty());
+}
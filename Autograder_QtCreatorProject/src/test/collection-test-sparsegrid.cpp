@@ -53,6 +53,21 @@ TIMED_TEST(SparseGridTests, forEachTest_SparseGrid, TEST_TIMEOUT_DEFAULT) {
     std::cout << "done!" << std::endl;
 }
 
+TIMED_TEST(SparseGridTests, getTest_SparseGrid, TEST_TIMEOUT_DEFAULT) {
+    SparseGrid<int> sgrid(3, 4);
+    sgrid.set(1, 3, 42);
+    assertEqualsInt("get unset cell", 0, sgrid.get(0, 0));
+    assertFalse("get does not set cell", sgrid.isSet(0, 0));
+    assertEqualsInt("get set cell", 42, sgrid.get(1, 3));
+    assertEqualsInt("size after gets", 1, sgrid.size());
+    sgrid[2][0] += 5;
+    assertTrue("operator [] sets cell", sgrid.isSet(2, 0));
+    assertEqualsString("toString", "{1:{3:42}, 2:{0:5}}, 3 x 4", sgrid.toString());
+    sgrid.resize(2, 3, /* retain */ true);
+    assertEqualsInt("size after shrink", 0, sgrid.size());
+    assertEqualsString("toString after shrink", "{}, 2 x 3", sgrid.toString());
+}
+
 TIMED_TEST(SparseGridTests, hashCodeTest_SparseGrid, TEST_TIMEOUT_DEFAULT) {
     HashSet<SparseGrid<int> > hashsparsegrid;
     SparseGrid<int> sparsegrid(2, 2);
@@ -71,6 +86,44 @@ TIMED_TEST(SparseGridTests, initializerListTest_SparseGrid, TEST_TIMEOUT_DEFAULT
     std::cout << "init list SparseGrid = " << sgrid << std::endl;
 }
 
+TIMED_TEST(SparseGridTests, iteratorTest_SparseGrid, TEST_TIMEOUT_DEFAULT) {
+    SparseGrid<int> sgrid(1000, 1000);
+    for (int i = 999; i >= 0; i--) {
+        sgrid.set(i, (i * 7) % 1000, i);
+    }
+    int count = 0;
+    int lastRow = -1;
+    for (SparseGrid<int>::iterator itr = sgrid.begin(); itr != sgrid.end(); ++itr) {
+        assertTrue("iterator row-major order", itr.row() > lastRow);
+        assertEqualsInt("iterator col", (itr.row() * 7) % 1000, itr.col());
+        assertEqualsInt("iterator value", itr.row(), *itr);
+        lastRow = itr.row();
+        count++;
+    }
+    assertEqualsInt("iterator visits set cells only", 1000, count);
+
+    // cells set after a scan are merged into the next one
+    sgrid.set(0, 999, -1);
+    sgrid.set(0, 1, -2);
+    Vector<int> firstRow;
+    for (int n : sgrid) {
+        if (firstRow.size() < 3) {
+            firstRow.add(n);
+        }
+    }
+    assertEqualsString("iterator after more sets", "{0, -2, -1}", firstRow.toString());
+
+    // scans leave the cells where they are, so references to values stay valid
+    int& last = sgrid[999][999];
+    last = 5;
+    sgrid.set(500, 0, 6);
+    sgrid.toString();
+    last++;
+    assertEqualsInt("reference after scan", 6, sgrid.get(999, 999));
+    assertEqualsInt("other cell after scan", 6, sgrid.get(500, 0));
+    assertEqualsInt("cell after both", 999, sgrid.get(999, 993));
+}
+
 TIMED_TEST(SparseGridTests, randomElementTest_SparseGrid, TEST_TIMEOUT_DEFAULT) {
     Map<std::string, int> counts;
     int RUNS = 200;
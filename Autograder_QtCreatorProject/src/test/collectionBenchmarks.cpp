@@ -0,0 +1,701 @@
+/*
+ * Timing comparisons of the collection classes on realistic workloads.
+ * These print their measurements rather than asserting anything about them,
+ * since timings depend on the machine; they do check that every variant
+ * being compared computes the same result.
+ */
+
+#include "testcases.h"
+#include "arena.h"
+#include "btreemap.h"
+#include "bulkops.h"
+#include "deque.h"
+#include "grid.h"
+#include "indexedpriorityqueue.h"
+#include "map.h"
+#include "pairingpriorityqueue.h"
+#include "parallel.h"
+#include "priorityqueue.h"
+#include "queue.h"
+#include "random.h"
+#include "set.h"
+#include "sparsegrid.h"
+#include "strlib.h"
+#include "timer.h"
+#include "vector.h"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+using namespace std;
+
+/* an edge of a benchmark graph, stored in its start vertex's list */
+struct BenchmarkEdge {
+    int to;
+    double weight;
+};
+
+typedef Vector<Vector<BenchmarkEdge> > BenchmarkGraph;
+
+/*
+ * Builds a rows x cols grid in which each cell is joined to its four
+ * neighbors, with random weights, like a road map or game board.
+ */
+static BenchmarkGraph makeGridGraph(int rows, int cols) {
+    BenchmarkGraph graph(rows * cols);
+    for (int r = 0; r < rows; r++) {
+        for (int c = 0; c < cols; c++) {
+            int v = r * cols + c;
+            if (c + 1 < cols) {
+                double weight = randomInteger(1, 10);
+                graph[v].add({v + 1, weight});
+                graph[v + 1].add({v, weight});
+            }
+            if (r + 1 < rows) {
+                double weight = randomInteger(1, 10);
+                graph[v].add({v + cols, weight});
+                graph[v + cols].add({v, weight});
+            }
+        }
+    }
+    return graph;
+}
+
+/*
+ * Builds a graph with random edges and weights, in which vertices are
+ * reached by many paths and so have their distances lowered many times.
+ */
+static BenchmarkGraph makeRandomGraph(int vertices, int edgesPerVertex) {
+    BenchmarkGraph graph(vertices);
+    for (int v = 0; v < vertices; v++) {
+        for (int i = 0; i < edgesPerVertex; i++) {
+            graph[v].add({randomInteger(0, vertices - 1), randomReal(1, 100)});
+        }
+    }
+    return graph;
+}
+
+/*
+ * Runs Dijkstra's algorithm from vertex 0 with one of the priority queues
+ * that support changePriority, and returns the sum of the distances found.
+ */
+template <typename PQ>
+static double dijkstra(const BenchmarkGraph& graph) {
+    Vector<double> dist(graph.size(), -1);
+    Vector<bool> done(graph.size(), false);
+    PQ pq;
+    dist[0] = 0;
+    pq.enqueue(0, 0);
+    double total = 0;
+    while (!pq.isEmpty()) {
+        int v = pq.dequeue();
+        done[v] = true;
+        total += dist[v];
+        for (const BenchmarkEdge& edge : graph[v]) {
+            double d = dist[v] + edge.weight;
+            if (done[edge.to]) {
+                continue;
+            } else if (dist[edge.to] < 0) {
+                dist[edge.to] = d;
+                pq.enqueue(edge.to, d);
+            } else if (d < dist[edge.to]) {
+                dist[edge.to] = d;
+                pq.changePriority(edge.to, d);
+            }
+        }
+    }
+    return total;
+}
+
+/*
+ * Runs Dijkstra's algorithm with a plain PriorityQueue, whose changePriority
+ * takes O(N) time, so a vertex is enqueued again whenever its distance
+ * drops and the stale entries are skipped as they come out.
+ */
+static double dijkstraLazy(const BenchmarkGraph& graph) {
+    Vector<double> dist(graph.size(), -1);
+    Vector<bool> done(graph.size(), false);
+    PriorityQueue<int> pq;
+    dist[0] = 0;
+    pq.enqueue(0, 0);
+    double total = 0;
+    while (!pq.isEmpty()) {
+        int v = pq.dequeue();
+        if (done[v]) {
+            continue;
+        }
+        done[v] = true;
+        total += dist[v];
+        for (const BenchmarkEdge& edge : graph[v]) {
+            double d = dist[v] + edge.weight;
+            if (!done[edge.to] && (dist[edge.to] < 0 || d < dist[edge.to])) {
+                dist[edge.to] = d;
+                pq.enqueue(edge.to, d);
+            }
+        }
+    }
+    return total;
+}
+
+static void reportDijkstra(const string& name, double (*search)(const BenchmarkGraph&),
+                           const BenchmarkGraph& graph, double expected) {
+    Timer timer(/* autostart */ true);
+    double total = search(graph);
+    long ms = timer.stop();
+    cout << "    " << left << setw(30) << name << right << setw(6) << ms << " ms";
+    if (total != expected) {
+        cout << "  (WRONG: distance sum " << total << ", expected " << expected << ")";
+    }
+    cout << endl;
+}
+
+/*
+ * Compares the priority queue layouts on Dijkstra's algorithm over a grid
+ * and over a random graph with many decrease-key operations per vertex.
+ */
+void priorityQueueBenchmarkTest() {
+    setRandomSeed(106);
+    Vector<string> names;
+    names.add("grid graph, 500x500");
+    names.add("random graph, 100000 x 16 edges");
+    Vector<BenchmarkGraph> graphs;
+    graphs.add(makeGridGraph(500, 500));
+    graphs.add(makeRandomGraph(100000, 16));
+    for (int i = 0; i < graphs.size(); i++) {
+        cout << "Dijkstra on " << names[i] << ":" << endl;
+        double expected = dijkstraLazy(graphs[i]);
+        reportDijkstra("PriorityQueue (re-enqueue)", dijkstraLazy, graphs[i], expected);
+        reportDijkstra("IndexedPriorityQueue<int, 2>",
+                       dijkstra<IndexedPriorityQueue<int, 2> >, graphs[i], expected);
+        reportDijkstra("IndexedPriorityQueue<int, 4>",
+                       dijkstra<IndexedPriorityQueue<int, 4> >, graphs[i], expected);
+        reportDijkstra("IndexedPriorityQueue<int, 8>",
+                       dijkstra<IndexedPriorityQueue<int, 8> >, graphs[i], expected);
+        reportDijkstra("PairingPriorityQueue<int>",
+                       dijkstra<PairingPriorityQueue<int> >, graphs[i], expected);
+    }
+}
+
+/*
+ * Builds, searches and destroys one big map, the same with std::map for
+ * comparison, and then many small sets, each with its own arena and all
+ * sharing one arena.
+ */
+void mapBenchmarkTest() {
+    const int BIG = 1000000;
+    const int SMALL_SETS = 20000;
+    const int SMALL_SIZE = 50;
+    setRandomSeed(106);
+    Vector<int> keys;
+    for (int i = 0; i < BIG; i++) {
+        keys.add(randomInteger(0, 2000000000));
+    }
+
+    Timer timer(/* autostart */ true);
+    Map<int, int>* map = new Map<int, int>();
+    for (int key : keys) {
+        map->put(key, key);
+    }
+    long buildMS = timer.stop();
+    timer.start();
+    int found = 0;
+    for (int key : keys) {
+        found += map->containsKey(key);
+    }
+    long searchMS = timer.stop();
+    timer.start();
+    delete map;
+    long destroyMS = timer.stop();
+    cout << "Map<int, int>, " << BIG << " puts: " << buildMS << " ms, "
+         << found << " lookups: " << searchMS << " ms, destroy: " << destroyMS << " ms" << endl;
+
+    timer.start();
+    std::map<int, int>* stlMap = new std::map<int, int>();
+    for (int key : keys) {
+        (*stlMap)[key] = key;
+    }
+    buildMS = timer.stop();
+    timer.start();
+    found = 0;
+    for (int key : keys) {
+        found += (int) stlMap->count(key);
+    }
+    searchMS = timer.stop();
+    timer.start();
+    delete stlMap;
+    destroyMS = timer.stop();
+    cout << "std::map<int, int>, " << BIG << " puts: " << buildMS << " ms, "
+         << found << " lookups: " << searchMS << " ms, destroy: " << destroyMS << " ms" << endl;
+
+    Vector<string> words;
+    for (int i = 0; i < SMALL_SIZE * 100; i++) {
+        words.add(integerToString(keys[i]));
+    }
+    timer.start();
+    for (int i = 0; i < SMALL_SETS; i++) {
+        Set<string> set;
+        for (int j = 0; j < SMALL_SIZE; j++) {
+            set.add(words[(i * SMALL_SIZE + j) % words.size()]);
+        }
+    }
+    cout << SMALL_SETS << " Set<string> of " << SMALL_SIZE << ", own arenas: "
+         << timer.stop() << " ms" << endl;
+    timer.start();
+    Arena arena;
+    for (int i = 0; i < SMALL_SETS; i++) {
+        Set<string> set(arena);
+        for (int j = 0; j < SMALL_SIZE; j++) {
+            set.add(words[(i * SMALL_SIZE + j) % words.size()]);
+        }
+        if (i % 1000 == 999) {
+            arena.release();
+        }
+    }
+    cout << SMALL_SETS << " Set<string> of " << SMALL_SIZE << ", shared arena: "
+         << timer.stop() << " ms" << endl;
+}
+
+/*
+ * Times building, searching, walking in order and destroying an ordered
+ * map of the given type filled with the given keys.
+ */
+template <typename MapType>
+static void reportOrderedMap(const string& name, const Vector<int>& keys) {
+    Timer timer(/* autostart */ true);
+    MapType* map = new MapType();
+    for (int key : keys) {
+        map->put(key, key);
+    }
+    long buildMS = timer.stop();
+    timer.start();
+    int found = 0;
+    for (int key : keys) {
+        found += map->containsKey(key);
+    }
+    long searchMS = timer.stop();
+    timer.start();
+    long long sum = 0;
+    for (int pass = 0; pass < 10; pass++) {
+        for (int key : *map) {
+            sum += key;
+        }
+    }
+    long walkMS = timer.stop();
+    timer.start();
+    delete map;
+    long destroyMS = timer.stop();
+    cout << "    " << left << setw(20) << name << right
+         << " puts: " << setw(5) << buildMS << " ms, "
+         << found << " lookups: " << setw(5) << searchMS << " ms, "
+         << "10 walks: " << setw(5) << walkMS << " ms (sum " << sum << "), "
+         << "destroy: " << setw(4) << destroyMS << " ms" << endl;
+}
+
+/*
+ * Compares Map's AVL tree with BTreeMap's B+ tree on the same random keys.
+ */
+void orderedMapBenchmarkTest() {
+    setRandomSeed(106);
+    Vector<int> keys;
+    for (int i = 0; i < 1000000; i++) {
+        keys.add(randomInteger(0, 2000000000));
+    }
+    cout << "Ordered maps of " << keys.size() << " random int keys:" << endl;
+    reportOrderedMap<Map<int, int> >("Map<int, int>", keys);
+    reportOrderedMap<BTreeMap<int, int> >("BTreeMap<int, int>", keys);
+}
+
+/*
+ * Times setting the given cells of a grid of the given type, reading them
+ * back, and scanning the whole grid in row-major order.
+ */
+template <typename GridType>
+static void reportGrid(const string& name, int rows, int cols,
+                       const Vector<int>& cellRows, const Vector<int>& cellCols) {
+    Timer timer(/* autostart */ true);
+    GridType* grid = new GridType(rows, cols);
+    for (int i = 0; i < cellRows.size(); i++) {
+        grid->set(cellRows[i], cellCols[i], i % 100 + 1);
+    }
+    long buildMS = timer.stop();
+    timer.start();
+    long long sum = 0;
+    for (int i = 0; i < cellRows.size(); i++) {
+        sum += grid->get(cellRows[i], cellCols[i]);
+    }
+    long getMS = timer.stop();
+    timer.start();
+    long long scanSum = 0;
+    for (int pass = 0; pass < 10; pass++) {
+        grid->mapAll([&scanSum](int value) {
+            scanSum += value;
+        });
+    }
+    long scanMS = timer.stop();
+    delete grid;
+    cout << "    " << left << setw(16) << name << right
+         << " sets: " << setw(5) << buildMS << " ms, "
+         << "gets: " << setw(5) << getMS << " ms (sum " << sum << "), "
+         << "10 scans: " << setw(5) << scanMS << " ms (sum " << scanSum << ")" << endl;
+}
+
+/*
+ * Compares SparseGrid with Grid on a large board with 2% of its cells set,
+ * as in a simulation of particles or live cells on a big sparse board.
+ */
+void sparseGridBenchmarkTest() {
+    const int ROWS = 4000;
+    const int COLS = 4000;
+    const int CELLS = ROWS * COLS / 50;
+    setRandomSeed(106);
+    Vector<int> cellRows;
+    Vector<int> cellCols;
+    for (int i = 0; i < CELLS; i++) {
+        cellRows.add(randomInteger(0, ROWS - 1));
+        cellCols.add(randomInteger(0, COLS - 1));
+    }
+    cout << ROWS << " x " << COLS << " grids with " << CELLS << " random cells set:" << endl;
+    reportGrid<SparseGrid<int> >("SparseGrid<int>", ROWS, COLS, cellRows, cellCols);
+    reportGrid<Grid<int> >("Grid<int>", ROWS, COLS, cellRows, cellCols);
+}
+
+/*
+ * Runs the given function the given number of times and returns the total
+ * time in milliseconds.
+ */
+template <typename Function>
+static long timeRepeated(int times, Function fn) {
+    Timer timer(/* autostart */ true);
+    for (int i = 0; i < times; i++) {
+        fn();
+    }
+    return timer.stop();
+}
+
+static void reportBulkOp(const string& name, long loopMS, long bulkMS, bool same) {
+    cout << "    " << left << setw(26) << name << right
+         << " loop: " << setw(5) << loopMS << " ms, "
+         << "bulk: " << setw(5) << bulkMS << " ms";
+    if (!same) {
+        cout << "  (WRONG: results differ)";
+    }
+    cout << endl;
+}
+
+/*
+ * Compares the functions in bulkops.h with the element-at-a-time loops a
+ * client would otherwise write, on a large Vector<double>, Grid<double>
+ * and Grid<int>.
+ */
+void bulkOpsBenchmarkTest() {
+    const int N = 1000000;
+    const int ROWS = 1000;
+    const int COLS = 1000;
+    const int TIMES = 50;
+    setRandomSeed(106);
+    Vector<double> x;
+    Vector<double> y;
+    for (int i = 0; i < N; i++) {
+        x.add(randomReal(-1, 1));
+        y.add(randomReal(-1, 1));
+    }
+    Grid<double> image(ROWS, COLS);
+    Grid<int> counts(ROWS, COLS);
+    for (int r = 0; r < ROWS; r++) {
+        for (int c = 0; c < COLS; c++) {
+            image[r][c] = randomReal(0, 1);
+            counts[r][c] = randomInteger(-1000, 1000);
+        }
+    }
+
+    cout << "Vector<double> of " << N << ", " << TIMES << " times:" << endl;
+    Vector<double> loopY = y;
+    Vector<double> bulkY = y;
+    long loopMS = timeRepeated(TIMES, [&]() {
+        for (int i = 0; i < loopY.size(); i++) {
+            loopY[i] += 0.5 * x[i];
+        }
+    });
+    long bulkMS = timeRepeated(TIMES, [&]() {
+        axpy(0.5, x, bulkY);
+    });
+    reportBulkOp("axpy (y[i] += 0.5 * x[i])", loopMS, bulkMS, loopY == bulkY);
+
+    Vector<double> loopFill = y;
+    Vector<double> bulkFill = y;
+    loopMS = timeRepeated(TIMES, [&]() {
+        for (int i = 0; i < loopFill.size(); i++) {
+            loopFill[i] = 0.25;
+        }
+    });
+    bulkMS = timeRepeated(TIMES, [&]() {
+        fill(bulkFill, 0.25);
+    });
+    reportBulkOp("fill", loopMS, bulkMS, loopFill == bulkFill);
+
+    double loopSum = 0;
+    double bulkSum = 0;
+    loopMS = timeRepeated(TIMES, [&]() {
+        loopSum = 0;
+        for (int i = 0; i < x.size(); i++) {
+            loopSum += x[i];
+        }
+    });
+    bulkMS = timeRepeated(TIMES, [&]() {
+        bulkSum = sumElements(x);
+    });
+    reportBulkOp("sumElements", loopMS, bulkMS, std::abs(loopSum - bulkSum) < 1e-6);
+
+    double loopMax = 0;
+    double bulkMax = 0;
+    loopMS = timeRepeated(TIMES, [&]() {
+        loopMax = x[0];
+        for (int i = 1; i < x.size(); i++) {
+            loopMax = std::max(loopMax, x[i]);
+        }
+    });
+    bulkMS = timeRepeated(TIMES, [&]() {
+        bulkMax = maxElement(x);
+    });
+    reportBulkOp("maxElement", loopMS, bulkMS, loopMax == bulkMax);
+
+    cout << ROWS << " x " << COLS << " grids, " << TIMES << " times:" << endl;
+    Grid<double> loopImage = image;
+    Grid<double> bulkImage = image;
+    loopMS = timeRepeated(TIMES, [&]() {
+        for (int r = 0; r < ROWS; r++) {
+            for (int c = 0; c < COLS; c++) {
+                loopImage[r][c] *= 0.999;
+            }
+        }
+    });
+    bulkMS = timeRepeated(TIMES, [&]() {
+        scale(bulkImage, 0.999);
+    });
+    reportBulkOp("scale Grid<double>", loopMS, bulkMS, loopImage == bulkImage);
+
+    Grid<int> loopZeros = counts;
+    Grid<int> bulkZeros = counts;
+    loopMS = timeRepeated(TIMES, [&]() {
+        for (int r = 0; r < ROWS; r++) {
+            for (int c = 0; c < COLS; c++) {
+                loopZeros[r][c] = 0;
+            }
+        }
+    });
+    bulkMS = timeRepeated(TIMES, [&]() {
+        fill(bulkZeros, 0);
+    });
+    reportBulkOp("fill Grid<int>", loopMS, bulkMS, loopZeros == bulkZeros);
+
+    Grid<int> loopCounts = counts;
+    Grid<int> bulkCounts = counts;
+    loopMS = timeRepeated(TIMES, [&]() {
+        for (int r = 0; r < ROWS; r++) {
+            for (int c = 0; c < COLS; c++) {
+                loopCounts[r][c] += counts[r][c];
+            }
+        }
+    });
+    bulkMS = timeRepeated(TIMES, [&]() {
+        addElements(bulkCounts, counts);
+    });
+    reportBulkOp("addElements Grid<int>", loopMS, bulkMS, loopCounts == bulkCounts);
+
+    int loopMin = 0;
+    int bulkMin = 0;
+    loopMS = timeRepeated(TIMES, [&]() {
+        loopMin = counts[0][0];
+        for (int r = 0; r < ROWS; r++) {
+            for (int c = 0; c < COLS; c++) {
+                loopMin = std::min(loopMin, counts[r][c]);
+            }
+        }
+    });
+    bulkMS = timeRepeated(TIMES, [&]() {
+        bulkMin = minElement(counts);
+    });
+    reportBulkOp("minElement Grid<int>", loopMS, bulkMS, loopMin == bulkMin);
+
+    Grid<double> loopT;
+    Grid<double> bulkT;
+    loopMS = timeRepeated(TIMES / 10, [&]() {
+        loopT.resize(COLS, ROWS);
+        for (int r = 0; r < ROWS; r++) {
+            for (int c = 0; c < COLS; c++) {
+                loopT[c][r] = image[r][c];
+            }
+        }
+    });
+    bulkMS = timeRepeated(TIMES / 10, [&]() {
+        bulkT = transpose(image);
+    });
+    reportBulkOp("transpose (5 times)", loopMS, bulkMS, loopT == bulkT);
+
+    Grid<double> kernel(3, 3, 1.0 / 9);
+    Grid<double> loopBlur;
+    Grid<double> bulkBlur;
+    loopMS = timeRepeated(TIMES / 10, [&]() {
+        loopBlur.resize(ROWS, COLS);
+        for (int r = 0; r < ROWS; r++) {
+            for (int c = 0; c < COLS; c++) {
+                double sum = 0;
+                for (int kr = 0; kr < 3; kr++) {
+                    for (int kc = 0; kc < 3; kc++) {
+                        if (image.inBounds(r + kr - 1, c + kc - 1)) {
+                            sum += kernel[kr][kc] * image[r + kr - 1][c + kc - 1];
+                        }
+                    }
+                }
+                loopBlur[r][c] = sum;
+            }
+        }
+    });
+    bulkMS = timeRepeated(TIMES / 10, [&]() {
+        bulkBlur = convolve(image, kernel);
+    });
+    bool same = true;
+    for (int r = 0; r < ROWS; r++) {
+        for (int c = 0; c < COLS; c++) {
+            same = same && std::abs(loopBlur[r][c] - bulkBlur[r][c]) < 1e-9;
+        }
+    }
+    reportBulkOp("convolve 3x3 (5 times)", loopMS, bulkMS, same);
+}
+
+/*
+ * Times the parallel operations with one thread and with the default number
+ * of threads (one per core), on work typical of batch analytics jobs.
+ */
+void parallelBenchmarkTest() {
+    const int N = 2000000;
+    setRandomSeed(106);
+    Vector<double> values;
+    Vector<int> keys;
+    for (int i = 0; i < N; i++) {
+        values.add(randomReal(0, 100));
+        keys.add(randomInteger(0, 2000000000));
+    }
+    auto heavy = [](double x) {
+        return std::sqrt(x) * std::sin(x) + std::log(x + 1);
+    };
+    int cores = getParallelThreadCount();
+    cout << "Parallel operations on " << N << " elements:" << endl;
+    for (int threads : {1, cores}) {
+        setParallelThreadCount(threads);
+        Vector<double> transformed = values;
+        Timer timer(/* autostart */ true);
+        parallelTransform(transformed, heavy);
+        long transformMS = timer.stop();
+        timer.start();
+        double sum = parallelReduce(transformed, 0.0, std::plus<double>());
+        long reduceMS = timer.stop();
+        Vector<int> sorted = keys;
+        timer.start();
+        parallelSort(sorted);
+        long sortMS = timer.stop();
+        bool ordered = std::is_sorted(sorted.begin(), sorted.end());
+        cout << "    " << setw(2) << threads << " thread(s):"
+             << " transform " << setw(5) << transformMS << " ms,"
+             << " reduce " << setw(4) << reduceMS << " ms (sum " << (long long) sum << "),"
+             << " sort " << setw(5) << sortMS << " ms"
+             << (ordered ? "" : "  (WRONG: not sorted)") << endl;
+        if (cores == 1) {
+            break;
+        }
+    }
+    setParallelThreadCount(cores);
+}
+
+/*
+ * Passes values through the given queue type in batches, as a producer and
+ * consumer would, one element at a time, and returns a checksum.
+ */
+template <typename QueueType>
+static long long pipeOneByOne(QueueType& queue, const Vector<int>& batch, int rounds) {
+    long long sum = 0;
+    for (int r = 0; r < rounds; r++) {
+        for (int value : batch) {
+            queue.enqueue(value);
+        }
+        for (int i = 0; i < batch.size(); i++) {
+            sum += queue.dequeue();
+        }
+    }
+    return sum;
+}
+
+/*
+ * Same as pipeOneByOne but using the batch operations enqueueAll/dequeueN.
+ */
+template <typename QueueType>
+static long long pipeBatched(QueueType& queue, const Vector<int>& batch, int rounds) {
+    long long sum = 0;
+    for (int r = 0; r < rounds; r++) {
+        queue.enqueueAll(batch);
+        for (int value : queue.dequeueN(batch.size())) {
+            sum += value;
+        }
+    }
+    return sum;
+}
+
+/*
+ * Compares Queue and Deque, element by element and in batches, with
+ * std::deque on a producer/consumer workload that keeps a backlog of
+ * elements queued, so that the ring buffer wraps around.
+ */
+void queueBenchmarkTest() {
+    const int BATCH = 256;
+    const int BACKLOG = 4 * BATCH;   // whole batches, so every run sees the same sequence
+    const int ROUNDS = 20000;
+    Vector<int> batch;
+    for (int i = 0; i < BATCH; i++) {
+        batch.add(i);
+    }
+    cout << "Queue types passing " << BATCH << "-element batches "
+         << ROUNDS << " times behind a backlog of " << BACKLOG << ":" << endl;
+
+    Queue<int> queue;
+    Deque<int> deque;
+    std::deque<int> stlDeque;
+    for (int i = 0; i < BACKLOG; i++) {
+        queue.enqueue(i % BATCH);
+        deque.enqueue(i % BATCH);
+        stlDeque.push_back(i % BATCH);
+    }
+    long long sum = 0;
+    long stlMS = timeRepeated(1, [&]() {
+        for (int r = 0; r < ROUNDS; r++) {
+            for (int value : batch) {
+                stlDeque.push_back(value);
+            }
+            for (int i = 0; i < BATCH; i++) {
+                sum += stlDeque.front();
+                stlDeque.pop_front();
+            }
+        }
+    });
+    long long expected = sum;
+    cout << "    std::deque<int>          one by one: " << setw(5) << stlMS << " ms" << endl;
+
+    struct Run {
+        string name;
+        std::function<long long()> fn;
+    };
+    Vector<Run> runs {
+        {"Queue<int>               one by one", [&]() { return pipeOneByOne(queue, batch, ROUNDS); }},
+        {"Queue<int>               batched   ", [&]() { return pipeBatched(queue, batch, ROUNDS); }},
+        {"Deque<int>               one by one", [&]() { return pipeOneByOne(deque, batch, ROUNDS); }},
+        {"Deque<int>               batched   ", [&]() { return pipeBatched(deque, batch, ROUNDS); }},
+    };
+    for (const Run& run : runs) {
+        long ms = timeRepeated(1, [&]() { sum = run.fn(); });
+        cout << "    " << run.name << ": " << setw(5) << ms << " ms"
+             << (sum == expected ? "" : "  (WRONG: checksum differs)") << endl;
+    }
+}
@@ -1,10 +1,18 @@
 #include "testcases.h"
 #include "console.h"
 #include "error.h"
+#include "filelib.h"
+#include "gbufferedimage.h"
+#include "gevents.h"
+#include "gtimer.h"
+#include "inprocessbackend.h"
+#include "platform.h"
 #include "regexpr.h"
 #include "simpio.h"
 #include "strlib.h"
+#include "timer.h"
 #include <iostream>
+#include <sstream>
 #include <string>
 using namespace std;
 
@@ -55,6 +63,47 @@ void coutCerrMixTest() {
     cout << endl;
 }
 
+/*
+ * Lets a 1 ms timer send far more events than the pipe reader thread's
+ * lock-free event queue holds (4096) while the program never polls for
+ * events and only waits for long multi-line replies, during which it takes
+ * nothing but result lines from the reader thread.  The replies must keep
+ * arriving, and afterward every tick must be collected in order.
+ */
+void eventFloodTest() {
+    const int EVENT_QUEUE_CAPACITY = 4096;
+    string slong = "abcbcde";
+    while (slong.length() < 1024*64) {
+        slong += slong;
+    }
+    GTimer timer(1);
+    timer.start();
+    long endMS = Timer::currentTimeMS() + 10000;
+    int calls = 0;
+    while (Timer::currentTimeMS() < endMS) {
+        regexReplace(slong, "bc", "XX");
+        calls++;
+    }
+    timer.stop();
+
+    int ticks = 0;
+    double lastTime = 0;
+    bool ordered = true;
+    for (GEvent event = getNextEvent(TIMER_EVENT); event.isValid(); event = getNextEvent(TIMER_EVENT)) {
+        ordered = ordered && event.getEventTime() >= lastTime;
+        lastTime = event.getEventTime();
+        ticks++;
+    }
+    cout << calls << " replies received while " << ticks << " timer events queued up";
+    if (ticks <= EVENT_QUEUE_CAPACITY) {
+        cout << " (too few to overflow the event queue; the test proves nothing)";
+    }
+    if (!ordered) {
+        cout << " (WRONG: events out of order)";
+    }
+    cout << endl;
+}
+
 void getIntegerTest() {
     int n = getInteger("Type an int! ");
     cout << "you typed " << n << endl;
@@ -92,6 +141,54 @@ void getIntegerTest() {
     //         << randomInteger(1, 10) << endl;
 }
 
+/*
+ * Throws an error naming what was checked unless fn raises an ErrorException.
+ */
+static void checkInProcessError(const string& what, void (*fn)()) {
+    try {
+        fn();
+    } catch (ErrorException&) {
+        return;
+    }
+    error("inProcessErrorTest: " + what + " did not raise an error");
+}
+
+static void inProcessInvalidRegex() {
+    regexMatch("abc", "(unclosed");
+}
+
+static void inProcessLoadImage() {
+    GBufferedImage image(10, 10, 0x00ff00);
+    string filename = getTempDirectory() + getDirectoryPathSeparator() + "inProcessErrorTest.png";
+    image.save(filename);
+    try {
+        image.load(filename);
+    } catch (...) {
+        deleteFile(filename);
+        throw;
+    }
+    deleteFile(filename);
+}
+
+/*
+ * Checks that errors from the in-process back-end reach the program as
+ * ErrorExceptions, both for a command that fails (an invalid regex) and for
+ * one the in-process back-end does not support (GBufferedImage.load), and
+ * that later calls still get their own replies.
+ * Run it with the SPL_BACKEND environment variable set to "inprocess".
+ */
+void inProcessErrorTest() {
+    if (!stanfordcpplib::InProcessBackEnd::isEnabled()) {
+        error("inProcessErrorTest: set SPL_BACKEND=inprocess to run this test");
+    }
+    checkInProcessError("invalid regex", inProcessInvalidRegex);
+    checkInProcessError("GBufferedImage::load", inProcessLoadImage);
+    if (!regexMatch("abcbcde", "a.*e")) {
+        error("inProcessErrorTest: regexMatch wrong after errors");
+    }
+    cout << "in-process back-end errors raised as ErrorException" << endl;
+}
+
 void killProcessTest() {
     std::cout << "Try killing the Java process now. Does it quit gracefully?" << std::endl;
     while (true) {
@@ -116,6 +213,101 @@ void longStringTest() {
     cout << "done." << endl;
 }
 
+/*
+ * Reports how many pipe read system calls are made per line of back-end
+ * output, for many short results and for one long multi-line result.
+ */
+void pipeReadBenchmarkTest() {
+    const int RUNS = 2000;
+    stanfordcpplib::PipeReadStats before = stanfordcpplib::getPipeReadStats();
+    Timer timer(/* autostart */ true);
+    for (int i = 0; i < RUNS; i++) {
+        regexMatch("abcbcde", "bc");
+    }
+    long ms = timer.stop();
+    stanfordcpplib::PipeReadStats after = stanfordcpplib::getPipeReadStats();
+    long lines = after.lines - before.lines;
+    long syscalls = after.syscalls - before.syscalls;
+    cout << "short results: " << RUNS << " calls in " << ms << " ms, "
+         << lines << " lines, " << syscalls << " read calls ("
+         << (lines == 0 ? 0.0 : (double) syscalls / lines) << " per line)" << endl;
+
+    string slong = "abcbcde";
+    while (slong.length() < 1024*64) {
+        slong += slong;
+    }
+    before = stanfordcpplib::getPipeReadStats();
+    timer.start();
+    slong = regexReplace(slong, "bc", "XX");
+    ms = timer.stop();
+    after = stanfordcpplib::getPipeReadStats();
+    lines = after.lines - before.lines;
+    syscalls = after.syscalls - before.syscalls;
+    cout << "long result: " << (after.bytes - before.bytes) << " bytes in " << ms << " ms, "
+         << lines << " lines, " << syscalls << " read calls ("
+         << (lines == 0 ? 0.0 : (double) syscalls / lines) << " per line)" << endl;
+}
+
+/*
+ * Counts per-command pipe traffic for a mix of fire-and-forget commands and
+ * commands that wait for a reply, and prints the resulting table.
+ */
+/*
+ * Throws an error naming the failed check, so that a broken counter stops
+ * the test rather than scrolling by in its output.
+ */
+static void checkPipeStats(bool condition, const string& message) {
+    if (!condition) {
+        error("pipeStatsTest: " + message);
+    }
+}
+
+static stanfordcpplib::PipeCommandStats findPipeStats(const string& command) {
+    for (const stanfordcpplib::PipeCommandStats& stats : stanfordcpplib::getPipeCommandStats()) {
+        if (stats.command == command) {
+            return stats;
+        }
+    }
+    error("pipeStatsTest: no statistics recorded for " + command);
+    return stanfordcpplib::PipeCommandStats();
+}
+
+void pipeStatsTest() {
+    bool wasEnabled = stanfordcpplib::isPipeStatsEnabled();
+    stanfordcpplib::setPipeStatsEnabled(true);
+
+    // a single command that waits for its reply
+    stanfordcpplib::resetPipeStats();
+    regexMatch("abcbcde", "bc");
+    stanfordcpplib::PipeCommandStats match = findPipeStats("Regex.match");
+    checkPipeStats(match.calls == 1, "Regex.match calls = " + longToString(match.calls) + ", expected 1");
+    checkPipeStats(match.waits.getCount() == 1,
+                   "Regex.match waits = " + longToString(match.waits.getCount()) + ", expected 1");
+    checkPipeStats(match.bytesSent > 0, "no bytes sent for Regex.match");
+    checkPipeStats(match.bytesReceived > 0, "no bytes received for Regex.match");
+
+    // many commands, only half of which wait
+    stanfordcpplib::resetPipeStats();
+    for (int i = 0; i < 200; i++) {
+        regexMatch("abcbcde", "bc");
+        setConsoleOutputColor(i % 2 ? "#000000" : "#000001");
+    }
+    stanfordcpplib::setPipeStatsEnabled(wasEnabled);
+    match = findPipeStats("Regex.match");
+    checkPipeStats(match.calls == 200, "Regex.match calls = " + longToString(match.calls) + ", expected 200");
+    checkPipeStats(match.waits.getCount() == 200,
+                   "Regex.match waits = " + longToString(match.waits.getCount()) + ", expected 200");
+    for (const stanfordcpplib::PipeCommandStats& stats : stanfordcpplib::getPipeCommandStats()) {
+        checkPipeStats(stats.command == "Regex.match" || stats.waits.getCount() == 0,
+                       stats.command + " waited for a reply it does not have");
+        checkPipeStats(stats.bytesSent >= stats.calls, "too few bytes counted for " + stats.command);
+    }
+
+    ostringstream out;
+    stanfordcpplib::printPipeStats(out);
+    cout << out.str();
+}
+
 void outputColorTest() {
     cout << "Output color test:" << endl;
     setConsoleOutputColor("#ff00ff");
@@ -1,7 +1,9 @@
 #ifndef _testcases_h
 #define _testcases_h
 
+#include <string>
 #include "assertions.h"
+#include "strlib.h"
 
 // default timeout in ms for test cases
 #define TEST_TIMEOUT_DEFAULT 3000
@@ -18,6 +20,67 @@ static void compareTestHelper(const T& o1, const T& o2, std::string type = "",
     assertEqualsBool(type + o1.toString() + " != " + o2.toString(), compareTo != 0,  o1 != o2);
 }
 
+/*
+ * Runs the tests shared by the priority queues that find elements by value,
+ * IndexedPriorityQueue and PairingPriorityQueue, given the queue type with
+ * string elements and with int elements.
+ */
+template <typename StringPQ, typename IntPQ>
+static void valuePriorityQueueTestHelper() {
+    // changing priorities moves elements both ways
+    StringPQ pq {{4, "a"}, {3, "bb"}, {1, "c"}, {6, "ddd"}, {5, "e"}};
+    pq.changePriority("ddd", 0);       // more urgent
+    pq.changePriority("c", 7);         // less urgent
+    assertEqualsString("toString", "{0:\"ddd\", 3:\"bb\", 4:\"a\", 5:\"e\", 7:\"c\"}", pq.toString());
+    assertEqualsString("back", "c", pq.back());
+    assertEqualsInt("getPriority", 3, (int) pq.getPriority("bb"));
+    std::string first = pq.dequeue();
+    std::string second = pq.dequeue();
+    assertEqualsString("dequeue", "ddd", first);
+    assertEqualsString("dequeue", "bb", second);
+    assertEqualsInt("size", 3, pq.size());
+
+    // contains and remove
+    StringPQ pq2 {{4, "a"}, {3, "bb"}, {1, "c"}, {6, "ddd"}, {5, "e"}};
+    assertTrue("contains", pq2.contains("a"));
+    pq2.remove("a");
+    pq2.remove("c");
+    assertTrue("contains after remove", !pq2.contains("a"));
+    assertEqualsString("toString", "{3:\"bb\", 5:\"e\", 6:\"ddd\"}", pq2.toString());
+    pq2.enqueue("a", 2);
+    assertEqualsString("peek", "a", pq2.peek());
+    assertEqualsInt("peekPriority", 2, (int) pq2.peekPriority());
+
+    // ties leave in the order they were enqueued
+    IntPQ ties;
+    for (int i = 0; i < 10; i++) {
+        ties.enqueue(i, i % 2 == 0 ? 1 : 5);
+    }
+    ties.changePriority(7, 1);         // joins the ties but keeps its place
+    std::string order;
+    while (!ties.isEmpty()) {
+        order += integerToString(ties.dequeue());
+    }
+    assertEqualsString("dequeue order", "0246781359", order);
+
+    // equal queues built in different orders hash alike
+    StringPQ pq3 {{4, "a"}, {3, "bb"}};
+    StringPQ pq4 {{3, "bb"}, {4, "a"}};
+    assertTrue("==", pq3 == pq4);
+    int hash3 = hashCode(pq3);
+    int hash4 = hashCode(pq4);
+    assertEqualsInt("hashCode", hash3, hash4);
+}
+
+// collection benchmarks
+void bulkOpsBenchmarkTest();
+void mapBenchmarkTest();
+void orderedMapBenchmarkTest();
+void parallelBenchmarkTest();
+void priorityQueueBenchmarkTest();
+void queueBenchmarkTest();
+void sparseGridBenchmarkTest();
+
 // exception tests
 void exceptionTest();
 void recursionIndentTest();
@@ -34,10 +97,14 @@ void radioButtonTest();
 // pipe tests
 void cinOutTest();
 void coutCerrMixTest();
+void eventFloodTest();
 void getIntegerTest();
+void inProcessErrorTest();
 void killProcessTest();
 void longStringTest();
 void outputColorTest();
+void pipeReadBenchmarkTest();
+void pipeStatsTest();
 
 // string tests
 void stringToIntegerTest();
@@ -0,0 +1,223 @@
+/*
+ * @version 2016/10/14
+ */
+
+package stanford.spl;
+
+import java.io.*;
+import java.net.*;
+import java.nio.file.*;
+import java.nio.file.attribute.*;
+import java.security.SecureRandom;
+import java.util.concurrent.atomic.AtomicBoolean;
+
+/**
+ * A long-lived Java back-end that C++ programs connect to instead of each
+ * launching a JVM of its own, started with:
+ *
+ *     java -jar spl.jar -server [infoFile]
+ *
+ * The server listens on a loopback socket and writes its port and a random
+ * token to infoFile (by default spl-backend-USER in TMPDIR or /tmp), which
+ * only the owner can read; a C++ program run with SPL_BACKEND_SERVER set
+ * reads the file, connects, and proves it may use the server with the token.
+ *
+ * Each connection is served as its own session by a new JavaBackEnd object,
+ * so no windows, objects or timers carry over from one program to the next.
+ * Sessions are served one at a time, since the back-end talks to its C++
+ * program through System.in and System.out.  Connections are accepted on
+ * their own thread while a session runs, so that a second program is told
+ * "session:busy" at once and can launch its own back-end without waiting.
+ *
+ * Relative file names are resolved against the directory the server was
+ * started in, not the C++ program's directory.
+ */
+public class BackEndServer {
+	private static final String SESSION_OK = "session:ok";
+	private static final String SESSION_BUSY = "session:busy";
+	
+	// how long a client may take to send its whole session line, in
+	// milliseconds; the accept loop waits for no connection longer than this
+	private static final int HELLO_TIMEOUT_MS = 2000;
+	
+	// longest session line accepted: "session", the token and an app name
+	private static final int HELLO_MAX_LENGTH = 1024;
+	
+	// true while a session owns System.in and System.out
+	private static final AtomicBoolean sessionActive = new AtomicBoolean(false);
+
+	private BackEndServer() {
+		// empty
+	}
+
+	/**
+	 * Returns the info file used when none is given on the command line;
+	 * must match backEndServerFile in the C++ library's platform.cpp.
+	 */
+	public static String getDefaultInfoFile() {
+		String dir = System.getenv("TMPDIR");
+		if (dir == null || dir.isEmpty()) {
+			dir = "/tmp";
+		}
+		return new File(dir, "spl-backend-" + System.getProperty("user.name")).getPath();
+	}
+
+	/**
+	 * Serves sessions until the JVM is killed.
+	 */
+	public static void serve(String infoFile) {
+		if (infoFile == null) {
+			infoFile = getDefaultInfoFile();
+		}
+		try {
+			ServerSocket server = new ServerSocket(0, 50, InetAddress.getByName("127.0.0.1"));
+			String token = newToken();
+			writeInfoFile(infoFile, server.getLocalPort(), token);
+			System.err.println("BackEndServer: listening on port " + server.getLocalPort()
+					+ " (" + infoFile + ")");
+			for (;;) {
+				Socket socket = server.accept();
+				try {
+					acceptSession(socket, token);
+				} catch (IOException ioe) {
+					System.err.println("BackEndServer: session failed: " + ioe);
+					close(socket);
+				}
+			}
+		} catch (IOException ioe) {
+			System.err.println("BackEndServer: unable to start: " + ioe);
+		}
+	}
+
+	/*
+	 * Checks the client's "session TOKEN APPNAME" line, then either starts
+	 * the session on a thread of its own or, if another session is running,
+	 * tells the client the server is busy.  Closes the socket unless a
+	 * session was started with it.
+	 */
+	private static void acceptSession(Socket socket, String token) throws IOException {
+		socket.setTcpNoDelay(true);
+		InputStream in = socket.getInputStream();
+		String[] hello = readHello(socket, in).split(" ", 3);
+		if (hello.length < 2 || !hello[0].equals("session") || !hello[1].equals(token)) {
+			System.err.println("BackEndServer: rejected connection with bad token");
+			close(socket);
+			return;
+		}
+		socket.setSoTimeout(0);
+		PrintStream out = new PrintStream(socket.getOutputStream(), /* autoflush */ true);
+		if (!sessionActive.compareAndSet(false, true)) {
+			out.println(SESSION_BUSY);
+			close(socket);
+			return;
+		}
+		String appName = hello.length > 2 ? hello[2] : "JBE";
+		out.println(SESSION_OK);
+		startSession(socket, in, out, appName);
+	}
+
+	/*
+	 * Runs a session on a new thread, with System.in and System.out connected
+	 * to the client's socket until the session ends.
+	 */
+	private static void startSession(final Socket socket, final InputStream in,
+			final PrintStream out, final String appName) {
+		final InputStream serverIn = System.in;
+		final PrintStream serverOut = System.out;
+		Thread thread = new Thread(new Runnable() {
+			public void run() {
+				try {
+					System.setIn(in);
+					System.setOut(out);
+					JavaBackEnd backEnd = new JavaBackEnd();
+					backEnd.runSession(appName, new Runnable() {
+						public void run() {
+							// makes the session's command loop see end of input
+							try {
+								socket.shutdownInput();
+							} catch (IOException ioe) {
+								// empty; already closed
+							}
+						}
+					});
+					backEnd.endSession();
+				} finally {
+					System.setIn(serverIn);
+					System.setOut(serverOut);
+					close(socket);
+					sessionActive.set(false);
+				}
+			}
+		}, "BackEndServer session " + appName);
+		thread.start();
+	}
+
+	private static void close(Socket socket) {
+		try {
+			socket.close();
+		} catch (IOException ioe) {
+			// empty
+		}
+	}
+
+	/*
+	 * Reads the client's session line a byte at a time, so that nothing after
+	 * it is consumed before the session's own reader takes over the stream.
+	 * The socket timeout limits each read, not the whole line, so it is set
+	 * to the time left before an overall deadline before every read; a client
+	 * that sends a byte now and then, or a line that never ends, is cut off
+	 * with an IOException rather than holding up the accept loop.
+	 */
+	private static String readHello(Socket socket, InputStream in) throws IOException {
+		long deadline = System.currentTimeMillis() + HELLO_TIMEOUT_MS;
+		StringBuilder sb = new StringBuilder();
+		for (;;) {
+			long remaining = deadline - System.currentTimeMillis();
+			if (remaining <= 0) {
+				throw new SocketTimeoutException("session line not received in time");
+			}
+			socket.setSoTimeout((int) remaining);
+			int ch = in.read();
+			if (ch < 0 || ch == '\n') {
+				return sb.toString();
+			}
+			if (sb.length() >= HELLO_MAX_LENGTH) {
+				throw new IOException("session line too long");
+			}
+			sb.append((char) ch);
+		}
+	}
+
+	private static String newToken() {
+		byte[] bytes = new byte[16];
+		new SecureRandom().nextBytes(bytes);
+		StringBuilder sb = new StringBuilder();
+		for (byte b : bytes) {
+			sb.append(String.format("%02x", b & 0xff));
+		}
+		return sb.toString();
+	}
+
+	/*
+	 * Writes "PORT TOKEN" to the info file, readable by the owner only.
+	 * The file is written under a random temporary name that is created with
+	 * owner-only permissions, so the token is never readable by anyone else,
+	 * and then renamed into place.  The C++ library refuses an info file that
+	 * belongs to another user or that others can read or write.
+	 */
+	private static void writeInfoFile(String infoFile, int port, String token) throws IOException {
+		Path file = Paths.get(infoFile).toAbsolutePath();
+		FileAttribute<?> ownerOnly = PosixFilePermissions.asFileAttribute(
+				PosixFilePermissions.fromString("rw-------"));
+		Path temp = Files.createTempFile(file.getParent(), file.getFileName() + ".", ".tmp", ownerOnly);
+		try {
+			PrintStream out = new PrintStream(Files.newOutputStream(temp));
+			out.println(port + " " + token);
+			out.close();
+			Files.move(temp, file, StandardCopyOption.REPLACE_EXISTING, StandardCopyOption.ATOMIC_MOVE);
+		} finally {
+			Files.deleteIfExists(temp);
+		}
+		file.toFile().deleteOnExit();
+	}
+}
@@ -3,6 +3,7 @@ package stanford.spl;
 import java.awt.*;
 import java.awt.image.*;
 import java.io.*;
+import java.nio.*;
 
 import javax.imageio.*;
 import javax.swing.*;
@@ -10,6 +11,8 @@ import javax.swing.*;
 /**
  * 
  * @author Marty Stepp
+ * @version 2016/10/12
+ * - added to/fromPixelBuffer for pixels shared with the C++ library
  * @version 2015/10/08
  * - bug fixes in to/fromGrid support
  * @version 2015/08/12
@@ -176,6 +179,36 @@ public class GBufferedImage extends GInteractor {
 		repaintImage();
 	}
 	
+	/**
+	 * Replaces the image's pixels with the given width * height 0xRRGGBB
+	 * values, stored row by row.
+	 */
+	public void fromPixelBuffer(int w, int h, IntBuffer pixels) {
+		if (w != imageWidth || h != imageHeight) {
+			this.resize(w, h, /* retain */ false);
+		}
+		int[] pixelArray = new int[imageWidth * imageHeight];
+		pixels.get(pixelArray);
+		for (int i = 0; i < pixelArray.length; i++) {
+			pixelArray[i] |= 0xff000000;   // alpha
+		}
+		bufferedImage.setRGB(0, 0, imageWidth, imageHeight, pixelArray, 0, imageWidth);
+		bufferedImage.flush();
+		repaintImage();
+	}
+	
+	/**
+	 * Writes the image's pixels into the given buffer as 0xRRGGBB values,
+	 * row by row.
+	 */
+	public void toPixelBuffer(IntBuffer pixels) {
+		int[] pixelArray = bufferedImage.getRGB(0, 0, imageWidth, imageHeight, null, 0, imageWidth);
+		for (int i = 0; i < pixelArray.length; i++) {
+			pixelArray[i] &= 0x00ffffff;
+		}
+		pixels.put(pixelArray);
+	}
+	
 	private void repaintImage() {
 		Dimension oldSize = label.getPreferredSize();
 		label.setIcon(new ImageIcon(bufferedImage));
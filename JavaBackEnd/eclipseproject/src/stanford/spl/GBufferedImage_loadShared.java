@@ -0,0 +1,39 @@
+package stanford.spl;
+
+import java.nio.*;
+import acm.graphics.*;
+import acm.util.*;
+
+/**
+ * 
+ * @version 2016/10/12
+ */
+public class GBufferedImage_loadShared extends JBECommand {
+	// GBufferedImage.loadShared("id", "foobar.png", "/dev/shm/spl-pixels-XXXXXX")
+	public void execute(TokenScanner paramTokenScanner, JavaBackEnd paramJavaBackEnd) {
+		paramTokenScanner.verifyToken("(");
+		String id = nextString(paramTokenScanner);
+		paramTokenScanner.verifyToken(",");
+		String filename = nextString(paramTokenScanner);
+		paramTokenScanner.verifyToken(",");
+		String path = nextString(paramTokenScanner);
+		paramTokenScanner.verifyToken(")");
+		
+		GObject gobj = paramJavaBackEnd.getGObject(id);
+		if (gobj != null && gobj instanceof GBufferedImage) {
+			GBufferedImage img = (GBufferedImage) gobj;
+			try {
+				img.load(filename);
+				int width = img.getImageWidth();
+				int height = img.getImageHeight();
+				IntBuffer pixels = SplSharedPixels.map(path, width * height);
+				img.toPixelBuffer(pixels);
+				SplPipeDecoder.writeResult("GDimension(" + width + ", " + height + ")");
+			} catch (Exception ex) {
+				SplPipeDecoder.writeResult("error:" + ex.getClass().getSimpleName() + ": " + ex.getMessage().replace('\n', ' '));
+			}
+		} else {
+			SplPipeDecoder.writeResult("error: NULL object");
+		}
+	}
+}
@@ -0,0 +1,39 @@
+package stanford.spl;
+
+import java.nio.*;
+import acm.graphics.*;
+import acm.util.*;
+
+/**
+ * 
+ * @version 2016/10/12
+ */
+public class GBufferedImage_updateAllPixelsShared extends JBECommand {
+	// GBufferedImage.updateAllPixelsShared("id", "/dev/shm/spl-pixels-XXXXXX", width, height)
+	public void execute(TokenScanner paramTokenScanner, JavaBackEnd paramJavaBackEnd) {
+		paramTokenScanner.verifyToken("(");
+		String id = nextString(paramTokenScanner);
+		paramTokenScanner.verifyToken(",");
+		String path = nextString(paramTokenScanner);
+		paramTokenScanner.verifyToken(",");
+		int width = nextInt(paramTokenScanner);
+		paramTokenScanner.verifyToken(",");
+		int height = nextInt(paramTokenScanner);
+		paramTokenScanner.verifyToken(")");
+		
+		// the C++ side waits for this reply before it reuses the shared file
+		GObject gobj = paramJavaBackEnd.getGObject(id);
+		if (gobj != null && gobj instanceof GBufferedImage) {
+			GBufferedImage img = (GBufferedImage) gobj;
+			try {
+				IntBuffer pixels = SplSharedPixels.map(path, width * height);
+				img.fromPixelBuffer(width, height, pixels);
+				SplPipeDecoder.writeResult("ok");
+			} catch (Exception ex) {
+				SplPipeDecoder.writeResult("error:" + ex.getClass().getSimpleName() + ": " + ex.getMessage());
+			}
+		} else {
+			SplPipeDecoder.writeResult("error: NULL object");
+		}
+	}
+}
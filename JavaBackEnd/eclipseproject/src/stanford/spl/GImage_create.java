@@ -0,0 +1,28 @@
+/*
+ * @version 2016/10/10
+ * - moved into source tree; writes result through SplPipeDecoder
+ *   so that it is tagged with the C++ request ID, if any
+ */
+
+package stanford.spl;
+
+import acm.graphics.GImage;
+import acm.util.TokenScanner;
+
+public class GImage_create extends JBECommand {
+	// GImage.create("id", "filename")
+	public void execute(TokenScanner paramTokenScanner, JavaBackEnd paramJavaBackEnd) {
+		paramTokenScanner.verifyToken("(");
+		String id = nextString(paramTokenScanner);
+		paramTokenScanner.verifyToken(",");
+		String filename = nextString(paramTokenScanner);
+		paramTokenScanner.verifyToken(")");
+		try {
+			GImage image = new GImage(filename);
+			paramJavaBackEnd.defineGObject(id, image);
+			SplPipeDecoder.writeResult("GDimension(" + image.getWidth() + ", " + image.getHeight() + ")");
+		} catch (Exception ex) {
+			SplPipeDecoder.writeResult(ex.getMessage());
+		}
+	}
+}
@@ -0,0 +1,30 @@
+/*
+ * @version 2016/10/10
+ * - moved into source tree; writes result through SplPipeDecoder
+ *   so that it is tagged with the C++ request ID, if any
+ * - a missing object is now reported as a result rather than a bare
+ *   "error:" line that the C++ side would never see as a reply
+ */
+
+package stanford.spl;
+
+import acm.graphics.GObject;
+import acm.graphics.GRectangle;
+import acm.util.TokenScanner;
+
+public class GObject_getBounds extends JBECommand {
+	// GObject.getBounds("id")
+	public void execute(TokenScanner paramTokenScanner, JavaBackEnd paramJavaBackEnd) {
+		paramTokenScanner.verifyToken("(");
+		String id = nextString(paramTokenScanner);
+		paramTokenScanner.verifyToken(")");
+		GObject gobj = paramJavaBackEnd.getGObject(id);
+		if (gobj == null) {
+			SplPipeDecoder.writeResult("error: NULL object");
+		} else {
+			GRectangle bounds = gobj.getBounds();
+			SplPipeDecoder.writeResult("GRectangle(" + bounds.getX() + ", " + bounds.getY()
+					+ ", " + bounds.getWidth() + ", " + bounds.getHeight() + ")");
+		}
+	}
+}
@@ -13,8 +13,10 @@ import acm.util.TokenScanner;
 
 public class GWindow_setExitOnClose extends JBECommand implements ActionListener, WindowListener {
 	private Set<String> windowsToMonitor = new HashSet<String>();
+	private JavaBackEnd backEnd;
 	
 	public void execute(TokenScanner paramTokenScanner, JavaBackEnd paramJavaBackEnd) {
+		backEnd = paramJavaBackEnd;
 		paramTokenScanner.verifyToken("(");
 		String str1 = nextString(paramTokenScanner);
 		JBEWindow localJBEWindow = paramJavaBackEnd.getWindow(str1);
@@ -45,7 +47,7 @@ public class GWindow_setExitOnClose extends JBECommand implements ActionListener
 	}
 	
 	public void actionPerformed(ActionEvent e) {
-		System.exit(0);
+		backEnd.exitBackEnd();
 	}
 	
 	public void windowActivated(WindowEvent arg0) {}
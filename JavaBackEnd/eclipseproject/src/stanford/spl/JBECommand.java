@@ -1,4 +1,6 @@
 /*
+ * @version 2016/10/06
+ * - added StanfordCppLib_setPipeProtocol
  * @version 2016/09/26
  * - added Note_play
  * @version 2016/07/06
@@ -49,10 +51,12 @@ public abstract class JBECommand {
 		localHashMap.put("GBufferedImage.fill", new GBufferedImage_fill());
 		localHashMap.put("GBufferedImage.fillRegion", new GBufferedImage_fillRegion());
 		localHashMap.put("GBufferedImage.load", new GBufferedImage_load());
+		localHashMap.put("GBufferedImage.loadShared", new GBufferedImage_loadShared());
 		localHashMap.put("GBufferedImage.resize", new GBufferedImage_resize());
 		localHashMap.put("GBufferedImage.save", new GBufferedImage_save());
 		localHashMap.put("GBufferedImage.setRGB", new GBufferedImage_setRGB());
 		localHashMap.put("GBufferedImage.updateAllPixels", new GBufferedImage_updateAllPixels());
+		localHashMap.put("GBufferedImage.updateAllPixelsShared", new GBufferedImage_updateAllPixelsShared());
 		localHashMap.put("GButton.create", new GButton_create());
 		localHashMap.put("GCheckBox.create", new GCheckBox_create());
 		localHashMap.put("GCheckBox.isSelected", new GCheckBox_isSelected());
@@ -214,6 +218,7 @@ public abstract class JBECommand {
 		localHashMap.put("Sound.play", new Sound_play());
 		localHashMap.put("StanfordCppLib.getJbeVersion", new StanfordCppLib_getJbeVersion());
 		localHashMap.put("StanfordCppLib.setCppVersion", new StanfordCppLib_setCppVersion());
+		localHashMap.put("StanfordCppLib.setPipeProtocol", new StanfordCppLib_setPipeProtocol());
 		localHashMap.put("TopCompound.create", new TopCompound_create());
 		localHashMap.put("URL.download", new URL_download());
 		return localHashMap;
@@ -25,7 +25,7 @@ public class JBEDummyProgram extends AbstractConsoleProgram {
 			} catch (InterruptedException ie) {
 				// empty
 			}
-			System.exit(0);
+			jbe.exitBackEnd();
 		}
 		return super.menuAction(event);
 	}
@@ -64,6 +64,11 @@ public class JavaBackEnd implements WindowListener, MouseListener, MouseMotionLi
 			DEBUG = prop != null && (prop.startsWith("t") || prop.startsWith("1"));
 		} catch (Exception e) {}
 		
+		if (paramArrayOfString.length > 0 && paramArrayOfString[0].equals("-server")) {
+			// long-lived back-end that C++ programs connect to; see BackEndServer
+			BackEndServer.serve(paramArrayOfString.length > 1 ? paramArrayOfString[1] : null);
+			return;
+		}
 		new JavaBackEnd().run(paramArrayOfString);
 	}
 	
@@ -75,6 +80,9 @@ public class JavaBackEnd implements WindowListener, MouseListener, MouseMotionLi
 	private JBEConsole console;
 	private JFrame consoleFrame;
 	private int consoleCloseOperation = JFrame.HIDE_ON_CLOSE;
+	private boolean binaryPipeProtocol = false;
+	private Runnable sessionCloser = null;      // set when serving a BackEndServer session
+	private volatile boolean sessionEnded = false;
 
 	private int consoleX = 10;
 	private int consoleY = 40;
@@ -118,6 +126,53 @@ public class JavaBackEnd implements WindowListener, MouseListener, MouseMotionLi
 		return Version.getCppLibraryVersion();
 	}
 
+	public void setBinaryPipeProtocol(boolean binary) {
+		this.binaryPipeProtocol = binary;
+	}
+	
+	/*
+	 * Runs one session of a BackEndServer: executes the commands of one
+	 * C++ program, read from System.in, until that program disconnects.
+	 * Where the back-end would normally exit, it calls sessionCloser instead.
+	 */
+	public void runSession(String appName, Runnable sessionCloser) {
+		this.sessionCloser = sessionCloser;
+		run(new String[] {appName});
+	}
+	
+	/*
+	 * Closes the windows and stops the timers of a finished session, so that
+	 * nothing from it reaches the next session's C++ program.
+	 */
+	public void endSession() {
+		sessionEnded = true;
+		for (GTimer timer : timerTable.values()) {
+			timer.stop();
+		}
+		timerTable.clear();
+		for (JBEWindow window : windowTable.values()) {
+			for (WindowListener listener : window.getWindowListeners()) {
+				window.removeWindowListener(listener);
+			}
+			window.dispose();
+		}
+		windowTable.clear();
+		if (consoleFrame != null) {
+			consoleFrame.dispose();
+		}
+	}
+	
+	/*
+	 * Exits the back-end, or in a BackEndServer session ends only the session.
+	 */
+	public void exitBackEnd() {
+		if (sessionCloser != null) {
+			sessionCloser.run();
+		} else {
+			System.exit(0);
+		}
+	}
+	
 	public String getJbeVersion() {
 		return Version.getLibraryVersion();
 	}
@@ -345,6 +400,9 @@ public class JavaBackEnd implements WindowListener, MouseListener, MouseMotionLi
 	}
 
 	public void println(String paramString) {
+		if (sessionEnded) {
+			return;
+		}
 		synchronized (this.eventLock) {
 			SplPipeDecoder.println(paramString);
 		}
@@ -355,6 +413,9 @@ public class JavaBackEnd implements WindowListener, MouseListener, MouseMotionLi
 	}
 	
 	public void acknowledgeEvent(String eventText) {
+		if (sessionEnded) {
+			return;
+		}
 		synchronized (this.eventLock) {
 			SplPipeDecoder.println(eventText);
 			if (!this.eventAcknowledged) {
@@ -638,6 +699,10 @@ public class JavaBackEnd implements WindowListener, MouseListener, MouseMotionLi
 				try {
 					Thread.sleep(200);
 				} catch (InterruptedException ie) {}
+				if (sessionCloser != null) {
+					sessionCloser.run();
+					return;
+				}
 				try {
 					System.out.close();
 				} catch (Exception e) {
@@ -682,7 +747,7 @@ public class JavaBackEnd implements WindowListener, MouseListener, MouseMotionLi
 		this.activeWindowCount -= 1;
 		if (this.activeWindowCount == 0) {
 			acknowledgeEvent("event:lastWindowGWindow_closed()");
-			System.exit(0);
+			exitBackEnd();
 		}
 	}
 
@@ -766,21 +831,17 @@ public class JavaBackEnd implements WindowListener, MouseListener, MouseMotionLi
 				if (str1 == null) {
 					break;
 				}
-				if (DEBUG) {
-					printLog(str1);
-				}
 				
 				if (str1.equals("LongCommand.begin()")) {
 					str1 = readLongCommand(localBufferedReader);
 				}
 				
-				localTokenScanner.setInput(str1);
-				String str2 = localTokenScanner.nextToken();
-				JBECommand localJBECommand = (JBECommand) this.cmdTable.get(str2);
-				if (localJBECommand == null) {
-					System.err.println("Unexpected error: unknown command \"" + str2 + "\"");
-				} else {
-					localJBECommand.execute(localTokenScanner, this);
+				executeCommand(str1, localTokenScanner);
+				if (this.binaryPipeProtocol) {
+					// C++ side waits for the switch to be acknowledged, so nothing
+					// after this command is buffered in localBufferedReader yet
+					binaryCommandLoop(localTokenScanner);
+					break;
 				}
 			}
 		} catch (Exception localException) {
@@ -792,6 +853,51 @@ public class JavaBackEnd implements WindowListener, MouseListener, MouseMotionLi
 		}
 	}
 	
+	/*
+	 * Reads and executes commands sent in the binary pipe protocol
+	 * (see SplBinaryPipeDecoder) until the C++ side closes the pipe.
+	 */
+	private void binaryCommandLoop(TokenScanner scanner) throws IOException {
+		SplBinaryPipeDecoder decoder = new SplBinaryPipeDecoder(System.in);
+		for (;;) {
+			java.nio.ByteBuffer frame = decoder.readFrame();
+			if (frame == null) {
+				break;
+			}
+			decoder.execute(frame, this, scanner);
+		}
+	}
+	
+	/*
+	 * Looks up the given text command in the command table and executes it.
+	 * A command of the form "#ID command" is a request whose result must be
+	 * tagged with that ID.
+	 */
+	public void executeCommand(String command, TokenScanner scanner) {
+		if (DEBUG) {
+			printLog(command);
+		}
+		Integer requestId = null;
+		if (command.startsWith("#")) {
+			int space = command.indexOf(' ');
+			requestId = Integer.valueOf(command.substring(1, space));
+			command = command.substring(space + 1);
+		}
+		scanner.setInput(command);
+		String name = scanner.nextToken();
+		JBECommand jbeCommand = (JBECommand) this.cmdTable.get(name);
+		if (jbeCommand == null) {
+			System.err.println("Unexpected error: unknown command \"" + name + "\"");
+		} else {
+			SplPipeDecoder.setRequestId(requestId);
+			try {
+				jbeCommand.execute(scanner, this);
+			} finally {
+				SplPipeDecoder.setRequestId(null);
+			}
+		}
+	}
+	
 	/*
 	 * Handle very long command strings in special way.
 	 */
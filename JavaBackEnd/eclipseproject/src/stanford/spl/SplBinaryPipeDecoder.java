@@ -0,0 +1,116 @@
+/*
+ * @version 2016/10/06
+ * - initial version
+ */
+
+package stanford.spl;
+
+import java.io.DataInputStream;
+import java.io.EOFException;
+import java.io.IOException;
+import java.io.InputStream;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+import acm.graphics.GObject;
+import acm.graphics.GPolygon;
+import acm.util.ErrorException;
+import acm.util.TokenScanner;
+
+/**
+ * Reads commands sent by the C++ library in the binary pipe protocol.
+ * Each frame is a 4-byte payload length followed by the payload, which is a
+ * 2-byte opcode and then that opcode's arguments.  Numbers are in the
+ * native byte order of the machine, since both processes run on it.
+ * Strings are a 4-byte length followed by that many bytes.
+ */
+public class SplBinaryPipeDecoder {
+	// related: same constants in C++ lib platform.cpp
+	public static final int OP_TEXT_COMMAND = 0;
+	public static final int OP_GBUFFEREDIMAGE_SETRGB = 1;
+	public static final int OP_GOBJECT_SETLOCATION = 2;
+	public static final int OP_GPOLYGON_ADDVERTEX = 3;
+
+	private DataInputStream input;
+	private ByteBuffer header = ByteBuffer.allocate(4).order(ByteOrder.nativeOrder());
+	private byte[] payload = new byte[4096];
+
+	public SplBinaryPipeDecoder(InputStream input) {
+		this.input = new DataInputStream(input);
+	}
+
+	/**
+	 * Reads the next frame and returns a buffer positioned at its opcode,
+	 * or null if the C++ side has closed the pipe.
+	 */
+	public ByteBuffer readFrame() throws IOException {
+		try {
+			input.readFully(header.array());
+		} catch (EOFException eofe) {
+			return null;
+		}
+		header.rewind();
+		int length = header.getInt();
+		if (length > payload.length) {
+			payload = new byte[Math.max(length, payload.length * 2)];
+		}
+		input.readFully(payload, 0, length);
+		ByteBuffer frame = ByteBuffer.wrap(payload, 0, length);
+		frame.order(ByteOrder.nativeOrder());
+		return frame;
+	}
+
+	/**
+	 * Executes the command in the given frame.  Text commands are passed
+	 * through the given scanner to the regular command table.
+	 */
+	public void execute(ByteBuffer frame, JavaBackEnd jbe, TokenScanner scanner) {
+		int opcode = frame.getShort() & 0xffff;
+		switch (opcode) {
+		case OP_TEXT_COMMAND: {
+			jbe.executeCommand(readString(frame), scanner);
+			break;
+		}
+		case OP_GBUFFEREDIMAGE_SETRGB: {
+			String id = readString(frame);
+			int x = frame.getInt();
+			int y = frame.getInt();
+			int rgb = frame.getInt();
+			GObject gobj = jbe.getGObject(id);
+			if (gobj != null && gobj instanceof GBufferedImage) {
+				((GBufferedImage) gobj).setRGB(x, y, rgb);
+			}
+			break;
+		}
+		case OP_GOBJECT_SETLOCATION: {
+			String id = readString(frame);
+			double x = frame.getDouble();
+			double y = frame.getDouble();
+			GObject gobj = jbe.getGObject(id);
+			if (gobj != null) {
+				gobj.setLocation(x, y);
+			}
+			break;
+		}
+		case OP_GPOLYGON_ADDVERTEX: {
+			String id = readString(frame);
+			double x = frame.getDouble();
+			double y = frame.getDouble();
+			GObject gobj = jbe.getGObject(id);
+			if (gobj != null) {
+				((GPolygon) gobj).addVertex(x, y);
+			}
+			break;
+		}
+		default:
+			throw new ErrorException("unknown binary pipe opcode " + opcode);
+		}
+	}
+
+	private static String readString(ByteBuffer frame) {
+		int length = frame.getInt();
+		String s = new String(frame.array(), frame.arrayOffset() + frame.position(), length);
+		frame.position(frame.position() + length);
+		return s;
+	}
+}
@@ -1,4 +1,7 @@
 /*
+ * @version 2016/10/10
+ * - results written while executing a command tagged with a request ID
+ *   are tagged with that ID ("result#ID:...")
  * @version 2015/10/08
  */
 
@@ -15,6 +18,10 @@ public class SplPipeDecoder {
 	// related: similar constant in C++ lib platform.cpp
 	public static final int PIPE_MAX_COMMAND_LENGTH = 2048;
 	
+	// ID of the request being executed on this thread, if the C++ side tagged
+	// its command with one ("#ID command"); replies carry the same ID
+	private static final ThreadLocal<Integer> requestId = new ThreadLocal<Integer>();
+	
 	public static String decode(String s) {
 		try {
 			s = URLDecoder.decode(s, "UTF-8");
@@ -95,7 +102,12 @@ public class SplPipeDecoder {
 	}
 	
 	public static synchronized void writeAck(String s) {
-		writeResult("___jbe___ack___ " + s);
+		// acks are never replies to a tagged request
+		println("result:___jbe___ack___ " + s);
+	}
+	
+	public static void setRequestId(Integer id) {
+		requestId.set(id);
 	}
 	
 	public static synchronized void writeResult(Object o) {
@@ -106,12 +118,14 @@ public class SplPipeDecoder {
 		if (s.length() > PIPE_MAX_COMMAND_LENGTH - 7) {
 			writeLongResult(s);
 		} else {
-			println("result:" + s);
+			Integer id = requestId.get();
+			println((id == null ? "result:" : "result#" + id + ":") + s);
 		}
 	}
 	
 	public static synchronized void writeLongResult(String s) {
-		println("result_long:begin");
+		Integer id = requestId.get();
+		println(id == null ? "result_long:begin" : "result_long#" + id + ":begin");
 		for (int i = 0, len = s.length();
 				i < len;
 				i += PIPE_MAX_COMMAND_LENGTH) {
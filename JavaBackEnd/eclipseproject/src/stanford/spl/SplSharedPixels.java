@@ -0,0 +1,54 @@
+/*
+ * @version 2016/10/12
+ */
+
+package stanford.spl;
+
+import java.io.*;
+import java.nio.*;
+import java.nio.channels.*;
+
+/**
+ * Maps the file through which the C++ library passes GBufferedImage pixels,
+ * so that they need not be sent through the pipe as Base64 text.
+ * Pixels are stored as ints in the C++ machine's native byte order,
+ * row by row, as 0xRRGGBB values.
+ */
+public class SplSharedPixels {
+	private static String mappedPath = null;
+	private static MappedByteBuffer mapped = null;
+	
+	private SplSharedPixels() {
+		// empty
+	}
+	
+	/**
+	 * Returns a view of the shared file at the given path that holds at least
+	 * pixelCount pixels, growing the file if needed; the C++ side notices the
+	 * larger file and maps it too.
+	 */
+	public static synchronized IntBuffer map(String path, int pixelCount) throws IOException {
+		long needed = Math.max(pixelCount, 1) * 4L;
+		if (mapped == null || !path.equals(mappedPath) || mapped.capacity() < needed) {
+			// the C++ side creates the file and removes it when it exits;
+			// don't leave behind a new, empty one in its place
+			if (!new File(path).isFile()) {
+				throw new FileNotFoundException(path);
+			}
+			RandomAccessFile file = new RandomAccessFile(path, "rw");
+			try {
+				if (file.length() < needed) {
+					file.setLength(needed);
+				}
+				mapped = file.getChannel().map(FileChannel.MapMode.READ_WRITE, 0, file.length());
+				mapped.order(ByteOrder.nativeOrder());
+				mappedPath = path;
+			} finally {
+				// the mapping stays valid after the file is closed
+				file.close();
+			}
+		}
+		mapped.clear();
+		return mapped.asIntBuffer();
+	}
+}
@@ -0,0 +1,31 @@
+/*
+ * @version 2016/10/06
+ * - initial version
+ */
+
+package stanford.spl;
+
+import acm.util.TokenScanner;
+
+/**
+ * Switches the C++ -> Java command channel to the protocol named in the
+ * command's argument; currently "text" (the default) or "binary".
+ * The C++ side waits for this command's "ok" result before writing
+ * anything in the new protocol.
+ */
+public class StanfordCppLib_setPipeProtocol extends JBECommand {
+	public void execute(TokenScanner paramTokenScanner, JavaBackEnd paramJavaBackEnd) {
+		paramTokenScanner.verifyToken("(");
+		String protocol = nextString(paramTokenScanner);
+		paramTokenScanner.verifyToken(")");
+		if (protocol.equals("binary")) {
+			paramJavaBackEnd.setBinaryPipeProtocol(true);
+			SplPipeDecoder.writeResult("ok");
+		} else if (protocol.equals("text")) {
+			paramJavaBackEnd.setBinaryPipeProtocol(false);
+			SplPipeDecoder.writeResult("ok");
+		} else {
+			SplPipeDecoder.writeResult("unknown pipe protocol: " + protocol);
+		}
+	}
+}
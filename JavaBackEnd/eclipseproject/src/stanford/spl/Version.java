@@ -1,6 +1,6 @@
 /*
  * @author Marty Stepp
- * @version 2016/09/26
+ * @version 2016/10/12
  * - If you update this file, make sure to update the @version tag above
  *   AND the String constant below! Both are needed and must be in sync. 
  * - see also: stanford/spl/LibraryUpdater.java 
@@ -9,7 +9,7 @@
 package stanford.spl;
 
 public class Version {
-	private static final String JAVA_BACK_END_VERSION = "2016/09/26";
+	private static final String JAVA_BACK_END_VERSION = "2016/10/12";
 	private static final String CPP_LIB_VERSION_UNKNOWN = "(unknown)";
 	private static String CPP_LIB_VERSION = CPP_LIB_VERSION_UNKNOWN;
 	public static final String ABOUT_MESSAGE = "";
@@ -0,0 +1,73 @@
+/*
+ * File: arena.cpp
+ * ---------------
+ * Implementation of the Arena class as declared in arena.h.
+ */
+
+#include "arena.h"
+#include <new>
+
+Arena::Arena() {
+    blocks = NULL;
+    next = 0;
+    end = 0;
+}
+
+Arena::~Arena() {
+    deleteBlocks(blocks);
+}
+
+size_t Arena::getCapacity() const {
+    size_t capacity = 0;
+    for (Block* block = blocks; block != NULL; block = block->next) {
+        capacity += block->size;
+    }
+    return capacity;
+}
+
+void Arena::release() {
+    if (blocks != NULL) {
+        deleteBlocks(blocks->next);
+        blocks->next = NULL;
+        next = reinterpret_cast<uintptr_t>(blocks + 1);
+        end = next + blocks->size;
+    }
+}
+
+/*
+ * Implementation notes: allocateBlock
+ * -----------------------------------
+ * Each new block is twice the size of the last, up to MAX_BLOCK_SIZE, so
+ * a growing collection seldom has to ask the system for memory.  A
+ * request too big for such a block gets a block of exactly its own size.
+ * Whatever is left at the end of the old block is abandoned.
+ */
+void* Arena::allocateBlock(size_t size, size_t alignment) {
+    size_t blockSize = INITIAL_BLOCK_SIZE;
+    if (blocks != NULL) {
+        blockSize = blocks->size * 2;
+        if (blockSize > MAX_BLOCK_SIZE) {
+            blockSize = MAX_BLOCK_SIZE;
+        }
+    }
+    if (blockSize < size + alignment) {
+        blockSize = size + alignment;
+    }
+    Block* block = static_cast<Block*>(::operator new(sizeof(Block) + blockSize));
+    block->next = blocks;
+    block->size = blockSize;
+    blocks = block;
+    next = reinterpret_cast<uintptr_t>(block + 1);
+    end = next + blockSize;
+    uintptr_t start = (next + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    next = start + size;
+    return reinterpret_cast<void*>(start);
+}
+
+void Arena::deleteBlocks(Block* first) {
+    while (first != NULL) {
+        Block* next = first->next;
+        ::operator delete(first);
+        first = next;
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ * File: arena.h
+ * -------------
+ * This file exports the <code>Arena</code> class, a memory allocator that
+ * hands out memory from large blocks and frees it all at once.
+ * The tree-based collections (Map, Set) draw their nodes from an arena
+ * instead of allocating each one separately with <code>new</code>, which
+ * makes building and destroying large trees much cheaper.
+ *
+ * Each map or set has an arena of its own by default.  A client that builds
+ * many short-lived maps or sets can instead create one Arena and pass it to
+ * their constructors, so that they all share its memory:
+ *
+ *     Arena arena;
+ *     for (...) {
+ *         Set<string> seen(arena);
+ *         ...
+ *     }
+ *     arena.release();
+ *
+ * A shared arena must outlive every collection that uses it.
+ *
+ * @version 2016/10/14
+ * - initial version
+ * @since 2016/10/14
+ */
+
+#ifndef _arena_h
+#define _arena_h
+
+#include <cstddef>
+#include <stdint.h>
+
+/*
+ * Class: Arena
+ * ------------
+ * This class allocates memory by carving it out of a few large blocks,
+ * each twice the size of the one before.  Memory is never freed piece by
+ * piece; all of it is freed together when the arena is released or
+ * destroyed.
+ */
+class Arena {
+public:
+    /*
+     * Constructor: Arena
+     * Usage: Arena arena;
+     * -------------------
+     * Initializes a new arena, which holds no memory until first used.
+     */
+    Arena();
+
+    /*
+     * Destructor: ~Arena
+     * ------------------
+     * Frees all memory allocated from the arena.
+     */
+    ~Arena();
+
+    /*
+     * Method: allocate
+     * Usage: void* p = arena.allocate(size, alignment);
+     * -------------------------------------------------
+     * Returns a pointer to <code>size</code> bytes of uninitialized memory,
+     * aligned to a multiple of <code>alignment</code>, which must be a power
+     * of two.  The memory remains valid until the arena is released or
+     * destroyed.
+     */
+    void* allocate(size_t size, size_t alignment);
+
+    /*
+     * Method: getCapacity
+     * Usage: size_t bytes = arena.getCapacity();
+     * ------------------------------------------
+     * Returns the total size in bytes of the blocks the arena currently holds.
+     */
+    size_t getCapacity() const;
+
+    /*
+     * Method: release
+     * Usage: arena.release();
+     * -----------------------
+     * Frees all memory allocated from the arena at once, making every
+     * pointer returned by allocate invalid.  The arena keeps its newest
+     * block, so that it can be filled again without asking the system for
+     * more memory.  Objects stored in the memory are not destroyed; that is
+     * up to the client, before the call.
+     */
+    void release();
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+private:
+    /* header at the start of each block; the block's memory follows it */
+    struct Block {
+        Block* next;
+        size_t size;
+    };
+
+    /* Constant definitions */
+    static const size_t INITIAL_BLOCK_SIZE = 1024;
+    static const size_t MAX_BLOCK_SIZE = 1024 * 1024;
+
+    /* Instance variables */
+    Block* blocks;            /* list of blocks, most recently added first */
+    uintptr_t next;           /* next free byte in the current block       */
+    uintptr_t end;            /* end of the current block                  */
+
+    /* Private methods */
+    void* allocateBlock(size_t size, size_t alignment);
+    void deleteBlocks(Block* first);
+
+    /* Arenas cannot be copied, since their memory is in use by others */
+    Arena(const Arena& src);
+    Arena& operator =(const Arena& src);
+};
+
+/*
+ * Implementation notes: allocate
+ * ------------------------------
+ * The common case, in which the request fits in the current block, is
+ * inline; allocateBlock handles starting a new block.
+ */
+inline void* Arena::allocate(size_t size, size_t alignment) {
+    uintptr_t start = (next + alignment - 1) & ~(uintptr_t) (alignment - 1);
+    if (start + size <= end && start >= next) {
+        next = start + size;
+        return reinterpret_cast<void*>(start);
+    }
+    return allocateBlock(size, alignment);
+}
+
+#endif // _arena_h
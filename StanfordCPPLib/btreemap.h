@@ -0,0 +1,1505 @@
+/*
+ * File: btreemap.h
+ * ----------------
+ * This file exports the template class <code>BTreeMap</code>, which
+ * maintains a collection of <i>key</i>-<i>value</i> pairs in key order.
+ * It offers the same interface as <code>Map</code> but stores its entries
+ * in a B+ tree, which keeps many keys side by side in each node.  Lookups
+ * touch far fewer nodes than in Map's binary tree, and iterating over the
+ * keys in order is a walk along a list of arrays.
+ *
+ * @version 2016/10/14
+ * - initial version
+ * @since 2016/10/14
+ */
+
+#ifndef _btreemap_h
+#define _btreemap_h
+
+#include <initializer_list>
+#include <map>
+#include <utility>
+#include "collections.h"
+#include "error.h"
+#include "hashcode.h"
+#include "vector.h"
+
+/*
+ * Class: BTreeMap<KeyType,ValueType>
+ * ----------------------------------
+ * This class maintains an association between <b><i>keys</i></b> and
+ * <b><i>values</i></b>, just as Map does.  Keys are ordered by their
+ * <code>&lt;</code> operator; unlike Map, a BTreeMap cannot be given a
+ * comparison function of its own.
+ *
+ * In addition to Map's methods, a BTreeMap can report its smallest and
+ * largest keys and extract the entries whose keys lie in a given range.
+ */
+template <typename KeyType, typename ValueType>
+class BTreeMap {
+public:
+    /*
+     * Constructor: BTreeMap
+     * Usage: BTreeMap<KeyType,ValueType> map;
+     * ---------------------------------------
+     * Initializes a new empty map that associates keys and values of the
+     * specified types.
+     */
+    BTreeMap();
+
+    /*
+     * Constructor: BTreeMap
+     * Usage: BTreeMap<KeyType,ValueType> map {{"a", 1}, {"b", 2}, {"c", 3}};
+     * ----------------------------------------------------------------------
+     * Initializes a new map that stores the given pairs.
+     * Note that the pairs are stored in key-sorted order internally and not
+     * necessarily the order in which they are written in the initializer list.
+     */
+    BTreeMap(std::initializer_list<std::pair<KeyType, ValueType> > list);
+
+    /*
+     * Destructor: ~BTreeMap
+     * ---------------------
+     * Frees any heap storage associated with this map.
+     */
+    virtual ~BTreeMap();
+
+    /*
+     * Method: add
+     * Usage: map.add(key, value);
+     * ---------------------------
+     * Associates <code>key</code> with <code>value</code> in this map.
+     * A synonym for the put method.
+     */
+    void add(const KeyType& key, const ValueType& value);
+
+    /*
+     * Method: addAll
+     * Usage: map.addAll(map2);
+     * ------------------------
+     * Adds all key/value pairs from the given map to this map.
+     * If both maps contain a pair for the same key, the one from map2 will
+     * replace the one from this map.
+     * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
+     * Returns a reference to this map.
+     * Identical in behavior to putAll.
+     */
+    BTreeMap& addAll(const BTreeMap& map2);
+    BTreeMap& addAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
+
+    /*
+     * Method: clear
+     * Usage: map.clear();
+     * -------------------
+     * Removes all entries from this map.
+     */
+    void clear();
+    
+    /*
+     * Method: containsKey
+     * Usage: if (map.containsKey(key)) ...
+     * ------------------------------------
+     * Returns <code>true</code> if there is an entry for <code>key</code>
+     * in this map.
+     */
+    bool containsKey(const KeyType& key) const;
+
+    /*
+     * Method: equals
+     * Usage: if (map.equals(map2)) ...
+     * --------------------------------
+     * Returns <code>true</code> if the two maps contain exactly the same
+     * key/value pairs, and <code>false</code> otherwise.
+     */
+    bool equals(const BTreeMap& map2) const;
+
+    /*
+     * Method: firstKey
+     * Usage: KeyType key = map.firstKey();
+     * ------------------------------------
+     * Returns the smallest key in this map.
+     * Throws an error if the map is empty.
+     */
+    const KeyType& firstKey() const;
+
+    /*
+     * Method: get
+     * Usage: ValueType value = map.get(key);
+     * --------------------------------------
+     * Returns the value associated with <code>key</code> in this map.
+     * If <code>key</code> is not found, <code>get</code> returns the
+     * default value for <code>ValueType</code>.
+     */
+    ValueType get(const KeyType& key) const;
+
+    /*
+     * Method: isEmpty
+     * Usage: if (map.isEmpty()) ...
+     * -----------------------------
+     * Returns <code>true</code> if this map contains no entries.
+     */
+    bool isEmpty() const;
+    
+    /*
+     * Method: keys
+     * Usage: Vector<KeyType> keys = map.keys();
+     * -----------------------------------------
+     * Returns a collection containing all keys in this map.
+     * Note that this implementation makes a deep copy of the keys,
+     * so it is inefficient to call on large maps.
+     */
+    Vector<KeyType> keys() const;
+    
+    /*
+     * Method: lastKey
+     * Usage: KeyType key = map.lastKey();
+     * -----------------------------------
+     * Returns the largest key in this map.
+     * Throws an error if the map is empty.
+     */
+    const KeyType& lastKey() const;
+
+    /*
+     * Method: mapAll
+     * Usage: map.mapAll(fn);
+     * ----------------------
+     * Iterates through the map entries and calls <code>fn(key, value)</code>
+     * for each one.  The keys are processed in ascending order.
+     */
+    void mapAll(void (*fn)(KeyType, ValueType)) const;
+    void mapAll(void (*fn)(const KeyType&, const ValueType&)) const;
+    
+    template <typename FunctorType>
+    void mapAll(FunctorType fn) const;
+
+    /*
+     * Method: put
+     * Usage: map.put(key, value);
+     * ---------------------------
+     * Associates <code>key</code> with <code>value</code> in this map.
+     * Any previous value associated with <code>key</code> is replaced
+     * by the new value.
+     */
+    void put(const KeyType& key, const ValueType& value);
+
+    /*
+     * Method: putAll
+     * Usage: map.putAll(map2);
+     * ------------------------
+     * Adds all key/value pairs from the given map to this map.
+     * If both maps contain a pair for the same key, the one from map2 will
+     * replace the one from this map.
+     * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
+     * Returns a reference to this map.
+     * Identical in behavior to addAll.
+     */
+    BTreeMap& putAll(const BTreeMap& map2);
+    BTreeMap& putAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
+
+    /*
+     * Method: remove
+     * Usage: map.remove(key);
+     * -----------------------
+     * Removes any entry for <code>key</code> from this map.
+     */
+    void remove(const KeyType& key);
+
+    /*
+     * Method: removeAll
+     * Usage: map.removeAll(map2);
+     * ---------------------------
+     * Removes all key/value pairs from this map that are contained in the given map.
+     * If both maps contain the same key but it maps to different values, that
+     * mapping will not be removed.
+     * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
+     * Returns a reference to this map.
+     */
+    BTreeMap& removeAll(const BTreeMap& map2);
+    BTreeMap& removeAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
+
+    /*
+     * Method: retainAll
+     * Usage: map.retainAll(map2);
+     * ---------------------------
+     * Removes all key/value pairs from this map that are not contained in the given map.
+     * If both maps contain the same key but it maps to different values, that
+     * mapping will be removed.
+     * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
+     * Returns a reference to this map.
+     */
+    BTreeMap& retainAll(const BTreeMap& map2);
+    BTreeMap& retainAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
+
+    /*
+     * Method: size
+     * Usage: int nEntries = map.size();
+     * ---------------------------------
+     * Returns the number of entries in this map.
+     */
+    int size() const;
+    
+    /*
+     * Method: subMap
+     * Usage: BTreeMap<KeyType,ValueType> range = map.subMap(fromKey, toKey);
+     * ----------------------------------------------------------------------
+     * Returns a new map holding the entries of this map whose keys are at
+     * least <code>fromKey</code> and less than <code>toKey</code>.
+     * The cost is proportional to the number of entries returned, plus the
+     * logarithm of the size of this map.
+     */
+    BTreeMap subMap(const KeyType& fromKey, const KeyType& toKey) const;
+
+    /*
+     * Returns an STL map object with the same elements as this map.
+     */
+    std::map<KeyType, ValueType> toStlMap() const;
+    
+    /*
+     * Method: toString
+     * Usage: string str = map.toString();
+     * -----------------------------------
+     * Converts the map to a printable string representation.
+     */
+    std::string toString() const;
+
+    /*
+     * Method: values
+     * Usage: Vector<ValueType> values = map.values();
+     * -----------------------------------------------
+     * Returns a collection containing all values in this map.
+     * Note that this implementation makes a deep copy of the values,
+     * so it is inefficient to call on large maps.
+     */
+    Vector<ValueType> values() const;
+    
+    /*
+     * Operator: []
+     * Usage: map[key]
+     * ---------------
+     * Selects the value associated with <code>key</code>.  This syntax
+     * makes it easy to think of a map as an "associative array"
+     * indexed by the key type.  If <code>key</code> is already present
+     * in the map, this function returns a reference to its associated
+     * value.  If key is not present in the map, a new entry is created
+     * whose value is set to the default for the value type.
+     */
+    ValueType& operator [](const KeyType& key);
+    ValueType operator [](const KeyType& key) const;
+
+    /*
+     * Operator: ==
+     * Usage: if (map1 == map2) ...
+     * ----------------------------
+     * Compares two maps for equality.
+     */
+    bool operator ==(const BTreeMap& map2) const;
+
+    /*
+     * Operator: !=
+     * Usage: if (map1 != map2) ...
+     * ----------------------------
+     * Compares two maps for inequality.
+     */
+    bool operator !=(const BTreeMap& map2) const;
+
+    /*
+     * Operators: <, <=, >, >=
+     * Usage: if (map1 < map2) ...
+     * ---------------------------
+     * Relational operators to compare two maps.
+     * The <, >, <=, >= operators require that the ValueType has a < operator
+     * so that the elements can be compared pairwise.
+     */
+    bool operator <(const BTreeMap& map2) const;
+    bool operator <=(const BTreeMap& map2) const;
+    bool operator >(const BTreeMap& map2) const;
+    bool operator >=(const BTreeMap& map2) const;
+
+    /*
+     * Operator: +
+     * Usage: map1 + map2
+     * ------------------
+     * Returns the union of the two maps, equivalent to a copy of the first map
+     * with addAll called on it passing the second map as a parameter.
+     * If the two maps both contain a mapping for the same key, the mapping
+     * from the second map is favored.
+     * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
+     */
+    BTreeMap operator +(const BTreeMap& map2) const;
+    BTreeMap operator +(std::initializer_list<std::pair<KeyType, ValueType> > list) const;
+
+    /*
+     * Operator: +=
+     * Usage: map1 += map2;
+     * --------------------
+     * Adds all key/value pairs from the given map to this map.
+     * Equivalent to calling addAll(map2).
+     * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
+     */
+    BTreeMap& operator +=(const BTreeMap& map2);
+    BTreeMap& operator +=(std::initializer_list<std::pair<KeyType, ValueType> > list);
+
+    /*
+     * Operator: -
+     * Usage: map1 - map2
+     * ------------------
+     * Returns the difference of the two maps, equivalent to a copy of the first map
+     * with removeAll called on it passing the second map as a parameter.
+     * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
+     */
+    BTreeMap operator -(const BTreeMap& map2) const;
+    BTreeMap operator -(std::initializer_list<std::pair<KeyType, ValueType> > list) const;
+
+    /*
+     * Operator: -=
+     * Usage: map1 -= map2;
+     * --------------------
+     * Removes all key/value pairs from the given map to this map.
+     * Equivalent to calling removeAll(map2).
+     * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
+     */
+    BTreeMap& operator -=(const BTreeMap& map2);
+    BTreeMap& operator -=(std::initializer_list<std::pair<KeyType, ValueType> > list);
+
+    /*
+     * Operator: *
+     * Usage: map1 * map2
+     * ------------------
+     * Returns the intersection of the two maps, equivalent to a copy of the first map
+     * with retainAll called on it passing the second map as a parameter.
+     * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
+     */
+    BTreeMap operator *(const BTreeMap& map2) const;
+    BTreeMap operator *(std::initializer_list<std::pair<KeyType, ValueType> > list) const;
+
+    /*
+     * Operator: *=
+     * Usage: map1 *= map2;
+     * ---------------------
+     * Removes all key/value pairs that are not found in the given map from this map.
+     * Equivalent to calling retainAll(map2).
+     * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
+     */
+    BTreeMap& operator *=(const BTreeMap& map2);
+    BTreeMap& operator *=(std::initializer_list<std::pair<KeyType, ValueType> > list);
+
+    /*
+     * Additional BTreeMap operations
+     * ------------------------------
+     * In addition to the methods listed in this interface, the BTreeMap
+     * class supports the following operations:
+     *
+     *   - Stream I/O using the << and >> operators
+     *   - Deep copying for the copy constructor and assignment operator
+     *   - Iteration using the range-based for statement and STL iterators
+     *
+     * All iteration is guaranteed to proceed in ascending order of keys.
+     */
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+    /*
+     * Implementation notes:
+     * ---------------------
+     * The map is represented as a B+ tree.  All entries live in the leaves,
+     * each of which holds up to LEAF_CAPACITY keys in sorted arrays, and the
+     * leaves are chained into a doubly-linked list in key order.  Internal
+     * nodes hold only separator keys: every key in the subtree children[i]
+     * is less than keys[i], and every key in children[i + 1] is at least
+     * keys[i].  Every node but the root is kept at least half full, so the
+     * tree stays shallow; a map of a million entries is four levels deep.
+     *
+     * Since a key is found by binary search within a node, and the keys of
+     * a node are adjacent in memory, a lookup touches a handful of cache
+     * lines rather than one per level of a binary tree.  Iteration needs no
+     * stack, since it simply follows the chain of leaves.
+     */
+
+private:
+    /* Constant definitions */
+    static const int LEAF_CAPACITY = 32;
+    static const int INTERNAL_CAPACITY = 32;
+    static const int MIN_LEAF_COUNT = LEAF_CAPACITY / 2;
+    static const int MIN_INTERNAL_COUNT = (INTERNAL_CAPACITY - 1) / 2;
+    static const int MAX_HEIGHT = 32;
+
+    /* Type definitions for the nodes of the tree */
+    struct Node {
+        bool isLeaf;             /* true for leaves, false for internal nodes */
+        int count;               /* Number of keys stored in the node         */
+    };
+
+    struct LeafNode : Node {
+        KeyType keys[LEAF_CAPACITY];        /* Keys in ascending order      */
+        ValueType values[LEAF_CAPACITY];    /* The corresponding values     */
+        LeafNode* prev;                     /* Leaf holding the smaller keys */
+        LeafNode* next;                     /* Leaf holding the larger keys  */
+    };
+
+    struct InternalNode : Node {
+        KeyType keys[INTERNAL_CAPACITY];            /* Separator keys      */
+        Node* children[INTERNAL_CAPACITY + 1];      /* count + 1 subtrees  */
+    };
+
+    /* Instance variables */
+    Node* root;                     /* Root of the tree, or NULL if empty */
+    LeafNode* firstLeaf;            /* Leaf holding the smallest keys     */
+    LeafNode* lastLeaf;             /* Leaf holding the largest keys      */
+    int nodeCount;                  /* Number of entries in the map       */
+
+    /* Private methods */
+
+    /*
+     * Implementation notes: findLowerIndex(keys, count, key), findUpperIndex
+     * ----------------------------------------------------------------------
+     * Binary searches of a node's keys.  findLowerIndex returns the index of
+     * the first key that is not less than key, and findUpperIndex the index of
+     * the first key that is greater than key; both return count if there is
+     * no such key.
+     */
+    static int findLowerIndex(const KeyType* keys, int count, const KeyType& key) {
+        int low = 0;
+        int high = count;
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (keys[mid] < key) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return low;
+    }
+
+    static int findUpperIndex(const KeyType* keys, int count, const KeyType& key) {
+        int low = 0;
+        int high = count;
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (key < keys[mid]) {
+                high = mid;
+            } else {
+                low = mid + 1;
+            }
+        }
+        return low;
+    }
+
+    /*
+     * Implementation notes: findLeaf(key)
+     * -----------------------------------
+     * Returns the leaf in which key belongs.  The tree must not be empty.
+     */
+    LeafNode* findLeaf(const KeyType& key) const {
+        Node* np = root;
+        while (!np->isLeaf) {
+            InternalNode* ip = static_cast<InternalNode*>(np);
+            np = ip->children[findUpperIndex(ip->keys, ip->count, key)];
+        }
+        return static_cast<LeafNode*>(np);
+    }
+
+    /*
+     * Implementation notes: findValue(key)
+     * ------------------------------------
+     * Returns a pointer to the value stored for key, or NULL if the map has
+     * no entry for it.
+     */
+    ValueType* findValue(const KeyType& key) const {
+        if (root == NULL) {
+            return NULL;
+        }
+        LeafNode* leaf = findLeaf(key);
+        int index = findLowerIndex(leaf->keys, leaf->count, key);
+        if (index < leaf->count && !(key < leaf->keys[index])) {
+            return &leaf->values[index];
+        }
+        return NULL;
+    }
+
+    /*
+     * Implementation notes: addEntry(key)
+     * -----------------------------------
+     * Returns a pointer to the value stored for key, first adding an entry
+     * with the default value if there is none.  The path from the root to
+     * the leaf is recorded on the way down, so that a full leaf can be split
+     * and the new separator pushed up into its ancestors, splitting them in
+     * turn as necessary.  Splitting the root adds a level to the tree.
+     */
+    ValueType* addEntry(const KeyType& key) {
+        if (root == NULL) {
+            LeafNode* leaf = createLeaf();
+            root = firstLeaf = lastLeaf = leaf;
+        }
+        InternalNode* path[MAX_HEIGHT];
+        int pathIndex[MAX_HEIGHT];
+        int depth = 0;
+        Node* np = root;
+        while (!np->isLeaf) {
+            InternalNode* ip = static_cast<InternalNode*>(np);
+            int index = findUpperIndex(ip->keys, ip->count, key);
+            path[depth] = ip;
+            pathIndex[depth] = index;
+            depth++;
+            np = ip->children[index];
+        }
+        LeafNode* leaf = static_cast<LeafNode*>(np);
+        int index = findLowerIndex(leaf->keys, leaf->count, key);
+        if (index < leaf->count && !(key < leaf->keys[index])) {
+            return &leaf->values[index];
+        }
+        if (leaf->count == LEAF_CAPACITY) {
+            LeafNode* right = splitLeaf(leaf);
+            if (index > leaf->count) {
+                index -= leaf->count;
+                leaf = right;
+            }
+            addSeparator(path, pathIndex, depth, right->keys[0], right);
+        }
+        for (int i = leaf->count; i > index; i--) {
+            leaf->keys[i] = std::move(leaf->keys[i - 1]);
+            leaf->values[i] = std::move(leaf->values[i - 1]);
+        }
+        leaf->keys[index] = key;
+        leaf->values[index] = ValueType();
+        leaf->count++;
+        nodeCount++;
+        return &leaf->values[index];
+    }
+
+    /*
+     * Implementation notes: splitLeaf(leaf)
+     * -------------------------------------
+     * Moves the upper half of a full leaf into a new leaf, which follows it
+     * in the chain of leaves, and returns the new leaf.
+     */
+    LeafNode* splitLeaf(LeafNode* leaf) {
+        LeafNode* right = createLeaf();
+        int half = LEAF_CAPACITY / 2;
+        for (int i = half; i < LEAF_CAPACITY; i++) {
+            right->keys[i - half] = std::move(leaf->keys[i]);
+            right->values[i - half] = std::move(leaf->values[i]);
+        }
+        right->count = LEAF_CAPACITY - half;
+        leaf->count = half;
+        right->prev = leaf;
+        right->next = leaf->next;
+        if (right->next == NULL) {
+            lastLeaf = right;
+        } else {
+            right->next->prev = right;
+        }
+        leaf->next = right;
+        return right;
+    }
+
+    /*
+     * Implementation notes: addSeparator(path, pathIndex, depth, key, right)
+     * ----------------------------------------------------------------------
+     * Called after the node at the given depth of the path has been split,
+     * with right holding the keys from key upward.  Inserts key and right
+     * into the parent, splitting full parents on the way up.  When a full
+     * internal node is split, its middle key moves up to its own parent
+     * rather than staying in either half.
+     */
+    void addSeparator(InternalNode** path, int* pathIndex, int depth,
+                      KeyType key, Node* right) {
+        while (depth > 0) {
+            depth--;
+            InternalNode* parent = path[depth];
+            int index = pathIndex[depth];
+            if (parent->count < INTERNAL_CAPACITY) {
+                insertChild(parent, index, key, right);
+                return;
+            }
+            int mid = INTERNAL_CAPACITY / 2;
+            InternalNode* sibling = createInternal();
+            for (int i = mid + 1; i < INTERNAL_CAPACITY; i++) {
+                sibling->keys[i - mid - 1] = std::move(parent->keys[i]);
+            }
+            for (int i = mid + 1; i <= INTERNAL_CAPACITY; i++) {
+                sibling->children[i - mid - 1] = parent->children[i];
+            }
+            sibling->count = INTERNAL_CAPACITY - mid - 1;
+            parent->count = mid;
+            KeyType middle = std::move(parent->keys[mid]);
+            if (index <= mid) {
+                insertChild(parent, index, key, right);
+            } else {
+                insertChild(sibling, index - mid - 1, key, right);
+            }
+            key = std::move(middle);
+            right = sibling;
+        }
+        InternalNode* newRoot = createInternal();
+        newRoot->keys[0] = std::move(key);
+        newRoot->children[0] = root;
+        newRoot->children[1] = right;
+        newRoot->count = 1;
+        root = newRoot;
+    }
+
+    /*
+     * Implementation notes: insertChild(np, index, key, child)
+     * --------------------------------------------------------
+     * Inserts key at position index of an internal node that has room for
+     * it, with child as the subtree that follows it.
+     */
+    static void insertChild(InternalNode* np, int index, const KeyType& key, Node* child) {
+        for (int i = np->count; i > index; i--) {
+            np->keys[i] = std::move(np->keys[i - 1]);
+            np->children[i + 1] = np->children[i];
+        }
+        np->keys[index] = key;
+        np->children[index + 1] = child;
+        np->count++;
+    }
+
+    /*
+     * Implementation notes: removeEntry(key)
+     * --------------------------------------
+     * Removes the entry for key, if any.  A leaf left less than half full
+     * borrows an entry from a neighbor that can spare one, or else is merged
+     * with that neighbor, which removes a child from the parent; the parent
+     * is then checked in the same way, and so on up the recorded path.  A
+     * root left with a single child is replaced by that child.
+     */
+    void removeEntry(const KeyType& key) {
+        if (root == NULL) {
+            return;
+        }
+        InternalNode* path[MAX_HEIGHT];
+        int pathIndex[MAX_HEIGHT];
+        int depth = 0;
+        Node* np = root;
+        while (!np->isLeaf) {
+            InternalNode* ip = static_cast<InternalNode*>(np);
+            int index = findUpperIndex(ip->keys, ip->count, key);
+            path[depth] = ip;
+            pathIndex[depth] = index;
+            depth++;
+            np = ip->children[index];
+        }
+        LeafNode* leaf = static_cast<LeafNode*>(np);
+        int index = findLowerIndex(leaf->keys, leaf->count, key);
+        if (index == leaf->count || key < leaf->keys[index]) {
+            return;
+        }
+        for (int i = index + 1; i < leaf->count; i++) {
+            leaf->keys[i - 1] = std::move(leaf->keys[i]);
+            leaf->values[i - 1] = std::move(leaf->values[i]);
+        }
+        leaf->count--;
+        clearSlot(leaf, leaf->count);
+        nodeCount--;
+
+        np = leaf;
+        while (depth > 0 && np->count < (np->isLeaf ? MIN_LEAF_COUNT : MIN_INTERNAL_COUNT)) {
+            depth--;
+            if (np->isLeaf) {
+                rebalanceLeaf(path[depth], pathIndex[depth]);
+            } else {
+                rebalanceInternal(path[depth], pathIndex[depth]);
+            }
+            np = path[depth];
+        }
+        if (root->count == 0) {
+            if (root->isLeaf) {
+                deleteNode(root);
+                root = firstLeaf = lastLeaf = NULL;
+            } else {
+                InternalNode* oldRoot = static_cast<InternalNode*>(root);
+                root = oldRoot->children[0];
+                oldRoot->count = -1;
+                deleteNode(oldRoot);
+            }
+        }
+    }
+
+    /*
+     * Implementation notes: rebalanceLeaf(parent, index)
+     * --------------------------------------------------
+     * Refills the leaf parent->children[index], which has fallen below
+     * MIN_LEAF_COUNT entries, from a neighboring leaf under the same parent,
+     * or merges the two if neither neighbor has an entry to spare.
+     */
+    void rebalanceLeaf(InternalNode* parent, int index) {
+        LeafNode* leaf = static_cast<LeafNode*>(parent->children[index]);
+        if (index > 0) {
+            LeafNode* left = static_cast<LeafNode*>(parent->children[index - 1]);
+            if (left->count > MIN_LEAF_COUNT) {
+                for (int i = leaf->count; i > 0; i--) {
+                    leaf->keys[i] = std::move(leaf->keys[i - 1]);
+                    leaf->values[i] = std::move(leaf->values[i - 1]);
+                }
+                left->count--;
+                leaf->keys[0] = std::move(left->keys[left->count]);
+                leaf->values[0] = std::move(left->values[left->count]);
+                clearSlot(left, left->count);
+                leaf->count++;
+                parent->keys[index - 1] = leaf->keys[0];
+                return;
+            }
+        }
+        if (index < parent->count) {
+            LeafNode* right = static_cast<LeafNode*>(parent->children[index + 1]);
+            if (right->count > MIN_LEAF_COUNT) {
+                leaf->keys[leaf->count] = std::move(right->keys[0]);
+                leaf->values[leaf->count] = std::move(right->values[0]);
+                leaf->count++;
+                for (int i = 1; i < right->count; i++) {
+                    right->keys[i - 1] = std::move(right->keys[i]);
+                    right->values[i - 1] = std::move(right->values[i]);
+                }
+                right->count--;
+                clearSlot(right, right->count);
+                parent->keys[index] = right->keys[0];
+                return;
+            }
+        }
+        mergeLeaves(parent, (index > 0) ? index - 1 : index);
+    }
+
+    /*
+     * Implementation notes: mergeLeaves(parent, index)
+     * ------------------------------------------------
+     * Moves every entry of parent->children[index + 1] into the leaf before
+     * it, then unlinks and deletes the emptied leaf.
+     */
+    void mergeLeaves(InternalNode* parent, int index) {
+        LeafNode* left = static_cast<LeafNode*>(parent->children[index]);
+        LeafNode* right = static_cast<LeafNode*>(parent->children[index + 1]);
+        for (int i = 0; i < right->count; i++) {
+            left->keys[left->count + i] = std::move(right->keys[i]);
+            left->values[left->count + i] = std::move(right->values[i]);
+        }
+        left->count += right->count;
+        left->next = right->next;
+        if (left->next == NULL) {
+            lastLeaf = left;
+        } else {
+            left->next->prev = left;
+        }
+        deleteNode(right);
+        removeChild(parent, index);
+    }
+
+    /*
+     * Implementation notes: rebalanceInternal(parent, index)
+     * ------------------------------------------------------
+     * The counterpart of rebalanceLeaf for internal nodes.  Borrowing
+     * rotates a key through the parent: the parent's separator moves down
+     * into the deficient node and the neighbor's outermost key replaces it.
+     */
+    void rebalanceInternal(InternalNode* parent, int index) {
+        InternalNode* np = static_cast<InternalNode*>(parent->children[index]);
+        if (index > 0) {
+            InternalNode* left = static_cast<InternalNode*>(parent->children[index - 1]);
+            if (left->count > MIN_INTERNAL_COUNT) {
+                np->children[np->count + 1] = np->children[np->count];
+                for (int i = np->count; i > 0; i--) {
+                    np->keys[i] = std::move(np->keys[i - 1]);
+                    np->children[i] = np->children[i - 1];
+                }
+                np->keys[0] = std::move(parent->keys[index - 1]);
+                np->children[0] = left->children[left->count];
+                np->count++;
+                left->count--;
+                parent->keys[index - 1] = std::move(left->keys[left->count]);
+                return;
+            }
+        }
+        if (index < parent->count) {
+            InternalNode* right = static_cast<InternalNode*>(parent->children[index + 1]);
+            if (right->count > MIN_INTERNAL_COUNT) {
+                np->keys[np->count] = std::move(parent->keys[index]);
+                np->children[np->count + 1] = right->children[0];
+                np->count++;
+                parent->keys[index] = std::move(right->keys[0]);
+                for (int i = 1; i < right->count; i++) {
+                    right->keys[i - 1] = std::move(right->keys[i]);
+                }
+                for (int i = 1; i <= right->count; i++) {
+                    right->children[i - 1] = right->children[i];
+                }
+                right->count--;
+                return;
+            }
+        }
+        mergeInternal(parent, (index > 0) ? index - 1 : index);
+    }
+
+    /*
+     * Implementation notes: mergeInternal(parent, index)
+     * --------------------------------------------------
+     * Merges parent->children[index + 1] into the node before it, bringing
+     * down the parent's separator between them.
+     */
+    void mergeInternal(InternalNode* parent, int index) {
+        InternalNode* left = static_cast<InternalNode*>(parent->children[index]);
+        InternalNode* right = static_cast<InternalNode*>(parent->children[index + 1]);
+        left->keys[left->count] = std::move(parent->keys[index]);
+        for (int i = 0; i < right->count; i++) {
+            left->keys[left->count + 1 + i] = std::move(right->keys[i]);
+        }
+        for (int i = 0; i <= right->count; i++) {
+            left->children[left->count + 1 + i] = right->children[i];
+        }
+        left->count += right->count + 1;
+        right->count = -1;
+        deleteNode(right);
+        removeChild(parent, index);
+    }
+
+    /*
+     * Implementation notes: removeChild(np, index)
+     * --------------------------------------------
+     * Removes keys[index] and children[index + 1] from an internal node.
+     */
+    static void removeChild(InternalNode* np, int index) {
+        for (int i = index + 1; i < np->count; i++) {
+            np->keys[i - 1] = std::move(np->keys[i]);
+        }
+        for (int i = index + 2; i <= np->count; i++) {
+            np->children[i - 1] = np->children[i];
+        }
+        np->count--;
+        np->keys[np->count] = KeyType();
+    }
+
+    /*
+     * Implementation notes: clearSlot(leaf, index)
+     * --------------------------------------------
+     * Resets an unused slot of a leaf, so that it does not hold on to the
+     * storage of a key or value that has moved elsewhere.
+     */
+    static void clearSlot(LeafNode* leaf, int index) {
+        leaf->keys[index] = KeyType();
+        leaf->values[index] = ValueType();
+    }
+
+    /*
+     * Implementation notes: createLeaf, createInternal, deleteNode
+     * ------------------------------------------------------------
+     * Nodes are allocated one at a time with new.  Since a node holds many
+     * entries, there are few of them.  deleteNode frees the whole subtree
+     * below an internal node unless its count has been set to -1, as is
+     * done for a node whose children have been moved elsewhere.
+     */
+    static LeafNode* createLeaf() {
+        LeafNode* leaf = new LeafNode();
+        leaf->isLeaf = true;
+        leaf->count = 0;
+        leaf->prev = leaf->next = NULL;
+        return leaf;
+    }
+
+    static InternalNode* createInternal() {
+        InternalNode* np = new InternalNode();
+        np->isLeaf = false;
+        np->count = 0;
+        return np;
+    }
+
+    static void deleteNode(Node* np) {
+        if (np->isLeaf) {
+            delete static_cast<LeafNode*>(np);
+        } else {
+            InternalNode* ip = static_cast<InternalNode*>(np);
+            for (int i = 0; i <= ip->count; i++) {
+                deleteNode(ip->children[i]);
+            }
+            delete ip;
+        }
+    }
+
+    /*
+     * Implementation notes: copyTree(np, lastCopied)
+     * ----------------------------------------------
+     * Returns a copy of the subtree rooted at np, linking the copied leaves
+     * in order after lastCopied, which is updated to the last leaf copied.
+     */
+    Node* copyTree(const Node* np, LeafNode*& lastCopied) {
+        if (np->isLeaf) {
+            const LeafNode* leaf = static_cast<const LeafNode*>(np);
+            LeafNode* copy = createLeaf();
+            for (int i = 0; i < leaf->count; i++) {
+                copy->keys[i] = leaf->keys[i];
+                copy->values[i] = leaf->values[i];
+            }
+            copy->count = leaf->count;
+            copy->prev = lastCopied;
+            if (lastCopied == NULL) {
+                firstLeaf = copy;
+            } else {
+                lastCopied->next = copy;
+            }
+            lastCopied = copy;
+            return copy;
+        }
+        const InternalNode* ip = static_cast<const InternalNode*>(np);
+        InternalNode* copy = createInternal();
+        for (int i = 0; i < ip->count; i++) {
+            copy->keys[i] = ip->keys[i];
+        }
+        for (int i = 0; i <= ip->count; i++) {
+            copy->children[i] = copyTree(ip->children[i], lastCopied);
+        }
+        copy->count = ip->count;
+        return copy;
+    }
+
+    void deepCopy(const BTreeMap& src) {
+        root = firstLeaf = lastLeaf = NULL;
+        nodeCount = src.nodeCount;
+        if (src.root != NULL) {
+            root = copyTree(src.root, lastLeaf);
+        }
+    }
+
+public:
+    /*
+     * Hidden features
+     * ---------------
+     * The remainder of this file consists of the code required to
+     * support deep copying and iteration.  Including these methods in
+     * the public portion of the interface would make that interface more
+     * difficult to understand for the average client.
+     */
+
+    /*
+     * Deep copying support
+     * --------------------
+     * This copy constructor and operator= are defined to make a
+     * deep copy, making it possible to pass/return maps by value
+     * and assign from one map to another.
+     */
+    BTreeMap& operator =(const BTreeMap& src) {
+        if (this != &src) {
+            clear();
+            deepCopy(src);
+        }
+        return *this;
+    }
+
+    BTreeMap(const BTreeMap& src) {
+        deepCopy(src);
+    }
+
+    /*
+     * Iterator support
+     * ----------------
+     * The classes in the StanfordCPPLib collection implement input
+     * iterators so that they work symmetrically with respect to the
+     * corresponding STL classes.  A BTreeMap iterator is just a leaf and
+     * a position within it; the end iterator has no leaf.
+     */
+    class iterator : public std::iterator<std::input_iterator_tag, KeyType> {
+    private:
+        const BTreeMap* mp;          /* Pointer to the map          */
+        LeafNode* leaf;              /* Leaf holding the current key */
+        int index;                   /* Position of the key in leaf  */
+
+    public:
+        iterator() : mp(NULL), leaf(NULL), index(0) {
+            /* Empty */
+        }
+
+        iterator(const BTreeMap* mp, LeafNode* leaf, int index)
+                : mp(mp), leaf(leaf), index(index) {
+            if (leaf != NULL && index >= leaf->count) {
+                this->leaf = leaf->next;
+                this->index = 0;
+            }
+        }
+
+        iterator& operator ++() {
+            index++;
+            if (index >= leaf->count) {
+                leaf = leaf->next;
+                index = 0;
+            }
+            return *this;
+        }
+
+        iterator operator ++(int) {
+            iterator copy(*this);
+            operator++();
+            return copy;
+        }
+
+        bool operator ==(const iterator& rhs) {
+            return mp == rhs.mp && leaf == rhs.leaf && index == rhs.index;
+        }
+
+        bool operator !=(const iterator& rhs) {
+            return !(*this == rhs);
+        }
+
+        KeyType& operator *() {
+            return leaf->keys[index];
+        }
+
+        KeyType* operator ->() {
+            return &leaf->keys[index];
+        }
+
+        friend class BTreeMap;
+    };
+
+    /*
+     * Returns an iterator positioned at the first key of the map.
+     */
+    iterator begin() const {
+        return iterator(this, firstLeaf, 0);
+    }
+
+    /*
+     * Returns an iterator positioned at the last key of the map.
+     */
+    iterator end() const {
+        return iterator(this, NULL, 0);
+    }
+
+    /*
+     * Returns an iterator positioned at the first key that is not less
+     * than the given key.
+     */
+    iterator lowerBound(const KeyType& key) const {
+        if (root == NULL) {
+            return end();
+        }
+        LeafNode* leaf = findLeaf(key);
+        return iterator(this, leaf, findLowerIndex(leaf->keys, leaf->count, key));
+    }
+};
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>::BTreeMap() {
+    root = NULL;
+    firstLeaf = lastLeaf = NULL;
+    nodeCount = 0;
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>::BTreeMap(std::initializer_list<std::pair<KeyType, ValueType> > list) {
+    root = NULL;
+    firstLeaf = lastLeaf = NULL;
+    nodeCount = 0;
+    putAll(list);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>::~BTreeMap() {
+    clear();
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::add(const KeyType& key,
+                                       const ValueType& value) {
+    put(key, value);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::addAll(const BTreeMap& map2) {
+    return putAll(map2);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::addAll(
+        std::initializer_list<std::pair<KeyType, ValueType> > list) {
+    return putAll(list);
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::clear() {
+    if (root != NULL) {
+        deleteNode(root);
+    }
+    root = NULL;
+    firstLeaf = lastLeaf = NULL;
+    nodeCount = 0;
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::containsKey(const KeyType& key) const {
+    return findValue(key) != NULL;
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::equals(const BTreeMap<KeyType, ValueType>& map2) const {
+    return stanfordcpplib::collections::equalsMap(*this, map2);
+}
+
+template <typename KeyType, typename ValueType>
+const KeyType& BTreeMap<KeyType, ValueType>::firstKey() const {
+    if (nodeCount == 0) {
+        error("BTreeMap::firstKey: map is empty");
+    }
+    return firstLeaf->keys[0];
+}
+
+template <typename KeyType, typename ValueType>
+ValueType BTreeMap<KeyType, ValueType>::get(const KeyType& key) const {
+    ValueType* vp = findValue(key);
+    if (vp == NULL) {
+        return ValueType();
+    }
+    return *vp;
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::isEmpty() const {
+    return nodeCount == 0;
+}
+
+template <typename KeyType, typename ValueType>
+Vector<KeyType> BTreeMap<KeyType, ValueType>::keys() const {
+    Vector<KeyType> keyset;
+    for (LeafNode* leaf = firstLeaf; leaf != NULL; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; i++) {
+            keyset.add(leaf->keys[i]);
+        }
+    }
+    return keyset;
+}
+
+template <typename KeyType, typename ValueType>
+const KeyType& BTreeMap<KeyType, ValueType>::lastKey() const {
+    if (nodeCount == 0) {
+        error("BTreeMap::lastKey: map is empty");
+    }
+    return lastLeaf->keys[lastLeaf->count - 1];
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::mapAll(void (*fn)(KeyType, ValueType)) const {
+    for (LeafNode* leaf = firstLeaf; leaf != NULL; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; i++) {
+            fn(leaf->keys[i], leaf->values[i]);
+        }
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::mapAll(void (*fn)(const KeyType&,
+                                                     const ValueType&)) const {
+    for (LeafNode* leaf = firstLeaf; leaf != NULL; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; i++) {
+            fn(leaf->keys[i], leaf->values[i]);
+        }
+    }
+}
+
+template <typename KeyType, typename ValueType>
+template <typename FunctorType>
+void BTreeMap<KeyType, ValueType>::mapAll(FunctorType fn) const {
+    for (LeafNode* leaf = firstLeaf; leaf != NULL; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; i++) {
+            fn(leaf->keys[i], leaf->values[i]);
+        }
+    }
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::put(const KeyType& key,
+                                       const ValueType& value) {
+    // copy value first, since it may be an entry that adding key moves
+    ValueType copy = value;
+    *addEntry(key) = std::move(copy);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::putAll(const BTreeMap& map2) {
+    map2.mapAll([this](const KeyType& key, const ValueType& value) {
+        put(key, value);
+    });
+    return *this;
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::putAll(
+        std::initializer_list<std::pair<KeyType, ValueType> > list) {
+    for (std::pair<KeyType, ValueType> pair : list) {
+        put(pair.first, pair.second);
+    }
+    return *this;
+}
+
+template <typename KeyType, typename ValueType>
+void BTreeMap<KeyType, ValueType>::remove(const KeyType& key) {
+    removeEntry(key);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::removeAll(const BTreeMap& map2) {
+    // collect the keys first, since map2 may be this map
+    Vector<KeyType> toRemove;
+    map2.mapAll([this, &toRemove](const KeyType& key, const ValueType& value) {
+        ValueType* vp = findValue(key);
+        if (vp != NULL && *vp == value) {
+            toRemove.add(key);
+        }
+    });
+    for (const KeyType& key : toRemove) {
+        remove(key);
+    }
+    return *this;
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::removeAll(
+        std::initializer_list<std::pair<KeyType, ValueType> > list) {
+    for (std::pair<KeyType, ValueType> pair : list) {
+        ValueType* vp = findValue(pair.first);
+        if (vp != NULL && *vp == pair.second) {
+            remove(pair.first);
+        }
+    }
+    return *this;
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::retainAll(const BTreeMap& map2) {
+    Vector<KeyType> toRemove;
+    mapAll([&map2, &toRemove](const KeyType& key, const ValueType& value) {
+        ValueType* vp = map2.findValue(key);
+        if (vp == NULL || *vp != value) {
+            toRemove.add(key);
+        }
+    });
+    for (const KeyType& key : toRemove) {
+        remove(key);
+    }
+    return *this;
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::retainAll(
+        std::initializer_list<std::pair<KeyType, ValueType> > list) {
+    BTreeMap<KeyType, ValueType> map2(list);
+    retainAll(map2);
+    return *this;
+}
+
+template <typename KeyType, typename ValueType>
+int BTreeMap<KeyType, ValueType>::size() const {
+    return nodeCount;
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType> BTreeMap<KeyType, ValueType>::subMap(
+        const KeyType& fromKey, const KeyType& toKey) const {
+    BTreeMap<KeyType, ValueType> result;
+    for (iterator it = lowerBound(fromKey); it.leaf != NULL; ++it) {
+        const KeyType& key = *it;
+        if (!(key < toKey)) {
+            break;
+        }
+        result.put(key, it.leaf->values[it.index]);
+    }
+    return result;
+}
+
+template <typename KeyType, typename ValueType>
+std::map<KeyType, ValueType> BTreeMap<KeyType, ValueType>::toStlMap() const {
+    std::map<KeyType, ValueType> result;
+    mapAll([&result](const KeyType& key, const ValueType& value) {
+        result.insert(result.end(), std::make_pair(key, value));
+    });
+    return result;
+}
+
+template <typename KeyType, typename ValueType>
+std::string BTreeMap<KeyType, ValueType>::toString() const {
+    std::ostringstream os;
+    os << *this;
+    return os.str();
+}
+
+template <typename KeyType, typename ValueType>
+Vector<ValueType> BTreeMap<KeyType, ValueType>::values() const {
+    Vector<ValueType> values;
+    for (LeafNode* leaf = firstLeaf; leaf != NULL; leaf = leaf->next) {
+        for (int i = 0; i < leaf->count; i++) {
+            values.add(leaf->values[i]);
+        }
+    }
+    return values;
+}
+
+template <typename KeyType, typename ValueType>
+ValueType& BTreeMap<KeyType, ValueType>::operator [](const KeyType& key) {
+    return *addEntry(key);
+}
+
+template <typename KeyType, typename ValueType>
+ValueType BTreeMap<KeyType, ValueType>::operator [](const KeyType& key) const {
+    return get(key);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType> BTreeMap<KeyType, ValueType>::operator +(const BTreeMap& map2) const {
+    BTreeMap<KeyType, ValueType> result = *this;
+    return result.putAll(map2);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType> BTreeMap<KeyType, ValueType>::operator +(
+        std::initializer_list<std::pair<KeyType, ValueType> > list) const {
+    BTreeMap<KeyType, ValueType> result = *this;
+    return result.putAll(list);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::operator +=(const BTreeMap& map2) {
+    return putAll(map2);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::operator +=(
+        std::initializer_list<std::pair<KeyType, ValueType> > list) {
+    return putAll(list);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType> BTreeMap<KeyType, ValueType>::operator -(const BTreeMap& map2) const {
+    BTreeMap<KeyType, ValueType> result = *this;
+    return result.removeAll(map2);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType> BTreeMap<KeyType, ValueType>::operator -(
+        std::initializer_list<std::pair<KeyType, ValueType> > list) const {
+    BTreeMap<KeyType, ValueType> result = *this;
+    return result.removeAll(list);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::operator -=(const BTreeMap& map2) {
+    return removeAll(map2);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::operator -=(
+        std::initializer_list<std::pair<KeyType, ValueType> > list) {
+    return removeAll(list);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType> BTreeMap<KeyType, ValueType>::operator *(const BTreeMap& map2) const {
+    BTreeMap<KeyType, ValueType> result = *this;
+    return result.retainAll(map2);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType> BTreeMap<KeyType, ValueType>::operator *(
+        std::initializer_list<std::pair<KeyType, ValueType> > list) const {
+    BTreeMap<KeyType, ValueType> result = *this;
+    return result.retainAll(list);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::operator *=(const BTreeMap& map2) {
+    return retainAll(map2);
+}
+
+template <typename KeyType, typename ValueType>
+BTreeMap<KeyType, ValueType>& BTreeMap<KeyType, ValueType>::operator *=(
+        std::initializer_list<std::pair<KeyType, ValueType> > list) {
+    return retainAll(list);
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::operator ==(const BTreeMap& map2) const {
+    return equals(map2);
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::operator !=(const BTreeMap& map2) const {
+    return !equals(map2);
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::operator <(const BTreeMap& map2) const {
+    return stanfordcpplib::collections::compareMaps(*this, map2) < 0;
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::operator <=(const BTreeMap& map2) const {
+    return stanfordcpplib::collections::compareMaps(*this, map2) <= 0;
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::operator >(const BTreeMap& map2) const {
+    return stanfordcpplib::collections::compareMaps(*this, map2) > 0;
+}
+
+template <typename KeyType, typename ValueType>
+bool BTreeMap<KeyType, ValueType>::operator >=(const BTreeMap& map2) const {
+    return stanfordcpplib::collections::compareMaps(*this, map2) >= 0;
+}
+
+/*
+ * Implementation notes: << and >>
+ * -------------------------------
+ * The insertion and extraction operators use the template facilities in
+ * strlib.h to read and write generic values in a way that treats strings
+ * specially.
+ */
+template <typename KeyType, typename ValueType>
+std::ostream& operator <<(std::ostream& os,
+                          const BTreeMap<KeyType, ValueType>& map) {
+    return stanfordcpplib::collections::writeMap(os, map);
+}
+
+template <typename KeyType, typename ValueType>
+std::istream& operator >>(std::istream& is, BTreeMap<KeyType, ValueType>& map) {
+    KeyType key;
+    ValueType value;
+    return stanfordcpplib::collections::readMap(is, map, key, value, /* descriptor */ std::string("BTreeMap::operator >>"));
+}
+
+/*
+ * Template hash function for maps.
+ * Requires the key and value types in the BTreeMap to have a hashCode function.
+ */
+template <typename K, typename V>
+int hashCode(const BTreeMap<K, V>& map) {
+    return stanfordcpplib::collections::hashCodeMap(map);
+}
+
+/*
+ * Function: randomKey
+ * Usage: element = randomKey(map);
+ * --------------------------------
+ * Returns a randomly chosen key of the given map.
+ * Throws an error if the map is empty.
+ */
+template <typename K, typename V>
+const K& randomKey(const BTreeMap<K, V>& map) {
+    if (map.isEmpty()) {
+        error("randomKey: empty map was passed");
+    }
+    int index = randomInteger(0, map.size() - 1);
+    int i = 0;
+    for (const K& key : map) {
+        if (i == index) {
+            return key;
+        }
+        i++;
+    }
+    
+    // this code will never be reached
+    static Vector<K> v = map.keys();
+    return v[0];
+}
+
+#include "private/init.h"   // ensure that Stanford C++ lib is initialized
+
+#endif // _btreemap_h
@@ -0,0 +1,463 @@
+/*
+ * File: bulkops.cpp
+ * -----------------
+ * This file implements the double and int kernels declared in bulkops.h.
+ *
+ * Each kernel has an AVX2 version, which works on 4 doubles or 8 ints per
+ * instruction, an SSE2 version, which works on 2 doubles or 4 ints, and
+ * the plain loops in bulkops.h for other processors.  Every x86-64
+ * processor has SSE2, so that version is chosen when the library is
+ * compiled; not all have AVX2, so that version is compiled with GCC's
+ * target attribute and used only if the processor turns out to support it
+ * when the program runs.  Defining BULKOPS_NO_SIMD when compiling this
+ * file turns both off.
+ *
+ * The SIMD versions are templates over a small struct for each kind of
+ * register (such as Sse2Double) that wraps the intrinsics for loading,
+ * storing and doing arithmetic on it.  The SSE2 and AVX2 templates have
+ * the same bodies, but have to be written twice because only the AVX2
+ * ones may be compiled with the target attribute.
+ */
+
+#include "bulkops.h"
+
+#if !defined(BULKOPS_NO_SIMD) && (defined(__GNUC__) || defined(__clang__)) \
+    && (defined(__x86_64__) || (defined(__i386__) && defined(__SSE2__)))
+#define BULKOPS_X86
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+namespace stanfordcpplib {
+namespace bulkops {
+
+#ifdef BULKOPS_X86
+
+static bool detectAvx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+static bool hasAvx2() {
+    static const bool result = detectAvx2();
+    return result;
+}
+
+/*
+ * Register types
+ * --------------
+ * apply<OP> is a template so that the choice of instruction is made when
+ * the kernels are compiled rather than once per register.
+ */
+struct Sse2Double {
+    typedef double Value;
+    typedef __m128d Register;
+    static const int WIDTH = 2;
+
+    static Register load(const double* p) { return _mm_loadu_pd(p); }
+    static void store(double* p, Register r) { _mm_storeu_pd(p, r); }
+    static Register broadcast(double x) { return _mm_set1_pd(x); }
+    static Register add(Register a, Register b) { return _mm_add_pd(a, b); }
+    static Register multiply(Register a, Register b) { return _mm_mul_pd(a, b); }
+
+    template <Operation OP>
+    static Register apply(Register a, Register b) {
+        switch (OP) {
+        case ADD:      return _mm_add_pd(a, b);
+        case SUBTRACT: return _mm_sub_pd(a, b);
+        case MULTIPLY: return _mm_mul_pd(a, b);
+        case MIN:      return _mm_min_pd(a, b);
+        default:       return _mm_max_pd(a, b);
+        }
+    }
+};
+
+struct Sse2Int {
+    typedef int Value;
+    typedef __m128i Register;
+    static const int WIDTH = 4;
+
+    static Register load(const int* p) { return _mm_loadu_si128((const __m128i*) p); }
+    static void store(int* p, Register r) { _mm_storeu_si128((__m128i*) p, r); }
+    static Register broadcast(int x) { return _mm_set1_epi32(x); }
+    static Register add(Register a, Register b) { return _mm_add_epi32(a, b); }
+
+    // SSE2 has no 32-bit multiply, min or max; build them from the
+    // 32x32->64-bit multiply of the even lanes, and from comparisons
+    static Register multiply(Register a, Register b) {
+        Register even = _mm_mul_epu32(a, b);
+        Register odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+        return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                                  _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+    }
+
+    static Register select(Register mask, Register a, Register b) {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    template <Operation OP>
+    static Register apply(Register a, Register b) {
+        switch (OP) {
+        case ADD:      return _mm_add_epi32(a, b);
+        case SUBTRACT: return _mm_sub_epi32(a, b);
+        case MULTIPLY: return multiply(a, b);
+        case MIN:      return select(_mm_cmplt_epi32(a, b), a, b);
+        default:       return select(_mm_cmpgt_epi32(a, b), a, b);
+        }
+    }
+};
+
+struct Avx2Double {
+    typedef double Value;
+    typedef __m256d Register;
+    static const int WIDTH = 4;
+
+    AVX2_TARGET static Register load(const double* p) { return _mm256_loadu_pd(p); }
+    AVX2_TARGET static void store(double* p, Register r) { _mm256_storeu_pd(p, r); }
+    AVX2_TARGET static Register broadcast(double x) { return _mm256_set1_pd(x); }
+    AVX2_TARGET static Register add(Register a, Register b) { return _mm256_add_pd(a, b); }
+    AVX2_TARGET static Register multiply(Register a, Register b) { return _mm256_mul_pd(a, b); }
+
+    template <Operation OP>
+    AVX2_TARGET static Register apply(Register a, Register b) {
+        switch (OP) {
+        case ADD:      return _mm256_add_pd(a, b);
+        case SUBTRACT: return _mm256_sub_pd(a, b);
+        case MULTIPLY: return _mm256_mul_pd(a, b);
+        case MIN:      return _mm256_min_pd(a, b);
+        default:       return _mm256_max_pd(a, b);
+        }
+    }
+};
+
+struct Avx2Int {
+    typedef int Value;
+    typedef __m256i Register;
+    static const int WIDTH = 8;
+
+    AVX2_TARGET static Register load(const int* p) { return _mm256_loadu_si256((const __m256i*) p); }
+    AVX2_TARGET static void store(int* p, Register r) { _mm256_storeu_si256((__m256i*) p, r); }
+    AVX2_TARGET static Register broadcast(int x) { return _mm256_set1_epi32(x); }
+    AVX2_TARGET static Register add(Register a, Register b) { return _mm256_add_epi32(a, b); }
+    AVX2_TARGET static Register multiply(Register a, Register b) { return _mm256_mullo_epi32(a, b); }
+
+    template <Operation OP>
+    AVX2_TARGET static Register apply(Register a, Register b) {
+        switch (OP) {
+        case ADD:      return _mm256_add_epi32(a, b);
+        case SUBTRACT: return _mm256_sub_epi32(a, b);
+        case MULTIPLY: return _mm256_mullo_epi32(a, b);
+        case MIN:      return _mm256_min_epi32(a, b);
+        default:       return _mm256_max_epi32(a, b);
+        }
+    }
+};
+
+/*
+ * SSE2 kernels
+ * ------------
+ * Each handles as many whole registers as fit and leaves the rest to the
+ * plain loops.  reduce keeps four registers of partial results, so that
+ * each addition need not wait for the one before it to finish.
+ */
+template <typename Simd>
+static void axpySse2(typename Simd::Value alpha, const typename Simd::Value* x,
+                     typename Simd::Value* y, int n) {
+    typename Simd::Register a = Simd::broadcast(alpha);
+    int i = 0;
+    for (; i + Simd::WIDTH <= n; i += Simd::WIDTH) {
+        Simd::store(y + i, Simd::add(Simd::load(y + i), Simd::multiply(a, Simd::load(x + i))));
+    }
+    axpy<typename Simd::Value>(alpha, x + i, y + i, n - i);
+}
+
+template <typename Simd>
+static void fillSse2(typename Simd::Value* x, int n, typename Simd::Value value) {
+    typename Simd::Register v = Simd::broadcast(value);
+    int i = 0;
+    for (; i + Simd::WIDTH <= n; i += Simd::WIDTH) {
+        Simd::store(x + i, v);
+    }
+    fill<typename Simd::Value>(x + i, n - i, value);
+}
+
+template <typename Simd>
+static void scaleSse2(typename Simd::Value* x, int n, typename Simd::Value factor) {
+    typename Simd::Register f = Simd::broadcast(factor);
+    int i = 0;
+    for (; i + Simd::WIDTH <= n; i += Simd::WIDTH) {
+        Simd::store(x + i, Simd::multiply(Simd::load(x + i), f));
+    }
+    scale<typename Simd::Value>(x + i, n - i, factor);
+}
+
+template <typename Simd, Operation OP>
+static void combineSse2(typename Simd::Value* y, const typename Simd::Value* x, int n) {
+    int i = 0;
+    for (; i + Simd::WIDTH <= n; i += Simd::WIDTH) {
+        Simd::store(y + i, Simd::template apply<OP>(Simd::load(y + i), Simd::load(x + i)));
+    }
+    combine<typename Simd::Value>(OP, y + i, x + i, n - i);
+}
+
+template <typename Simd, Operation OP>
+static typename Simd::Value reduceSse2(const typename Simd::Value* x, int n) {
+    typedef typename Simd::Value Value;
+    typedef typename Simd::Register Register;
+    const int W = Simd::WIDTH;
+    if (n < 4 * W) {
+        return reduce<Value>(OP, x, n);
+    }
+    Register r0 = Simd::load(x);
+    Register r1 = Simd::load(x + W);
+    Register r2 = Simd::load(x + 2 * W);
+    Register r3 = Simd::load(x + 3 * W);
+    int i = 4 * W;
+    for (; i + 4 * W <= n; i += 4 * W) {
+        r0 = Simd::template apply<OP>(r0, Simd::load(x + i));
+        r1 = Simd::template apply<OP>(r1, Simd::load(x + i + W));
+        r2 = Simd::template apply<OP>(r2, Simd::load(x + i + 2 * W));
+        r3 = Simd::template apply<OP>(r3, Simd::load(x + i + 3 * W));
+    }
+    r0 = Simd::template apply<OP>(Simd::template apply<OP>(r0, r1),
+                                  Simd::template apply<OP>(r2, r3));
+    Value lanes[W];
+    Simd::store(lanes, r0);
+    Value result = reduce<Value>(OP, lanes, W);
+    for (; i < n; i++) {
+        result = applyOperation(OP, result, x[i]);
+    }
+    return result;
+}
+
+/*
+ * AVX2 kernels
+ * ------------
+ * The same as the SSE2 kernels above, compiled for AVX2.
+ */
+template <typename Simd>
+AVX2_TARGET static void axpyAvx2(typename Simd::Value alpha, const typename Simd::Value* x,
+                                 typename Simd::Value* y, int n) {
+    typename Simd::Register a = Simd::broadcast(alpha);
+    int i = 0;
+    for (; i + Simd::WIDTH <= n; i += Simd::WIDTH) {
+        Simd::store(y + i, Simd::add(Simd::load(y + i), Simd::multiply(a, Simd::load(x + i))));
+    }
+    axpy<typename Simd::Value>(alpha, x + i, y + i, n - i);
+}
+
+template <typename Simd>
+AVX2_TARGET static void fillAvx2(typename Simd::Value* x, int n, typename Simd::Value value) {
+    typename Simd::Register v = Simd::broadcast(value);
+    int i = 0;
+    for (; i + Simd::WIDTH <= n; i += Simd::WIDTH) {
+        Simd::store(x + i, v);
+    }
+    fill<typename Simd::Value>(x + i, n - i, value);
+}
+
+template <typename Simd>
+AVX2_TARGET static void scaleAvx2(typename Simd::Value* x, int n, typename Simd::Value factor) {
+    typename Simd::Register f = Simd::broadcast(factor);
+    int i = 0;
+    for (; i + Simd::WIDTH <= n; i += Simd::WIDTH) {
+        Simd::store(x + i, Simd::multiply(Simd::load(x + i), f));
+    }
+    scale<typename Simd::Value>(x + i, n - i, factor);
+}
+
+template <typename Simd, Operation OP>
+AVX2_TARGET static void combineAvx2(typename Simd::Value* y, const typename Simd::Value* x, int n) {
+    int i = 0;
+    for (; i + Simd::WIDTH <= n; i += Simd::WIDTH) {
+        Simd::store(y + i, Simd::template apply<OP>(Simd::load(y + i), Simd::load(x + i)));
+    }
+    combine<typename Simd::Value>(OP, y + i, x + i, n - i);
+}
+
+template <typename Simd, Operation OP>
+AVX2_TARGET static typename Simd::Value reduceAvx2(const typename Simd::Value* x, int n) {
+    typedef typename Simd::Value Value;
+    typedef typename Simd::Register Register;
+    const int W = Simd::WIDTH;
+    if (n < 4 * W) {
+        return reduce<Value>(OP, x, n);
+    }
+    Register r0 = Simd::load(x);
+    Register r1 = Simd::load(x + W);
+    Register r2 = Simd::load(x + 2 * W);
+    Register r3 = Simd::load(x + 3 * W);
+    int i = 4 * W;
+    for (; i + 4 * W <= n; i += 4 * W) {
+        r0 = Simd::template apply<OP>(r0, Simd::load(x + i));
+        r1 = Simd::template apply<OP>(r1, Simd::load(x + i + W));
+        r2 = Simd::template apply<OP>(r2, Simd::load(x + i + 2 * W));
+        r3 = Simd::template apply<OP>(r3, Simd::load(x + i + 3 * W));
+    }
+    r0 = Simd::template apply<OP>(Simd::template apply<OP>(r0, r1),
+                                  Simd::template apply<OP>(r2, r3));
+    Value lanes[W];
+    Simd::store(lanes, r0);
+    Value result = reduce<Value>(OP, lanes, W);
+    for (; i < n; i++) {
+        result = applyOperation(OP, result, x[i]);
+    }
+    return result;
+}
+
+/*
+ * Dispatch
+ * --------
+ * These pick the AVX2 or SSE2 kernel, and turn the operation into a
+ * template argument.
+ */
+template <typename Sse2, typename Avx2, Operation OP>
+static void combineSimd(typename Sse2::Value* y, const typename Sse2::Value* x, int n) {
+    if (hasAvx2()) {
+        combineAvx2<Avx2, OP>(y, x, n);
+    } else {
+        combineSse2<Sse2, OP>(y, x, n);
+    }
+}
+
+template <typename Sse2, typename Avx2>
+static void combineSimd(Operation op, typename Sse2::Value* y, const typename Sse2::Value* x, int n) {
+    switch (op) {
+    case ADD:      combineSimd<Sse2, Avx2, ADD>(y, x, n); break;
+    case SUBTRACT: combineSimd<Sse2, Avx2, SUBTRACT>(y, x, n); break;
+    case MULTIPLY: combineSimd<Sse2, Avx2, MULTIPLY>(y, x, n); break;
+    case MIN:      combineSimd<Sse2, Avx2, MIN>(y, x, n); break;
+    case MAX:      combineSimd<Sse2, Avx2, MAX>(y, x, n); break;
+    }
+}
+
+template <typename Sse2, typename Avx2, Operation OP>
+static typename Sse2::Value reduceSimd(const typename Sse2::Value* x, int n) {
+    if (hasAvx2()) {
+        return reduceAvx2<Avx2, OP>(x, n);
+    } else {
+        return reduceSse2<Sse2, OP>(x, n);
+    }
+}
+
+template <typename Sse2, typename Avx2>
+static typename Sse2::Value reduceSimd(Operation op, const typename Sse2::Value* x, int n) {
+    switch (op) {
+    case ADD:      return reduceSimd<Sse2, Avx2, ADD>(x, n);
+    case SUBTRACT: return reduce<typename Sse2::Value>(op, x, n);   // not associative
+    case MULTIPLY: return reduceSimd<Sse2, Avx2, MULTIPLY>(x, n);
+    case MIN:      return reduceSimd<Sse2, Avx2, MIN>(x, n);
+    default:       return reduceSimd<Sse2, Avx2, MAX>(x, n);
+    }
+}
+
+void axpy(double alpha, const double* x, double* y, int n) {
+    if (hasAvx2()) {
+        axpyAvx2<Avx2Double>(alpha, x, y, n);
+    } else {
+        axpySse2<Sse2Double>(alpha, x, y, n);
+    }
+}
+
+void axpy(int alpha, const int* x, int* y, int n) {
+    if (hasAvx2()) {
+        axpyAvx2<Avx2Int>(alpha, x, y, n);
+    } else {
+        axpySse2<Sse2Int>(alpha, x, y, n);
+    }
+}
+
+void fill(double* x, int n, double value) {
+    if (hasAvx2()) {
+        fillAvx2<Avx2Double>(x, n, value);
+    } else {
+        fillSse2<Sse2Double>(x, n, value);
+    }
+}
+
+void fill(int* x, int n, int value) {
+    if (hasAvx2()) {
+        fillAvx2<Avx2Int>(x, n, value);
+    } else {
+        fillSse2<Sse2Int>(x, n, value);
+    }
+}
+
+void scale(double* x, int n, double factor) {
+    if (hasAvx2()) {
+        scaleAvx2<Avx2Double>(x, n, factor);
+    } else {
+        scaleSse2<Sse2Double>(x, n, factor);
+    }
+}
+
+void scale(int* x, int n, int factor) {
+    if (hasAvx2()) {
+        scaleAvx2<Avx2Int>(x, n, factor);
+    } else {
+        scaleSse2<Sse2Int>(x, n, factor);
+    }
+}
+
+void combine(Operation op, double* y, const double* x, int n) {
+    combineSimd<Sse2Double, Avx2Double>(op, y, x, n);
+}
+
+void combine(Operation op, int* y, const int* x, int n) {
+    combineSimd<Sse2Int, Avx2Int>(op, y, x, n);
+}
+
+double reduce(Operation op, const double* x, int n) {
+    return reduceSimd<Sse2Double, Avx2Double>(op, x, n);
+}
+
+int reduce(Operation op, const int* x, int n) {
+    return reduceSimd<Sse2Int, Avx2Int>(op, x, n);
+}
+
+#else // BULKOPS_X86
+
+void axpy(double alpha, const double* x, double* y, int n) {
+    axpy<double>(alpha, x, y, n);
+}
+
+void axpy(int alpha, const int* x, int* y, int n) {
+    axpy<int>(alpha, x, y, n);
+}
+
+void fill(double* x, int n, double value) {
+    fill<double>(x, n, value);
+}
+
+void fill(int* x, int n, int value) {
+    fill<int>(x, n, value);
+}
+
+void scale(double* x, int n, double factor) {
+    scale<double>(x, n, factor);
+}
+
+void scale(int* x, int n, int factor) {
+    scale<int>(x, n, factor);
+}
+
+void combine(Operation op, double* y, const double* x, int n) {
+    combine<double>(op, y, x, n);
+}
+
+void combine(Operation op, int* y, const int* x, int n) {
+    combine<int>(op, y, x, n);
+}
+
+double reduce(Operation op, const double* x, int n) {
+    return reduce<double>(op, x, n);
+}
+
+int reduce(Operation op, const int* x, int n) {
+    return reduce<int>(op, x, n);
+}
+
+#endif // BULKOPS_X86
+
+} // namespace bulkops
+} // namespace stanfordcpplib
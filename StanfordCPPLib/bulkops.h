@@ -0,0 +1,436 @@
+/*
+ * File: bulkops.h
+ * ---------------
+ * This file exports functions that do arithmetic on all of the elements
+ * of a Vector or Grid of numbers at once, such as adding one grid to
+ * another, scaling a vector, filling it with one value, or finding the
+ * sum of its elements:
+ *
+ *     Grid<double> heat(rows, cols);
+ *     ...
+ *     scale(heat, 0.5);
+ *     double total = sumElements(heat);
+ *
+ * Each function gives the same result as the obvious loop over the
+ * elements, except that sums of floating-point elements may differ from
+ * a left-to-right sum in the last few bits because they are added in a
+ * different order.  The functions are several times faster than such
+ * loops on large collections because they work directly on the elements
+ * in memory rather than through get, set or <code>[]</code>, and for
+ * <code>double</code> and <code>int</code> elements they use the
+ * processor's SIMD (SSE2 or AVX2) instructions, which do the same
+ * arithmetic on several elements at once.  Other element types, such as
+ * <code>float</code> or <code>long</code>, are handled one element at a
+ * time.
+ *
+ * Functions that combine two vectors or grids signal an error unless
+ * they have the same size.
+ *
+ * @version 2016/10/14
+ * - initial version
+ * @since 2016/10/14
+ */
+
+#ifndef _bulkops_h
+#define _bulkops_h
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include "error.h"
+#include "grid.h"
+#include "vector.h"
+
+namespace stanfordcpplib {
+namespace bulkops {
+
+/*
+ * The arithmetic that combine and reduce apply to pairs of elements.
+ */
+enum Operation { ADD, SUBTRACT, MULTIPLY, MIN, MAX };
+
+template <typename T>
+inline T applyOperation(Operation op, T a, T b) {
+    switch (op) {
+    case ADD:      return a + b;
+    case SUBTRACT: return a - b;
+    case MULTIPLY: return a * b;
+    case MIN:      return (b < a) ? b : a;
+    default:       return (a < b) ? b : a;
+    }
+}
+
+/*
+ * Kernels that do the work on raw arrays of n elements.  The double and
+ * int versions are in bulkops.cpp and use SIMD instructions; these
+ * templates handle every other element type, and the last few elements
+ * that do not fill a SIMD register.
+ */
+
+/* y[i] += alpha * x[i] */
+void axpy(double alpha, const double* x, double* y, int n);
+void axpy(int alpha, const int* x, int* y, int n);
+
+template <typename T>
+void axpy(T alpha, const T* x, T* y, int n) {
+    for (int i = 0; i < n; i++) {
+        y[i] += alpha * x[i];
+    }
+}
+
+/* x[i] = value */
+void fill(double* x, int n, double value);
+void fill(int* x, int n, int value);
+
+template <typename T>
+void fill(T* x, int n, T value) {
+    for (int i = 0; i < n; i++) {
+        x[i] = value;
+    }
+}
+
+/* x[i] *= factor */
+void scale(double* x, int n, double factor);
+void scale(int* x, int n, int factor);
+
+template <typename T>
+void scale(T* x, int n, T factor) {
+    for (int i = 0; i < n; i++) {
+        x[i] *= factor;
+    }
+}
+
+/* y[i] = y[i] op x[i] */
+void combine(Operation op, double* y, const double* x, int n);
+void combine(Operation op, int* y, const int* x, int n);
+
+template <typename T>
+void combine(Operation op, T* y, const T* x, int n) {
+    for (int i = 0; i < n; i++) {
+        y[i] = applyOperation(op, y[i], x[i]);
+    }
+}
+
+/* x[0] op x[1] op ... op x[n-1], in any order; n must be at least 1 */
+double reduce(Operation op, const double* x, int n);
+int reduce(Operation op, const int* x, int n);
+
+template <typename T>
+T reduce(Operation op, const T* x, int n) {
+    T result = x[0];
+    for (int i = 1; i < n; i++) {
+        result = applyOperation(op, result, x[i]);
+    }
+    return result;
+}
+
+template <typename T>
+void checkArithmetic() {
+    static_assert(std::is_arithmetic<T>::value,
+                  "bulk operations require a numeric element type");
+}
+
+template <typename T, typename Allocator>
+void checkSizes(const Vector<T, Allocator>& v1, const Vector<T, Allocator>& v2,
+                const std::string& prefix) {
+    if (v1.size() != v2.size()) {
+        error(prefix + ": vectors have different sizes ("
+              + integerToString(v1.size()) + " and "
+              + integerToString(v2.size()) + ")");
+    }
+}
+
+template <typename T>
+void checkSizes(const Grid<T>& g1, const Grid<T>& g2, const std::string& prefix) {
+    if (g1.numRows() != g2.numRows() || g1.numCols() != g2.numCols()) {
+        error(prefix + ": grids have different dimensions ("
+              + integerToString(g1.numRows()) + "x" + integerToString(g1.numCols())
+              + " and "
+              + integerToString(g2.numRows()) + "x" + integerToString(g2.numCols())
+              + ")");
+    }
+}
+
+template <typename T>
+T reduceElements(Operation op, const T* x, int n, const std::string& prefix) {
+    checkArithmetic<T>();
+    if (n == 0) {
+        if (op == ADD) {
+            return T();
+        }
+        error(prefix + ": the collection is empty");
+    }
+    return reduce(op, x, n);
+}
+
+} // namespace bulkops
+} // namespace stanfordcpplib
+
+/*
+ * Function: addElements
+ * Usage: addElements(y, x);
+ * -------------------------
+ * Adds each element of <code>x</code> to the corresponding element of
+ * <code>y</code>, as in <code>y[i] += x[i]</code>.
+ */
+template <typename T, typename Allocator>
+void addElements(Vector<T, Allocator>& y, const Vector<T, Allocator>& x) {
+    stanfordcpplib::bulkops::checkArithmetic<T>();
+    stanfordcpplib::bulkops::checkSizes(y, x, "addElements");
+    stanfordcpplib::bulkops::combine(stanfordcpplib::bulkops::ADD, y.data(), x.data(), y.size());
+}
+
+template <typename T>
+void addElements(Grid<T>& y, const Grid<T>& x) {
+    stanfordcpplib::bulkops::checkArithmetic<T>();
+    stanfordcpplib::bulkops::checkSizes(y, x, "addElements");
+    stanfordcpplib::bulkops::combine(stanfordcpplib::bulkops::ADD, y.data(), x.data(), y.size());
+}
+
+/*
+ * Function: axpy
+ * Usage: axpy(alpha, x, y);
+ * -------------------------
+ * Adds <code>alpha</code> times each element of <code>x</code> to the
+ * corresponding element of <code>y</code>, as in
+ * <code>y[i] += alpha * x[i]</code>.  (The name comes from the BLAS
+ * linear algebra library, where it stands for "alpha x plus y".)
+ */
+template <typename T, typename Allocator, typename Number>
+void axpy(Number alpha, const Vector<T, Allocator>& x, Vector<T, Allocator>& y) {
+    stanfordcpplib::bulkops::checkArithmetic<T>();
+    stanfordcpplib::bulkops::checkSizes(x, y, "axpy");
+    stanfordcpplib::bulkops::axpy(static_cast<T>(alpha), x.data(), y.data(), y.size());
+}
+
+template <typename T, typename Number>
+void axpy(Number alpha, const Grid<T>& x, Grid<T>& y) {
+    stanfordcpplib::bulkops::checkArithmetic<T>();
+    stanfordcpplib::bulkops::checkSizes(x, y, "axpy");
+    stanfordcpplib::bulkops::axpy(static_cast<T>(alpha), x.data(), y.data(), y.size());
+}
+
+/*
+ * Function: convolve
+ * Usage: Grid<double> blurred = convolve(image, kernel);
+ * ------------------------------------------------------
+ * Returns a grid the same size as <code>grid</code> in which each element
+ * is the weighted sum of the elements around the same position in
+ * <code>grid</code>, with the weights given by <code>kernel</code>.  The
+ * kernel is centered on each element in turn, with its middle element
+ * (<code>kernel[kernel.numRows() / 2][kernel.numCols() / 2]</code>) over
+ * it, and the elements of the kernel are multiplied by the elements of
+ * the grid beneath them and added up.  Positions beyond the edges of the
+ * grid count as 0.  For example, a 3x3 kernel of all 1/9s blurs an image
+ * by averaging each pixel with its neighbors.
+ *
+ * As in most image processing libraries, the kernel is not flipped first,
+ * so strictly speaking this computes a cross-correlation; the two are the
+ * same for symmetric kernels.
+ */
+template <typename T>
+Grid<T> convolve(const Grid<T>& grid, const Grid<T>& kernel) {
+    stanfordcpplib::bulkops::checkArithmetic<T>();
+    int nRows = grid.numRows();
+    int nCols = grid.numCols();
+    Grid<T> result(nRows, nCols);
+    const T* in = grid.data();
+    T* out = result.data();
+    int centerRow = kernel.numRows() / 2;
+    int centerCol = kernel.numCols() / 2;
+
+    // each kernel element adds a shifted, weighted copy of the grid's rows;
+    // doing one output row at a time keeps that row in the cache
+    for (int row = 0; row < nRows; row++) {
+        for (int kRow = 0; kRow < kernel.numRows(); kRow++) {
+            int inRow = row + kRow - centerRow;
+            if (inRow < 0 || inRow >= nRows) {
+                continue;
+            }
+            for (int kCol = 0; kCol < kernel.numCols(); kCol++) {
+                T weight = kernel.getUnchecked(kRow, kCol);
+                int shift = kCol - centerCol;
+                int start = std::max(0, -shift);
+                int end = std::min(nCols, nCols - shift);
+                if (weight == T() || start >= end) {
+                    continue;
+                }
+                stanfordcpplib::bulkops::axpy(weight, in + inRow * nCols + start + shift,
+                                              out + row * nCols + start, end - start);
+            }
+        }
+    }
+    return result;
+}
+
+/*
+ * Function: fill
+ * Usage: fill(v, value);
+ * ----------------------
+ * Sets every element of the given vector or grid to <code>value</code>.
+ * For a grid this does the same as <code>grid.fill(value)</code>.
+ */
+template <typename T, typename Allocator, typename Number>
+void fill(Vector<T, Allocator>& v, Number value) {
+    stanfordcpplib::bulkops::checkArithmetic<T>();
+    stanfordcpplib::bulkops::fill(v.data(), v.size(), static_cast<T>(value));
+}
+
+template <typename T, typename Number>
+void fill(Grid<T>& grid, Number value) {
+    stanfordcpplib::bulkops::checkArithmetic<T>();
+    stanfordcpplib::bulkops::fill(grid.data(), grid.size(), static_cast<T>(value));
+}
+
+/*
+ * Function: maxElement
+ * Usage: double largest = maxElement(v);
+ * --------------------------------------
+ * Returns the largest element of the given vector or grid.  Signals an
+ * error if it is empty.
+ */
+template <typename T, typename Allocator>
+T maxElement(const Vector<T, Allocator>& v) {
+    return stanfordcpplib::bulkops::reduceElements(stanfordcpplib::bulkops::MAX,
+                                                   v.data(), v.size(), "maxElement");
+}
+
+template <typename T>
+T maxElement(const Grid<T>& grid) {
+    return stanfordcpplib::bulkops::reduceElements(stanfordcpplib::bulkops::MAX,
+                                                   grid.data(), grid.size(), "maxElement");
+}
+
+/*
+ * Function: minElement
+ * Usage: double smallest = minElement(v);
+ * ---------------------------------------
+ * Returns the smallest element of the given vector or grid.  Signals an
+ * error if it is empty.
+ */
+template <typename T, typename Allocator>
+T minElement(const Vector<T, Allocator>& v) {
+    return stanfordcpplib::bulkops::reduceElements(stanfordcpplib::bulkops::MIN,
+                                                   v.data(), v.size(), "minElement");
+}
+
+template <typename T>
+T minElement(const Grid<T>& grid) {
+    return stanfordcpplib::bulkops::reduceElements(stanfordcpplib::bulkops::MIN,
+                                                   grid.data(), grid.size(), "minElement");
+}
+
+/*
+ * Function: multiplyElements
+ * Usage: multiplyElements(y, x);
+ * ------------------------------
+ * Multiplies each element of <code>y</code> by the corresponding element
+ * of <code>x</code>, as in <code>y[i] *= x[i]</code>.
+ */
+template <typename T, typename Allocator>
+void multiplyElements(Vector<T, Allocator>& y, const Vector<T, Allocator>& x) {
+    stanfordcpplib::bulkops::checkArithmetic<T>();
+    stanfordcpplib::bulkops::checkSizes(y, x, "multiplyElements");
+    stanfordcpplib::bulkops::combine(stanfordcpplib::bulkops::MULTIPLY, y.data(), x.data(), y.size());
+}
+
+template <typename T>
+void multiplyElements(Grid<T>& y, const Grid<T>& x) {
+    stanfordcpplib::bulkops::checkArithmetic<T>();
+    stanfordcpplib::bulkops::checkSizes(y, x, "multiplyElements");
+    stanfordcpplib::bulkops::combine(stanfordcpplib::bulkops::MULTIPLY, y.data(), x.data(), y.size());
+}
+
+/*
+ * Function: scale
+ * Usage: scale(v, factor);
+ * ------------------------
+ * Multiplies every element of the given vector or grid by
+ * <code>factor</code>.
+ */
+template <typename T, typename Allocator, typename Number>
+void scale(Vector<T, Allocator>& v, Number factor) {
+    stanfordcpplib::bulkops::checkArithmetic<T>();
+    stanfordcpplib::bulkops::scale(v.data(), v.size(), static_cast<T>(factor));
+}
+
+template <typename T, typename Number>
+void scale(Grid<T>& grid, Number factor) {
+    stanfordcpplib::bulkops::checkArithmetic<T>();
+    stanfordcpplib::bulkops::scale(grid.data(), grid.size(), static_cast<T>(factor));
+}
+
+/*
+ * Function: subtractElements
+ * Usage: subtractElements(y, x);
+ * ------------------------------
+ * Subtracts each element of <code>x</code> from the corresponding element
+ * of <code>y</code>, as in <code>y[i] -= x[i]</code>.
+ */
+template <typename T, typename Allocator>
+void subtractElements(Vector<T, Allocator>& y, const Vector<T, Allocator>& x) {
+    stanfordcpplib::bulkops::checkArithmetic<T>();
+    stanfordcpplib::bulkops::checkSizes(y, x, "subtractElements");
+    stanfordcpplib::bulkops::combine(stanfordcpplib::bulkops::SUBTRACT, y.data(), x.data(), y.size());
+}
+
+template <typename T>
+void subtractElements(Grid<T>& y, const Grid<T>& x) {
+    stanfordcpplib::bulkops::checkArithmetic<T>();
+    stanfordcpplib::bulkops::checkSizes(y, x, "subtractElements");
+    stanfordcpplib::bulkops::combine(stanfordcpplib::bulkops::SUBTRACT, y.data(), x.data(), y.size());
+}
+
+/*
+ * Function: sumElements
+ * Usage: double total = sumElements(v);
+ * -------------------------------------
+ * Returns the sum of the elements of the given vector or grid, or 0 if
+ * it is empty.
+ */
+template <typename T, typename Allocator>
+T sumElements(const Vector<T, Allocator>& v) {
+    return stanfordcpplib::bulkops::reduceElements(stanfordcpplib::bulkops::ADD,
+                                                   v.data(), v.size(), "sumElements");
+}
+
+template <typename T>
+T sumElements(const Grid<T>& grid) {
+    return stanfordcpplib::bulkops::reduceElements(stanfordcpplib::bulkops::ADD,
+                                                   grid.data(), grid.size(), "sumElements");
+}
+
+/*
+ * Function: transpose
+ * Usage: Grid<double> t = transpose(grid);
+ * ----------------------------------------
+ * Returns a grid with the rows and columns of the given grid swapped, so
+ * that <code>t[col][row]</code> is <code>grid[row][col]</code>.
+ */
+template <typename T>
+Grid<T> transpose(const Grid<T>& grid) {
+    // copy in square tiles, so that the rows being read and the rows being
+    // written both stay in the cache instead of striding across memory
+    const int TILE = 32;
+    int nRows = grid.numRows();
+    int nCols = grid.numCols();
+    Grid<T> result(nCols, nRows);
+    const T* in = grid.data();
+    T* out = result.data();
+    for (int rowStart = 0; rowStart < nRows; rowStart += TILE) {
+        int rowEnd = std::min(nRows, rowStart + TILE);
+        for (int colStart = 0; colStart < nCols; colStart += TILE) {
+            int colEnd = std::min(nCols, colStart + TILE);
+            for (int row = rowStart; row < rowEnd; row++) {
+                for (int col = colStart; col < colEnd; col++) {
+                    out[col * nRows + row] = in[row * nCols + col];
+                }
+            }
+        }
+    }
+    return result;
+}
+
+#include "private/init.h"   // ensure that Stanford C++ lib is initialized
+
+#endif // _bulkops_h
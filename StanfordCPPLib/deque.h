@@ -5,6 +5,10 @@
  * in which values can be added and removed from the front or back.
  * It combines much of the functionality of a stack and a queue.
  * 
+ * @version 2016/10/14
+ * - stored in a power-of-two ring buffer shared with Queue rather than a std::deque
+ * - added enqueueAll and dequeueN to add and remove many elements at once
+ * - added move constructor and move assignment operator
  * @version 2016/09/24
  * - refactored to use collections.h utility functions
  * @version 2016/09/22
@@ -26,6 +30,8 @@
 #include "collections.h"
 #include "error.h"
 #include "hashcode.h"
+#include "vector.h"
+#include "private/ringbuffer.h"
 
 /*
  * Class: Deque<ValueType>
@@ -100,6 +106,17 @@ public:
     ValueType dequeueBack();
     ValueType dequeueFront();
 
+    /*
+     * Method: dequeueN
+     * Usage: Vector<ValueType> first = deque.dequeueN(n);
+     * ---------------------------------------------------
+     * Removes the first <code>n</code> items in the deque and returns
+     * them in order.  The items are moved out of the deque a contiguous
+     * run at a time, which is faster than calling <code>dequeue</code>
+     * <code>n</code> times.
+     */
+    Vector<ValueType> dequeueN(int n);
+
     /*
      * Method: enqueue
      * Usage: deque.enqueue(value);
@@ -110,6 +127,19 @@ public:
     void enqueue(const ValueType& value);
     void enqueueBack(const ValueType& value);
     void enqueueFront(const ValueType& value);
+
+    /*
+     * Method: enqueueAll
+     * Usage: deque.enqueueAll(collection);
+     * ------------------------------------
+     * Adds every element of the given collection, in its iteration order,
+     * to the end of the deque.  The deque grows at most once to make room
+     * for them.  The collection may be any that has <code>size</code>,
+     * <code>begin</code> and <code>end</code>, including this deque.
+     */
+    template <typename CollectionType>
+    void enqueueAll(const CollectionType& collection);
+    void enqueueAll(std::initializer_list<ValueType> list);
     
     /*
      * Method: equals
@@ -219,60 +249,68 @@ public:
     template <typename T>
     friend std::ostream& operator <<(std::ostream& os, const Deque<T>& deque);
 
+    /*
+     * Implementation notes: Deque data structure
+     * ------------------------------------------
+     * The elements are stored in a ring buffer, shared with the Queue
+     * class and described in private/ringbuffer.h.  Unlike a std::deque,
+     * which keeps its elements in many separately allocated blocks, the
+     * ring buffer keeps them in one array whose capacity is a power of
+     * two, so reaching element i is a single masked index.
+     */
+
 private:
     /* Instance variables */
-    std::deque<ValueType> elements;
+    stanfordcpplib::collections::RingBuffer<ValueType> elements;
 
 public:
+    /*
+     * Copying and moving support
+     * --------------------------
+     * Deques are copied element by element.  A deque that is moved from
+     * is left empty.
+     */
+    Deque(const Deque& src) = default;
+    Deque& operator =(const Deque& src) = default;
+    Deque(Deque&& src) = default;
+    Deque& operator =(Deque&& src) = default;
+
     /*
      * Iterator support
      * ----------------
      * The classes in the StanfordCPPLib collection implement input
      * iterators so that they work symmetrically with respect to the
-     * corresponding STL classes.
+     * corresponding STL classes.  A deque's iterators are random-access.
      */
-    class iterator : public std::deque<ValueType>::iterator {
-    public:
-        iterator() : std::deque<ValueType>::iterator() {}
-        iterator(const iterator& it) : std::deque<ValueType>::iterator(it) {}
-        iterator(const typename std::deque<ValueType>::iterator& it) : std::deque<ValueType>::iterator(it) {}
-    };
-    class const_iterator : public std::deque<ValueType>::const_iterator {
-    public:
-        const_iterator() : std::deque<ValueType>::const_iterator() {}
-        const_iterator(const const_iterator& it) : std::deque<ValueType>::const_iterator(it) {}
-        const_iterator(const typename std::deque<ValueType>::const_iterator& it) : std::deque<ValueType>::const_iterator(it) {}
-    };
+    typedef typename stanfordcpplib::collections::RingBuffer<ValueType>::iterator iterator;
+    typedef typename stanfordcpplib::collections::RingBuffer<ValueType>::const_iterator const_iterator;
 
     /*
      * Returns an iterator positioned at the first element of the deque.
      */
     iterator begin() {
-        return iterator(elements.begin());
+        return elements.begin();
     }
 
     /*
      * Returns an iterator positioned at the first element of the deque.
      */
     const_iterator begin() const {
-        auto itr = elements.begin();
-        return const_iterator(itr);
+        return elements.begin();
     }
     
     /*
      * Returns an iterator positioned at the last element of the deque.
      */
     iterator end() {
-        auto itr = elements.end();
-        return iterator(itr);
+        return elements.end();
     }
     
     /*
      * Returns an iterator positioned at the last element of the deque.
      */
     const_iterator end() const {
-        auto itr = elements.end();
-        return const_iterator(itr);
+        return elements.end();
     }
 };
 
@@ -298,10 +336,7 @@ Deque<ValueType>::~Deque() {
 
 template <typename ValueType>
 Deque<ValueType>::Deque(std::initializer_list<ValueType> list) {
-    clear();
-    for (const ValueType& value : list) {
-        add(value);
-    }
+    enqueueAll(list);
 }
 
 template <typename ValueType>
@@ -348,9 +383,7 @@ ValueType Deque<ValueType>::dequeueBack() {
     if (isEmpty()) {
         error("Deque::dequeueBack: Attempting to dequeue from an empty deque");
     }
-    ValueType result = elements.back();
-    elements.pop_back();
-    return result;
+    return elements.popBack();
 }
 
 template <typename ValueType>
@@ -358,8 +391,18 @@ ValueType Deque<ValueType>::dequeueFront() {
     if (isEmpty()) {
         error("Deque::dequeueFront: Attempting to dequeue from an empty deque");
     }
-    ValueType result = elements.front();
-    elements.pop_front();
+    return elements.popFront();
+}
+
+template <typename ValueType>
+Vector<ValueType> Deque<ValueType>::dequeueN(int n) {
+    if (n < 0 || n > size()) {
+        error("Deque::dequeueN: Attempting to dequeue " + integerToString(n)
+              + " elements from a deque of size " + integerToString(size()));
+    }
+    Vector<ValueType> result;
+    result.ensureCapacity(n);
+    elements.popFrontInto(n, result);
     return result;
 }
 
@@ -370,17 +413,28 @@ void Deque<ValueType>::enqueue(const ValueType& value) {
 
 template <typename ValueType>
 void Deque<ValueType>::enqueueBack(const ValueType& value) {
-    elements.push_back(value);
+    elements.emplaceBack(value);
 }
 
 template <typename ValueType>
 void Deque<ValueType>::enqueueFront(const ValueType& value) {
-    elements.push_front(value);
+    elements.emplaceFront(value);
+}
+
+template <typename ValueType>
+template <typename CollectionType>
+void Deque<ValueType>::enqueueAll(const CollectionType& collection) {
+    elements.appendRange(collection.begin(), (int) collection.size());
+}
+
+template <typename ValueType>
+void Deque<ValueType>::enqueueAll(std::initializer_list<ValueType> list) {
+    elements.appendRange(list.begin(), (int) list.size());
 }
 
 template <typename ValueType>
 bool Deque<ValueType>::equals(const Deque<ValueType>& deque2) const {
-    return elements == deque2.elements;
+    return stanfordcpplib::collections::equals(*this, deque2);
 }
 
 template <typename ValueType>
@@ -393,7 +447,7 @@ const ValueType& Deque<ValueType>::front() const {
 
 template <typename ValueType>
 bool Deque<ValueType>::isEmpty() const {
-    return elements.empty();
+    return elements.size() == 0;
 }
 
 template <typename ValueType>
@@ -445,7 +499,7 @@ int Deque<ValueType>::size() const {
 
 template <typename ValueType>
 std::deque<ValueType> Deque<ValueType>::toStlDeque() const {
-    return elements;
+    return std::deque<ValueType>(begin(), end());
 }
 
 template <typename ValueType>
@@ -487,7 +541,7 @@ bool Deque<ValueType>::operator >=(const Deque& deque2) const {
 
 template <typename ValueType>
 std::ostream& operator <<(std::ostream& os, const Deque<ValueType>& deque) {
-    return stanfordcpplib::collections::writeCollection(os, deque);
+    return stanfordcpplib::collections::writeIterable(os, deque.begin(), deque.end());
 }
 
 template <typename ValueType>
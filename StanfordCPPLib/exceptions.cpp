@@ -5,6 +5,8 @@
  * by student code on the console.
  * 
  * @author Marty Stepp
+ * @version 2016/10/14
+ * - signal and terminate handlers remove the GBufferedImage shared pixel file
  * @version 2016/08/02
  * - added some new cxx11 filters to stack traces
  * - fixed spacing on *** messages from exception handlers
@@ -392,6 +394,9 @@ static void stanfordCppLibSignalHandler(int sig) {
     // turn the signal handler off (should run only once; avoid infinite cycle)
     signalHandlerDisable();
 
+    // the program will not get to exit normally, so remove its files now
+    stanfordcpplib::removeSharedPixelFile();
+
     // tailor the error message to the kind of signal that occurred
     std::string SIGNAL_KIND = "A fatal error";
     std::string SIGNAL_DETAILS = "No details were provided about the error.";
@@ -451,6 +456,7 @@ static void stanfordCppLibTerminateHandler() {
     msg += "***\n";
     
     std::ostream& out = std::cerr;   // used by FILL_IN_EXCEPTION_TRACE macro
+    stanfordcpplib::removeSharedPixelFile();
     try {
         signalHandlerDisable();   // don't want both a signal AND a terminate() call
         throw;   // re-throws the exception that already occurred
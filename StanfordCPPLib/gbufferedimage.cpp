@@ -5,6 +5,9 @@
  * See that file for documentation of each member.
  *
  * @author Marty Stepp
+ * @version 2016/10/12
+ * - fromGrid and load pass pixels through memory shared with the Java
+ *   back-end when it supports that, rather than as Base64 text
  * @version 2016/07/30
  * - added constructor that takes a file name
  * - converted all occurrences of string parameters to const string&
@@ -216,6 +219,12 @@ void GBufferedImage::fromGrid(const Grid<int>& grid) {
     m_width = grid.width();
     m_height = grid.height();
     
+    // if possible, hand the back-end the pixels through shared memory,
+    // which skips encoding them and pushing megabytes of text down the pipe
+    if (stanfordcpplib::getPlatform()->gbufferedimage_updateAllPixelsShared(this, m_pixels)) {
+        return;
+    }
+    
     // output a base64-encoded version of the image pixels
     std::ostringstream out;
     
@@ -272,6 +281,13 @@ void GBufferedImage::load(const std::string& filename) {
         error("GBufferedImage::load: file not found: " + filename);
     }
     
+    // read pixels straight from memory shared with the Java back-end, if possible
+    if (stanfordcpplib::getPlatform()->gbufferedimage_loadShared(this, filename, m_pixels)) {
+        m_width = m_pixels.width();
+        m_height = m_pixels.height();
+        return;
+    }
+    
     // read Base64-compressed pixel data from Java back-end
     std::string result = stanfordcpplib::getPlatform()->gbufferedimage_load(this, filename);
     std::string decoded = Base64::decode(result);
@@ -4,6 +4,16 @@
  * This file exports the <code>Grid</code> class, which offers a
  * convenient abstraction for representing a two-dimensional array.
  *
+ * @version 2016/10/14
+ * - added move constructor and move assignment operator
+ * - added set overload that moves its argument
+ * - resize(true) moves retained elements rather than copying them, and now
+ *   retains the right elements when the number of columns changes
+ * - index checks are inline and no longer build a string on every access
+ * - added data, getUnchecked, setUnchecked methods
+ * - fill assigns the elements directly rather than through set
+ * - rows returned by operator [] offer data, begin, end for direct access
+ *   to the row's elements
  * @version 2016/09/24
  * - refactored to use collections.h utility functions
  * - made member variables actually private (oops)
@@ -38,6 +48,7 @@
 #include <iostream>
 #include <string>
 #include <sstream>
+#include <utility>
 #include "collections.h"
 #include "error.h"
 #include "hashcode.h"
@@ -101,6 +112,18 @@ public:
      */
     virtual ~Grid();
     
+    /*
+     * Method: data
+     * Usage: ValueType* p = grid.data();
+     * ----------------------------------
+     * Returns a pointer to the grid's elements, which are stored contiguously
+     * in row-major order: the element at <code>row</code>/<code>col</code>
+     * is at <code>p[row * grid.numCols() + col]</code>.  The pointer is
+     * valid until the grid is resized or destroyed.
+     */
+    ValueType* data();
+    const ValueType* data() const;
+
     /*
      * Method: equals
      * Usage: if (grid.equals(grid2)) ...
@@ -131,6 +154,17 @@ public:
     ValueType get(int row, int col);
     const ValueType& get(int row, int col) const;
 
+    /*
+     * Method: getUnchecked
+     * Usage: ValueType value = grid.getUnchecked(row, col);
+     * -----------------------------------------------------
+     * Returns the element at the specified <code>row</code>/<code>col</code>
+     * position without checking that it is inside the grid boundaries.
+     * This is for inner loops whose indexes are known to be valid; passing
+     * indexes outside the grid has undefined behavior.
+     */
+    const ValueType& getUnchecked(int row, int col) const;
+
     /*
      * Method: height
      * Usage: int nRows = grid.height();
@@ -224,8 +258,21 @@ public:
      * location in this grid with a new value.  This method signals an error
      * if the <code>row</code> and <code>col</code> arguments are outside
      * the grid boundaries.
+     * If the value is a temporary, it is moved into the grid rather
+     * than copied.
      */
     void set(int row, int col, const ValueType& value);
+    void set(int row, int col, ValueType&& value);
+
+    /*
+     * Method: setUnchecked
+     * Usage: grid.setUnchecked(row, col, value);
+     * ------------------------------------------
+     * Replaces the element at the specified <code>row</code>/<code>col</code>
+     * location without checking that it is inside the grid boundaries.
+     * Passing indexes outside the grid has undefined behavior.
+     */
+    void setUnchecked(int row, int col, const ValueType& value);
 
     /*
      * Method: size
@@ -280,6 +327,12 @@ public:
      * get or set individual elements.  This method signals an error if
      * the <code>row</code> and <code>col</code> arguments are outside
      * the grid boundaries.
+     *
+     * The row that <code>grid[row]</code> returns can also be used as a
+     * view of that row's elements, which are contiguous in memory:
+     * <code>grid[row].data()</code> points to the first of its
+     * <code>grid[row].size()</code> elements, and
+     * <code>for (double& x : grid[row])</code> loops over them.
      */
     GridRow operator [](int row);
     const GridRowConst operator [](int row) const;
@@ -354,15 +407,30 @@ private:
 
     /*
      * Throws an ErrorException if the given row/col are not within the range of
-     * (0,0) through (rowMax-1,colMax-1) inclusive.
+     * (0,0) through (nRows-1,nCols-1) inclusive.
      * This is a consolidated error handler for all various Grid members that
      * accept index parameters.
      * The prefix parameter represents a text string to place at the start of
      * the error message, generally to help indicate which member threw the error.
+     * The check itself is inline and cheap; only indexError, which builds the
+     * message, is kept out of line.  Loops that have already checked their
+     * bounds can skip it with getUnchecked, setUnchecked or a row's data().
      */
-    void checkIndexes(int row, int col,
-                      int rowMax, int colMax,
-                      std::string prefix) const;
+    void checkIndexes(int row, int col, const char* prefix) const {
+        // casting to unsigned makes negative indexes too large as well
+        if ((unsigned int) row >= (unsigned int) nRows
+                || (unsigned int) col >= (unsigned int) nCols) {
+            indexError(row, col, prefix);
+        }
+    }
+
+    void checkRow(int row, const char* prefix) const {
+        if ((unsigned int) row >= (unsigned int) nRows) {
+            indexError(row, 0, prefix);
+        }
+    }
+
+    void indexError(int row, int col, const char* prefix) const;
     int gridCompare(const Grid& grid2) const;
 
     /*
@@ -385,7 +453,9 @@ private:
      * assignment (operator=).  Making copies is generally avoided
      * because of the expense and thus, grids are typically passed
      * by reference, however, when a copy is needed, these operations
-     * are supported.
+     * are supported.  Grids that are about to be destroyed, such as those
+     * returned from functions, are moved instead: the new grid takes over
+     * the old one's array and the old one is left with 0 rows and columns.
      */
     void deepCopy(const Grid& grid) {
         int n = grid.nRows * grid.nCols;
@@ -410,6 +480,28 @@ public:
         deepCopy(src);
     }
 
+    Grid& operator =(Grid&& src) noexcept {
+        if (this != &src) {
+            delete[] elements;
+            elements = src.elements;
+            nRows = src.nRows;
+            nCols = src.nCols;
+            src.elements = NULL;
+            src.nRows = 0;
+            src.nCols = 0;
+        }
+        return *this;
+    }
+
+    Grid(Grid&& src) noexcept
+            : elements(src.elements),
+              nRows(src.nRows),
+              nCols(src.nCols) {
+        src.elements = NULL;
+        src.nRows = 0;
+        src.nCols = 0;
+    }
+
     /*
      * Iterator support
      * ----------------
@@ -482,15 +574,32 @@ public:
         }
 
         ValueType& operator [](int col) {
-            gp->checkIndexes(row, col, gp->nRows-1, gp->nCols-1, "operator [][]");
+            gp->checkIndexes(row, col, "operator [][]");
             return gp->elements[(row * gp->nCols) + col];
         }
 
-        ValueType operator [](int col) const {
-            gp->checkIndexes(row, col, gp->nRows-1, gp->nCols-1, "operator [][]");
+        const ValueType& operator [](int col) const {
+            gp->checkIndexes(row, col, "operator [][]");
             return gp->elements[(row * gp->nCols) + col];
         }
 
+        /*
+         * data, begin and end give direct access to the row's elements,
+         * which are contiguous; the row index is checked once here.
+         */
+        ValueType* data() const {
+            gp->checkRow(row, "operator []");
+            return gp->elements + (row * gp->nCols);
+        }
+
+        ValueType* begin() const {
+            return data();
+        }
+
+        ValueType* end() const {
+            return data() + gp->nCols;
+        }
+
         int size() const {
             return gp->width();
         }
@@ -513,11 +622,24 @@ public:
             /* Empty */
         }
 
-        const ValueType operator [](int col) const {
-            gp->checkIndexes(row, col, gp->nRows-1, gp->nCols-1, "operator [][]");
+        const ValueType& operator [](int col) const {
+            gp->checkIndexes(row, col, "operator [][]");
             return gp->elements[(row * gp->nCols) + col];
         }
 
+        const ValueType* data() const {
+            gp->checkRow(row, "operator []");
+            return gp->elements + (row * gp->nCols);
+        }
+
+        const ValueType* begin() const {
+            return data();
+        }
+
+        const ValueType* end() const {
+            return data() + gp->nCols;
+        }
+
         int size() const {
             return gp->width();
         }
@@ -592,6 +714,16 @@ Grid<ValueType>::~Grid() {
     }
 }
 
+template <typename ValueType>
+ValueType* Grid<ValueType>::data() {
+    return elements;
+}
+
+template <typename ValueType>
+const ValueType* Grid<ValueType>::data() const {
+    return elements;
+}
+
 template <typename ValueType>
 bool Grid<ValueType>::equals(const Grid<ValueType>& grid2) const {
     // optimization: if literally same grid, stop
@@ -614,22 +746,25 @@ bool Grid<ValueType>::equals(const Grid<ValueType>& grid2) const {
 
 template <typename ValueType>
 void Grid<ValueType>::fill(const ValueType& value) {
-    for (int row = 0; row < nRows; row++) {
-        for (int col = 0; col < nCols; col++) {
-            set(row, col, value);
-        }
+    for (int i = 0, n = nRows * nCols; i < n; i++) {
+        elements[i] = value;
     }
 }
 
 template <typename ValueType>
 ValueType Grid<ValueType>::get(int row, int col) {
-    checkIndexes(row, col, nRows-1, nCols-1, "get");
+    checkIndexes(row, col, "get");
     return elements[(row * nCols) + col];
 }
 
 template <typename ValueType>
 const ValueType& Grid<ValueType>::get(int row, int col) const {
-    checkIndexes(row, col, nRows-1, nCols-1, "get");
+    checkIndexes(row, col, "get");
+    return elements[(row * nCols) + col];
+}
+
+template <typename ValueType>
+const ValueType& Grid<ValueType>::getUnchecked(int row, int col) const {
     return elements[(row * nCols) + col];
 }
 
@@ -745,7 +880,7 @@ void Grid<ValueType>::resize(int nRows, int nCols, bool retain) {
         int minCols = oldnCols < nCols ? oldnCols : nCols;
         for (int row = 0; row < minRows; row++) {
             for (int col = 0; col < minCols; col++) {
-                this->elements[(row * nCols) + col] = oldElements[(row * oldnRows) + col];
+                this->elements[(row * nCols) + col] = std::move(oldElements[(row * oldnCols) + col]);
             }
         }
     }
@@ -758,7 +893,18 @@ void Grid<ValueType>::resize(int nRows, int nCols, bool retain) {
 
 template <typename ValueType>
 void Grid<ValueType>::set(int row, int col, const ValueType& value) {
-    checkIndexes(row, col, nRows-1, nCols-1, "set");
+    checkIndexes(row, col, "set");
+    elements[(row * nCols) + col] = value;
+}
+
+template <typename ValueType>
+void Grid<ValueType>::set(int row, int col, ValueType&& value) {
+    checkIndexes(row, col, "set");
+    elements[(row * nCols) + col] = std::move(value);
+}
+
+template <typename ValueType>
+void Grid<ValueType>::setUnchecked(int row, int col, const ValueType& value) {
     elements[(row * nCols) + col] = value;
 }
 
@@ -846,24 +992,22 @@ bool Grid<ValueType>::operator >=(const Grid& grid2) const {
 }
 
 template <typename ValueType>
-void Grid<ValueType>::checkIndexes(int row, int col,
-                                   int rowMax, int colMax,
-                                   std::string prefix) const {
+void Grid<ValueType>::indexError(int row, int col, const char* prefix) const {
     const int rowMin = 0;
     const int colMin = 0;
-    if (row < rowMin || row > rowMax || col < colMin || col > colMax) {
-        std::ostringstream out;
-        out << "Grid::" << prefix << ": (" << row << ", " << col << ")"
-            << " is outside of valid range [";
-        if (rowMin < rowMax && colMin < colMax) {
-            out << "(" << rowMin << ", " << colMin <<  ")..("
-                << rowMax << ", " << colMax << ")";
-        } else if (rowMin == rowMax && colMin == colMax) {
-            out << "(" << rowMin << ", " << colMin <<  ")";
-        } // else min > max, no range, empty grid
-        out << "]";
-        error(out.str());
-    }
+    const int rowMax = nRows - 1;
+    const int colMax = nCols - 1;
+    std::ostringstream out;
+    out << "Grid::" << prefix << ": (" << row << ", " << col << ")"
+        << " is outside of valid range [";
+    if (rowMin < rowMax && colMin < colMax) {
+        out << "(" << rowMin << ", " << colMin <<  ")..("
+            << rowMax << ", " << colMax << ")";
+    } else if (rowMin == rowMax && colMin == colMax) {
+        out << "(" << rowMin << ", " << colMin <<  ")";
+    } // else min > max, no range, empty grid
+    out << "]";
+    error(out.str());
 }
 
 template <typename ValueType>
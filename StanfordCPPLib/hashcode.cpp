@@ -3,18 +3,41 @@
  * ------------------
  * This file implements the interface declared in hashcode.h.
  * 
+ * @version 2016/10/14
+ * - replaced byte-at-a-time djb2 string hashing with a 64-bit word-at-a-time
+ *   hash, and identity integer hashing with a 64-bit mixing function
+ * - added per-process hash seeding
  * @version 2015/07/05
  * - using global hashing functions rather than global variables
  */
 
 #include "hashcode.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
 
 static const int HASH_SEED = 5381;               // Starting point for first cycle
 static const int HASH_MULTIPLIER = 33;           // Multiplier for each cycle
 static const int HASH_MASK = unsigned(-1) >> 1;  // All 1 bits except the sign
 
+// odd 64-bit constants with well-mixed bits, used as multipliers/offsets
+static const unsigned long long HASH_PRIME_1 = 0x9e3779b97f4a7c15ULL;
+static const unsigned long long HASH_PRIME_2 = 0xc2b2ae3d27d4eb4fULL;
+static const unsigned long long HASH_PRIME_3 = 0x165667b19e3779f9ULL;
+
+// prototypes of static helper functions
+static unsigned long long chooseHashSeed();
+static int foldHash(unsigned long long hash);
+static unsigned long long hashWord(unsigned long long hash, unsigned long long word);
+static unsigned long long mix64(unsigned long long value);
+static unsigned long long readWord(const unsigned char* bytes);
+static unsigned long long rotateLeft(unsigned long long value, int bits);
+
 int hashSeed() {
-    return HASH_SEED;
+    unsigned long long seed = hashSeed64();
+    return seed == 0 ? HASH_SEED : foldHash(seed);
 }
 
 int hashMultiplier() {
@@ -25,69 +48,187 @@ int hashMask() {
     return HASH_MASK;
 }
 
+unsigned long long hashSeed64() {
+    static unsigned long long seed = chooseHashSeed();
+    return seed;
+}
+
+/*
+ * Picks the seed according to SPL_HASH_SEED / SPL_RANDOM_HASH_SEED.
+ * std::random_device is deterministic on some older MinGW versions, so its
+ * output is combined with the clock.
+ */
+static unsigned long long chooseHashSeed() {
+#ifdef SPL_RANDOM_HASH_SEED
+    bool random = true;
+#else
+    bool random = false;
+#endif
+    char* setting = getenv("SPL_HASH_SEED");
+    if (setting && *setting) {
+        char* end = NULL;
+        unsigned long long seed = strtoull(setting, &end, 0);
+        if (end && *end == '\0') {
+            return seed;
+        }
+        random = std::string(setting) == "random";
+    }
+    if (!random) {
+        return 0;
+    }
+    std::random_device device;
+    unsigned long long seed = (static_cast<unsigned long long>(device()) << 32) ^ device();
+    seed ^= static_cast<unsigned long long>(
+                std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    return mix64(seed) | 1;   // never 0, which means "not seeded"
+}
+
 /*
  * Implementation notes: hashCode
  * ------------------------------
- * This function takes a string key and uses it to derive a hash code,
- * which is a nonnegative integer related to the key by a deterministic
- * function that distributes keys well across the space of integers.
- * The general method is called linear congruence, which is also used
- * in random-number generators.  The specific algorithm used here is
- * called djb2 after the initials of its inventor, Daniel J. Bernstein,
- * Professor of Mathematics at the University of Illinois at Chicago.
+ * These functions take a key and use it to derive a hash code, which is a
+ * nonnegative integer related to the key by a deterministic function that
+ * distributes keys well across the space of integers.  Every key is first
+ * reduced to a 64-bit hash by one of two functions, which is then folded
+ * into the 31 bits of an int:
+ *
+ * - hashMix, for keys that fit into 64 bits, is the finalizer of Sebastiano
+ *   Vigna's SplitMix64 generator.  Changing any one bit of the key flips
+ *   about half the bits of the result, so keys that are close together or
+ *   share a stride do not collide when a hash table keeps only a few bits.
+ *   Integer keys are widened to 64 bits first, so equal integers hash
+ *   equally whatever their integer type ('a' and 97, say).  Floating-point
+ *   keys are hashed by their bit patterns instead, so 1.0 and 1 differ.
+ *
+ * - hashBytes, for strings, consumes its input 8 bytes at a time rather
+ *   than 1.  Inputs of 32 bytes or more are split across four independent
+ *   lanes so that the processor can work on several multiplies at once;
+ *   the lanes are combined at the end.  Each step multiplies, rotates and
+ *   multiplies again in the style of xxHash, and the length is mixed in
+ *   first so that trailing zero bytes still change the hash.
  */
 
 int hashCode(bool key) {
-    return (int) key;
+    return foldHash(hashMix(key));
 }
 
 int hashCode(char key) {
-    return key;
+    return foldHash(hashMix(static_cast<unsigned long long>(static_cast<long long>(key))));
 }
 
 int hashCode(double key) {
-    char* byte = (char*) &key;
-    unsigned hash = HASH_SEED;
-    for (int i = 0; i < (int) sizeof(double); i++) {
-        hash = HASH_MULTIPLIER * hash + (int) *byte++;
+    if (key == 0) {
+        key = 0;   // -0.0 == 0.0, so they must hash the same
     }
-    return hash & HASH_MASK;
+    unsigned long long bits;
+    memcpy(&bits, &key, sizeof(bits));
+    return foldHash(hashMix(bits));
 }
 
 int hashCode(float key) {
-    char* byte = (char*) &key;
-    unsigned hash = HASH_SEED;
-    for (int i = 0; i < (int) sizeof(float); i++) {
-        hash = HASH_MULTIPLIER * hash + (int) *byte++;
-    }
-    return hash & HASH_MASK;
+    return hashCode(static_cast<double>(key));
 }
 
 int hashCode(int key) {
-    return key & HASH_MASK;
+    return hashCode(static_cast<long long>(key));
 }
 
 int hashCode(long key) {
-    return int(key) & HASH_MASK;
+    return hashCode(static_cast<long long>(key));
+}
+
+int hashCode(long long key) {
+    return foldHash(hashMix(static_cast<unsigned long long>(key)));
+}
+
+int hashCode(unsigned int key) {
+    return foldHash(hashMix(key));
+}
+
+int hashCode(unsigned long key) {
+    return foldHash(hashMix(key));
+}
+
+int hashCode(unsigned long long key) {
+    return foldHash(hashMix(key));
 }
 
 int hashCode(const char* str) {
-    unsigned hash = HASH_SEED;
-    for (int i = 0; str && str[i] != 0; i++) {
-        hash = HASH_MULTIPLIER * hash + str[i];
-    }
-    return int(hash & HASH_MASK);
+    return foldHash(hashBytes(str, str ? (int) strlen(str) : 0));
 }
 
 int hashCode(const std::string& str) {
-    unsigned hash = HASH_SEED;
-    int n = str.length();
-    for (int i = 0; i < n; i++) {
-        hash = HASH_MULTIPLIER * hash + str[i];
-    }
-    return int(hash & HASH_MASK);
+    return foldHash(hashBytes(str.data(), (int) str.length()));
 }
 
 int hashCode(void* key) {
-    return hashCode(reinterpret_cast<long>(key));
+    return foldHash(hashMix(reinterpret_cast<uintptr_t>(key)));
+}
+
+unsigned long long hashBytes(const void* data, int length) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    unsigned long long hash = hashSeed64() ^ (HASH_PRIME_3 * (unsigned long long) length);
+    if (length >= 32) {
+        unsigned long long lane1 = hash + HASH_PRIME_1 + HASH_PRIME_2;
+        unsigned long long lane2 = hash + HASH_PRIME_2;
+        unsigned long long lane3 = hash;
+        unsigned long long lane4 = hash - HASH_PRIME_1;
+        do {
+            lane1 = hashWord(lane1, readWord(bytes));
+            lane2 = hashWord(lane2, readWord(bytes + 8));
+            lane3 = hashWord(lane3, readWord(bytes + 16));
+            lane4 = hashWord(lane4, readWord(bytes + 24));
+            bytes += 32;
+            length -= 32;
+        } while (length >= 32);
+        hash = rotateLeft(lane1, 1) + rotateLeft(lane2, 7)
+                + rotateLeft(lane3, 12) + rotateLeft(lane4, 18);
+    }
+    while (length >= 8) {
+        hash = hashWord(hash, readWord(bytes));
+        bytes += 8;
+        length -= 8;
+    }
+    if (length > 0) {
+        unsigned long long word = 0;
+        memcpy(&word, bytes, length);
+        hash = hashWord(hash, word);
+    }
+    return mix64(hash);
+}
+
+unsigned long long hashMix(unsigned long long value) {
+    return mix64(value + HASH_PRIME_1 + hashSeed64());
+}
+
+/*
+ * Reduces a 64-bit hash to a nonnegative int, keeping the influence of
+ * the upper half.
+ */
+static int foldHash(unsigned long long hash) {
+    return int((hash ^ (hash >> 32)) & HASH_MASK);
+}
+
+static unsigned long long hashWord(unsigned long long hash, unsigned long long word) {
+    return rotateLeft(hash ^ (word * HASH_PRIME_2), 31) * HASH_PRIME_1;
+}
+
+static unsigned long long mix64(unsigned long long value) {
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+/*
+ * Reads 8 bytes that need not be aligned; compilers turn this memcpy into
+ * a single load.
+ */
+static unsigned long long readWord(const unsigned char* bytes) {
+    unsigned long long word;
+    memcpy(&word, bytes, sizeof(word));
+    return word;
+}
+
+static unsigned long long rotateLeft(unsigned long long value, int bits) {
+    return (value << bits) | (value >> (64 - bits));
 }
@@ -5,6 +5,14 @@
  * These functions are used by the HashMap and HashSet collections, as well as
  * by other collections that wish to be used as elements within HashMaps/Sets.
  * 
+ * @version 2016/10/14
+ * - strings and other byte sequences are hashed a 64-bit word at a time
+ * - integer, floating-point and pointer keys are passed through a mixing
+ *   function rather than used as their own hash codes
+ * - added hashBytes() and hashMix() with 64-bit results
+ * - added hashSpread() for hash tables indexed by the low bits of a hash code
+ * - added optional per-process random seeding (SPL_HASH_SEED) and hashSeed64()
+ * - added hashCode overloads for long long and unsigned integer types
  * @version 2015/07/05
  * - using global hashing functions rather than global variables
  *   (hashSeed(), hashMultiplier(), and hashMask())
@@ -29,10 +37,55 @@ int hashCode(double key);
 int hashCode(float key);
 int hashCode(int key);
 int hashCode(long key);
+int hashCode(long long key);
+int hashCode(unsigned int key);
+int hashCode(unsigned long key);
+int hashCode(unsigned long long key);
 int hashCode(const char* str);
 int hashCode(const std::string& str);
 int hashCode(void* key);
 
+/*
+ * Function: hashBytes
+ * Usage: unsigned long long hash = hashBytes(data, length);
+ * ---------------------------------------------------------
+ * Returns a 64-bit hash of the given number of bytes starting at data.
+ * This is the function used to hash strings; it is also useful for hashing
+ * other flat blocks of memory, such as arrays of numbers.
+ */
+unsigned long long hashBytes(const void* data, int length);
+
+/*
+ * Function: hashMix
+ * Usage: unsigned long long hash = hashMix(value);
+ * ------------------------------------------------
+ * Scrambles the given 64-bit value so that every bit of the input affects
+ * every bit of the result.  This is the function used to hash integers,
+ * and can be used to combine several hash codes into one.
+ */
+unsigned long long hashMix(unsigned long long value);
+
+/*
+ * Function: hashSpread
+ * Usage: unsigned int hash = hashSpread(hashCode(key));
+ * -----------------------------------------------------
+ * Scrambles a hash code so that every bit of it affects the low bits, which
+ * hash tables with a power-of-two number of slots use to pick one.  The
+ * hashCode functions in this file are already well mixed, but hash functions
+ * written by clients for their own types often are not; without this, keys
+ * whose hash codes differ only in their high bits would collide.  This is
+ * the function HashMap and LinkedHashMap apply to every hash code.
+ */
+inline unsigned int hashSpread(int hash) {
+    unsigned int h = static_cast<unsigned int>(hash);
+    h ^= h >> 16;
+    h *= 0x85ebca6bU;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35U;
+    h ^= h >> 16;
+    return h;
+}
+
 /*
  * Constants that are used to help implement these functions
  * (see hashcode.h for example usage)
@@ -41,6 +94,26 @@ int hashSeed();         // Starting point for first cycle
 int hashMultiplier();   // Multiplier for each cycle
 int hashMask();         // All 1 bits except the sign
 
+/*
+ * Hash seeding
+ * ------------
+ * By default all hash functions are deterministic, so a program puts the
+ * same keys in the same order into its hash tables on every run.  A
+ * program that hashes keys chosen by an adversary can instead pick a random
+ * seed for each run, which makes it infeasible to construct keys that all
+ * collide.  A random seed is used if the library is compiled with
+ * SPL_RANDOM_HASH_SEED defined, or if the SPL_HASH_SEED environment variable
+ * is set to "random"; SPL_HASH_SEED may also be set to a number to use
+ * that seed, for example to reproduce the behavior of an earlier run.
+ * The seed is chosen when the first hash code is computed and never changes
+ * afterward, since changing it would scramble existing hash tables.
+ *
+ * hashSeed64 returns the full 64-bit seed, which is 0 unless seeding is on;
+ * hashSeed above returns it folded into an int, or the traditional
+ * starting value 5381 when the seed is 0.
+ */
+unsigned long long hashSeed64();
+
 #include "private/init.h"   // ensure that Stanford C++ lib is initialized
 
 #endif // _hashcode_h
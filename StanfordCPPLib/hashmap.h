@@ -4,6 +4,10 @@
  * This file exports the <code>HashMap</code> class, which stores
  * a set of <i>key</i>-<i>value</i> pairs.
  * 
+ * @version 2016/10/14
+ * - reimplemented as an open-addressing (Robin Hood) hash table with
+ *   power-of-two capacity, storing keys and values inline in one array
+ *   instead of chaining separately allocated cells
  * @version 2016/09/24
  * - refactored to use collections.h utility functions
  * @version 2016/08/10
@@ -387,138 +391,204 @@ public:
     /*
      * Implementation notes:
      * ---------------------
-     * The HashMap class is represented using a hash table that uses
-     * bucket chaining to resolve collisions.
-    */
+     * The HashMap class is represented using an open-addressing hash table
+     * with Robin Hood probing.  Each entry lives directly in a slot of one
+     * flat array, so a lookup examines a few adjacent slots rather than
+     * following pointers through a chain of cells.
+     */
 private:
     /* Constant definitions */
-    static const int INITIAL_BUCKET_COUNT = 101;
-    static const int MAX_LOAD_PERCENTAGE = 70;
+    static const int INITIAL_CAPACITY = 16;      // must be a power of two
+    static const int MAX_LOAD_PERCENTAGE = 80;
 
-    /* Type definition for cells in the bucket chain */
-    struct Cell {
+    /*
+     * Type definition for slots in the table.  An empty slot has a probe
+     * distance of 0; otherwise 'distance' is one more than the number of
+     * slots the entry sits past its home slot, (hash & (capacity - 1)).
+     */
+    struct Slot {
         KeyType key;
         ValueType value;
-        Cell* next;
+        unsigned int hash;
+        int distance;
+
+        Slot() : key(), value(), hash(0), distance(0) {
+            /* Empty */
+        }
     };
 
     /* Instance variables */
-    Vector<Cell*> buckets;
-    int nBuckets;
-    int numEntries;
+    Slot* slots;              /* Array of capacity slots, or NULL if capacity is 0 */
+    int capacity;             /* Number of slots; always 0 or a power of two       */
+    int numEntries;           /* Number of occupied slots                          */
 
     /* Private methods */
 
     /*
-     * Private method: createBuckets
-     * Usage: createBuckets(nBuckets);
-     * -------------------------------
-     * Sets up the vector of buckets to have nBuckets entries, each NULL.
-     * If asked to make empty vector, makes one bucket just to simplify
-     * handling elsewhere.
+     * Private method: hashOf
+     * Usage: unsigned int hash = hashOf(key);
+     * ---------------------------------------
+     * Returns the hashCode for key, scrambled by hashSpread so that every
+     * bit of it affects the low bits used to choose a home slot.
      */
-    void createBuckets(int nBuckets) {
-        if (nBuckets == 0) {
-            nBuckets = 1;
-        }
-        buckets = Vector<Cell*>(nBuckets, NULL);
-        this->nBuckets = nBuckets;
+    static unsigned int hashOf(const KeyType& key) {
+        return hashSpread(hashCode(key));
+    }
+
+    /*
+     * Private method: createSlots
+     * Usage: createSlots(capacity);
+     * -----------------------------
+     * Sets up an array of the given number of empty slots, which must be
+     * 0 or a power of two.  The array is not allocated until the first
+     * entry is added, so empty maps are cheap to create and copy.
+     */
+    void createSlots(int capacity) {
+        slots = capacity == 0 ? NULL : new Slot[capacity];
+        this->capacity = capacity;
         numEntries = 0;
     }
 
     /*
-     * Private method: deleteBuckets
-     * Usage: deleteBuckets(buckets);
-     * ------------------------------
-     * Deletes all the cells in the linked lists contained in vector.
+     * Private method: deleteSlots
+     * Usage: deleteSlots();
+     * ---------------------
+     * Frees the slot array and leaves the map empty, with no slots.
      */
-    void deleteBuckets(Vector<Cell*>& buckets) {
-        for (int i = 0; i < buckets.size(); i++) {
-            Cell* cp = buckets[i];
-            while (cp != NULL) {
-                Cell* np = cp->next;
-                delete cp;
-                cp = np;
-            }
-            buckets[i] = NULL;
-        }
+    void deleteSlots() {
+        delete[] slots;
+        slots = NULL;
+        capacity = 0;
+        numEntries = 0;
     }
 
     /*
      * Private method: expandAndRehash
      * Usage: expandAndRehash();
      * -------------------------
-     * This method is used to increase the number of buckets in the map
-     * and then rehashes all existing entries and adds them into new buckets.
-     * This operation is used when the load factor (i.e. the number of cells
-     * per bucket) has increased enough to warrant this O(N) operation to
-     * enlarge and redistribute the entries.
+     * Doubles the number of slots and moves every entry into the new array.
+     * This operation is used when the load factor (i.e. the fraction of
+     * slots in use) has increased enough to warrant this O(N) operation,
+     * since probe sequences grow quickly once the table is nearly full.
      */
     void expandAndRehash() {
-        Vector<Cell*> oldBuckets = buckets;
-        createBuckets(oldBuckets.size() * 2 + 1);
-        for (int i = 0; i < oldBuckets.size(); i++) {
-            for (Cell* cp = oldBuckets[i]; cp != NULL; cp = cp->next) {
-                put(cp->key, cp->value);
+        Slot* oldSlots = slots;
+        int oldCapacity = capacity;
+        int oldEntries = numEntries;
+        createSlots(oldCapacity == 0 ? INITIAL_CAPACITY : oldCapacity * 2);
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldSlots[i].distance != 0) {
+                insertSlot(oldSlots[i]);
+            }
+        }
+        numEntries = oldEntries;
+        delete[] oldSlots;
+    }
+
+    /*
+     * Private method: findSlot
+     * Usage: int index = findSlot(key, hash);
+     * ---------------------------------------
+     * Returns the index of the slot holding the given key, or -1 if the key
+     * is not in the map.  The search stops as soon as it reaches a slot whose
+     * entry is closer to its home than the key would be, since Robin Hood
+     * insertion would have placed the key before that entry.
+     */
+    int findSlot(const KeyType& key, unsigned int hash) const {
+        if (numEntries == 0) {
+            return -1;
+        }
+        int mask = capacity - 1;
+        int index = hash & mask;
+        for (int distance = 1; distance <= slots[index].distance; distance++) {
+            const Slot& slot = slots[index];
+            if (slot.hash == hash && slot.key == key) {
+                return index;
+            }
+            index = (index + 1) & mask;
+        }
+        return -1;
+    }
+
+    /*
+     * Private method: insertSlot
+     * Usage: int index = insertSlot(slot);
+     * ------------------------------------
+     * Places an entry that is not already in the map into the table, moving
+     * the entry itself (its key, value and hash; its distance is ignored).
+     * Whenever the entry being placed has probed further than the one in its
+     * way, the two swap places and the displaced entry continues onward.
+     * Returns the index at which the given entry ended up.  Does not update
+     * numEntries, and assumes there is at least one empty slot.
+     */
+    int insertSlot(Slot& entry) {
+        int mask = capacity - 1;
+        int index = entry.hash & mask;
+        int result = -1;
+        entry.distance = 1;
+        for (;;) {
+            Slot& slot = slots[index];
+            if (slot.distance == 0) {
+                slot = std::move(entry);
+                return result < 0 ? index : result;
+            } else if (slot.distance < entry.distance) {
+                std::swap(slot, entry);
+                if (result < 0) {
+                    result = index;
+                }
             }
+            index = (index + 1) & mask;
+            entry.distance++;
         }
-        deleteBuckets(oldBuckets);
     }
 
     /*
-     * Private method: findCell
-     * Usage: Cell* cp = findCell(bucket, key);
-     *        Cell* cp = findCell(bucket, key, parent);
-     * ------------------------------------------------
-     * Finds a cell in the chain for the specified bucket that matches key.
-     * If a match is found, the return value is a pointer to the cell containing
-     * the matching key.  If no match is found, the function returns NULL.
-     * If the optional third argument is supplied, it is filled in with the
-     * cell preceding the matching cell to allow the client to splice out
-     * the target cell in the delete call.  If parent is NULL, it indicates
-     * that the cell is the first cell in the bucket chain.
-     */
-    Cell* findCell(int bucket, const KeyType& key) const {
-        Cell *dummy;
-        return findCell(bucket, key, dummy);
+     * Private method: addSlot
+     * Usage: int index = addSlot(entry);
+     * ----------------------------------
+     * Adds an entry whose key is not already in the map, growing the table
+     * first if it is too full.  The entry's value must already be filled in:
+     * growing and inserting both move existing entries, so a value that
+     * refers to an entry of this map would not survive until afterward.
+     * Returns the index at which the entry ended up.
+     */
+    int addSlot(Slot& entry) {
+        if ((numEntries + 1) * 100LL > MAX_LOAD_PERCENTAGE * (long long) capacity) {
+            expandAndRehash();
+        }
+        int index = insertSlot(entry);
+        numEntries++;
+        return index;
     }
 
-    Cell* findCell(int bucket, const KeyType& key, Cell*& parent) const {
-        parent = NULL;
-        Cell* cp = buckets.get(bucket);
-        while (cp != NULL && key != cp->key) {
-            parent = cp;
-            cp = cp->next;
+    /*
+     * Private method: removeSlot
+     * Usage: removeSlot(index);
+     * -------------------------
+     * Removes the entry at the given index by shifting the entries after it
+     * back by one slot, up to the next empty slot or entry already in its
+     * home slot.  This keeps probe sequences short without tombstones.
+     */
+    void removeSlot(int index) {
+        int mask = capacity - 1;
+        int next = (index + 1) & mask;
+        while (slots[next].distance > 1) {
+            slots[index] = std::move(slots[next]);
+            slots[index].distance--;
+            index = next;
+            next = (index + 1) & mask;
         }
-        return cp;
+        slots[index] = Slot();
+        numEntries--;
     }
 
     void deepCopy(const HashMap& src) {
-        createBuckets(src.nBuckets);
-        for (int i = 0; i < src.nBuckets; i++) {
-            // BUGFIX: was just calling put(), which reversed the chains;
-            // now deep-copy the chains exactly as they were to preserve hashcode
-            Cell* endOfChain = NULL;
-            for (Cell* cp = src.buckets.get(i); cp != NULL; cp = cp->next) {
-                // put(cp->key, cp->value);
-                
-                // copy the cell and put at end of bucket list
-                Cell* copy = new Cell();
-                copy->key = cp->key;
-                copy->value = cp->value;
-                copy->next = NULL;
-                if (endOfChain == NULL) {
-                    // first node in bucket
-                    buckets.set(i, copy);
-                } else {
-                    // not first node; put after existing node
-                    endOfChain->next = copy;
-                    endOfChain = copy;
-                }
-                endOfChain = copy;
-                numEntries++;
-            }
+        // copy slot by slot so that the copy iterates in the same order
+        createSlots(src.capacity);
+        for (int i = 0; i < src.capacity; i++) {
+            slots[i] = src.slots[i];
         }
+        numEntries = src.numEntries;
     }
 
 public:
@@ -540,7 +610,7 @@ public:
      */
     HashMap& operator =(const HashMap& src) {
         if (this != &src) {
-            clear();
+            deleteSlots();
             deepCopy(src);
         }
         return *this;
@@ -560,38 +630,34 @@ public:
     class iterator : public std::iterator<std::input_iterator_tag, KeyType> {
     private:
         const HashMap* mp;           /* Pointer to the map           */
-        int bucket;                  /* Index of current bucket      */
-        Cell* cp;                    /* Current cell in bucket chain */
+        int index;                   /* Index of current slot        */
 
     public:
-        iterator() : mp(NULL), bucket(0), cp(0) {
+        iterator() : mp(NULL), index(0) {
             /* Empty */
         }
 
         iterator(const HashMap* mp, bool end) {
             this->mp = mp;
             if (end) {
-                bucket = mp->nBuckets;
-                cp = NULL;
+                index = mp->capacity;
             } else {
-                bucket = 0;
-                cp = mp->buckets.get(bucket);
-                while (cp == NULL && ++bucket < mp->nBuckets) {
-                    cp = mp->buckets.get(bucket);
+                index = 0;
+                while (index < mp->capacity && mp->slots[index].distance == 0) {
+                    index++;
                 }
             }
         }
 
         iterator(const iterator& it) {
             mp = it.mp;
-            bucket = it.bucket;
-            cp = it.cp;
+            index = it.index;
         }
 
         iterator& operator ++() {
-            cp = cp->next;
-            while (cp == NULL && ++bucket < mp->nBuckets) {
-                cp = mp->buckets.get(bucket);
+            index++;
+            while (index < mp->capacity && mp->slots[index].distance == 0) {
+                index++;
             }
             return *this;
         }
@@ -603,7 +669,7 @@ public:
         }
 
         bool operator ==(const iterator& rhs) {
-            return mp == rhs.mp && bucket == rhs.bucket && cp == rhs.cp;
+            return mp == rhs.mp && index == rhs.index;
         }
 
         bool operator !=(const iterator& rhs) {
@@ -611,11 +677,11 @@ public:
         }
 
         KeyType& operator *() {
-            return cp->key;
+            return mp->slots[index].key;
         }
 
         KeyType* operator ->() {
-            return &cp->key;
+            return &mp->slots[index].key;
         }
 
         friend class HashMap;
@@ -640,28 +706,29 @@ public:
  * Implementation notes: HashMap class
  * -----------------------------------
  * In this map implementation, the entries are stored in a hashtable.
- * The hashtable keeps a vector of "buckets", where each bucket is a
- * linked list of elements that share the same hash code (i.e. hash
- * collisions are resolved by chaining). The buckets are dynamically
- * allocated so that we can change the the number of buckets (rehash)
- * when the load factor becomes too high. The map should provide O(1)
- * performance on the put/remove/get operations.
+ * The hashtable is a single array of slots whose size is a power of two,
+ * so a hash code is reduced to a slot index with a mask rather than a
+ * division.  Each entry is stored in the first free slot at or after its
+ * home slot (open addressing), and the Robin Hood rule keeps every entry
+ * close to its home: an entry that has probed further than the one in its
+ * way takes that slot over.  The array is doubled (rehashed) when the
+ * load factor becomes too high.  The map should provide O(1) performance
+ * on the put/remove/get operations.
  */
 template <typename KeyType, typename ValueType>
 HashMap<KeyType, ValueType>::HashMap() {
-    createBuckets(INITIAL_BUCKET_COUNT);
+    createSlots(0);
 }
 
 template <typename KeyType, typename ValueType>
 HashMap<KeyType, ValueType>::HashMap(std::initializer_list<std::pair<KeyType, ValueType> > list) {
-    createBuckets(INITIAL_BUCKET_COUNT);
+    createSlots(0);
     putAll(list);
 }
 
 template <typename KeyType, typename ValueType>
 HashMap<KeyType, ValueType>::~HashMap() {
-    deleteBuckets(buckets);
-    numEntries = 0;
+    deleteSlots();
 }
 
 template <typename KeyType, typename ValueType>
@@ -682,13 +749,12 @@ HashMap<KeyType, ValueType>& HashMap<KeyType, ValueType>::addAll(
 
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::clear() {
-    deleteBuckets(buckets);
-    numEntries = 0;
+    deleteSlots();
 }
 
 template <typename KeyType, typename ValueType>
 bool HashMap<KeyType, ValueType>::containsKey(const KeyType& key) const {
-    return findCell(hashCode(key) % nBuckets, key) != NULL;
+    return findSlot(key, hashOf(key)) >= 0;
 }
 
 template <typename KeyType, typename ValueType>
@@ -698,11 +764,11 @@ bool HashMap<KeyType, ValueType>::equals(const HashMap<KeyType, ValueType>& map2
 
 template <typename KeyType, typename ValueType>
 ValueType HashMap<KeyType, ValueType>::get(const KeyType& key) const {
-    Cell* cp = findCell(hashCode(key) % nBuckets, key);
-    if (cp == NULL) {
+    int index = findSlot(key, hashOf(key));
+    if (index < 0) {
         return ValueType();
     }
-    return cp->value;
+    return slots[index].value;
 }
 
 template <typename KeyType, typename ValueType>
@@ -721,9 +787,9 @@ Vector<KeyType> HashMap<KeyType, ValueType>::keys() const {
 
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::mapAll(void (*fn)(KeyType, ValueType)) const {
-    for (int i = 0; i < buckets.size(); i++) {
-        for (Cell* cp = buckets.get(i); cp != NULL; cp = cp->next) {
-            fn(cp->key, cp->value);
+    for (int i = 0; i < capacity; i++) {
+        if (slots[i].distance != 0) {
+            fn(slots[i].key, slots[i].value);
         }
     }
 }
@@ -731,9 +797,9 @@ void HashMap<KeyType, ValueType>::mapAll(void (*fn)(KeyType, ValueType)) const {
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::mapAll(void (*fn)(const KeyType&,
                                                    const ValueType&)) const {
-    for (int i = 0; i < buckets.size(); i++) {
-        for (Cell* cp = buckets.get(i); cp != NULL; cp = cp->next) {
-            fn(cp->key, cp->value);
+    for (int i = 0; i < capacity; i++) {
+        if (slots[i].distance != 0) {
+            fn(slots[i].key, slots[i].value);
         }
     }
 }
@@ -741,16 +807,27 @@ void HashMap<KeyType, ValueType>::mapAll(void (*fn)(const KeyType&,
 template <typename KeyType, typename ValueType>
 template <typename FunctorType>
 void HashMap<KeyType, ValueType>::mapAll(FunctorType fn) const {
-    for (int i = 0; i < buckets.size(); i++) {
-        for (Cell* cp = buckets.get(i); cp != NULL; cp = cp->next) {
-            fn(cp->key, cp->value);
+    for (int i = 0; i < capacity; i++) {
+        if (slots[i].distance != 0) {
+            fn(slots[i].key, slots[i].value);
         }
     }
 }
 
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::put(const KeyType& key, const ValueType& value) {
-    (*this)[key] = value;
+    unsigned int hash = hashOf(key);
+    int index = findSlot(key, hash);
+    if (index >= 0) {
+        slots[index].value = value;
+    } else {
+        // copy value before any entry moves, since it may be one of them
+        Slot entry;
+        entry.key = key;
+        entry.value = value;
+        entry.hash = hash;
+        addSlot(entry);
+    }
 }
 
 template <typename KeyType, typename ValueType>
@@ -772,27 +849,24 @@ HashMap<KeyType, ValueType>& HashMap<KeyType, ValueType>::putAll(
 
 template <typename KeyType, typename ValueType>
 void HashMap<KeyType, ValueType>::remove(const KeyType& key) {
-    int bucket = hashCode(key) % nBuckets;
-    Cell *parent;
-    Cell* cp = findCell(bucket, key, parent);
-    if (cp != NULL) {
-        if (parent == NULL) {
-            buckets[bucket] = cp->next;
-        } else {
-            parent->next = cp->next;
-        }
-        delete cp;
-        numEntries--;
+    int index = findSlot(key, hashOf(key));
+    if (index >= 0) {
+        removeSlot(index);
     }
 }
 
 template <typename KeyType, typename ValueType>
 HashMap<KeyType, ValueType>& HashMap<KeyType, ValueType>::removeAll(const HashMap& map2) {
+    // collect the keys first, since map2 may be this map
+    Vector<KeyType> toRemove;
     for (KeyType key : map2) {
         if (containsKey(key) && get(key) == map2.get(key)) {
-            remove(key);
+            toRemove.add(key);
         }
     }
+    for (KeyType key : toRemove) {
+        remove(key);
+    }
     return *this;
 }
 
@@ -852,21 +926,15 @@ Vector<ValueType> HashMap<KeyType, ValueType>::values() const {
 
 template <typename KeyType, typename ValueType>
 ValueType& HashMap<KeyType, ValueType>::operator [](const KeyType& key) {
-    int bucket = hashCode(key) % nBuckets;
-    Cell* cp = findCell(bucket, key);
-    if (cp == NULL) {
-        if (numEntries > MAX_LOAD_PERCENTAGE * nBuckets / 100.0) {
-            expandAndRehash();
-            bucket = hashCode(key) % nBuckets;
-        }
-        cp = new Cell;
-        cp->key = key;
-        cp->value = ValueType();
-        cp->next = buckets[bucket];
-        buckets[bucket] = cp;
-        numEntries++;
+    unsigned int hash = hashOf(key);
+    int index = findSlot(key, hash);
+    if (index < 0) {
+        Slot entry;
+        entry.key = key;
+        entry.hash = hash;
+        index = addSlot(entry);
     }
-    return cp->value;
+    return slots[index].value;
 }
 
 template <typename KeyType, typename ValueType>
@@ -0,0 +1,591 @@
+/*
+ * File: indexedpriorityqueue.h
+ * ----------------------------
+ * This file exports the <code>IndexedPriorityQueue</code> class, a
+ * collection in which values are processed in priority order.
+ * Identical to a PriorityQueue except that each value can be in the queue
+ * at most once, and the queue keeps track of where each value is stored.
+ * This lets it change the priority of any value, in either direction, or
+ * remove any value in O(log N) time, where PriorityQueue must search the
+ * whole queue.  This is provided at the memory cost of a hash table of the
+ * values, so the value type must have a hashCode function and == operator.
+ * Graph searches such as Dijkstra's algorithm and A* are the typical use.
+ *
+ * @version 2016/10/14
+ * - initial version
+ * @since 2016/10/14
+ */
+
+#ifndef _indexedpriorityqueue_h
+#define _indexedpriorityqueue_h
+
+#include <initializer_list>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include "error.h"
+#include "hashcode.h"
+#include "hashmap.h"
+#include "strlib.h"
+#include "vector.h"
+
+/*
+ * Class: IndexedPriorityQueue<ValueType>
+ * --------------------------------------
+ * This class models a priority queue, in which values are processed in
+ * order of priority, whose values are all distinct.  As in the
+ * <a href="PriorityQueue-class.html"><code>PriorityQueue</code></a> class,
+ * lower priority numbers correspond to higher effective priorities, and
+ * values with equal priorities are dequeued in the order in which they
+ * were enqueued.
+ *
+ * The optional <code>Arity</code> parameter sets how many children each
+ * node of the underlying heap has.  The default of 4 makes the heap half
+ * as deep as a binary heap, so each operation moves fewer entries and
+ * touches fewer cache lines; <code>IndexedPriorityQueue&lt;T, 2&gt;</code>
+ * is a classic binary heap.
+ */
+template <typename ValueType, int Arity = 4>
+class IndexedPriorityQueue {
+    static_assert(Arity >= 2, "IndexedPriorityQueue: Arity must be at least 2");
+
+public:
+    /*
+     * Constructor: IndexedPriorityQueue
+     * Usage: IndexedPriorityQueue<ValueType> pq;
+     * ------------------------------------------
+     * Initializes a new priority queue, which is initially empty.
+     */
+    IndexedPriorityQueue();
+
+    /*
+     * Constructor: IndexedPriorityQueue
+     * Usage: IndexedPriorityQueue<ValueType> pq {{1.0, "a"}, {2.0, "b"}};
+     * -------------------------------------------------------------------
+     * Initializes a new priority queue that stores the given pairs.
+     * Throws an error if the same value appears more than once.
+     */
+    IndexedPriorityQueue(std::initializer_list<std::pair<double, ValueType> > list);
+
+    /*
+     * Destructor: ~IndexedPriorityQueue
+     * ---------------------------------
+     * Frees any heap storage associated with this priority queue.
+     */
+    virtual ~IndexedPriorityQueue();
+
+    /*
+     * Method: add
+     * Usage: pq.add(value, priority);
+     * -------------------------------
+     * A synonym for the enqueue method.
+     */
+    void add(const ValueType& value, double priority);
+
+    /*
+     * Method: back
+     * Usage: ValueType last = pq.back();
+     * ----------------------------------
+     * Returns the value that would be dequeued last.
+     * Unlike the other methods, this takes O(N) time.
+     */
+    const ValueType& back() const;
+
+    /*
+     * Method: changePriority
+     * Usage: pq.changePriority(value, newPriority);
+     * ---------------------------------------------
+     * Gives <code>value</code> the specified new priority, which may be more
+     * or less urgent than its current priority.  The value keeps its place
+     * in the enqueue order for breaking ties between equal priorities.
+     * Throws an error if the value is not present in the queue.
+     */
+    void changePriority(const ValueType& value, double newPriority);
+
+    /*
+     * Method: clear
+     * Usage: pq.clear();
+     * ------------------
+     * Removes all elements from the priority queue.
+     */
+    void clear();
+
+    /*
+     * Method: contains
+     * Usage: if (pq.contains(value)) ...
+     * ----------------------------------
+     * Returns <code>true</code> if the given value is in the queue.
+     */
+    bool contains(const ValueType& value) const;
+
+    /*
+     * Method: dequeue
+     * Usage: ValueType first = pq.dequeue();
+     * --------------------------------------
+     * Removes and returns the highest priority value.  If multiple
+     * entries in the queue have the same priority, those values are
+     * dequeued in the same order in which they were enqueued.
+     */
+    ValueType dequeue();
+
+    /*
+     * Method: enqueue
+     * Usage: pq.enqueue(value, priority);
+     * -----------------------------------
+     * Adds <code>value</code> to the queue with the specified priority.
+     * Throws an error if the value is already in the queue; use
+     * changePriority to give it a new priority instead.
+     */
+    void enqueue(const ValueType& value, double priority);
+
+    /*
+     * Method: equals
+     * Usage: if (pq.equals(pq2)) ...
+     * ------------------------------
+     * Returns <code>true</code> if this queue contains exactly the same
+     * values and priorities as the given other queue, in the same order.
+     * Identical in behavior to the == operator.
+     */
+    bool equals(const IndexedPriorityQueue& pq2) const;
+
+    /*
+     * Method: front
+     * Usage: ValueType first = pq.front();
+     * ------------------------------------
+     * Returns the value of highest priority in the queue, without
+     * removing it.  A synonym for the peek method.
+     */
+    const ValueType& front() const;
+
+    /*
+     * Method: getPriority
+     * Usage: double priority = pq.getPriority(value);
+     * -----------------------------------------------
+     * Returns the current priority of the given value.
+     * Throws an error if the value is not present in the queue.
+     */
+    double getPriority(const ValueType& value) const;
+
+    /*
+     * Method: isEmpty
+     * Usage: if (pq.isEmpty()) ...
+     * ----------------------------
+     * Returns <code>true</code> if the priority queue contains no elements.
+     */
+    bool isEmpty() const;
+
+    /*
+     * Method: peek
+     * Usage: ValueType first = pq.peek();
+     * -----------------------------------
+     * Returns the value of highest priority in the queue, without
+     * removing it.
+     */
+    const ValueType& peek() const;
+
+    /*
+     * Method: peekPriority
+     * Usage: double priority = pq.peekPriority();
+     * -------------------------------------------
+     * Returns the priority of the first element in the queue, without
+     * removing it.
+     */
+    double peekPriority() const;
+
+    /*
+     * Method: remove
+     * Usage: ValueType first = pq.remove();
+     *        pq.remove(value);
+     * -------------------------------------
+     * The first form is a synonym for the dequeue method.  The second form
+     * removes the given value from the queue, wherever it is; it throws an
+     * error if the value is not present in the queue.
+     */
+    ValueType remove();
+    void remove(const ValueType& value);
+
+    /*
+     * Method: size
+     * Usage: int n = pq.size();
+     * -------------------------
+     * Returns the number of values in the priority queue.
+     */
+    int size() const;
+
+    /*
+     * Method: toString
+     * Usage: string str = pq.toString();
+     * ----------------------------------
+     * Converts the queue to a printable string representation,
+     * such as <code>{1:"a", 2.5:"b"}</code>, in priority order.
+     */
+    std::string toString() const;
+
+    /*
+     * Operators: ==, !=
+     * Usage: if (pq1 == pq2) ...
+     * --------------------------
+     * Relational operators to compare two queues to see if they have the
+     * same elements and priorities.
+     */
+    bool operator ==(const IndexedPriorityQueue& pq2) const;
+    bool operator !=(const IndexedPriorityQueue& pq2) const;
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+    /*
+     * Implementation notes: IndexedPriorityQueue data structure
+     * ---------------------------------------------------------
+     * The queue is a d-ary heap stored in a Vector, in which the children
+     * of the entry at index i are at indexes Arity * i + 1 through
+     * Arity * i + Arity, together with a HashMap from each value to its
+     * index in the heap.  Every time an entry moves, the map is updated to
+     * match, so any value can be found in O(1) time and moved up or down
+     * from there.
+     */
+private:
+    /* Type used for each heap entry */
+    struct HeapEntry {
+        ValueType value;
+        double priority;
+        long sequence;     /* enqueue order, for breaking ties (FIFO) */
+    };
+
+    /* Instance variables */
+    Vector<HeapEntry> heap;
+    HashMap<ValueType, int> indexes;
+    long enqueueCount;
+
+    /* Private function prototypes */
+    static double checkPriority(double priority, const std::string& prefix);
+    int findIndex(const ValueType& value, const std::string& prefix) const;
+    int percolateUp(int index);
+    int percolateDown(int index);
+    void placeEntry(int index, HeapEntry&& entry);
+    void removeAt(int index);
+    static bool takesPriority(const HeapEntry& entry1, const HeapEntry& entry2);
+
+    template <typename T, int A>
+    friend std::ostream& operator <<(std::ostream& os, const IndexedPriorityQueue<T, A>& pq);
+};
+
+template <typename ValueType, int Arity>
+IndexedPriorityQueue<ValueType, Arity>::IndexedPriorityQueue() {
+    clear();
+}
+
+template <typename ValueType, int Arity>
+IndexedPriorityQueue<ValueType, Arity>::IndexedPriorityQueue(
+        std::initializer_list<std::pair<double, ValueType> > list) {
+    clear();
+    for (const std::pair<double, ValueType>& pair : list) {
+        enqueue(pair.second, pair.first);
+    }
+}
+
+template <typename ValueType, int Arity>
+IndexedPriorityQueue<ValueType, Arity>::~IndexedPriorityQueue() {
+    /* Empty */
+}
+
+template <typename ValueType, int Arity>
+void IndexedPriorityQueue<ValueType, Arity>::add(const ValueType& value, double priority) {
+    enqueue(value, priority);
+}
+
+/*
+ * Implementation notes: back
+ * --------------------------
+ * The last value must be in a leaf, and the leaves are the entries after
+ * the parent of the last entry, so only those are examined.
+ */
+template <typename ValueType, int Arity>
+const ValueType& IndexedPriorityQueue<ValueType, Arity>::back() const {
+    if (isEmpty()) {
+        error("IndexedPriorityQueue::back: Attempting to read back of an empty queue");
+    }
+    int last = heap.size() - 1;
+    for (int i = (heap.size() - 2) / Arity + 1; i < heap.size() - 1; i++) {
+        if (takesPriority(heap[last], heap[i])) {
+            last = i;
+        }
+    }
+    return heap[last].value;
+}
+
+template <typename ValueType, int Arity>
+void IndexedPriorityQueue<ValueType, Arity>::changePriority(const ValueType& value, double newPriority) {
+    newPriority = checkPriority(newPriority, "changePriority");
+    int index = findIndex(value, "changePriority");
+    double oldPriority = heap[index].priority;
+    heap[index].priority = newPriority;
+    if (newPriority < oldPriority) {
+        percolateUp(index);
+    } else {
+        percolateDown(index);
+    }
+}
+
+template <typename ValueType, int Arity>
+void IndexedPriorityQueue<ValueType, Arity>::clear() {
+    heap.clear();
+    indexes.clear();
+    enqueueCount = 0;
+}
+
+template <typename ValueType, int Arity>
+bool IndexedPriorityQueue<ValueType, Arity>::contains(const ValueType& value) const {
+    return indexes.containsKey(value);
+}
+
+template <typename ValueType, int Arity>
+ValueType IndexedPriorityQueue<ValueType, Arity>::dequeue() {
+    if (isEmpty()) {
+        error("IndexedPriorityQueue::dequeue: Attempting to dequeue an empty queue");
+    }
+    ValueType value = heap[0].value;
+    removeAt(0);
+    return value;
+}
+
+template <typename ValueType, int Arity>
+void IndexedPriorityQueue<ValueType, Arity>::enqueue(const ValueType& value, double priority) {
+    priority = checkPriority(priority, "enqueue");
+    if (indexes.containsKey(value)) {
+        error("IndexedPriorityQueue::enqueue: Value is already in the queue; use changePriority");
+    }
+    HeapEntry entry = {value, priority, enqueueCount++};
+    heap.add(std::move(entry));
+    percolateUp(heap.size() - 1);
+}
+
+template <typename ValueType, int Arity>
+bool IndexedPriorityQueue<ValueType, Arity>::equals(const IndexedPriorityQueue& pq2) const {
+    if (this == &pq2) {
+        return true;
+    }
+    if (size() != pq2.size()) {
+        return false;
+    }
+    IndexedPriorityQueue<ValueType, Arity> backup1 = *this;
+    IndexedPriorityQueue<ValueType, Arity> backup2 = pq2;
+    while (!backup1.isEmpty()) {
+        if (backup1.peekPriority() != backup2.peekPriority()
+                || !(backup1.dequeue() == backup2.dequeue())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename ValueType, int Arity>
+const ValueType& IndexedPriorityQueue<ValueType, Arity>::front() const {
+    if (isEmpty()) {
+        error("IndexedPriorityQueue::front: Attempting to read front of an empty queue");
+    }
+    return heap[0].value;
+}
+
+template <typename ValueType, int Arity>
+double IndexedPriorityQueue<ValueType, Arity>::getPriority(const ValueType& value) const {
+    return heap[findIndex(value, "getPriority")].priority;
+}
+
+template <typename ValueType, int Arity>
+bool IndexedPriorityQueue<ValueType, Arity>::isEmpty() const {
+    return heap.isEmpty();
+}
+
+template <typename ValueType, int Arity>
+const ValueType& IndexedPriorityQueue<ValueType, Arity>::peek() const {
+    if (isEmpty()) {
+        error("IndexedPriorityQueue::peek: Attempting to peek at an empty queue");
+    }
+    return heap[0].value;
+}
+
+template <typename ValueType, int Arity>
+double IndexedPriorityQueue<ValueType, Arity>::peekPriority() const {
+    if (isEmpty()) {
+        error("IndexedPriorityQueue::peekPriority: Attempting to peek at an empty queue");
+    }
+    return heap[0].priority;
+}
+
+template <typename ValueType, int Arity>
+ValueType IndexedPriorityQueue<ValueType, Arity>::remove() {
+    return dequeue();
+}
+
+template <typename ValueType, int Arity>
+void IndexedPriorityQueue<ValueType, Arity>::remove(const ValueType& value) {
+    removeAt(findIndex(value, "remove"));
+}
+
+template <typename ValueType, int Arity>
+int IndexedPriorityQueue<ValueType, Arity>::size() const {
+    return heap.size();
+}
+
+template <typename ValueType, int Arity>
+std::string IndexedPriorityQueue<ValueType, Arity>::toString() const {
+    std::ostringstream os;
+    os << *this;
+    return os.str();
+}
+
+template <typename ValueType, int Arity>
+bool IndexedPriorityQueue<ValueType, Arity>::operator ==(const IndexedPriorityQueue& pq2) const {
+    return equals(pq2);
+}
+
+template <typename ValueType, int Arity>
+bool IndexedPriorityQueue<ValueType, Arity>::operator !=(const IndexedPriorityQueue& pq2) const {
+    return !equals(pq2);
+}
+
+/*
+ * Rejects NaN priorities, which would break the heap ordering, and turns
+ * -0.0 into 0.0 so that the two compare and print the same way.
+ */
+template <typename ValueType, int Arity>
+double IndexedPriorityQueue<ValueType, Arity>::checkPriority(double priority, const std::string& prefix) {
+    if (!(priority == priority)) {
+        error("IndexedPriorityQueue::" + prefix + ": Attempted to use NaN as a priority.");
+    }
+    return priority == 0 ? 0.0 : priority;
+}
+
+template <typename ValueType, int Arity>
+int IndexedPriorityQueue<ValueType, Arity>::findIndex(const ValueType& value, const std::string& prefix) const {
+    if (!indexes.containsKey(value)) {
+        error("IndexedPriorityQueue::" + prefix + ": Element value not found.");
+    }
+    return indexes.get(value);
+}
+
+/*
+ * Implementation notes: percolateUp, percolateDown
+ * ------------------------------------------------
+ * These move the entry at the given index toward the root or toward the
+ * leaves until it is in heap order with its parent and children, and
+ * return the index at which it ends up.  Rather than swapping the entry
+ * one level at a time, they lift it out of the heap, shift the entries
+ * that are out of order into the hole it leaves, and put it back once,
+ * so each level costs one move and one index update.
+ */
+template <typename ValueType, int Arity>
+int IndexedPriorityQueue<ValueType, Arity>::percolateUp(int index) {
+    HeapEntry entry = std::move(heap[index]);
+    while (index > 0) {
+        int parent = (index - 1) / Arity;
+        if (!takesPriority(entry, heap[parent])) {
+            break;
+        }
+        placeEntry(index, std::move(heap[parent]));
+        index = parent;
+    }
+    placeEntry(index, std::move(entry));
+    return index;
+}
+
+template <typename ValueType, int Arity>
+int IndexedPriorityQueue<ValueType, Arity>::percolateDown(int index) {
+    int count = heap.size();
+    HeapEntry entry = std::move(heap[index]);
+    while (true) {
+        int first = Arity * index + 1;
+        if (first >= count) {
+            break;
+        }
+        int end = first + Arity < count ? first + Arity : count;
+        int child = first;
+        for (int i = first + 1; i < end; i++) {
+            if (takesPriority(heap[i], heap[child])) {
+                child = i;
+            }
+        }
+        if (!takesPriority(heap[child], entry)) {
+            break;
+        }
+        placeEntry(index, std::move(heap[child]));
+        index = child;
+    }
+    placeEntry(index, std::move(entry));
+    return index;
+}
+
+template <typename ValueType, int Arity>
+void IndexedPriorityQueue<ValueType, Arity>::placeEntry(int index, HeapEntry&& entry) {
+    heap[index] = std::move(entry);
+    indexes[heap[index].value] = index;
+}
+
+/*
+ * Implementation notes: removeAt
+ * ------------------------------
+ * The last entry of the heap is moved into the hole left by the removed
+ * one.  It may belong either above or below that spot, so it is
+ * percolated in both directions (at most one of which will move it).
+ */
+template <typename ValueType, int Arity>
+void IndexedPriorityQueue<ValueType, Arity>::removeAt(int index) {
+    int last = heap.size() - 1;
+    indexes.remove(heap[index].value);
+    if (index != last) {
+        heap[index] = std::move(heap[last]);
+    }
+    heap.remove(last);
+    if (index != last) {
+        percolateDown(percolateUp(index));
+    }
+}
+
+template <typename ValueType, int Arity>
+bool IndexedPriorityQueue<ValueType, Arity>::takesPriority(const HeapEntry& entry1,
+                                                           const HeapEntry& entry2) {
+    if (entry1.priority != entry2.priority) {
+        return entry1.priority < entry2.priority;
+    }
+    return entry1.sequence < entry2.sequence;
+}
+
+/*
+ * Template hash function for indexed priority queues.
+ * Requires the element type in the priority queue to have a hashCode function.
+ */
+template <typename T, int Arity>
+int hashCode(const IndexedPriorityQueue<T, Arity>& pq) {
+    IndexedPriorityQueue<T, Arity> backup = pq;
+    int code = hashSeed();
+    while (!backup.isEmpty()) {
+        code = hashMultiplier() * code + hashCode(backup.peek());
+        code = hashMultiplier() * code + hashCode(backup.peekPriority());
+        backup.dequeue();
+    }
+    return int(code & hashMask());
+}
+
+template <typename ValueType, int Arity>
+std::ostream& operator <<(std::ostream& os, const IndexedPriorityQueue<ValueType, Arity>& pq) {
+    os << "{";
+    IndexedPriorityQueue<ValueType, Arity> copy = pq;
+    for (int i = 0, len = pq.size(); i < len; i++) {
+        if (i > 0) {
+            os << ", ";
+        }
+        os << copy.peekPriority() << ":";
+        writeGenericValue(os, copy.dequeue(), /* forceQuotes */ true);
+    }
+    return os << "}";
+}
+
+#include "private/init.h"   // ensure that Stanford C++ lib is initialized
+
+#endif // _indexedpriorityqueue_h
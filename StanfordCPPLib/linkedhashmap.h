@@ -5,10 +5,17 @@
  * a set of <i>key</i>-<i>value</i> pairs.
  * Identical to a HashMap except that upon iteration using a for-each loop
  * or << / toString call, it will emit its key/value pairs in the order they
- * were originally inserted.  This is provided at a runtime and memory
- * cost due to needing to store an extra copy of the keys.
+ * were originally inserted.  This is provided at a small memory cost,
+ * since each entry carries two extra pointers to remember the order.
  * 
  * @author Marty Stepp
+ * @version 2016/10/14
+ * - reimplemented as a chained hash table whose entries are also linked
+ *   in insertion order, so remove takes O(1) time and each key is stored
+ *   only once
+ * - putting a key that is already present no longer lists it twice
+ * - mapAll visits the entries in insertion order
+ * - added non-const operator []
  * @version 2016/09/24
  * - refactored to use collections.h utility functions
  * @version 2016/09/22
@@ -35,13 +42,15 @@
 #include "collections.h"
 #include "error.h"
 #include "hashcode.h"
-#include "hashmap.h"
 #include "vector.h"
 
 /*
  * Class: LinkedHashMap<KeyType,ValueType>
  * ---------------------------------------
- * 
+ * Identical to a HashMap except that upon iteration using a for-each loop
+ * or << / toString call, it will emit its keys in the order they were
+ * originally inserted.  Putting a new value for a key that is already
+ * present does not change the key's position in that order.
  */
 template <typename KeyType, typename ValueType>
 class LinkedHashMap {
@@ -153,11 +162,12 @@ public:
      * Method: keys
      * Usage: Vector<KeyType> keys = map.keys();
      * -----------------------------------------
-     * Returns a collection containing all keys in this map.
-     * This implementation already retains an internal copy of the keys,
-     * so it is efficient to call this function even on large maps.
+     * Returns a collection containing all keys in this map, in the order
+     * they were added.
+     * Note that this implementation makes a deep copy of the keys,
+     * so it is inefficient to call on large maps.
      */
-    const Vector<KeyType>& keys() const;
+    Vector<KeyType> keys() const;
 
     /*
      * Method: mapAll
@@ -264,7 +274,7 @@ public:
      * value.  If key is not present in the map, a new entry is created
      * whose value is set to the default for the value type.
      */
-    // ValueType& operator [](const KeyType& key);
+    ValueType& operator [](const KeyType& key);
     ValueType operator [](const KeyType& key) const;
 
     /*
@@ -385,12 +395,174 @@ public:
     /*
      * Implementation notes:
      * ---------------------
-     * The HashMap class is represented using a hash map along with a
-     * Vector to remember the order of insertion.
-    */
+     * The LinkedHashMap class is represented using a chained hash table
+     * whose entries are also linked into a doubly-linked list in the order
+     * they were added.  Since each entry is allocated on its own and never
+     * moves, the list can link the entries themselves: an entry is found
+     * through its bucket, it is unlinked from its chain and from the list
+     * in constant time, and iteration simply follows the list.
+     */
 private:
-    HashMap<KeyType, ValueType> innerMap;
-    Vector<KeyType> keyVector;
+    /* Constant definitions */
+    static const int INITIAL_BUCKET_COUNT = 16;      // must be a power of two
+    static const int MAX_LOAD_PERCENTAGE = 75;
+
+    /* Type definition for the entries in the table */
+    struct Entry {
+        KeyType key;              /* The key for this entry                     */
+        ValueType value;          /* The value associated with the key          */
+        unsigned int hash;        /* The scrambled hash code of the key         */
+        Entry* chain;             /* Next entry in the same bucket              */
+        Entry* before;            /* Entry added just before this one, or NULL  */
+        Entry* after;             /* Entry added just after this one, or NULL   */
+    };
+
+    /* Instance variables */
+    Entry** buckets;              /* Array of bucket chains, or NULL if none    */
+    int bucketCount;              /* Number of buckets; 0 or a power of two     */
+    int numEntries;               /* Number of entries in the map               */
+    Entry* head;                  /* Oldest entry, where iteration begins       */
+    Entry* tail;                  /* Newest entry                               */
+
+    /* Private methods */
+
+    /*
+     * Private method: hashOf
+     * Usage: unsigned int hash = hashOf(key);
+     * ---------------------------------------
+     * Returns the hashCode for key, scrambled by hashSpread so that every
+     * bit of it affects the low bits that choose a bucket.
+     */
+    static unsigned int hashOf(const KeyType& key) {
+        return hashSpread(hashCode(key));
+    }
+
+    /*
+     * Private method: findEntry
+     * Usage: Entry* entry = findEntry(key);
+     * -------------------------------------
+     * Returns the entry for the given key, or NULL if there is none.
+     */
+    Entry* findEntry(const KeyType& key) const {
+        if (numEntries == 0) {
+            return NULL;
+        }
+        unsigned int hash = hashOf(key);
+        for (Entry* entry = buckets[hash & (bucketCount - 1)]; entry != NULL; entry = entry->chain) {
+            if (entry->hash == hash && entry->key == key) {
+                return entry;
+            }
+        }
+        return NULL;
+    }
+
+    /*
+     * Private method: addEntry
+     * Usage: Entry* entry = addEntry(key, hash, value);
+     * -------------------------------------------------
+     * Adds an entry for a key that is not already in the map, given the
+     * key's scrambled hash code, at the end of the insertion order.
+     */
+    Entry* addEntry(const KeyType& key, unsigned int hash, const ValueType& value) {
+        if ((numEntries + 1) * 100LL > MAX_LOAD_PERCENTAGE * (long long) bucketCount) {
+            expandAndRehash();
+        }
+        Entry*& bucket = buckets[hash & (bucketCount - 1)];
+        Entry* entry = new Entry {key, value, hash, bucket, tail, NULL};
+        bucket = entry;
+        if (tail == NULL) {
+            head = entry;
+        } else {
+            tail->after = entry;
+        }
+        tail = entry;
+        numEntries++;
+        return entry;
+    }
+
+    /*
+     * Private method: removeEntry
+     * Usage: removeEntry(key);
+     * ------------------------
+     * Removes the entry for the given key, if there is one, from its bucket
+     * chain and from the insertion order.
+     */
+    void removeEntry(const KeyType& key) {
+        if (numEntries == 0) {
+            return;
+        }
+        unsigned int hash = hashOf(key);
+        Entry** link = &buckets[hash & (bucketCount - 1)];
+        while (*link != NULL) {
+            Entry* entry = *link;
+            if (entry->hash == hash && entry->key == key) {
+                *link = entry->chain;
+                if (entry->before == NULL) {
+                    head = entry->after;
+                } else {
+                    entry->before->after = entry->after;
+                }
+                if (entry->after == NULL) {
+                    tail = entry->before;
+                } else {
+                    entry->after->before = entry->before;
+                }
+                delete entry;
+                numEntries--;
+                return;
+            }
+            link = &entry->chain;
+        }
+    }
+
+    /*
+     * Private method: expandAndRehash
+     * Usage: expandAndRehash();
+     * -------------------------
+     * Doubles the number of buckets and relinks every entry into the chain
+     * for its new bucket.  The entries themselves, and so the insertion
+     * order, are left as they are.
+     */
+    void expandAndRehash() {
+        delete[] buckets;
+        bucketCount = (bucketCount == 0) ? INITIAL_BUCKET_COUNT : bucketCount * 2;
+        buckets = new Entry*[bucketCount]();
+        for (Entry* entry = head; entry != NULL; entry = entry->after) {
+            Entry*& bucket = buckets[entry->hash & (bucketCount - 1)];
+            entry->chain = bucket;
+            bucket = entry;
+        }
+    }
+
+    /*
+     * Private method: deleteEntries
+     * Usage: deleteEntries();
+     * -----------------------
+     * Frees every entry and the bucket array, leaving the map empty.
+     */
+    void deleteEntries() {
+        Entry* entry = head;
+        while (entry != NULL) {
+            Entry* next = entry->after;
+            delete entry;
+            entry = next;
+        }
+        delete[] buckets;
+        buckets = NULL;
+        bucketCount = 0;
+        numEntries = 0;
+        head = tail = NULL;
+    }
+
+    void deepCopy(const LinkedHashMap& src) {
+        buckets = NULL;
+        bucketCount = 0;
+        numEntries = 0;
+        head = tail = NULL;
+        for (Entry* entry = src.head; entry != NULL; entry = entry->after) {
+            addEntry(entry->key, entry->hash, entry->value);
+        }
+    }
 
 public:
     /*
@@ -402,6 +574,25 @@ public:
      * difficult to understand for the average client.
      */
 
+    /*
+     * Deep copying support
+     * --------------------
+     * This copy constructor and operator= are defined to make a
+     * deep copy, making it possible to pass/return maps by value
+     * and assign from one map to another.
+     */
+    LinkedHashMap& operator =(const LinkedHashMap& src) {
+        if (this != &src) {
+            deleteEntries();
+            deepCopy(src);
+        }
+        return *this;
+    }
+
+    LinkedHashMap(const LinkedHashMap& src) {
+        deepCopy(src);
+    }
+
     /*
      * Iterator support
      * ----------------
@@ -409,46 +600,88 @@ public:
      * iterators so that they work symmetrically with respect to the
      * corresponding STL classes.
      */
-    class iterator : public Vector<KeyType>::iterator {
+    class iterator : public std::iterator<std::input_iterator_tag, KeyType> {
+    private:
+        Entry* entry;                /* Current entry, or NULL at the end */
+
     public:
-        iterator() : Vector<KeyType>::iterator() {}
-        iterator(const iterator& it) : Vector<KeyType>::iterator(it) {}
-        iterator(const typename Vector<KeyType>::iterator& it) : Vector<KeyType>::iterator(it) {}
+        iterator() : entry(NULL) {
+            /* Empty */
+        }
+
+        iterator(Entry* entry) : entry(entry) {
+            /* Empty */
+        }
+
+        iterator& operator ++() {
+            entry = entry->after;
+            return *this;
+        }
+
+        iterator operator ++(int) {
+            iterator copy(*this);
+            operator++();
+            return copy;
+        }
+
+        bool operator ==(const iterator& rhs) {
+            return entry == rhs.entry;
+        }
+
+        bool operator !=(const iterator& rhs) {
+            return !(*this == rhs);
+        }
+
+        KeyType& operator *() {
+            return entry->key;
+        }
+
+        KeyType* operator ->() {
+            return &entry->key;
+        }
     };
 
     /*
      * Returns an iterator positioned at the first key of the map.
      */
     iterator begin() const {
-        return iterator(keyVector.begin());
+        return iterator(head);
     }
 
     /*
      * Returns an iterator positioned at the last key of the map.
      */
     iterator end() const {
-        return iterator(keyVector.end());
+        return iterator(NULL);
     }
 };
 
 /*
  * Implementation notes: LinkedHashMap class
  * -----------------------------------------
- * ...
+ * The bucket array is not allocated until the first entry is added, so
+ * an empty map costs no more than its instance variables.
  */
 template <typename KeyType, typename ValueType>
 LinkedHashMap<KeyType, ValueType>::LinkedHashMap() {
-    // empty
+    buckets = NULL;
+    bucketCount = 0;
+    numEntries = 0;
+    head = tail = NULL;
 }
 
 template <typename KeyType, typename ValueType>
 LinkedHashMap<KeyType, ValueType>::LinkedHashMap(std::initializer_list<std::pair<KeyType, ValueType> > list) {
+    buckets = NULL;
+    bucketCount = 0;
+    numEntries = 0;
+    head = tail = NULL;
     putAll(list);
 }
 
 template <typename KeyType, typename ValueType>
 LinkedHashMap<KeyType, ValueType>::~LinkedHashMap() {
-    // empty
+    deleteEntries();
 }
 
 template <typename KeyType, typename ValueType>
@@ -469,13 +702,12 @@ LinkedHashMap<KeyType, ValueType>& LinkedHashMap<KeyType, ValueType>::addAll(
 
 template <typename KeyType, typename ValueType>
 void LinkedHashMap<KeyType, ValueType>::clear() {
-    innerMap.clear();
-    keyVector.clear();
+    deleteEntries();
 }
 
 template <typename KeyType, typename ValueType>
 bool LinkedHashMap<KeyType, ValueType>::containsKey(const KeyType& key) const {
-    return innerMap.containsKey(key);
+    return findEntry(key) != NULL;
 }
 
 template <typename KeyType, typename ValueType>
@@ -485,40 +717,55 @@ bool LinkedHashMap<KeyType, ValueType>::equals(const LinkedHashMap<KeyType, Valu
 
 template <typename KeyType, typename ValueType>
 ValueType LinkedHashMap<KeyType, ValueType>::get(const KeyType& key) const {
-    return innerMap.get(key);
+    Entry* entry = findEntry(key);
+    return (entry == NULL) ? ValueType() : entry->value;
 }
 
 template <typename KeyType, typename ValueType>
 bool LinkedHashMap<KeyType, ValueType>::isEmpty() const {
-    return innerMap.isEmpty();
+    return numEntries == 0;
 }
 
 template <typename KeyType, typename ValueType>
-const Vector<KeyType>& LinkedHashMap<KeyType, ValueType>::keys() const {
-    return keyVector;
+Vector<KeyType> LinkedHashMap<KeyType, ValueType>::keys() const {
+    Vector<KeyType> keyset;
+    for (Entry* entry = head; entry != NULL; entry = entry->after) {
+        keyset.add(entry->key);
+    }
+    return keyset;
 }
 
 template <typename KeyType, typename ValueType>
 void LinkedHashMap<KeyType, ValueType>::mapAll(void (*fn)(KeyType, ValueType)) const {
-    innerMap.mapAll(fn);
+    for (Entry* entry = head; entry != NULL; entry = entry->after) {
+        fn(entry->key, entry->value);
+    }
 }
 
 template <typename KeyType, typename ValueType>
 void LinkedHashMap<KeyType, ValueType>::mapAll(void (*fn)(const KeyType&,
                                                    const ValueType&)) const {
-    innerMap.mapAll(fn);
+    for (Entry* entry = head; entry != NULL; entry = entry->after) {
+        fn(entry->key, entry->value);
+    }
 }
 
 template <typename KeyType, typename ValueType>
 template <typename FunctorType>
 void LinkedHashMap<KeyType, ValueType>::mapAll(FunctorType fn) const {
-    innerMap.mapAll(fn);
+    for (Entry* entry = head; entry != NULL; entry = entry->after) {
+        fn(entry->key, entry->value);
+    }
 }
 
 template <typename KeyType, typename ValueType>
 void LinkedHashMap<KeyType, ValueType>::put(const KeyType& key, const ValueType& value) {
-    innerMap.put(key, value);
-    keyVector.add(key);
+    Entry* entry = findEntry(key);
+    if (entry == NULL) {
+        addEntry(key, hashOf(key), value);
+    } else {
+        entry->value = value;
+    }
 }
 
 template <typename KeyType, typename ValueType>
@@ -540,22 +787,21 @@ LinkedHashMap<KeyType, ValueType>& LinkedHashMap<KeyType, ValueType>::putAll(
 
 template <typename KeyType, typename ValueType>
 void LinkedHashMap<KeyType, ValueType>::remove(const KeyType& key) {
-    innerMap.remove(key);
-    for (int i = 0, sz = keyVector.size(); i < sz; i++) {
-        if (keyVector[i] == key) {
-            keyVector.remove(i);
-            break;
-        }
-    }
+    removeEntry(key);
 }
 
 template <typename KeyType, typename ValueType>
 LinkedHashMap<KeyType, ValueType>& LinkedHashMap<KeyType, ValueType>::removeAll(const LinkedHashMap& map2) {
+    // collect the keys first, since map2 may be this map
+    Vector<KeyType> toRemove;
     for (KeyType key : map2) {
         if (containsKey(key) && get(key) == map2.get(key)) {
-            remove(key);
+            toRemove.add(key);
         }
     }
+    for (KeyType key : toRemove) {
+        remove(key);
+    }
     return *this;
 }
 
@@ -594,7 +840,7 @@ LinkedHashMap<KeyType, ValueType>& LinkedHashMap<KeyType, ValueType>::retainAll(
 
 template <typename KeyType, typename ValueType>
 int LinkedHashMap<KeyType, ValueType>::size() const {
-    return innerMap.size();
+    return numEntries;
 }
 
 template <typename KeyType, typename ValueType>
@@ -607,15 +853,24 @@ std::string LinkedHashMap<KeyType, ValueType>::toString() const {
 template <typename KeyType, typename ValueType>
 Vector<ValueType> LinkedHashMap<KeyType, ValueType>::values() const {
     Vector<ValueType> values;
-    for (KeyType key : *this) {
-        values.add(get(key));
+    for (Entry* entry = head; entry != NULL; entry = entry->after) {
+        values.add(entry->value);
     }
     return values;
 }
 
+template <typename KeyType, typename ValueType>
+ValueType& LinkedHashMap<KeyType, ValueType>::operator [](const KeyType& key) {
+    Entry* entry = findEntry(key);
+    if (entry == NULL) {
+        entry = addEntry(key, hashOf(key), ValueType());
+    }
+    return entry->value;
+}
+
 template <typename KeyType, typename ValueType>
 ValueType LinkedHashMap<KeyType, ValueType>::operator [](const KeyType& key) const {
-    return innerMap[key];
+    return get(key);
 }
 
 template <typename KeyType, typename ValueType>
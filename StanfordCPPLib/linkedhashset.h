@@ -5,6 +5,10 @@
  * implements an efficient abstraction for storing sets of values.
  * 
  * @author Marty Stepp
+ * @version 2016/10/14
+ * - remove now takes O(1) time, since LinkedHashMap links its entries
+ *   in insertion order directly
+ * - fixed iterator operator -> to return a pointer to the element
  * @version 2016/09/24
  * - refactored to use collections.h utility functions
  * @version 2016/09/22
@@ -36,8 +40,8 @@
  * -------------------------------
  * Identical to a HashSet except that upon iteration using a for-each loop
  * or << / toString call, it will emit its elements in the order they were
- * originally inserted.  This is provided at a runtime and memory
- * cost due to needing to store an extra copy of the elements.
+ * originally inserted.  This is provided at a small memory cost,
+ * since each element carries two extra pointers to remember the order.
  */
 template <typename ValueType>
 class LinkedHashSet {
@@ -452,7 +456,7 @@ public:
         }
 
         ValueType* operator ->() {
-            return mapit;
+            return &*mapit;
         }
     };
 
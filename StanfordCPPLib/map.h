@@ -4,6 +4,12 @@
  * This file exports the template class <code>Map</code>, which
  * maintains a collection of <i>key</i>-<i>value</i> pairs.
  * 
+ * @version 2016/10/14
+ * - nodes are allocated from an Arena, per map or shared among maps
+ * - added range constructor and fromSorted, which build the tree from
+ *   sorted input in linear time
+ * - putAll, removeAll and retainAll merge two maps of similar size in
+ *   linear time
  * @version 2016/09/24
  * - refactored to use collections.h utility functions
  * @version 2016/09/22
@@ -31,10 +37,15 @@
 #ifndef _map_h
 #define _map_h
 
+#include <algorithm>
 #include <cstdlib>
 #include <initializer_list>
 #include <map>
+#include <new>
+#include <type_traits>
 #include <utility>
+#include <vector>
+#include "arena.h"
 #include "collections.h"
 #include "error.h"
 #include "hashcode.h"
@@ -71,6 +82,31 @@ public:
      */
     Map(std::initializer_list<std::pair<KeyType, ValueType> > list);
 
+    /*
+     * Constructor: Map
+     * Usage: Map<KeyType,ValueType> map(begin, end);
+     * ----------------------------------------------
+     * Initializes a new map that stores the key/value pairs in the range
+     * from <code>begin</code> up to <code>end</code>, such as the elements
+     * of a <code>std::map</code> or a vector of <code>std::pair</code>.
+     * If a key appears more than once, its last value is kept.
+     * Pairs that are already in ascending order of their keys are linked
+     * into a balanced tree in linear time; others are sorted first.
+     */
+    template <typename InputIterator>
+    Map(InputIterator begin, InputIterator end);
+
+    /*
+     * Constructor: Map
+     * Usage: Map<KeyType,ValueType> map(arena);
+     * -----------------------------------------
+     * Initializes a new empty map that allocates its entries from the given
+     * arena, which may be shared with other maps and sets, rather than from
+     * an arena of its own.  The arena must outlive the map.
+     * See arena.h for details.
+     */
+    explicit Map(Arena& arena);
+
     /*
      * Destructor: ~Map
      * ----------------
@@ -96,7 +132,7 @@ public:
      * replace the one from this map.
      * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
      * Returns a reference to this map.
-     * Identical in behavior to putAll.
+     * Identical in behavior to putAll, including its cost.
      */
     Map& addAll(const Map& map2);
     Map& addAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
@@ -127,6 +163,20 @@ public:
      */
     bool equals(const Map& map2) const;
 
+    /*
+     * Method: fromSorted
+     * Usage: Map<KeyType,ValueType> map = Map<KeyType,ValueType>::fromSorted(begin, end);
+     * -----------------------------------------------------------------------------------
+     * Returns a new map holding the key/value pairs in the range from
+     * <code>begin</code> up to <code>end</code>, which must be in ascending
+     * order of their keys, as when they are read from a sorted file.
+     * The map is built in time proportional to its size.  If a key appears
+     * more than once, its last value is kept.  Throws an error if the keys
+     * are out of order.
+     */
+    template <typename InputIterator>
+    static Map fromSorted(InputIterator begin, InputIterator end);
+
     /*
      * Method: get
      * Usage: ValueType value = map.get(key);
@@ -189,6 +239,8 @@ public:
      * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
      * Returns a reference to this map.
      * Identical in behavior to addAll.
+     * When map2 is not much smaller than this map, the two are merged in
+     * a single pass over both, in time proportional to their total size.
      */
     Map& putAll(const Map& map2);
     Map& putAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
@@ -210,6 +262,7 @@ public:
      * mapping will not be removed.
      * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
      * Returns a reference to this map.
+     * Like putAll, this merges the two maps in linear time when that is faster.
      */
     Map& removeAll(const Map& map2);
     Map& removeAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
@@ -223,6 +276,7 @@ public:
      * mapping will be removed.
      * You can also pass an initializer list of pairs such as {{"a", 1}, {"b", 2}, {"c", 3}}.
      * Returns a reference to this map.
+     * Like putAll, this merges the two maps in linear time when that is faster.
      */
     Map& retainAll(const Map& map2);
     Map& retainAll(std::initializer_list<std::pair<KeyType, ValueType> > list);
@@ -397,6 +451,17 @@ public:
      * The map class is represented using a binary search tree.  The
      * specific implementation used here is the classic AVL algorithm
      * developed by Georgii Adel'son-Vel'skii and Evgenii Landis in 1962.
+     *
+     * Nodes are allocated from an Arena rather than one at a time with new.
+     * Removed nodes are kept on a free list and reused by later puts.
+     * Clearing or destroying a map that owns its arena releases the whole
+     * arena at once; its nodes are visited only if their keys or values
+     * need destructors.  A map that shares an arena cannot release it, so
+     * clear puts its nodes on its free list instead.
+     *
+     * Bulk operations avoid the AVL insertion algorithm altogether when
+     * they can.  The entries are laid out in key order in an array, which
+     * is then linked into a perfectly balanced tree in linear time.
      */
 
 private:
@@ -414,6 +479,11 @@ private:
         int bf;                  /* AVL balance factor                  */
     };
 
+    /* Type used to link nodes on the free list after they are destroyed */
+    struct FreeNode {
+        FreeNode* next;
+    };
+
     /*
      * Implementation notes: Comparator
      * --------------------------------
@@ -464,6 +534,13 @@ private:
     BSTNode*root;                   /* Pointer to the root of the tree */
     int nodeCount;                  /* Number of entries in the map    */
     Comparator* cmpp;               /* Pointer to the comparator       */
+    Arena ownArena;                 /* Node memory, unless shared      */
+    Arena* arena;                   /* Arena that nodes come from      */
+    FreeNode* freeNodes;            /* Removed nodes, ready for reuse  */
+
+    /* Sets build their maps from ranges of elements */
+    template <typename T>
+    friend class Set;
 
     /* Private methods */
 
@@ -504,9 +581,7 @@ private:
     ValueType* addNode(BSTNode*& t, const KeyType& key, bool& heightFlag) {
         heightFlag = false;
         if (t == NULL)  {
-            t = new BSTNode();
-            t->key = key;
-            t->value = ValueType();
+            t = createNode(key, ValueType());
             t->bf = BST_IN_BALANCE;
             t->left = t->right = NULL;
             heightFlag = true;
@@ -580,12 +655,12 @@ private:
         BSTNode* toDelete = t;
         if (t->left == NULL) {
             t = t->right;
-            delete toDelete;
+            destroyNode(toDelete);
             nodeCount--;
             return true;
         } else if (t->right == NULL) {
             t = t->left;
-            delete toDelete;
+            destroyNode(toDelete);
             nodeCount--;
             return true;
         } else {
@@ -725,16 +800,59 @@ private:
         t = child;
     }
 
+    /*
+     * Implementation notes: createNode(key, value), destroyNode(t)
+     * ------------------------------------------------------------
+     * These construct a node in memory from the free list or the arena,
+     * and destroy a node and put its memory on the free list.
+     */
+    BSTNode* createNode(const KeyType& key, const ValueType& value) {
+        void* memory;
+        if (freeNodes != NULL) {
+            memory = freeNodes;
+            freeNodes = freeNodes->next;
+        } else {
+            memory = arena->allocate(sizeof(BSTNode), alignof(BSTNode));
+        }
+        return new (memory) BSTNode {key, value, NULL, NULL, BST_IN_BALANCE};
+    }
+
+    void destroyNode(BSTNode* t) {
+        t->~BSTNode();
+        freeNodes = new (static_cast<void*>(t)) FreeNode {freeNodes};
+    }
+
     /*
      * Implementation notes: deleteTree(t)
      * -----------------------------------
-     * Deletes all the nodes in the tree.
+     * Deletes all the nodes in the tree.  If the map owns its arena, the
+     * caller releases the arena afterward, so nodes that need no destructor
+     * are not even visited.
      */
     void deleteTree(BSTNode* t) {
+        if (arena != &ownArena) {
+            recycleTree(t);
+        } else {
+            if (!std::is_trivially_destructible<BSTNode>::value) {
+                destroyTree(t);
+            }
+            freeNodes = NULL;
+        }
+    }
+
+    void destroyTree(BSTNode* t) {
         if (t != NULL) {
-            deleteTree(t->left);
-            deleteTree(t->right);
-            delete t;
+            destroyTree(t->left);
+            destroyTree(t->right);
+            t->~BSTNode();
+        }
+    }
+
+    void recycleTree(BSTNode* t) {
+        if (t != NULL) {
+            recycleTree(t->left);
+            recycleTree(t->right);
+            destroyNode(t);
         }
     }
 
@@ -779,15 +897,205 @@ private:
         if (t == NULL) {
             return NULL;
         }
-        BSTNode* np = new BSTNode;
-        np->key = t->key;
-        np->value = t->value;
+        BSTNode* np = createNode(t->key, t->value);
         np->bf = t->bf;
         np->left = copyTree(t->left);
         np->right = copyTree(t->right);
         return np;
     }
 
+    /*
+     * Functors that pick the key and value out of a std::pair.  They return
+     * the pair's own members, whose types may differ from KeyType and
+     * ValueType; any conversion happens where the result is passed on, so
+     * that the converted temporary lasts until that call returns.
+     */
+    struct PairKey {
+        template <typename PairType>
+        const typename PairType::first_type& operator ()(const PairType& pair) const {
+            return pair.first;
+        }
+    };
+
+    struct PairValue {
+        template <typename PairType>
+        const typename PairType::second_type& operator ()(const PairType& pair) const {
+            return pair.second;
+        }
+    };
+
+    /*
+     * Implementation notes: buildTree(begin, end, keyOf, valueOf, caller)
+     * -------------------------------------------------------------------
+     * Fills this empty map from the range [begin, end), taking the key and
+     * value of each element from the keyOf and valueOf functors.  The nodes
+     * are created in input order while checking whether the keys ascend;
+     * if they do not, the nodes are sorted, or, if caller is not NULL, an
+     * error is reported on its behalf.  A stable sort keeps repeated keys
+     * in input order, so that the last of them is the one kept.
+     */
+    template <typename InputIterator, typename KeyOf, typename ValueOf>
+    void buildTree(InputIterator begin, InputIterator end,
+                   KeyOf keyOf, ValueOf valueOf, const char* caller) {
+        std::vector<BSTNode*> nodes;
+        bool sorted = true;
+        for (; begin != end; ++begin) {
+            auto&& element = *begin;
+            BSTNode* np = createNode(keyOf(element), valueOf(element));
+            if (sorted && !nodes.empty() && cmpp->lessThan(np->key, nodes.back()->key)) {
+                sorted = false;
+            }
+            nodes.push_back(np);
+        }
+        if (!sorted) {
+            if (caller != NULL) {
+                for (BSTNode* np : nodes) {
+                    destroyNode(np);
+                }
+                error(std::string(caller) + ": keys are not in ascending order");
+            }
+            Comparator& cmp = getComparator();
+            std::stable_sort(nodes.begin(), nodes.end(), [&cmp](BSTNode* n1, BSTNode* n2) {
+                return cmp.lessThan(n1->key, n2->key);
+            });
+        }
+        int count = 0;
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (i + 1 < nodes.size() && !cmpp->lessThan(nodes[i]->key, nodes[i + 1]->key)) {
+                destroyNode(nodes[i]);
+            } else {
+                nodes[count++] = nodes[i];
+            }
+        }
+        int height;
+        root = linkTree(nodes, 0, count, height);
+        nodeCount = count;
+    }
+
+    /*
+     * Implementation notes: linkTree(nodes, start, end, height)
+     * ---------------------------------------------------------
+     * Links nodes[start] through nodes[end - 1], which are in ascending
+     * order of their keys, into a perfectly balanced tree and returns its
+     * root, setting height to the height of the tree.  The middle node is
+     * the root; when the count is even, the left half gets the extra node,
+     * so each balance factor is either in balance or left heavy.
+     */
+    static BSTNode* linkTree(const std::vector<BSTNode*>& nodes, int start, int end,
+                             int& height) {
+        if (start == end) {
+            height = 0;
+            return NULL;
+        }
+        int mid = start + (end - start) / 2;
+        int leftHeight;
+        int rightHeight;
+        BSTNode* np = nodes[mid];
+        np->left = linkTree(nodes, start, mid, leftHeight);
+        np->right = linkTree(nodes, mid + 1, end, rightHeight);
+        np->bf = rightHeight - leftHeight;
+        height = std::max(leftHeight, rightHeight) + 1;
+        return np;
+    }
+
+    /*
+     * Implementation notes: listNodes(t, nodes)
+     * -----------------------------------------
+     * Appends the nodes of the tree rooted at t to nodes in key order.
+     */
+    static void listNodes(BSTNode* t, std::vector<BSTNode*>& nodes) {
+        if (t != NULL) {
+            listNodes(t->left, nodes);
+            nodes.push_back(t);
+            listNodes(t->right, nodes);
+        }
+    }
+
+    /*
+     * Implementation notes: shouldMerge(other, updates)
+     * -------------------------------------------------
+     * Returns true if merging other into this map is expected to be faster
+     * than making the given number of separate updates, each of which
+     * descends about log2 N levels of the tree; one step of a merge costs
+     * about as much as one level of a descent.  A merge walks both maps
+     * in key order, so they must be ordered alike, which is known only if
+     * both use the default comparator.
+     */
+    bool shouldMerge(const Map& other, int updates) const {
+        if (!hasDefaultOrder() || !other.hasDefaultOrder()) {
+            return false;
+        }
+        int total = nodeCount + other.nodeCount;
+        int depth = 0;
+        for (int n = total; n > 0; n /= 2) {
+            depth++;
+        }
+        return (long) updates * depth > total;
+    }
+
+    bool hasDefaultOrder() const {
+        return dynamic_cast<TemplateComparator<std::less<KeyType> >*>(cmpp) != NULL;
+    }
+
+    /*
+     * Implementation notes: mergeTree(other, keepUnmatched, addUnmatched, keepMatched)
+     * --------------------------------------------------------------------------------
+     * Merges other into this map in a single pass over both, like the merge
+     * step of mergesort, and then links the result into a balanced tree.
+     * A key found only in this map is kept if keepUnmatched is true, and one
+     * found only in other is copied in if addUnmatched is true.  For a key
+     * in both maps, keepMatched(mine, theirs) says whether to keep this
+     * map's node and may update its value.
+     */
+    template <typename MatchFn>
+    void mergeTree(const Map& other, bool keepUnmatched, bool addUnmatched,
+                   MatchFn keepMatched) {
+        std::vector<BSTNode*> mine;
+        std::vector<BSTNode*> theirs;
+        mine.reserve(nodeCount);
+        theirs.reserve(other.nodeCount);
+        listNodes(root, mine);
+        listNodes(other.root, theirs);
+        std::vector<BSTNode*> merged;
+        merged.reserve(mine.size() + (addUnmatched ? theirs.size() : 0));
+        size_t i = 0;
+        size_t j = 0;
+        while (i < mine.size() || j < theirs.size()) {
+            int sign;
+            if (i == mine.size()) {
+                sign = +1;
+            } else if (j == theirs.size()) {
+                sign = -1;
+            } else {
+                sign = compareKeys(mine[i]->key, theirs[j]->key);
+            }
+            if (sign < 0) {
+                if (keepUnmatched) {
+                    merged.push_back(mine[i]);
+                } else {
+                    destroyNode(mine[i]);
+                }
+                i++;
+            } else if (sign > 0) {
+                if (addUnmatched) {
+                    merged.push_back(createNode(theirs[j]->key, theirs[j]->value));
+                }
+                j++;
+            } else {
+                if (keepMatched(mine[i], theirs[j])) {
+                    merged.push_back(mine[i]);
+                } else {
+                    destroyNode(mine[i]);
+                }
+                i++;
+                j++;
+            }
+        }
+        int height;
+        root = linkTree(merged, 0, (int) merged.size(), height);
+        nodeCount = (int) merged.size();
+    }
+
 public:
     /*
      * Hidden features
@@ -804,6 +1112,8 @@ public:
         root = NULL;
         nodeCount = 0;
         cmpp = new TemplateComparator<CompareType>(cmp);
+        arena = &ownArena;
+        freeNodes = NULL;
     }
 
     /*
@@ -837,7 +1147,7 @@ public:
         return *this;
     }
 
-    Map(const Map& src) {
+    Map(const Map& src) : arena(&ownArena), freeNodes(NULL) {
         deepCopy(src);
     }
 
@@ -958,6 +1268,8 @@ Map<KeyType, ValueType>::Map() {
     root = NULL;
     nodeCount = 0;
     cmpp = new TemplateComparator<std::less<KeyType> >(std::less<KeyType>());
+    arena = &ownArena;
+    freeNodes = NULL;
 }
 
 template <typename KeyType, typename ValueType>
@@ -965,7 +1277,29 @@ Map<KeyType, ValueType>::Map(std::initializer_list<std::pair<KeyType, ValueType>
     root = NULL;
     nodeCount = 0;
     cmpp = new TemplateComparator<std::less<KeyType> >(std::less<KeyType>());
-    putAll(list);
+    arena = &ownArena;
+    freeNodes = NULL;
+    buildTree(list.begin(), list.end(), PairKey(), PairValue(), /* caller */ NULL);
+}
+
+template <typename KeyType, typename ValueType>
+template <typename InputIterator>
+Map<KeyType, ValueType>::Map(InputIterator begin, InputIterator end) {
+    root = NULL;
+    nodeCount = 0;
+    cmpp = new TemplateComparator<std::less<KeyType> >(std::less<KeyType>());
+    arena = &ownArena;
+    freeNodes = NULL;
+    buildTree(begin, end, PairKey(), PairValue(), /* caller */ NULL);
+}
+
+template <typename KeyType, typename ValueType>
+Map<KeyType, ValueType>::Map(Arena& arena) {
+    root = NULL;
+    nodeCount = 0;
+    cmpp = new TemplateComparator<std::less<KeyType> >(std::less<KeyType>());
+    this->arena = &arena;
+    freeNodes = NULL;
 }
 
 template <typename KeyType, typename ValueType>
@@ -1001,6 +1335,7 @@ void Map<KeyType, ValueType>::clear() {
     deleteTree(root);
     root = NULL;
     nodeCount = 0;
+    ownArena.release();
 }
 
 template <typename KeyType, typename ValueType>
@@ -1013,6 +1348,15 @@ bool Map<KeyType, ValueType>::equals(const Map<KeyType, ValueType>& map2) const
     return stanfordcpplib::collections::equalsMap(*this, map2);
 }
 
+template <typename KeyType, typename ValueType>
+template <typename InputIterator>
+Map<KeyType, ValueType> Map<KeyType, ValueType>::fromSorted(InputIterator begin,
+                                                            InputIterator end) {
+    Map<KeyType, ValueType> map;
+    map.buildTree(begin, end, PairKey(), PairValue(), "Map::fromSorted");
+    return map;
+}
+
 template <typename KeyType, typename ValueType>
 ValueType Map<KeyType, ValueType>::get(const KeyType& key) const {
     ValueType* vp = findNode(root, key);
@@ -1062,6 +1406,14 @@ void Map<KeyType, ValueType>::put(const KeyType& key,
 
 template <typename KeyType, typename ValueType>
 Map<KeyType, ValueType>& Map<KeyType, ValueType>::putAll(const Map& map2) {
+    if (shouldMerge(map2, map2.nodeCount)) {
+        mergeTree(map2, /* keepUnmatched */ true, /* addUnmatched */ true,
+                  [](BSTNode* mine, BSTNode* theirs) -> bool {
+            mine->value = theirs->value;
+            return true;
+        });
+        return *this;
+    }
     for (KeyType key : map2) {
         put(key, map2.get(key));
     }
@@ -1084,11 +1436,23 @@ void Map<KeyType, ValueType>::remove(const KeyType& key) {
 
 template <typename KeyType, typename ValueType>
 Map<KeyType, ValueType>& Map<KeyType, ValueType>::removeAll(const Map& map2) {
+    if (shouldMerge(map2, map2.nodeCount)) {
+        mergeTree(map2, /* keepUnmatched */ true, /* addUnmatched */ false,
+                  [](BSTNode* mine, BSTNode* theirs) -> bool {
+            return !(mine->value == theirs->value);
+        });
+        return *this;
+    }
+    // collect the keys first, since map2 may be this map
+    Vector<KeyType> toRemove;
     for (KeyType key : map2) {
         if (containsKey(key) && get(key) == map2.get(key)) {
-            remove(key);
+            toRemove.add(key);
         }
     }
+    for (KeyType key : toRemove) {
+        remove(key);
+    }
     return *this;
 }
 
@@ -1105,6 +1469,13 @@ Map<KeyType, ValueType>& Map<KeyType, ValueType>::removeAll(
 
 template <typename KeyType, typename ValueType>
 Map<KeyType, ValueType>& Map<KeyType, ValueType>::retainAll(const Map& map2) {
+    if (shouldMerge(map2, nodeCount)) {
+        mergeTree(map2, /* keepUnmatched */ false, /* addUnmatched */ false,
+                  [](BSTNode* mine, BSTNode* theirs) -> bool {
+            return mine->value == theirs->value;
+        });
+        return *this;
+    }
     Vector<KeyType> toRemove;
     for (KeyType key : *this) {
         if (!map2.containsKey(key) || get(key) != map2.get(key)) {
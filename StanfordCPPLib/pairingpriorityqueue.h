@@ -0,0 +1,688 @@
+/*
+ * File: pairingpriorityqueue.h
+ * ----------------------------
+ * This file exports the <code>PairingPriorityQueue</code> class, a
+ * collection in which values are processed in priority order.
+ * It has the same members as IndexedPriorityQueue and the same rules:
+ * each value can be in the queue at most once, and the value type must
+ * have a hashCode function and == operator.  The difference is the data
+ * structure underneath, a pairing heap, which makes enqueue and raising
+ * the priority of a value take O(1) time, at the cost of a slower dequeue.
+ * This suits graph searches that lower the distances of many vertices for
+ * each one they remove.
+ *
+ * @version 2016/10/14
+ * - initial version
+ * @since 2016/10/14
+ */
+
+#ifndef _pairingpriorityqueue_h
+#define _pairingpriorityqueue_h
+
+#include <initializer_list>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include "error.h"
+#include "hashcode.h"
+#include "hashmap.h"
+#include "strlib.h"
+#include "vector.h"
+
+/*
+ * Class: PairingPriorityQueue<ValueType>
+ * --------------------------------------
+ * This class models a priority queue, in which values are processed in
+ * order of priority, whose values are all distinct.  As in the
+ * <a href="PriorityQueue-class.html"><code>PriorityQueue</code></a> class,
+ * lower priority numbers correspond to higher effective priorities, and
+ * values with equal priorities are dequeued in the order in which they
+ * were enqueued.
+ */
+template <typename ValueType>
+class PairingPriorityQueue {
+public:
+    /*
+     * Constructor: PairingPriorityQueue
+     * Usage: PairingPriorityQueue<ValueType> pq;
+     * ------------------------------------------
+     * Initializes a new priority queue, which is initially empty.
+     */
+    PairingPriorityQueue();
+
+    /*
+     * Constructor: PairingPriorityQueue
+     * Usage: PairingPriorityQueue<ValueType> pq {{1.0, "a"}, {2.0, "b"}};
+     * -------------------------------------------------------------------
+     * Initializes a new priority queue that stores the given pairs.
+     * Throws an error if the same value appears more than once.
+     */
+    PairingPriorityQueue(std::initializer_list<std::pair<double, ValueType> > list);
+
+    /*
+     * Destructor: ~PairingPriorityQueue
+     * ---------------------------------
+     * Frees any heap storage associated with this priority queue.
+     */
+    virtual ~PairingPriorityQueue();
+
+    /*
+     * Method: add
+     * Usage: pq.add(value, priority);
+     * -------------------------------
+     * A synonym for the enqueue method.
+     */
+    void add(const ValueType& value, double priority);
+
+    /*
+     * Method: back
+     * Usage: ValueType last = pq.back();
+     * ----------------------------------
+     * Returns the value that would be dequeued last.
+     * Unlike the other methods, this takes O(N) time.
+     */
+    const ValueType& back() const;
+
+    /*
+     * Method: changePriority
+     * Usage: pq.changePriority(value, newPriority);
+     * ---------------------------------------------
+     * Gives <code>value</code> the specified new priority, which may be more
+     * or less urgent than its current priority.  The value keeps its place
+     * in the enqueue order for breaking ties between equal priorities.
+     * Throws an error if the value is not present in the queue.
+     */
+    void changePriority(const ValueType& value, double newPriority);
+
+    /*
+     * Method: clear
+     * Usage: pq.clear();
+     * ------------------
+     * Removes all elements from the priority queue.
+     */
+    void clear();
+
+    /*
+     * Method: contains
+     * Usage: if (pq.contains(value)) ...
+     * ----------------------------------
+     * Returns <code>true</code> if the given value is in the queue.
+     */
+    bool contains(const ValueType& value) const;
+
+    /*
+     * Method: dequeue
+     * Usage: ValueType first = pq.dequeue();
+     * --------------------------------------
+     * Removes and returns the highest priority value.  If multiple
+     * entries in the queue have the same priority, those values are
+     * dequeued in the same order in which they were enqueued.
+     */
+    ValueType dequeue();
+
+    /*
+     * Method: enqueue
+     * Usage: pq.enqueue(value, priority);
+     * -----------------------------------
+     * Adds <code>value</code> to the queue with the specified priority.
+     * Throws an error if the value is already in the queue; use
+     * changePriority to give it a new priority instead.
+     */
+    void enqueue(const ValueType& value, double priority);
+
+    /*
+     * Method: equals
+     * Usage: if (pq.equals(pq2)) ...
+     * ------------------------------
+     * Returns <code>true</code> if this queue contains exactly the same
+     * values and priorities as the given other queue, in the same order.
+     * Identical in behavior to the == operator.
+     */
+    bool equals(const PairingPriorityQueue& pq2) const;
+
+    /*
+     * Method: front
+     * Usage: ValueType first = pq.front();
+     * ------------------------------------
+     * Returns the value of highest priority in the queue, without
+     * removing it.  A synonym for the peek method.
+     */
+    const ValueType& front() const;
+
+    /*
+     * Method: getPriority
+     * Usage: double priority = pq.getPriority(value);
+     * -----------------------------------------------
+     * Returns the current priority of the given value.
+     * Throws an error if the value is not present in the queue.
+     */
+    double getPriority(const ValueType& value) const;
+
+    /*
+     * Method: isEmpty
+     * Usage: if (pq.isEmpty()) ...
+     * ----------------------------
+     * Returns <code>true</code> if the priority queue contains no elements.
+     */
+    bool isEmpty() const;
+
+    /*
+     * Method: peek
+     * Usage: ValueType first = pq.peek();
+     * -----------------------------------
+     * Returns the value of highest priority in the queue, without
+     * removing it.
+     */
+    const ValueType& peek() const;
+
+    /*
+     * Method: peekPriority
+     * Usage: double priority = pq.peekPriority();
+     * -------------------------------------------
+     * Returns the priority of the first element in the queue, without
+     * removing it.
+     */
+    double peekPriority() const;
+
+    /*
+     * Method: remove
+     * Usage: ValueType first = pq.remove();
+     *        pq.remove(value);
+     * -------------------------------------
+     * The first form is a synonym for the dequeue method.  The second form
+     * removes the given value from the queue, wherever it is; it throws an
+     * error if the value is not present in the queue.
+     */
+    ValueType remove();
+    void remove(const ValueType& value);
+
+    /*
+     * Method: size
+     * Usage: int n = pq.size();
+     * -------------------------
+     * Returns the number of values in the priority queue.
+     */
+    int size() const;
+
+    /*
+     * Method: toString
+     * Usage: string str = pq.toString();
+     * ----------------------------------
+     * Converts the queue to a printable string representation,
+     * such as <code>{1:"a", 2.5:"b"}</code>, in priority order.
+     */
+    std::string toString() const;
+
+    /*
+     * Operators: ==, !=
+     * Usage: if (pq1 == pq2) ...
+     * --------------------------
+     * Relational operators to compare two queues to see if they have the
+     * same elements and priorities.
+     */
+    bool operator ==(const PairingPriorityQueue& pq2) const;
+    bool operator !=(const PairingPriorityQueue& pq2) const;
+
+    /* Private section */
+
+    /**********************************************************************/
+    /* Note: Everything below this point in the file is logically part    */
+    /* of the implementation and should not be of interest to clients.    */
+    /**********************************************************************/
+
+    /*
+     * Implementation notes: PairingPriorityQueue data structure
+     * ---------------------------------------------------------
+     * A pairing heap is a tree in which every node takes priority over its
+     * children, and a node may have any number of children.  Two trees are
+     * linked by making the root that loses the comparison the first child
+     * of the other, so enqueue just links a new one-node tree to the root.
+     * Dequeue removes the root and links its children back into one tree,
+     * pairing them left to right and then combining the pairs right to
+     * left, which keeps its amortized cost at O(log N).
+     *
+     * Each node points to its first child, its next sibling and its
+     * previous sibling (or its parent, if it is a first child), so that
+     * any node can be cut out of the tree in O(1) time.  A HashMap from
+     * each value to its node finds the node to cut for changePriority
+     * and remove(value).
+     */
+private:
+    /* Type used for each node of the heap */
+    struct HeapNode {
+        ValueType value;
+        double priority;
+        long sequence;     /* enqueue order, for breaking ties (FIFO) */
+        HeapNode* child;
+        HeapNode* next;
+        HeapNode* prev;    /* previous sibling, or parent if first child */
+    };
+
+    /* Instance variables */
+    HeapNode* root;
+    HashMap<ValueType, HeapNode*> nodes;
+    long enqueueCount;
+
+    /* Private function prototypes */
+    static double checkPriority(double priority, const std::string& prefix);
+    static void cut(HeapNode* node);
+    void deepCopy(const PairingPriorityQueue& src);
+    void deleteNodes();
+    HeapNode* findNode(const ValueType& value, const std::string& prefix) const;
+    static HeapNode* link(HeapNode* first, HeapNode* second);
+    static HeapNode* mergePairs(HeapNode* first);
+    void removeNode(HeapNode* node);
+    static bool takesPriority(const HeapNode* node1, const HeapNode* node2);
+
+    template <typename T>
+    friend std::ostream& operator <<(std::ostream& os, const PairingPriorityQueue<T>& pq);
+
+public:
+    /*
+     * Copy constructor and assignment operator
+     * ----------------------------------------
+     * These methods implement deep copying for priority queues.
+     */
+    PairingPriorityQueue(const PairingPriorityQueue& src);
+    PairingPriorityQueue& operator =(const PairingPriorityQueue& src);
+};
+
+template <typename ValueType>
+PairingPriorityQueue<ValueType>::PairingPriorityQueue() {
+    root = nullptr;
+    enqueueCount = 0;
+}
+
+template <typename ValueType>
+PairingPriorityQueue<ValueType>::PairingPriorityQueue(
+        std::initializer_list<std::pair<double, ValueType> > list) {
+    root = nullptr;
+    enqueueCount = 0;
+    for (const std::pair<double, ValueType>& pair : list) {
+        enqueue(pair.second, pair.first);
+    }
+}
+
+template <typename ValueType>
+PairingPriorityQueue<ValueType>::PairingPriorityQueue(const PairingPriorityQueue& src) {
+    root = nullptr;
+    deepCopy(src);
+}
+
+template <typename ValueType>
+PairingPriorityQueue<ValueType>::~PairingPriorityQueue() {
+    deleteNodes();
+}
+
+template <typename ValueType>
+void PairingPriorityQueue<ValueType>::add(const ValueType& value, double priority) {
+    enqueue(value, priority);
+}
+
+/*
+ * Implementation notes: back
+ * --------------------------
+ * The last value must be in a node with no children, but there is no
+ * quick way to find those, so every node in the queue is examined.
+ */
+template <typename ValueType>
+const ValueType& PairingPriorityQueue<ValueType>::back() const {
+    if (isEmpty()) {
+        error("PairingPriorityQueue::back: Attempting to read back of an empty queue");
+    }
+    HeapNode* last = root;
+    for (const ValueType& value : nodes) {
+        HeapNode* node = nodes.get(value);
+        if (takesPriority(last, node)) {
+            last = node;
+        }
+    }
+    return last->value;
+}
+
+/*
+ * Implementation notes: changePriority
+ * ------------------------------------
+ * A node whose priority becomes more urgent still takes priority over its
+ * children, so its whole subtree is cut out and linked back to the root.
+ * A node whose priority becomes less urgent might not, so it is removed
+ * from the tree and enqueued again as a single node.
+ */
+template <typename ValueType>
+void PairingPriorityQueue<ValueType>::changePriority(const ValueType& value, double newPriority) {
+    newPriority = checkPriority(newPriority, "changePriority");
+    HeapNode* node = findNode(value, "changePriority");
+    if (newPriority < node->priority) {
+        node->priority = newPriority;
+        if (node != root) {
+            cut(node);
+            root = link(root, node);
+        }
+    } else if (newPriority > node->priority) {
+        removeNode(node);
+        node->priority = newPriority;
+        node->child = nullptr;
+        root = link(root, node);
+    }
+}
+
+template <typename ValueType>
+void PairingPriorityQueue<ValueType>::clear() {
+    deleteNodes();
+    nodes.clear();
+    enqueueCount = 0;
+}
+
+template <typename ValueType>
+bool PairingPriorityQueue<ValueType>::contains(const ValueType& value) const {
+    return nodes.containsKey(value);
+}
+
+template <typename ValueType>
+ValueType PairingPriorityQueue<ValueType>::dequeue() {
+    if (isEmpty()) {
+        error("PairingPriorityQueue::dequeue: Attempting to dequeue an empty queue");
+    }
+    HeapNode* node = root;
+    removeNode(node);
+    nodes.remove(node->value);
+    ValueType value = std::move(node->value);
+    delete node;
+    return value;
+}
+
+template <typename ValueType>
+void PairingPriorityQueue<ValueType>::enqueue(const ValueType& value, double priority) {
+    priority = checkPriority(priority, "enqueue");
+    if (nodes.containsKey(value)) {
+        error("PairingPriorityQueue::enqueue: Value is already in the queue; use changePriority");
+    }
+    HeapNode* node = new HeapNode {value, priority, enqueueCount++, nullptr, nullptr, nullptr};
+    nodes.put(value, node);
+    root = link(root, node);
+}
+
+template <typename ValueType>
+bool PairingPriorityQueue<ValueType>::equals(const PairingPriorityQueue& pq2) const {
+    if (this == &pq2) {
+        return true;
+    }
+    if (size() != pq2.size()) {
+        return false;
+    }
+    PairingPriorityQueue<ValueType> backup1 = *this;
+    PairingPriorityQueue<ValueType> backup2 = pq2;
+    while (!backup1.isEmpty()) {
+        if (backup1.peekPriority() != backup2.peekPriority()
+                || !(backup1.dequeue() == backup2.dequeue())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename ValueType>
+const ValueType& PairingPriorityQueue<ValueType>::front() const {
+    if (isEmpty()) {
+        error("PairingPriorityQueue::front: Attempting to read front of an empty queue");
+    }
+    return root->value;
+}
+
+template <typename ValueType>
+double PairingPriorityQueue<ValueType>::getPriority(const ValueType& value) const {
+    return findNode(value, "getPriority")->priority;
+}
+
+template <typename ValueType>
+bool PairingPriorityQueue<ValueType>::isEmpty() const {
+    return root == nullptr;
+}
+
+template <typename ValueType>
+const ValueType& PairingPriorityQueue<ValueType>::peek() const {
+    if (isEmpty()) {
+        error("PairingPriorityQueue::peek: Attempting to peek at an empty queue");
+    }
+    return root->value;
+}
+
+template <typename ValueType>
+double PairingPriorityQueue<ValueType>::peekPriority() const {
+    if (isEmpty()) {
+        error("PairingPriorityQueue::peekPriority: Attempting to peek at an empty queue");
+    }
+    return root->priority;
+}
+
+template <typename ValueType>
+ValueType PairingPriorityQueue<ValueType>::remove() {
+    return dequeue();
+}
+
+template <typename ValueType>
+void PairingPriorityQueue<ValueType>::remove(const ValueType& value) {
+    HeapNode* node = findNode(value, "remove");
+    removeNode(node);
+    nodes.remove(value);
+    delete node;
+}
+
+template <typename ValueType>
+int PairingPriorityQueue<ValueType>::size() const {
+    return nodes.size();
+}
+
+template <typename ValueType>
+std::string PairingPriorityQueue<ValueType>::toString() const {
+    std::ostringstream os;
+    os << *this;
+    return os.str();
+}
+
+template <typename ValueType>
+bool PairingPriorityQueue<ValueType>::operator ==(const PairingPriorityQueue& pq2) const {
+    return equals(pq2);
+}
+
+template <typename ValueType>
+bool PairingPriorityQueue<ValueType>::operator !=(const PairingPriorityQueue& pq2) const {
+    return !equals(pq2);
+}
+
+template <typename ValueType>
+PairingPriorityQueue<ValueType>& PairingPriorityQueue<ValueType>::operator =(const PairingPriorityQueue& src) {
+    if (this != &src) {
+        clear();
+        deepCopy(src);
+    }
+    return *this;
+}
+
+/*
+ * Rejects NaN priorities, which would break the heap ordering, and turns
+ * -0.0 into 0.0 so that the two compare and print the same way.
+ */
+template <typename ValueType>
+double PairingPriorityQueue<ValueType>::checkPriority(double priority, const std::string& prefix) {
+    if (!(priority == priority)) {
+        error("PairingPriorityQueue::" + prefix + ": Attempted to use NaN as a priority.");
+    }
+    return priority == 0 ? 0.0 : priority;
+}
+
+/*
+ * Detaches the given node, along with its children, from its parent and
+ * siblings.  The node must not be the root.
+ */
+template <typename ValueType>
+void PairingPriorityQueue<ValueType>::cut(HeapNode* node) {
+    if (node->prev->child == node) {
+        node->prev->child = node->next;
+    } else {
+        node->prev->next = node->next;
+    }
+    if (node->next) {
+        node->next->prev = node->prev;
+    }
+    node->next = nullptr;
+    node->prev = nullptr;
+}
+
+/*
+ * Implementation notes: deepCopy
+ * ------------------------------
+ * The copy does not reproduce the shape of the tree; each value is simply
+ * enqueued again with its original priority and sequence number, which
+ * is all that determines the order in which values come out.
+ */
+template <typename ValueType>
+void PairingPriorityQueue<ValueType>::deepCopy(const PairingPriorityQueue& src) {
+    for (const ValueType& value : src.nodes) {
+        HeapNode* srcNode = src.nodes.get(value);
+        HeapNode* node = new HeapNode {value, srcNode->priority, srcNode->sequence,
+                nullptr, nullptr, nullptr};
+        nodes.put(value, node);
+        root = link(root, node);
+    }
+    enqueueCount = src.enqueueCount;
+}
+
+template <typename ValueType>
+void PairingPriorityQueue<ValueType>::deleteNodes() {
+    for (const ValueType& value : nodes) {
+        delete nodes.get(value);
+    }
+    root = nullptr;
+}
+
+template <typename ValueType>
+typename PairingPriorityQueue<ValueType>::HeapNode*
+PairingPriorityQueue<ValueType>::findNode(const ValueType& value, const std::string& prefix) const {
+    if (!nodes.containsKey(value)) {
+        error("PairingPriorityQueue::" + prefix + ": Element value not found.");
+    }
+    return nodes.get(value);
+}
+
+/*
+ * Combines two trees into one, either of which may be empty, and returns
+ * its root.  The roots passed in must not have siblings.
+ */
+template <typename ValueType>
+typename PairingPriorityQueue<ValueType>::HeapNode*
+PairingPriorityQueue<ValueType>::link(HeapNode* first, HeapNode* second) {
+    if (!first) {
+        return second;
+    } else if (!second) {
+        return first;
+    }
+    if (takesPriority(second, first)) {
+        std::swap(first, second);
+    }
+    second->next = first->child;
+    if (first->child) {
+        first->child->prev = second;
+    }
+    second->prev = first;
+    first->child = second;
+    return first;
+}
+
+/*
+ * Implementation notes: mergePairs
+ * --------------------------------
+ * Links the list of sibling trees starting at the given node into a
+ * single tree, and returns its root.  The first pass links the trees in
+ * pairs and pushes each result onto a stack, threaded through the next
+ * pointers; the second pass pops the stack, which visits the pairs right
+ * to left, linking each into the result.  No recursion is needed, so a
+ * node with very many children cannot overflow the call stack.
+ */
+template <typename ValueType>
+typename PairingPriorityQueue<ValueType>::HeapNode*
+PairingPriorityQueue<ValueType>::mergePairs(HeapNode* first) {
+    HeapNode* pairs = nullptr;
+    while (first) {
+        HeapNode* second = first->next;
+        HeapNode* rest = second ? second->next : nullptr;
+        first->next = nullptr;
+        if (second) {
+            second->next = nullptr;
+        }
+        HeapNode* pair = link(first, second);
+        pair->next = pairs;
+        pairs = pair;
+        first = rest;
+    }
+    HeapNode* result = nullptr;
+    while (pairs) {
+        HeapNode* pair = pairs;
+        pairs = pairs->next;
+        pair->next = nullptr;
+        result = link(result, pair);
+    }
+    if (result) {
+        result->prev = nullptr;
+    }
+    return result;
+}
+
+/*
+ * Takes the given node out of the tree, leaving its children in the
+ * tree in its place.  The node itself is not freed.
+ */
+template <typename ValueType>
+void PairingPriorityQueue<ValueType>::removeNode(HeapNode* node) {
+    HeapNode* children = mergePairs(node->child);
+    if (node == root) {
+        root = children;
+    } else {
+        cut(node);
+        root = link(root, children);
+    }
+    node->child = nullptr;
+}
+
+template <typename ValueType>
+bool PairingPriorityQueue<ValueType>::takesPriority(const HeapNode* node1, const HeapNode* node2) {
+    if (node1->priority != node2->priority) {
+        return node1->priority < node2->priority;
+    }
+    return node1->sequence < node2->sequence;
+}
+
+/*
+ * Template hash function for pairing priority queues.
+ * Requires the element type in the priority queue to have a hashCode function.
+ */
+template <typename T>
+int hashCode(const PairingPriorityQueue<T>& pq) {
+    PairingPriorityQueue<T> backup = pq;
+    int code = hashSeed();
+    while (!backup.isEmpty()) {
+        code = hashMultiplier() * code + hashCode(backup.peek());
+        code = hashMultiplier() * code + hashCode(backup.peekPriority());
+        backup.dequeue();
+    }
+    return int(code & hashMask());
+}
+
+template <typename ValueType>
+std::ostream& operator <<(std::ostream& os, const PairingPriorityQueue<ValueType>& pq) {
+    os << "{";
+    PairingPriorityQueue<ValueType> copy = pq;
+    for (int i = 0, len = pq.size(); i < len; i++) {
+        if (i > 0) {
+            os << ", ";
+        }
+        os << copy.peekPriority() << ":";
+        writeGenericValue(os, copy.dequeue(), /* forceQuotes */ true);
+    }
+    return os << "}";
+}
+
+#include "private/init.h"   // ensure that Stanford C++ lib is initialized
+
+#endif // _pairingpriorityqueue_h
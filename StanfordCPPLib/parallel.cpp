@@ -0,0 +1,324 @@
+/*
+ * File: parallel.cpp
+ * ------------------
+ * This file implements the thread pool behind the functions in parallel.h.
+ *
+ * Implementation notes: work stealing
+ * -----------------------------------
+ * Every parallel operation is built from forkJoin, which runs two pieces
+ * of work and returns when both are done.  The thread calling forkJoin
+ * pushes the second piece onto its own queue of tasks, runs the first
+ * piece itself, and then takes the second piece back off its queue and
+ * runs it too, unless another thread has taken it in the meantime.
+ * Threads with nothing to do take ("steal") tasks from the other end of
+ * other threads' queues, which holds the oldest and so the largest pieces
+ * of work.  Pieces are split in half recursively, so a few steals are
+ * enough to spread a big job over all of the threads, and a thread that
+ * finishes early simply steals more.  A thread whose task has been stolen
+ * steals other work while it waits for that task to finish.
+ *
+ * A thief looks through the queues without taking any pool-wide lock: it
+ * reads a snapshot of the list of queues, which is replaced only when a
+ * queue is added, and locks just the queue it is stealing from.
+ *
+ * The pool's worker threads are started the first time they are needed and
+ * then sleep whenever there is nothing to steal.  A thread from outside
+ * the pool that starts a parallel operation borrows a queue for as long as
+ * the operation runs, and does its share of the work like a worker.
+ */
+
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace stanfordcpplib {
+namespace parallel {
+
+/*
+ * A piece of work forked by one thread, for whichever thread gets to it
+ * first.  Tasks live on the stack of the thread that forked them, which
+ * waits for them to be done before returning.
+ */
+struct Task {
+    const std::function<void()>* fn;
+    std::atomic<bool> done;
+    std::exception_ptr error;   // thrown by fn, to rethrow in the forking thread
+};
+
+/*
+ * The tasks forked by one thread.  The thread pushes and pops tasks at the
+ * back; other threads steal from the front.
+ */
+struct WorkQueue {
+    std::mutex lock;
+    std::deque<Task*> tasks;
+    bool inUse;                 // lent to a thread outside the pool
+};
+
+/* The queue of the thread that is running, or NULL if it has none */
+static thread_local WorkQueue* currentQueue = NULL;
+
+class Pool {
+public:
+    Pool() : stealList(new std::vector<WorkQueue*>()), workerCount(0),
+             activeWorkers(0), pending(0), sleeping(0) {
+        unsigned int cores = std::thread::hardware_concurrency();
+        setThreadCount(cores > 0 ? (int) cores : 1);
+    }
+
+    int getThreadCount() const {
+        return activeWorkers + 1;
+    }
+
+    /*
+     * Uses the given number of threads, counting the thread that starts
+     * each operation, starting more workers if needed.  Extra workers are
+     * not stopped, but sleep until the count goes back up.
+     */
+    void setThreadCount(int threadCount) {
+        std::lock_guard<std::mutex> registry(registryLock);
+        while (workerCount < threadCount - 1) {
+            WorkQueue* queue = new WorkQueue();
+            queue->inUse = true;
+            addQueue(queue);
+            std::thread(&Pool::workerLoop, this, queue, workerCount).detach();
+            workerCount++;
+        }
+        activeWorkers = threadCount - 1;
+        std::lock_guard<std::mutex> lock(sleepLock);
+        wakeUp.notify_all();
+    }
+
+    /*
+     * Lends a queue to a thread from outside the pool.  Queues are reused
+     * rather than freed, because other threads may be looking at them.
+     */
+    WorkQueue* borrowQueue() {
+        std::lock_guard<std::mutex> registry(registryLock);
+        for (WorkQueue* queue : queues) {
+            if (!queue->inUse) {
+                queue->inUse = true;
+                return queue;
+            }
+        }
+        WorkQueue* queue = new WorkQueue();
+        queue->inUse = true;
+        addQueue(queue);
+        return queue;
+    }
+
+    void returnQueue(WorkQueue* queue) {
+        std::lock_guard<std::mutex> registry(registryLock);
+        queue->inUse = false;
+    }
+
+    void push(WorkQueue* queue, Task* task) {
+        {
+            std::lock_guard<std::mutex> lock(queue->lock);
+            queue->tasks.push_back(task);
+        }
+        pending++;
+        if (sleeping > 0) {
+            std::lock_guard<std::mutex> lock(sleepLock);
+            wakeUp.notify_one();
+        }
+    }
+
+    /*
+     * Waits for a task forked by this thread to be done, running it here
+     * if no other thread has taken it, or else running other tasks
+     * until it is done.
+     */
+    void join(WorkQueue* queue, Task* task) {
+        bool stolen = true;
+        {
+            std::lock_guard<std::mutex> lock(queue->lock);
+            if (!queue->tasks.empty() && queue->tasks.back() == task) {
+                queue->tasks.pop_back();
+                pending--;
+                stolen = false;
+            }
+        }
+        if (!stolen) {
+            run(task);
+            return;
+        }
+        while (!task->done.load(std::memory_order_acquire)) {
+            Task* other = steal(queue);
+            if (other != NULL) {
+                run(other);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+private:
+    std::mutex registryLock;            // guards queues and workerCount
+    std::vector<WorkQueue*> queues;     // every queue; never shrinks
+    std::atomic<const std::vector<WorkQueue*>*> stealList;   // snapshot of queues
+    int workerCount;                    // worker threads started
+    std::atomic<int> activeWorkers;     // worker threads allowed to steal
+    std::atomic<int> pending;           // tasks waiting in queues
+    std::atomic<int> sleeping;          // workers waiting for tasks
+    std::mutex sleepLock;
+    std::condition_variable wakeUp;
+
+    /*
+     * Adds a new queue and publishes a new snapshot of the queues for
+     * thieves.  Snapshots are never freed, since a thief may still be
+     * reading an old one; there is one per queue ever added, and queues
+     * are only added for new workers or new outside threads.
+     * Must be called with registryLock held.
+     */
+    void addQueue(WorkQueue* queue) {
+        queues.push_back(queue);
+        stealList.store(new std::vector<WorkQueue*>(queues), std::memory_order_release);
+    }
+
+    static void run(Task* task) {
+        try {
+            (*task->fn)();
+        } catch (...) {
+            task->error = std::current_exception();
+        }
+        task->done.store(true, std::memory_order_release);
+    }
+
+    /*
+     * Takes the oldest task from some other thread's queue, or returns NULL
+     * if there are none.  Each thread starts looking at a different queue,
+     * so that thieves spread out.  Only the queue being looked at is locked.
+     */
+    Task* steal(WorkQueue* self) {
+        static thread_local unsigned int start = 0;
+        const std::vector<WorkQueue*>& victims = *stealList.load(std::memory_order_acquire);
+        int count = (int) victims.size();
+        start++;
+        for (int i = 0; i < count; i++) {
+            WorkQueue* queue = victims[(start + i) % count];
+            if (queue == self) {
+                continue;
+            }
+            std::lock_guard<std::mutex> lock(queue->lock);
+            if (!queue->tasks.empty()) {
+                Task* task = queue->tasks.front();
+                queue->tasks.pop_front();
+                pending--;
+                return task;
+            }
+        }
+        return NULL;
+    }
+
+    void workerLoop(WorkQueue* queue, int index) {
+        currentQueue = queue;
+        while (true) {
+            Task* task = (index < activeWorkers) ? steal(queue) : NULL;
+            if (task != NULL) {
+                run(task);
+                continue;
+            }
+            // a thread that pushes a task increments pending before it
+            // checks sleeping, and this thread does the reverse, so at
+            // least one of them sees the other and no wakeup is lost
+            std::unique_lock<std::mutex> lock(sleepLock);
+            sleeping++;
+            wakeUp.wait(lock, [this, index]() {
+                return pending > 0 && index < activeWorkers;
+            });
+            sleeping--;
+        }
+    }
+};
+
+/*
+ * The pool is created when first used and never destroyed, so that its
+ * detached worker threads can never see it freed while the program exits.
+ */
+static Pool& getPool() {
+    static Pool* pool = new Pool();
+    return *pool;
+}
+
+void forkJoin(const std::function<void()>& first, const std::function<void()>& second) {
+    Pool& pool = getPool();
+    if (pool.getThreadCount() <= 1) {
+        first();
+        second();
+        return;
+    }
+
+    WorkQueue* queue = currentQueue;
+    bool borrowed = (queue == NULL);
+    if (borrowed) {
+        queue = pool.borrowQueue();
+        currentQueue = queue;
+    }
+    Task task;
+    task.fn = &second;
+    task.done = false;
+    pool.push(queue, &task);
+    std::exception_ptr firstError;
+    try {
+        first();
+    } catch (...) {
+        firstError = std::current_exception();
+    }
+    // the task is on this stack frame, so wait for it even if first threw
+    pool.join(queue, &task);
+    if (borrowed) {
+        currentQueue = NULL;
+        pool.returnQueue(queue);
+    }
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+    if (task.error) {
+        std::rethrow_exception(task.error);
+    }
+}
+
+void forRange(int begin, int end, int grainSize, const std::function<void(int, int)>& body) {
+    if (end - begin <= grainSize) {
+        if (begin < end) {
+            body(begin, end);
+        }
+        return;
+    }
+    int middle = begin + (end - begin) / 2;
+    forkJoin([&]() { forRange(begin, middle, grainSize, body); },
+             [&]() { forRange(middle, end, grainSize, body); });
+}
+
+int choosePieceSize(int size, int grainSize) {
+    int threadCount = getPool().getThreadCount();
+    if (threadCount <= 1) {
+        return std::max(size, 1);
+    }
+    // split into no more than about 8 pieces per thread, which is plenty
+    // to even out the load
+    int pieces = 8 * threadCount;
+    return std::max(std::max(grainSize, 1), (size + pieces - 1) / pieces);
+}
+
+} // namespace parallel
+} // namespace stanfordcpplib
+
+int getParallelThreadCount() {
+    return stanfordcpplib::parallel::getPool().getThreadCount();
+}
+
+void setParallelThreadCount(int threadCount) {
+    if (threadCount < 1) {
+        error("setParallelThreadCount: thread count must be at least 1, was "
+              + integerToString(threadCount));
+    }
+    stanfordcpplib::parallel::getPool().setThreadCount(threadCount);
+}
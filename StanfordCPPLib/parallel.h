@@ -0,0 +1,335 @@
+/*
+ * File: parallel.h
+ * ----------------
+ * This file exports parallel versions of common operations on the
+ * collection classes, which share the work among all of the processor's
+ * cores instead of running on just one:
+ *
+ *     parallelMapAll(vec, fn);          calls fn on every element
+ *     parallelTransform(vec, fn);       replaces every element x by fn(x)
+ *     n = parallelReduce(vec, 0, add);  combines all of the elements
+ *     parallelSort(vec);                sorts the elements
+ *
+ * The work is done by a pool of threads shared by the whole program, one
+ * per core by default.  Each operation splits the collection into pieces
+ * of at least <code>grainSize</code> elements; a thread that runs out of
+ * work takes a piece that another thread has not started yet, so the
+ * threads stay busy even if some pieces take longer than others.  A
+ * collection of no more than <code>grainSize</code> elements is processed
+ * on the calling thread alone, since starting other threads would cost
+ * more than it saves.  The default grain size suits cheap functions such
+ * as arithmetic on each element; pass a smaller one if each call does a
+ * lot of work, or a larger one if it does very little.
+ *
+ * The functions passed to these operations are called from several threads
+ * at once, in no particular order, so they must not modify data shared
+ * between calls (such as a global counter) without synchronization, and
+ * must not add to or remove from the collection.  If a call throws an
+ * exception, the operation waits for the calls already under way to finish
+ * and then throws it.
+ *
+ * @version 2016/10/14
+ * - initial version
+ * @since 2016/10/14
+ */
+
+#ifndef _parallel_h
+#define _parallel_h
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "error.h"
+#include "grid.h"
+#include "hashmap.h"
+#include "map.h"
+#include "vector.h"
+
+/*
+ * Constant: PARALLEL_DEFAULT_GRAIN_SIZE
+ * -------------------------------------
+ * The default for the smallest number of elements that a parallel
+ * operation hands to a thread at once.
+ */
+const int PARALLEL_DEFAULT_GRAIN_SIZE = 1024;
+
+/*
+ * Function: getParallelThreadCount
+ * Usage: int n = getParallelThreadCount();
+ * ----------------------------------------
+ * Returns the number of threads that parallel operations use, counting the
+ * thread that calls them.  This is the number of cores in the processor
+ * unless it has been changed by setParallelThreadCount.
+ */
+int getParallelThreadCount();
+
+/*
+ * Function: setParallelThreadCount
+ * Usage: setParallelThreadCount(n);
+ * ---------------------------------
+ * Sets the number of threads that parallel operations use, counting the
+ * thread that calls them.  With 1 thread, they run serially.  Signals an
+ * error if the count is less than 1.
+ */
+void setParallelThreadCount(int threadCount);
+
+namespace stanfordcpplib {
+namespace parallel {
+
+/*
+ * Runs first and second, possibly at the same time on different threads,
+ * and returns when both are done.  Rethrows an exception thrown by either.
+ */
+void forkJoin(const std::function<void()>& first, const std::function<void()>& second);
+
+/*
+ * Calls body(begin, end) on pieces of [begin, end) of at most grainSize
+ * indexes, splitting the range between threads.
+ */
+void forRange(int begin, int end, int grainSize, const std::function<void(int, int)>& body);
+
+/*
+ * Returns the size of the pieces in which to process size elements, given
+ * the smallest piece the client asked for.
+ */
+int choosePieceSize(int size, int grainSize);
+
+template <typename ValueType, typename FunctorType>
+void mapElements(const ValueType* elements, int size, FunctorType& fn, int grainSize) {
+    forRange(0, size, choosePieceSize(size, grainSize), [elements, &fn](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            fn(elements[i]);
+        }
+    });
+}
+
+template <typename ValueType, typename FunctorType>
+void transformElements(ValueType* elements, int size, FunctorType& fn, int grainSize) {
+    forRange(0, size, choosePieceSize(size, grainSize), [elements, &fn](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            elements[i] = fn(elements[i]);
+        }
+    });
+}
+
+template <typename ValueType, typename CombineType>
+ValueType reduceElements(const ValueType* elements, int begin, int end,
+                         const ValueType& identity, CombineType& combine, int pieceSize) {
+    if (end - begin <= pieceSize) {
+        ValueType result = identity;
+        for (int i = begin; i < end; i++) {
+            result = combine(result, elements[i]);
+        }
+        return result;
+    }
+    int middle = begin + (end - begin) / 2;
+    ValueType first = identity;
+    ValueType second = identity;
+    forkJoin([&]() { first = reduceElements(elements, begin, middle, identity, combine, pieceSize); },
+             [&]() { second = reduceElements(elements, middle, end, identity, combine, pieceSize); });
+    return combine(first, second);
+}
+
+/*
+ * Merges the sorted runs a[0..aSize) and b[0..bSize) into out, splitting
+ * the work between threads: the middle element of the longer run goes to
+ * its final place, found by binary search in the other run, and the
+ * elements on either side of it are merged in parallel.
+ */
+template <typename ValueType, typename LessType>
+void mergeRuns(ValueType* a, int aSize, ValueType* b, int bSize, ValueType* out,
+               LessType& less, int pieceSize) {
+    if (aSize + bSize <= pieceSize) {
+        std::merge(std::make_move_iterator(a), std::make_move_iterator(a + aSize),
+                   std::make_move_iterator(b), std::make_move_iterator(b + bSize),
+                   out, less);
+        return;
+    }
+    if (aSize < bSize) {
+        std::swap(a, b);
+        std::swap(aSize, bSize);
+    }
+    int aMiddle = aSize / 2;
+    int bMiddle = (int) (std::lower_bound(b, b + bSize, a[aMiddle], less) - b);
+    out[aMiddle + bMiddle] = std::move(a[aMiddle]);
+    forkJoin([&]() {
+                 mergeRuns(a, aMiddle, b, bMiddle, out, less, pieceSize);
+             },
+             [&]() {
+                 mergeRuns(a + aMiddle + 1, aSize - aMiddle - 1, b + bMiddle, bSize - bMiddle,
+                           out + aMiddle + bMiddle + 1, less, pieceSize);
+             });
+}
+
+/*
+ * Sorts elements[0..size) with a parallel merge sort: pieces are sorted
+ * with std::sort, and pairs of sorted halves are merged into buffer and
+ * moved back.
+ */
+template <typename ValueType, typename LessType>
+void sortElements(ValueType* elements, ValueType* buffer, int size,
+                  LessType& less, int pieceSize) {
+    if (size <= pieceSize) {
+        std::sort(elements, elements + size, less);
+        return;
+    }
+    int half = size / 2;
+    forkJoin([&]() { sortElements(elements, buffer, half, less, pieceSize); },
+             [&]() { sortElements(elements + half, buffer + half, size - half, less, pieceSize); });
+    mergeRuns(elements, half, elements + half, size - half, buffer, less, pieceSize);
+    forRange(0, size, pieceSize, [elements, buffer](int begin, int end) {
+        std::move(buffer + begin, buffer + end, elements + begin);
+    });
+}
+
+} // namespace parallel
+} // namespace stanfordcpplib
+
+/*
+ * Function: parallelMapAll
+ * Usage: parallelMapAll(collection, fn);
+ *        parallelMapAll(collection, fn, grainSize);
+ * -------------------------------------------------
+ * Calls the given function on each element of the collection, like the
+ * collection's <code>mapAll</code> method, but from several threads at
+ * once and in no particular order.  For a Map or HashMap, the function is
+ * called with each key and its value.  Any other collection that can be
+ * looped over, such as a Set or Lexicon, has its elements copied into an
+ * array first; Vector and Grid elements are used in place.
+ */
+template <typename ValueType, typename Allocator, typename FunctorType>
+void parallelMapAll(const Vector<ValueType, Allocator>& vec, FunctorType fn,
+                    int grainSize = PARALLEL_DEFAULT_GRAIN_SIZE) {
+    stanfordcpplib::parallel::mapElements(vec.data(), vec.size(), fn, grainSize);
+}
+
+template <typename ValueType, typename FunctorType>
+void parallelMapAll(const Grid<ValueType>& grid, FunctorType fn,
+                    int grainSize = PARALLEL_DEFAULT_GRAIN_SIZE) {
+    stanfordcpplib::parallel::mapElements(grid.data(), grid.size(), fn, grainSize);
+}
+
+template <typename KeyType, typename ValueType, typename FunctorType>
+void parallelMapAll(const Map<KeyType, ValueType>& map, FunctorType fn,
+                    int grainSize = PARALLEL_DEFAULT_GRAIN_SIZE) {
+    std::vector<std::pair<const KeyType*, const ValueType*> > entries;
+    map.mapAll([&entries](const KeyType& key, const ValueType& value) {
+        entries.push_back(std::make_pair(&key, &value));
+    });
+    auto call = [&fn](const std::pair<const KeyType*, const ValueType*>& entry) {
+        fn(*entry.first, *entry.second);
+    };
+    stanfordcpplib::parallel::mapElements(entries.data(), (int) entries.size(), call, grainSize);
+}
+
+template <typename KeyType, typename ValueType, typename FunctorType>
+void parallelMapAll(const HashMap<KeyType, ValueType>& map, FunctorType fn,
+                    int grainSize = PARALLEL_DEFAULT_GRAIN_SIZE) {
+    std::vector<std::pair<const KeyType*, const ValueType*> > entries;
+    map.mapAll([&entries](const KeyType& key, const ValueType& value) {
+        entries.push_back(std::make_pair(&key, &value));
+    });
+    auto call = [&fn](const std::pair<const KeyType*, const ValueType*>& entry) {
+        fn(*entry.first, *entry.second);
+    };
+    stanfordcpplib::parallel::mapElements(entries.data(), (int) entries.size(), call, grainSize);
+}
+
+template <typename CollectionType, typename FunctorType>
+void parallelMapAll(const CollectionType& collection, FunctorType fn,
+                    int grainSize = PARALLEL_DEFAULT_GRAIN_SIZE) {
+    typedef typename std::decay<decltype(*collection.begin())>::type ValueType;
+    Vector<ValueType> elements;
+    for (const ValueType& value : collection) {
+        elements.add(value);
+    }
+    stanfordcpplib::parallel::mapElements(elements.data(), elements.size(), fn, grainSize);
+}
+
+/*
+ * Function: parallelReduce
+ * Usage: double total = parallelReduce(vec, 0.0, [](double a, double b) { return a + b; });
+ * -----------------------------------------------------------------------------------------
+ * Combines all of the elements of the vector or grid into one value using
+ * the given function, which takes two values and returns their
+ * combination, and returns the result.  The threads each combine a piece
+ * of the elements, starting from <code>identity</code>, and then their
+ * results are combined, so the function must be associative (the grouping
+ * of the elements must not matter, as for addition, multiplication, min
+ * and max), and combining <code>identity</code> with any value must give
+ * back that value (0 for addition, 1 for multiplication).  The elements
+ * stay in their order, so the function need not be commutative.  If the
+ * collection is empty, returns <code>identity</code>.
+ */
+template <typename ValueType, typename Allocator, typename IdentityType, typename CombineType>
+ValueType parallelReduce(const Vector<ValueType, Allocator>& vec, const IdentityType& identity,
+                         CombineType combine, int grainSize = PARALLEL_DEFAULT_GRAIN_SIZE) {
+    return stanfordcpplib::parallel::reduceElements(
+            vec.data(), 0, vec.size(), ValueType(identity), combine,
+            stanfordcpplib::parallel::choosePieceSize(vec.size(), grainSize));
+}
+
+template <typename ValueType, typename IdentityType, typename CombineType>
+ValueType parallelReduce(const Grid<ValueType>& grid, const IdentityType& identity,
+                         CombineType combine, int grainSize = PARALLEL_DEFAULT_GRAIN_SIZE) {
+    return stanfordcpplib::parallel::reduceElements(
+            grid.data(), 0, grid.size(), ValueType(identity), combine,
+            stanfordcpplib::parallel::choosePieceSize(grid.size(), grainSize));
+}
+
+/*
+ * Function: parallelSort
+ * Usage: parallelSort(vec);
+ *        parallelSort(vec, less);
+ *        parallelSort(vec, less, grainSize);
+ * ------------------------------------------
+ * Sorts the elements of the vector into ascending order, using the
+ * element type's <code>&lt;</code> operator or the given function, which
+ * returns whether its first argument belongs before its second.  Elements
+ * that are equal may not keep their relative order.  The sort uses a
+ * temporary copy of the vector.
+ */
+template <typename ValueType, typename Allocator, typename LessType>
+void parallelSort(Vector<ValueType, Allocator>& vec, LessType less,
+                  int grainSize = PARALLEL_DEFAULT_GRAIN_SIZE) {
+    int size = vec.size();
+    int piece = stanfordcpplib::parallel::choosePieceSize(size, grainSize);
+    if (size <= piece) {
+        std::sort(vec.data(), vec.data() + size, less);
+        return;
+    }
+    std::vector<ValueType> buffer(vec.data(), vec.data() + size);
+    stanfordcpplib::parallel::sortElements(vec.data(), buffer.data(), size, less, piece);
+}
+
+template <typename ValueType, typename Allocator>
+void parallelSort(Vector<ValueType, Allocator>& vec, int grainSize = PARALLEL_DEFAULT_GRAIN_SIZE) {
+    parallelSort(vec, std::less<ValueType>(), grainSize);
+}
+
+/*
+ * Function: parallelTransform
+ * Usage: parallelTransform(vec, fn);
+ *        parallelTransform(vec, fn, grainSize);
+ * ---------------------------------------------
+ * Replaces each element of the vector or grid with the result of calling
+ * the given function on it, from several threads at once.
+ */
+template <typename ValueType, typename Allocator, typename FunctorType>
+void parallelTransform(Vector<ValueType, Allocator>& vec, FunctorType fn,
+                       int grainSize = PARALLEL_DEFAULT_GRAIN_SIZE) {
+    stanfordcpplib::parallel::transformElements(vec.data(), vec.size(), fn, grainSize);
+}
+
+template <typename ValueType, typename FunctorType>
+void parallelTransform(Grid<ValueType>& grid, FunctorType fn,
+                       int grainSize = PARALLEL_DEFAULT_GRAIN_SIZE) {
+    stanfordcpplib::parallel::transformElements(grid.data(), grid.size(), fn, grainSize);
+}
+
+#include "private/init.h"   // ensure that Stanford C++ lib is initialized
+
+#endif // _parallel_h
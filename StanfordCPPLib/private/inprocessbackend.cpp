@@ -0,0 +1,1179 @@
+/*
+ * File: inprocessbackend.cpp
+ * --------------------------
+ * This file implements the inprocessbackend.h interface.
+ * Each command handler mirrors the Java class of the same name in the
+ * stanford.spl package of the Java back-end, e.g. GObject.setLocation is
+ * handled as GObject_setLocation.java handles it.
+ *
+ * @version 2016/10/14
+ * - initial version
+ */
+
+#include "private/inprocessbackend.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <regex>
+#include <sstream>
+#include "base64.h"
+#include "gevents.h"
+#include "gwindow.h"
+#include "strlib.h"
+#include "private/version.h"
+
+#define __DONT_ENABLE_GRAPHICAL_CONSOLE
+#include "console.h"
+#undef __DONT_ENABLE_GRAPHICAL_CONSOLE
+
+// approximate metrics of the back-end's default fonts, in pixels
+static const double DEFAULT_FONT_SIZE = 12;
+static const double FONT_ASCENT_RATIO = 0.8;
+static const double FONT_DESCENT_RATIO = 0.25;
+static const double FONT_CHAR_WIDTH_RATIO = 0.6;
+
+// how far from a GLine a point may be and still be "on" it (as in acm.graphics)
+static const double LINE_TOLERANCE = 1.5;
+
+// size reported for the (nonexistent) screen
+static const int SCREEN_WIDTH = 1920;
+static const int SCREEN_HEIGHT = 1080;
+
+static const int DEFAULT_BACKGROUND = 0xffffff;
+
+/* Function prototypes */
+
+static void drawLine(Grid<int>& pixels, double x0, double y0, double x1, double y1, int rgb);
+static void drawOval(Grid<int>& pixels, double x, double y, double width, double height,
+                     double start, double sweep, bool pie, int rgb);
+static void fillOval(Grid<int>& pixels, double x, double y, double width, double height,
+                     double start, double sweep, int rgb);
+static void fillPolygon(Grid<int>& pixels, const Vector<double>& points, int rgb);
+static void fillRect(Grid<int>& pixels, double x, double y, double width, double height, int rgb);
+static double fontSize(const std::string& font);
+static bool inSweep(double angle, double start, double sweep);
+static bool readImageSize(const std::string& filename, int& width, int& height);
+static void setPixel(Grid<int>& pixels, int x, int y, int rgb);
+static bool writePng(const Grid<int>& pixels, const std::string& filename);
+
+namespace stanfordcpplib {
+
+InProcessBackEnd::ObjectData::ObjectData()
+        : x(0), y(0), width(0), height(0), corner(0), start(0), sweep(0),
+          visible(true), filled(false), color(0), fillColor(-1),
+          selected(false), enabled(true), editable(true),
+          value(0), majorTickSpacing(0), minorTickSpacing(0),
+          paintLabels(false), paintTicks(false), snapToTicks(false),
+          selectedRow(-1), selectedColumn(-1) {
+    // empty
+}
+
+InProcessBackEnd::WindowData::WindowData()
+        : x(0), y(0), width(0), height(0), visible(false) {
+    // empty
+}
+
+InProcessBackEnd::TimerData::TimerData()
+        : delay(0), running(false), nextTick(0) {
+    // empty
+}
+
+InProcessBackEnd::InProcessBackEnd()
+        : clock(std::time(NULL) * 1000.0) {
+    // empty
+}
+
+bool InProcessBackEnd::isEnabled() {
+#ifdef SPL_INPROCESS_BACKEND
+    return true;
+#else
+    static int __isEnabled = -1;   // -1 means unknown
+    if (__isEnabled < 0) {
+        char* backEnd = getenv("SPL_BACKEND");
+        __isEnabled = (backEnd != NULL && std::string(backEnd) == "inprocess") ? 1 : 0;
+    }
+    return __isEnabled == 1;
+#endif // SPL_INPROCESS_BACKEND
+}
+
+InProcessBackEnd& InProcessBackEnd::instance() {
+    static InProcessBackEnd __instance;
+    return __instance;
+}
+
+void InProcessBackEnd::execute(const std::string& command) {
+    // "#ID command" is a request whose reply must be tagged with that ID
+    std::string line = command;
+    requestTag = "";
+    if (startsWith(line, "#")) {
+        size_t space = line.find(' ');
+        requestTag = line.substr(0, space);
+        line = line.substr(space + 1);
+    }
+
+    TokenScanner scanner(line);
+    scanner.ignoreWhitespace();
+    scanner.scanNumbers();
+    scanner.scanStrings();
+    scanner.addWordCharacters(".");
+    std::string name = scanner.nextToken();
+    scanner.verifyToken("(");
+    if (!executeGObject(name, scanner)
+            && !executeGWindow(name, scanner)
+            && !executeInteractor(name, scanner)
+            && !executeOther(name, scanner)) {
+        // like the Java back-end, ignore commands that need no reply and
+        // have no effect without a display (sounds, console colors, ...)
+    }
+    requestTag = "";
+}
+
+bool InProcessBackEnd::readLine(std::string& line) {
+    if (replies.isEmpty()) {
+        return false;
+    }
+    line = replies.dequeue();
+    return true;
+}
+
+void InProcessBackEnd::renderWindow(const std::string& windowId, Grid<int>& pixels) {
+    WindowData& window = windows[windowId];
+    pixels = window.background;
+    if (objects.containsKey(window.topCompound)) {
+        render(window.topCompound, pixels, 0, 0);
+    }
+}
+
+bool InProcessBackEnd::executeGObject(const std::string& name, TokenScanner& scanner) {
+    if (name == "GRect.create" || name == "GOval.create" || name == "GRoundRect.create"
+            || name == "G3DRect.create" || name == "GArc.create") {
+        std::string id = nextString(scanner);
+        ObjectData& obj = create(id, name.substr(0, name.find('.')));
+        obj.width = nextDouble(scanner);
+        obj.height = nextDouble(scanner);
+        if (name == "GRoundRect.create") {
+            obj.corner = nextDouble(scanner);
+        } else if (name == "GArc.create") {
+            obj.start = nextDouble(scanner);
+            obj.sweep = nextDouble(scanner);
+        }
+    } else if (name == "GLine.create") {
+        ObjectData& obj = create(nextString(scanner), "GLine");
+        obj.x = nextDouble(scanner);
+        obj.y = nextDouble(scanner);
+        obj.width = nextDouble(scanner) - obj.x;
+        obj.height = nextDouble(scanner) - obj.y;
+    } else if (name == "GLabel.create") {
+        ObjectData& obj = create(nextString(scanner), "GLabel");
+        obj.text = nextString(scanner);
+    } else if (name == "GPolygon.create" || name == "GCompound.create") {
+        create(nextString(scanner), name.substr(0, name.find('.')));
+    } else if (name == "GImage.create") {
+        std::string id = nextString(scanner);
+        std::string filename = nextString(scanner);
+        int width, height;
+        if (!readImageSize(filename, width, height)) {
+            replyError("GImage: unable to read image size from " + filename);
+        } else {
+            ObjectData& obj = create(id, "GImage");
+            obj.width = width;
+            obj.height = height;
+            replyDimension(width, height);
+        }
+    } else if (name == "GBufferedImage.create") {
+        ObjectData& obj = create(nextString(scanner), "GBufferedImage");
+        obj.x = nextInt(scanner);
+        obj.y = nextInt(scanner);
+        obj.width = nextInt(scanner);
+        obj.height = nextInt(scanner);
+        obj.pixels.resize((int) obj.height, (int) obj.width);
+        obj.pixels.fill(nextInt(scanner));
+    } else if (name == "GObject.delete") {
+        std::string id = nextString(scanner);
+        detach(id);
+        objects.remove(id);
+    } else if (name == "GObject.remove") {
+        detach(nextString(scanner));
+    } else if (name == "GCompound.add") {
+        std::string compound = nextString(scanner);
+        std::string id = nextString(scanner);
+        detach(id);
+        objects[id].parent = compound;
+        objects[compound].children.add(id);
+    } else if (name == "GObject.sendForward" || name == "GObject.sendToFront"
+               || name == "GObject.sendBackward" || name == "GObject.sendToBack") {
+        std::string id = nextString(scanner);
+        std::string parent = objects[id].parent;
+        if (!parent.empty()) {
+            Vector<std::string>& children = objects[parent].children;
+            int index = 0;
+            while (index < children.size() && children[index] != id) {
+                index++;
+            }
+            if (index < children.size()) {
+                children.remove(index);
+                int newIndex = index;
+                if (name == "GObject.sendForward") {
+                    newIndex = std::min(index + 1, children.size());
+                } else if (name == "GObject.sendToFront") {
+                    newIndex = children.size();
+                } else if (name == "GObject.sendBackward") {
+                    newIndex = std::max(index - 1, 0);
+                } else {
+                    newIndex = 0;
+                }
+                children.insert(newIndex, id);
+            }
+        }
+    } else if (name == "GObject.setLocation") {
+        ObjectData& obj = objects[nextString(scanner)];
+        double x = nextDouble(scanner);
+        double y = nextDouble(scanner);
+        obj.x = x;
+        obj.y = y;
+    } else if (name == "GObject.setSize") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.width = nextDouble(scanner);
+        obj.height = nextDouble(scanner);
+    } else if (name == "GObject.scale") {
+        ObjectData& obj = objects[nextString(scanner)];
+        double sx = nextDouble(scanner);
+        double sy = nextDouble(scanner);
+        obj.width *= sx;
+        obj.height *= sy;
+        for (int i = 0; i + 1 < obj.vertices.size(); i += 2) {
+            obj.vertices[i] *= sx;
+            obj.vertices[i + 1] *= sy;
+        }
+    } else if (name == "GObject.setVisible") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.visible = nextBool(scanner);
+    } else if (name == "GObject.setColor") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.color = convertColorToRGB(nextString(scanner));
+    } else if (name == "GObject.setFillColor") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.fillColor = convertColorToRGB(nextString(scanner));
+    } else if (name == "GObject.setFilled") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.filled = nextBool(scanner);
+    } else if (name == "GObject.getBounds") {
+        GRectangle bounds = getBounds(nextString(scanner));
+        std::ostringstream out;
+        out << "GRectangle(" << bounds.getX() << ", " << bounds.getY() << ", "
+            << bounds.getWidth() << ", " << bounds.getHeight() << ")";
+        reply(out.str());
+    } else if (name == "GObject.contains") {
+        std::string id = nextString(scanner);
+        double x = nextDouble(scanner);
+        double y = nextDouble(scanner);
+        reply(boolToString(objects.containsKey(id) && contains(id, x, y)));
+    } else if (name == "GLine.setStartPoint") {
+        ObjectData& obj = objects[nextString(scanner)];
+        double x = nextDouble(scanner);
+        double y = nextDouble(scanner);
+        obj.width += obj.x - x;
+        obj.height += obj.y - y;
+        obj.x = x;
+        obj.y = y;
+    } else if (name == "GLine.setEndPoint") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.width = nextDouble(scanner) - obj.x;
+        obj.height = nextDouble(scanner) - obj.y;
+    } else if (name == "GArc.setStartAngle") {
+        objects[nextString(scanner)].start = nextDouble(scanner);
+    } else if (name == "GArc.setSweepAngle") {
+        objects[nextString(scanner)].sweep = nextDouble(scanner);
+    } else if (name == "GArc.setFrameRectangle") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.x = nextDouble(scanner);
+        obj.y = nextDouble(scanner);
+        obj.width = nextDouble(scanner);
+        obj.height = nextDouble(scanner);
+    } else if (name == "GPolygon.addVertex") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.vertices.add(nextDouble(scanner));
+        obj.vertices.add(nextDouble(scanner));
+    } else if (name == "GLabel.setFont") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.font = nextString(scanner);
+    } else if (name == "GLabel.setLabel") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.text = nextString(scanner);
+    } else if (name == "GLabel.getFontAscent") {
+        reply(realToString(fontSize(objects[nextString(scanner)].font) * FONT_ASCENT_RATIO));
+    } else if (name == "GLabel.getFontDescent") {
+        reply(realToString(fontSize(objects[nextString(scanner)].font) * FONT_DESCENT_RATIO));
+    } else if (name == "GLabel.getGLabelSize") {
+        GRectangle bounds = getBounds(nextString(scanner));
+        replyDimension(bounds.getWidth(), bounds.getHeight());
+    } else if (name == "GBufferedImage.fill") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.pixels.fill(nextInt(scanner));
+    } else if (name == "GBufferedImage.fillRegion") {
+        ObjectData& obj = objects[nextString(scanner)];
+        double x = nextInt(scanner);
+        double y = nextInt(scanner);
+        double width = nextInt(scanner);
+        double height = nextInt(scanner);
+        fillRect(obj.pixels, x, y, width, height, nextInt(scanner));
+    } else if (name == "GBufferedImage.setRGB") {
+        ObjectData& obj = objects[nextString(scanner)];
+        int x = nextInt(scanner);
+        int y = nextInt(scanner);
+        setPixel(obj.pixels, x, y, nextInt(scanner));
+    } else if (name == "GBufferedImage.resize") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.width = nextInt(scanner);
+        obj.height = nextInt(scanner);
+        obj.pixels.resize((int) obj.height, (int) obj.width, /* retain */ nextBool(scanner));
+    } else if (name == "GBufferedImage.updateAllPixels") {
+        // same encoding as GBufferedImage::fromGrid: 2-byte width and height,
+        // then 3 bytes (R, G, B) per pixel
+        ObjectData& obj = objects[nextString(scanner)];
+        std::string bytes = Base64::decode(nextString(scanner));
+        if (bytes.length() >= 4) {
+            int width = ((bytes[0] & 0xff) << 8) | (bytes[1] & 0xff);
+            int height = ((bytes[2] & 0xff) << 8) | (bytes[3] & 0xff);
+            obj.width = width;
+            obj.height = height;
+            obj.pixels.resize(height, width, /* retain */ false);
+            size_t i = 4;
+            for (int& rgb : obj.pixels) {
+                if (i + 2 < bytes.length()) {
+                    rgb = ((bytes[i] & 0xff) << 16) | ((bytes[i + 1] & 0xff) << 8) | (bytes[i + 2] & 0xff);
+                    i += 3;
+                }
+            }
+        }
+    } else if (name == "GBufferedImage.load") {
+        nextString(scanner);
+        replyError("GBufferedImage.load is not supported by the in-process back-end");
+    } else if (name == "GBufferedImage.save") {
+        ObjectData& obj = objects[nextString(scanner)];
+        std::string filename = nextString(scanner);
+        if (writePng(obj.pixels, filename)) {
+            reply("ok");
+        } else {
+            replyError("unable to write " + filename);
+        }
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool InProcessBackEnd::executeGWindow(const std::string& name, TokenScanner& scanner) {
+    if (name == "GWindow.create") {
+        std::string id = nextString(scanner);
+        WindowData& window = windows[id];
+        window.width = nextDouble(scanner);
+        window.height = nextDouble(scanner);
+        window.topCompound = nextString(scanner);
+        window.visible = nextBool(scanner);
+        window.background.resize((int) window.height, (int) window.width);
+        window.background.fill(DEFAULT_BACKGROUND);
+        reply("ok");
+    } else if (name == "GWindow.delete" || name == "GWindow.close") {
+        windows.remove(nextString(scanner));
+    } else if (name == "GWindow.clear" || name == "GWindow.clearCanvas") {
+        windows[nextString(scanner)].background.fill(DEFAULT_BACKGROUND);
+    } else if (name == "GWindow.draw" || name == "GWindow.drawInBackground") {
+        WindowData& window = windows[nextString(scanner)];
+        std::string id = nextString(scanner);
+        if (objects.containsKey(id)) {
+            render(id, window.background, 0, 0);
+        }
+    } else if (name == "GWindow.setSize" || name == "GWindow.setCanvasSize") {
+        WindowData& window = windows[nextString(scanner)];
+        window.width = nextDouble(scanner);
+        window.height = nextDouble(scanner);
+        Grid<int> old = window.background;
+        window.background.resize((int) window.height, (int) window.width);
+        window.background.fill(DEFAULT_BACKGROUND);
+        for (int row = 0; row < std::min(old.numRows(), window.background.numRows()); row++) {
+            for (int col = 0; col < std::min(old.numCols(), window.background.numCols()); col++) {
+                window.background[row][col] = old[row][col];
+            }
+        }
+    } else if (name == "GWindow.setLocation") {
+        WindowData& window = windows[nextString(scanner)];
+        window.x = nextDouble(scanner);
+        window.y = nextDouble(scanner);
+    } else if (name == "GWindow.setTitle") {
+        WindowData& window = windows[nextString(scanner)];
+        window.title = nextString(scanner);
+    } else if (name == "GWindow.setVisible") {
+        WindowData& window = windows[nextString(scanner)];
+        window.visible = nextBool(scanner);
+    } else if (name == "GWindow.getLocation") {
+        WindowData& window = windows[nextString(scanner)];
+        std::ostringstream out;
+        out << "Point(" << (int) window.x << ", " << (int) window.y << ")";
+        reply(out.str());
+    } else if (name == "GWindow.getSize" || name == "GWindow.getCanvasSize") {
+        WindowData& window = windows[nextString(scanner)];
+        replyDimension((int) window.width, (int) window.height);
+    } else if (name == "GWindow.getRegionSize") {
+        replyDimension(0, 0);
+    } else if (name == "GWindow.getScreenSize") {
+        replyDimension(SCREEN_WIDTH, SCREEN_HEIGHT);
+    } else if (name == "GWindow.getScreenWidth") {
+        reply(integerToString(SCREEN_WIDTH));
+    } else if (name == "GWindow.getScreenHeight") {
+        reply(integerToString(SCREEN_HEIGHT));
+    } else if (name == "GWindow.saveCanvasPixels") {
+        std::string id = nextString(scanner);
+        std::string filename = nextString(scanner);
+        Grid<int> pixels;
+        renderWindow(id, pixels);
+        writePng(pixels, filename);
+    } else if (name == "GEvent.getNextEvent") {
+        fireTimers(nextInt(scanner));
+        reply("___jbe___ack___ ");
+    } else if (name == "GEvent.waitForEvent") {
+        // nothing but timers can produce events here; without a running
+        // timer the program would wait forever
+        int mask = nextInt(scanner);
+        int before = replies.size();
+        fireTimers(mask);
+        if (replies.size() == before) {
+            double next = -1;
+            for (const std::string& id : timers) {
+                if (timers[id].running && (next < 0 || timers[id].nextTick < next)) {
+                    next = timers[id].nextTick;
+                }
+            }
+            if (!(mask & TIMER_EVENT) || next < 0) {
+                replyError("waitForEvent: no such event can occur with the in-process back-end");
+                return true;
+            }
+            clock = next;
+            fireTimers(mask);
+        }
+        reply("___jbe___ack___ ");
+    } else if (name == "GTimer.create") {
+        TimerData& timer = timers[nextString(scanner)];
+        timer.delay = nextDouble(scanner);
+    } else if (name == "GTimer.deleteTimer") {
+        timers.remove(nextString(scanner));
+    } else if (name == "GTimer.startTimer") {
+        TimerData& timer = timers[nextString(scanner)];
+        timer.running = true;
+        timer.nextTick = clock + timer.delay;
+    } else if (name == "GTimer.stopTimer") {
+        timers[nextString(scanner)].running = false;
+    } else if (name == "GTimer.pause") {
+        clock += nextDouble(scanner);
+        reply("ok");
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool InProcessBackEnd::executeInteractor(const std::string& name, TokenScanner& scanner) {
+    if (name == "GButton.create" || name == "GCheckBox.create") {
+        ObjectData& obj = create(nextString(scanner), name.substr(0, name.find('.')));
+        obj.text = nextString(scanner);
+    } else if (name == "GRadioButton.create") {
+        ObjectData& obj = create(nextString(scanner), "GRadioButton");
+        obj.text = nextString(scanner);
+    } else if (name == "GTextField.create") {
+        ObjectData& obj = create(nextString(scanner), "GTextField");
+        obj.width = nextInt(scanner) * DEFAULT_FONT_SIZE * FONT_CHAR_WIDTH_RATIO;
+    } else if (name == "GChooser.create") {
+        create(nextString(scanner), "GChooser");
+    } else if (name == "GSlider.create") {
+        ObjectData& obj = create(nextString(scanner), "GSlider");
+        nextInt(scanner);   // min
+        nextInt(scanner);   // max
+        obj.value = nextInt(scanner);
+    } else if (name == "GTable.create") {
+        ObjectData& obj = create(nextString(scanner), "GTable");
+        int numRows = nextInt(scanner);
+        int numCols = nextInt(scanner);
+        obj.cells.resize(numRows, numCols);
+    } else if (name == "GInteractor.getSize") {
+        ObjectData& obj = objects[nextString(scanner)];
+        replyDimension(obj.width, obj.height);
+    } else if (name == "GInteractor.isEnabled") {
+        reply(boolToString(objects[nextString(scanner)].enabled));
+    } else if (name == "GInteractor.setEnabled") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.enabled = nextBool(scanner);
+    } else if (name == "GCheckBox.isSelected" || name == "GRadioButton.isSelected") {
+        reply(boolToString(objects[nextString(scanner)].selected));
+    } else if (name == "GCheckBox.setSelected" || name == "GRadioButton.setSelected") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.selected = nextBool(scanner);
+    } else if (name == "GTextField.getText") {
+        reply(objects[nextString(scanner)].text);
+    } else if (name == "GTextField.setText") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.text = nextString(scanner);
+    } else if (name == "GTextField.isEditable") {
+        reply(boolToString(objects[nextString(scanner)].editable));
+    } else if (name == "GTextField.setEditable" || name == "GTable.setEditable") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.editable = nextBool(scanner);
+    } else if (name == "GChooser.addItem") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.items.add(nextString(scanner));
+        if (obj.items.size() == 1) {
+            obj.selectedItem = obj.items[0];
+        }
+    } else if (name == "GChooser.getSelectedItem") {
+        reply(objects[nextString(scanner)].selectedItem);
+    } else if (name == "GChooser.setSelectedItem") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.selectedItem = nextString(scanner);
+    } else if (name == "GSlider.getValue") {
+        reply(integerToString(objects[nextString(scanner)].value));
+    } else if (name == "GSlider.setValue") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.value = nextInt(scanner);
+    } else if (name == "GSlider.getMajorTickSpacing") {
+        reply(integerToString(objects[nextString(scanner)].majorTickSpacing));
+    } else if (name == "GSlider.setMajorTickSpacing") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.majorTickSpacing = nextInt(scanner);
+    } else if (name == "GSlider.getMinorTickSpacing") {
+        reply(integerToString(objects[nextString(scanner)].minorTickSpacing));
+    } else if (name == "GSlider.setMinorTickSpacing") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.minorTickSpacing = nextInt(scanner);
+    } else if (name == "GSlider.getPaintLabels") {
+        reply(boolToString(objects[nextString(scanner)].paintLabels));
+    } else if (name == "GSlider.setPaintLabels") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.paintLabels = nextBool(scanner);
+    } else if (name == "GSlider.getPaintTicks") {
+        reply(boolToString(objects[nextString(scanner)].paintTicks));
+    } else if (name == "GSlider.setPaintTicks") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.paintTicks = nextBool(scanner);
+    } else if (name == "GSlider.getSnapToTicks") {
+        reply(boolToString(objects[nextString(scanner)].snapToTicks));
+    } else if (name == "GSlider.setSnapToTicks") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.snapToTicks = nextBool(scanner);
+    } else if (name == "GTable.get") {
+        ObjectData& obj = objects[nextString(scanner)];
+        int row = nextInt(scanner);
+        int column = nextInt(scanner);
+        reply(obj.cells.inBounds(row, column) ? obj.cells[row][column] : "");
+    } else if (name == "GTable.set") {
+        ObjectData& obj = objects[nextString(scanner)];
+        int row = nextInt(scanner);
+        int column = nextInt(scanner);
+        std::string value = nextString(scanner);
+        if (obj.cells.inBounds(row, column)) {
+            obj.cells[row][column] = value;
+        }
+    } else if (name == "GTable.clear") {
+        objects[nextString(scanner)].cells.fill("");
+    } else if (name == "GTable.resize") {
+        ObjectData& obj = objects[nextString(scanner)];
+        int numRows = nextInt(scanner);
+        int numCols = nextInt(scanner);
+        obj.cells.resize(numRows, numCols, /* retain */ true);
+    } else if (name == "GTable.select") {
+        ObjectData& obj = objects[nextString(scanner)];
+        obj.selectedRow = nextInt(scanner);
+        obj.selectedColumn = nextInt(scanner);
+    } else if (name == "GTable.getSelection") {
+        ObjectData& obj = objects[nextString(scanner)];
+        reply(integerToString(obj.selectedRow));
+        reply(integerToString(obj.selectedColumn));
+    } else if (name == "GTable.getColumnWidth") {
+        ObjectData& obj = objects[nextString(scanner)];
+        reply(integerToString(obj.columnWidths.get(nextInt(scanner))));
+    } else if (name == "GTable.setColumnWidth") {
+        ObjectData& obj = objects[nextString(scanner)];
+        int column = nextInt(scanner);
+        obj.columnWidths.put(column, nextInt(scanner));
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool InProcessBackEnd::executeOther(const std::string& name, TokenScanner& scanner) {
+    if (name == "StanfordCppLib.getJbeVersion") {
+        // the newest protocol this stand-in speaks: request IDs, but not
+        // shared pixel memory (pixels are already in this process)
+        reply(STANFORD_JAVA_BACKEND_REQUEST_ID_VERSION);
+    } else if (name == "JBEConsole.print") {
+        std::string str = nextString(scanner);
+        bool isStderr = nextBool(scanner);
+        if (!getConsoleEcho()) {   // else echoConsole has already written it
+            fputs(str.c_str(), isStderr ? stderr : stdout);
+        }
+    } else if (name == "JBEConsole.println") {
+        if (!getConsoleEcho()) {
+            fputs("\n", stdout);
+            fflush(stdout);
+        }
+    } else if (name == "JBEConsole.getLine") {
+        // std::cin may be redirected to the console itself; read stdin directly
+        std::string line;
+        char buffer[1024];
+        bool sawNewline = false;
+        while (!sawNewline && fgets(buffer, sizeof(buffer), stdin)) {
+            line += buffer;
+            sawNewline = endsWith(line, '\n');
+        }
+        if (!sawNewline && line.empty()) {
+            // end of input; like closing the console window
+            std::exit(0);
+        }
+        if (endsWith(line, '\n')) {
+            line.erase(line.length() - 1);
+        }
+        if (endsWith(line, '\r')) {
+            line.erase(line.length() - 1);
+        }
+        reply(line);
+    } else if (name == "Regex.match" || name == "Regex.matchCount"
+               || name == "Regex.matchCountWithLines" || name == "Regex.replace") {
+        std::string s = urlDecode(nextString(scanner));
+        std::string regexp = urlDecode(nextString(scanner));
+        try {
+            std::regex pattern(regexp);
+            if (name == "Regex.match") {
+                reply(boolToString(std::regex_match(s, pattern)));
+            } else if (name == "Regex.replace") {
+                std::string replacement = urlDecode(nextString(scanner));
+                reply(urlEncode(std::regex_replace(s, pattern, replacement)));
+            } else {
+                int count = 0;
+                std::string lines;
+                for (std::sregex_iterator it(s.begin(), s.end(), pattern), end; it != end; ++it) {
+                    count++;
+                    int lineNumber = 1 + (int) std::count(s.begin(), s.begin() + it->position(), '\n');
+                    lines += (lines.empty() ? "" : ",") + integerToString(lineNumber);
+                }
+                reply(name == "Regex.matchCount" ? integerToString(count)
+                                                 : integerToString(count) + ":" + lines);
+            }
+        } catch (const std::regex_error& ex) {
+            replyError(std::string("Regex: ") + ex.what());
+        }
+    } else if (name == "File.openFileDialog" || name == "GFileChooser.showOpenDialog"
+               || name == "GFileChooser.showSaveDialog" || name == "GOptionPane.showInputDialog") {
+        reply("");   // as if the user cancelled
+    } else if (name == "GOptionPane.showConfirmDialog" || name == "GOptionPane.showOptionDialog") {
+        reply("-1");   // JOptionPane.CLOSED_OPTION
+    } else if (name == "GOptionPane.showMessageDialog" || name == "GOptionPane.showTextFileDialog"
+               || name == "DiffImage.compareWindowToImage" || name == "DiffImage.show"
+               || name == "Note.play" || name == "Sound.create"
+               || name == "AutograderUnitTest.setWindowDescriptionText") {
+        reply("ok");
+    } else if (name == "AutograderUnitTest.isChecked") {
+        reply("true");   // all tests start out checked
+    } else if (name == "URL.download") {
+        reply("-1");
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool InProcessBackEnd::nextBool(TokenScanner& scanner) {
+    std::string token = scanner.nextToken();
+    if (token == ",") {
+        token = scanner.nextToken();
+    }
+    return token == "true";
+}
+
+double InProcessBackEnd::nextDouble(TokenScanner& scanner) {
+    std::string token = scanner.nextToken();
+    if (token == ",") {
+        token = scanner.nextToken();
+    }
+    if (token == "-") {
+        token += scanner.nextToken();
+    }
+    return stringToReal(token);
+}
+
+int InProcessBackEnd::nextInt(TokenScanner& scanner) {
+    return (int) nextDouble(scanner);
+}
+
+std::string InProcessBackEnd::nextString(TokenScanner& scanner) {
+    std::string token = scanner.nextToken();
+    if (token == ",") {
+        token = scanner.nextToken();
+    }
+    return scanner.getStringValue(token);
+}
+
+void InProcessBackEnd::reply(const std::string& result) {
+    replies.enqueue("result" + requestTag + ":" + result);
+}
+
+void InProcessBackEnd::replyDimension(double width, double height) {
+    std::ostringstream out;
+    out << "GDimension(" << width << ", " << height << ")";
+    reply(out.str());
+}
+
+void InProcessBackEnd::replyError(const std::string& message) {
+    // the C++ library reports back-end exceptions of this form as errors
+    replies.enqueue("result" + requestTag + ":acm.util.ErrorException: " + message);
+}
+
+InProcessBackEnd::ObjectData& InProcessBackEnd::create(const std::string& id, const std::string& type) {
+    ObjectData& obj = objects[id];
+    obj = ObjectData();
+    obj.type = type;
+    return obj;
+}
+
+void InProcessBackEnd::detach(const std::string& id) {
+    if (!objects.containsKey(id)) {
+        return;
+    }
+    ObjectData& obj = objects[id];
+    if (!obj.parent.empty() && objects.containsKey(obj.parent)) {
+        Vector<std::string>& children = objects[obj.parent].children;
+        for (int i = 0; i < children.size(); i++) {
+            if (children[i] == id) {
+                children.remove(i);
+                break;
+            }
+        }
+    }
+    obj.parent = "";
+}
+
+GRectangle InProcessBackEnd::getBounds(const std::string& id) {
+    ObjectData& obj = objects[id];
+    if (obj.type == "GLine") {
+        return GRectangle(std::min(obj.x, obj.x + obj.width), std::min(obj.y, obj.y + obj.height),
+                          std::fabs(obj.width), std::fabs(obj.height));
+    } else if (obj.type == "GLabel") {
+        double size = fontSize(obj.font);
+        double ascent = size * FONT_ASCENT_RATIO;
+        return GRectangle(obj.x, obj.y - ascent,
+                          obj.text.length() * size * FONT_CHAR_WIDTH_RATIO,
+                          ascent + size * FONT_DESCENT_RATIO);
+    } else if (obj.type == "GPolygon" || obj.type == "GCompound") {
+        bool empty = true;
+        double x1 = 0, y1 = 0, x2 = 0, y2 = 0;
+        if (obj.type == "GPolygon") {
+            for (int i = 0; i + 1 < obj.vertices.size(); i += 2) {
+                double vx = obj.vertices[i];
+                double vy = obj.vertices[i + 1];
+                x1 = empty ? vx : std::min(x1, vx);
+                y1 = empty ? vy : std::min(y1, vy);
+                x2 = empty ? vx : std::max(x2, vx);
+                y2 = empty ? vy : std::max(y2, vy);
+                empty = false;
+            }
+        } else {
+            for (const std::string& child : obj.children) {
+                GRectangle bounds = getBounds(child);
+                double right = bounds.getX() + bounds.getWidth();
+                double bottom = bounds.getY() + bounds.getHeight();
+                x1 = empty ? bounds.getX() : std::min(x1, bounds.getX());
+                y1 = empty ? bounds.getY() : std::min(y1, bounds.getY());
+                x2 = empty ? right : std::max(x2, right);
+                y2 = empty ? bottom : std::max(y2, bottom);
+                empty = false;
+            }
+        }
+        return GRectangle(obj.x + x1, obj.y + y1, x2 - x1, y2 - y1);
+    } else {
+        return GRectangle(obj.x, obj.y, obj.width, obj.height);
+    }
+}
+
+bool InProcessBackEnd::contains(const std::string& id, double x, double y) {
+    ObjectData& obj = objects[id];
+    if (obj.type == "GOval") {
+        double rx = obj.width / 2;
+        double ry = obj.height / 2;
+        if (rx <= 0 || ry <= 0) {
+            return false;
+        }
+        double dx = (x - obj.x - rx) / rx;
+        double dy = (y - obj.y - ry) / ry;
+        return dx * dx + dy * dy <= 1.0;
+    } else if (obj.type == "GLine") {
+        // distance from the point to the segment
+        double length2 = obj.width * obj.width + obj.height * obj.height;
+        double t = length2 == 0 ? 0
+                : ((x - obj.x) * obj.width + (y - obj.y) * obj.height) / length2;
+        t = std::max(0.0, std::min(1.0, t));
+        double dx = x - (obj.x + t * obj.width);
+        double dy = y - (obj.y + t * obj.height);
+        return std::sqrt(dx * dx + dy * dy) <= LINE_TOLERANCE;
+    } else if (obj.type == "GPolygon") {
+        // even-odd rule
+        bool inside = false;
+        int n = obj.vertices.size() / 2;
+        for (int i = 0, j = n - 1; i < n; j = i++) {
+            double xi = obj.x + obj.vertices[2 * i], yi = obj.y + obj.vertices[2 * i + 1];
+            double xj = obj.x + obj.vertices[2 * j], yj = obj.y + obj.vertices[2 * j + 1];
+            if ((yi > y) != (yj > y) && x < (xj - xi) * (y - yi) / (yj - yi) + xi) {
+                inside = !inside;
+            }
+        }
+        return inside;
+    } else if (obj.type == "GCompound") {
+        for (const std::string& child : obj.children) {
+            if (contains(child, x - obj.x, y - obj.y)) {
+                return true;
+            }
+        }
+        return false;
+    } else {
+        return getBounds(id).contains(x, y);
+    }
+}
+
+void InProcessBackEnd::fireTimers(int mask) {
+    if (!(mask & TIMER_EVENT)) {
+        return;
+    }
+    for (const std::string& id : timers) {
+        TimerData& timer = timers[id];
+        if (timer.running && timer.nextTick <= clock) {
+            std::ostringstream out;
+            out << "event:timerTicked(\"" << id << "\", " << std::fixed << timer.nextTick << ")";
+            replies.enqueue(out.str());
+            timer.nextTick = std::max(timer.nextTick + timer.delay, clock);
+            if (timer.delay <= 0) {
+                timer.nextTick = clock + 1;   // don't tick forever in one call
+            }
+        }
+    }
+}
+
+void InProcessBackEnd::render(const std::string& id, Grid<int>& pixels, double dx, double dy) {
+    ObjectData& obj = objects[id];
+    if (!obj.visible) {
+        return;
+    }
+    double x = obj.x + dx;
+    double y = obj.y + dy;
+    int fill = obj.fillColor == -1 ? obj.color : obj.fillColor;
+    if (obj.type == "GRect" || obj.type == "GRoundRect" || obj.type == "G3DRect") {
+        if (obj.filled) {
+            fillRect(pixels, x, y, obj.width, obj.height, fill);
+        }
+        drawLine(pixels, x, y, x + obj.width, y, obj.color);
+        drawLine(pixels, x + obj.width, y, x + obj.width, y + obj.height, obj.color);
+        drawLine(pixels, x + obj.width, y + obj.height, x, y + obj.height, obj.color);
+        drawLine(pixels, x, y + obj.height, x, y, obj.color);
+    } else if (obj.type == "GOval") {
+        if (obj.filled) {
+            fillOval(pixels, x, y, obj.width, obj.height, 0, 360, fill);
+        }
+        drawOval(pixels, x, y, obj.width, obj.height, 0, 360, false, obj.color);
+    } else if (obj.type == "GArc") {
+        if (obj.filled) {
+            fillOval(pixels, x, y, obj.width, obj.height, obj.start, obj.sweep, fill);
+        }
+        drawOval(pixels, x, y, obj.width, obj.height, obj.start, obj.sweep, obj.filled, obj.color);
+    } else if (obj.type == "GLine") {
+        drawLine(pixels, x, y, x + obj.width, y + obj.height, obj.color);
+    } else if (obj.type == "GPolygon") {
+        Vector<double> points;
+        for (int i = 0; i + 1 < obj.vertices.size(); i += 2) {
+            points.add(x + obj.vertices[i]);
+            points.add(y + obj.vertices[i + 1]);
+        }
+        if (obj.filled) {
+            fillPolygon(pixels, points, fill);
+        }
+        int n = points.size() / 2;
+        for (int i = 0; i < n; i++) {
+            int j = (i + 1) % n;
+            drawLine(pixels, points[2 * i], points[2 * i + 1], points[2 * j], points[2 * j + 1], obj.color);
+        }
+    } else if (obj.type == "GBufferedImage") {
+        for (int row = 0; row < obj.pixels.numRows(); row++) {
+            for (int col = 0; col < obj.pixels.numCols(); col++) {
+                setPixel(pixels, (int) x + col, (int) y + row, obj.pixels[row][col]);
+            }
+        }
+    } else if (obj.type == "GCompound") {
+        for (const std::string& child : obj.children) {
+            render(child, pixels, x, y);
+        }
+    }
+    // GLabel, GImage and interactors are not drawn
+}
+
+} // namespace stanfordcpplib
+
+static void drawLine(Grid<int>& pixels, double x0, double y0, double x1, double y1, int rgb) {
+    // Bresenham's algorithm
+    int ix0 = (int) std::floor(x0), iy0 = (int) std::floor(y0);
+    int ix1 = (int) std::floor(x1), iy1 = (int) std::floor(y1);
+    int dx = std::abs(ix1 - ix0), sx = ix0 < ix1 ? 1 : -1;
+    int dy = -std::abs(iy1 - iy0), sy = iy0 < iy1 ? 1 : -1;
+    int err = dx + dy;
+    while (true) {
+        setPixel(pixels, ix0, iy0, rgb);
+        if (ix0 == ix1 && iy0 == iy1) {
+            break;
+        }
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            ix0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            iy0 += sy;
+        }
+    }
+}
+
+static void drawOval(Grid<int>& pixels, double x, double y, double width, double height,
+                     double start, double sweep, bool pie, int rgb) {
+    // trace the outline as a polyline fine enough to leave no gaps
+    double rx = width / 2, ry = height / 2;
+    double cx = x + rx, cy = y + ry;
+    int steps = std::max(8, (int) (std::fabs(sweep) / 360 * 2 * (width + height)));
+    double prevX = 0, prevY = 0;
+    for (int i = 0; i <= steps; i++) {
+        double angle = (start + sweep * i / steps) * M_PI / 180;
+        double px = cx + rx * std::cos(angle);
+        double py = cy - ry * std::sin(angle);
+        if (i > 0) {
+            drawLine(pixels, prevX, prevY, px, py, rgb);
+        } else if (pie) {
+            drawLine(pixels, cx, cy, px, py, rgb);
+        }
+        prevX = px;
+        prevY = py;
+    }
+    if (pie) {
+        drawLine(pixels, prevX, prevY, cx, cy, rgb);
+    }
+}
+
+static void fillOval(Grid<int>& pixels, double x, double y, double width, double height,
+                     double start, double sweep, int rgb) {
+    double rx = width / 2, ry = height / 2;
+    if (rx <= 0 || ry <= 0) {
+        return;
+    }
+    double cx = x + rx, cy = y + ry;
+    bool whole = std::fabs(sweep) >= 360;
+    for (int row = std::max(0, (int) y); row < std::min(pixels.numRows(), (int) std::ceil(y + height)); row++) {
+        for (int col = std::max(0, (int) x); col < std::min(pixels.numCols(), (int) std::ceil(x + width)); col++) {
+            double dx = (col + 0.5 - cx) / rx;
+            double dy = (row + 0.5 - cy) / ry;
+            if (dx * dx + dy * dy <= 1.0
+                    && (whole || inSweep(std::atan2(-dy, dx) * 180 / M_PI, start, sweep))) {
+                pixels[row][col] = rgb;
+            }
+        }
+    }
+}
+
+static void fillPolygon(Grid<int>& pixels, const Vector<double>& points, int rgb) {
+    // even-odd scanline fill, sampling at pixel centers
+    int n = points.size() / 2;
+    for (int row = 0; row < pixels.numRows(); row++) {
+        double py = row + 0.5;
+        Vector<double> crossings;
+        for (int i = 0, j = n - 1; i < n; j = i++) {
+            double xi = points[2 * i], yi = points[2 * i + 1];
+            double xj = points[2 * j], yj = points[2 * j + 1];
+            if ((yi > py) != (yj > py)) {
+                crossings.add((xj - xi) * (py - yi) / (yj - yi) + xi);
+            }
+        }
+        std::sort(crossings.begin(), crossings.end());
+        for (int k = 0; k + 1 < crossings.size(); k += 2) {
+            for (int col = std::max(0, (int) std::ceil(crossings[k] - 0.5));
+                 col < pixels.numCols() && col + 0.5 <= crossings[k + 1]; col++) {
+                pixels[row][col] = rgb;
+            }
+        }
+    }
+}
+
+static void fillRect(Grid<int>& pixels, double x, double y, double width, double height, int rgb) {
+    for (int row = std::max(0, (int) y); row < std::min(pixels.numRows(), (int) (y + height)); row++) {
+        for (int col = std::max(0, (int) x); col < std::min(pixels.numCols(), (int) (x + width)); col++) {
+            pixels[row][col] = rgb;
+        }
+    }
+}
+
+/*
+ * Returns the size in points of a font given as "Family-Style-Size",
+ * or the default size if none is given.
+ */
+static double fontSize(const std::string& font) {
+    size_t dash = font.rfind('-');
+    if (dash != std::string::npos && stringIsReal(font.substr(dash + 1))) {
+        return stringToReal(font.substr(dash + 1));
+    }
+    return DEFAULT_FONT_SIZE;
+}
+
+/*
+ * Returns true if the given angle (in degrees) lies within the arc that
+ * starts at 'start' and extends counterclockwise by 'sweep' degrees.
+ */
+static bool inSweep(double angle, double start, double sweep) {
+    if (sweep < 0) {
+        start += sweep;
+        sweep = -sweep;
+    }
+    double offset = std::fmod(angle - start, 360.0);
+    if (offset < 0) {
+        offset += 360;
+    }
+    return offset <= sweep;
+}
+
+/*
+ * Reads the width and height of the PNG, GIF, JPEG or BMP image in the
+ * given file from its header, without decoding the image.
+ */
+static bool readImageSize(const std::string& filename, int& width, int& height) {
+    std::ifstream input(filename.c_str(), std::ios::binary);
+    std::string header(32, '\0');
+    if (!input.read(&header[0], header.size()) && input.gcount() < 26) {
+        return false;
+    }
+    const unsigned char* h = (const unsigned char*) header.data();
+    if (startsWith(header, "\x89PNG")) {
+        width = (h[16] << 24) | (h[17] << 16) | (h[18] << 8) | h[19];
+        height = (h[20] << 24) | (h[21] << 16) | (h[22] << 8) | h[23];
+        return true;
+    } else if (startsWith(header, "GIF8")) {
+        width = h[6] | (h[7] << 8);
+        height = h[8] | (h[9] << 8);
+        return true;
+    } else if (startsWith(header, "BM")) {
+        width = h[18] | (h[19] << 8) | (h[20] << 16) | (h[21] << 24);
+        height = std::abs(h[22] | (h[23] << 8) | (h[24] << 16) | (h[25] << 24));
+        return true;
+    } else if (h[0] == 0xff && h[1] == 0xd8) {
+        // walk the JPEG segments up to the start-of-frame marker
+        input.clear();
+        input.seekg(2);
+        unsigned char segment[9];
+        while (input.read((char*) segment, 4) && segment[0] == 0xff) {
+            int marker = segment[1];
+            int length = (segment[2] << 8) | segment[3];
+            if (marker >= 0xc0 && marker <= 0xcf && marker != 0xc4 && marker != 0xc8 && marker != 0xcc) {
+                if (!input.read((char*) segment, 5)) {
+                    return false;
+                }
+                height = (segment[1] << 8) | segment[2];
+                width = (segment[3] << 8) | segment[4];
+                return true;
+            }
+            input.seekg(length - 2, std::ios::cur);
+        }
+    }
+    return false;
+}
+
+static void setPixel(Grid<int>& pixels, int x, int y, int rgb) {
+    if (pixels.inBounds(y, x)) {
+        pixels[y][x] = rgb;
+    }
+}
+
+/*
+ * Writes the given 0xRRGGBB pixels to a PNG file.  The image data is
+ * stored without compression, so no zlib is needed.
+ */
+static bool writePng(const Grid<int>& pixels, const std::string& filename) {
+    static unsigned int crcTable[256];
+    if (crcTable[1] == 0) {
+        for (unsigned int n = 0; n < 256; n++) {
+            unsigned int c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            crcTable[n] = c;
+        }
+    }
+
+    struct Bytes {
+        std::string data;
+        void put32(unsigned int value) {
+            data += (char) (value >> 24);
+            data += (char) (value >> 16);
+            data += (char) (value >> 8);
+            data += (char) value;
+        }
+    };
+
+    // raw scanlines: a 0 filter byte and then R, G, B for each pixel
+    int width = pixels.numCols(), height = pixels.numRows();
+    std::string raw;
+    raw.reserve((size_t) height * (1 + 3 * width));
+    for (int row = 0; row < height; row++) {
+        raw += '\0';
+        for (int col = 0; col < width; col++) {
+            int rgb = pixels[row][col];
+            raw += (char) (rgb >> 16);
+            raw += (char) (rgb >> 8);
+            raw += (char) rgb;
+        }
+    }
+
+    // zlib stream made of 'stored' deflate blocks of at most 65535 bytes
+    Bytes zlib;
+    zlib.data = "\x78\x01";
+    size_t pos = 0;
+    do {
+        size_t length = std::min(raw.length() - pos, (size_t) 65535);
+        bool last = pos + length == raw.length();
+        zlib.data += (char) (last ? 1 : 0);
+        zlib.data += (char) (length & 0xff);
+        zlib.data += (char) (length >> 8);
+        zlib.data += (char) (~length & 0xff);
+        zlib.data += (char) ((~length >> 8) & 0xff);
+        zlib.data.append(raw, pos, length);
+        pos += length;
+    } while (pos < raw.length());
+    unsigned int a = 1, b = 0;
+    for (size_t i = 0; i < raw.length(); i++) {
+        a = (a + (unsigned char) raw[i]) % 65521;
+        b = (b + a) % 65521;
+    }
+    zlib.put32((b << 16) | a);
+
+    Bytes png;
+    png.data = "\x89PNG\r\n\x1a\n";
+    Bytes ihdr;
+    ihdr.data = "IHDR";
+    ihdr.put32(width);
+    ihdr.put32(height);
+    ihdr.data += std::string("\x08\x02\x00\x00\x00", 5);   // 8-bit RGB
+    std::string chunks[] = { ihdr.data, "IDAT" + zlib.data, "IEND" };
+    for (const std::string& chunk : chunks) {
+        png.put32(chunk.length() - 4);
+        png.data += chunk;
+        unsigned int crc = 0xffffffffu;
+        for (size_t i = 0; i < chunk.length(); i++) {
+            crc = crcTable[(crc ^ (unsigned char) chunk[i]) & 0xff] ^ (crc >> 8);
+        }
+        png.put32(crc ^ 0xffffffffu);
+    }
+
+    std::ofstream output(filename.c_str(), std::ios::binary);
+    output.write(png.data.data(), png.data.length());
+    return !output.fail();
+}
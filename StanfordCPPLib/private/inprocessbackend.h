@@ -0,0 +1,171 @@
+/*
+ * File: inprocessbackend.h
+ * ------------------------
+ * This file declares the InProcessBackEnd class, a stand-in for the Java
+ * back-end (spl.jar) that runs inside the C++ program itself.
+ * It speaks the same text commands as the Java back-end, but keeps the
+ * state of windows, graphical objects, interactors and timers in memory
+ * and answers queries about them directly, so that no Java process needs
+ * to be launched.  This is meant for autograders and batch jobs, where
+ * starting a JVM would cost far more than running the program itself.
+ *
+ * Graphics are drawn into offscreen rasters, which can be saved as PNG
+ * files through GWindow::saveCanvasPixels and GBufferedImage::save.
+ * Things that need a real display or a real user are answered as if the
+ * user had cancelled: dialogs return empty results, and waiting for a
+ * mouse or key event is an error.  Timers run on a simulated clock that
+ * advances only when the program pauses or waits for a timer event, so
+ * animations run as fast as the program can draw them.
+ * Text is not rendered, and label sizes come from approximate font metrics.
+ *
+ * The in-process back-end is used if the library is compiled with
+ * SPL_INPROCESS_BACKEND defined, or if the SPL_BACKEND environment variable
+ * is set to "inprocess" when the program starts.
+ *
+ * @version 2016/10/14
+ * - initial version
+ */
+
+#ifndef _inprocessbackend_h
+#define _inprocessbackend_h
+
+#include <string>
+#include "grid.h"
+#include "gtypes.h"
+#include "hashmap.h"
+#include "queue.h"
+#include "tokenscanner.h"
+#include "vector.h"
+
+namespace stanfordcpplib {
+
+class InProcessBackEnd {
+public:
+    /*
+     * Returns true if the in-process back-end should be used rather than
+     * the Java back-end.
+     */
+    static bool isEnabled();
+
+    /*
+     * Returns the single instance of the in-process back-end.
+     */
+    static InProcessBackEnd& instance();
+
+    /*
+     * Carries out one command of the pipe protocol, as the Java back-end
+     * would, and queues any lines that the Java back-end would send back.
+     */
+    void execute(const std::string& command);
+
+    /*
+     * Removes the next queued reply line and stores it into 'line'.
+     * Returns false if there is no reply waiting.
+     */
+    bool readLine(std::string& line);
+
+    /*
+     * Draws the current contents of the window with the given ID into
+     * 'pixels' as 0xRRGGBB values, resizing it to the window's canvas size.
+     */
+    void renderWindow(const std::string& windowId, Grid<int>& pixels);
+
+private:
+    /* state of one graphical object or interactor, keyed by its ID */
+    struct ObjectData {
+        ObjectData();
+
+        std::string type;                // "GRect", "GLabel", "GButton", ...
+        std::string parent;              // ID of containing GCompound, if any
+        Vector<std::string> children;    // GCompound: contents, back to front
+        double x;                        // location (GLine: start point)
+        double y;
+        double width;                    // size (GLine: end point minus start)
+        double height;
+        double corner;                   // GRoundRect corner size
+        double start;                    // GArc start angle, in degrees
+        double sweep;                    // GArc sweep angle, in degrees
+        bool visible;
+        bool filled;
+        int color;
+        int fillColor;                   // -1 means same as color
+        std::string text;                // label of GLabel/GButton, text of GTextField
+        std::string font;
+        Vector<double> vertices;         // GPolygon: x, y pairs relative to location
+        Grid<int> pixels;                // GBufferedImage contents
+        bool selected;                   // GCheckBox, GRadioButton
+        bool enabled;
+        bool editable;                   // GTextField, GTable
+        int value;                       // GSlider
+        int majorTickSpacing;
+        int minorTickSpacing;
+        bool paintLabels;
+        bool paintTicks;
+        bool snapToTicks;
+        Vector<std::string> items;       // GChooser items
+        std::string selectedItem;
+        Grid<std::string> cells;         // GTable contents
+        HashMap<int, int> columnWidths;
+        int selectedRow;
+        int selectedColumn;
+    };
+
+    /* state of one window, keyed by its ID */
+    struct WindowData {
+        WindowData();
+
+        std::string topCompound;
+        double x;
+        double y;
+        double width;                    // canvas size
+        double height;
+        bool visible;
+        std::string title;
+        Grid<int> background;            // pixels drawn with GWindow::draw
+    };
+
+    /* state of one timer, keyed by its ID */
+    struct TimerData {
+        TimerData();
+
+        double delay;                    // in milliseconds
+        bool running;
+        double nextTick;                 // simulated clock time of next tick
+    };
+
+    InProcessBackEnd();
+
+    /* command groups; each returns false if the command is not theirs */
+    bool executeGObject(const std::string& name, TokenScanner& scanner);
+    bool executeGWindow(const std::string& name, TokenScanner& scanner);
+    bool executeInteractor(const std::string& name, TokenScanner& scanner);
+    bool executeOther(const std::string& name, TokenScanner& scanner);
+
+    /* helpers for reading arguments and writing replies */
+    static bool nextBool(TokenScanner& scanner);
+    static double nextDouble(TokenScanner& scanner);
+    static int nextInt(TokenScanner& scanner);
+    static std::string nextString(TokenScanner& scanner);
+    void reply(const std::string& result);
+    void replyDimension(double width, double height);
+    void replyError(const std::string& message);
+
+    /* geometry and drawing */
+    ObjectData& create(const std::string& id, const std::string& type);
+    void detach(const std::string& id);
+    GRectangle getBounds(const std::string& id);
+    bool contains(const std::string& id, double x, double y);
+    void fireTimers(int mask);
+    void render(const std::string& id, Grid<int>& pixels, double dx, double dy);
+
+    Queue<std::string> replies;
+    std::string requestTag;              // "#ID" of the command being executed, if any
+    HashMap<std::string, ObjectData> objects;
+    HashMap<std::string, WindowData> windows;
+    HashMap<std::string, TimerData> timers;
+    double clock;                        // simulated time in milliseconds
+};
+
+} // namespace stanfordcpplib
+
+#endif // _inprocessbackend_h
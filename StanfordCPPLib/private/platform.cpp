@@ -4,6 +4,28 @@
  * This file implements the platform interface by passing commands to
  * a Java back end that manages the display.
  * 
+ * @version 2016/10/04
+ * - getPipe reads from the Java back-end in blocks through a buffered reader
+ *   rather than making one read() call per character (Linux/Mac)
+ * - added getPipeReadStats for benchmarking pipe reads
+ * - putPipe buffers outgoing commands and writes them in bulk; buffer is
+ *   flushed before waiting on a result, when full, at exit, and by flushPipe
+ * - added opt-in binary pipe protocol with length-prefixed frames and
+ *   numeric opcodes (SPL_BINARY_PIPE_PROTOCOL / SPL_PIPE_PROTOCOL=binary)
+ * - on Linux/Mac a reader thread drains the pipe from the Java back-end and
+ *   queues events as they arrive, so event polling avoids round trips
+ * - added Async variants of some result-returning methods; requests are
+ *   tagged with IDs so that many can be in flight at once
+ * - GBufferedImage pixels for fromGrid and load pass through a memory-mapped
+ *   file shared with the Java back-end rather than as Base64 text (Linux/Mac)
+ * - added headless in-process stand-in for the Java back-end
+ *   (SPL_INPROCESS_BACKEND / SPL_BACKEND=inprocess)
+ * - added per-command pipe statistics and reply latency histograms
+ *   (SPL_PIPE_STATS / setPipeStatsEnabled / printPipeStats)
+ * - Java back-end is launched on the first command sent to it rather than
+ *   at startup, so programs that never need it never start a JVM
+ * - can connect to a long-lived back-end server (java -jar spl.jar -server)
+ *   instead of launching a JVM (SPL_BACKEND_SERVER, Linux/Mac)
  * @version 2016/09/24
  * - bug fix for current directory of spl.jar on Mac platform
  * @version 2016/09/22
@@ -68,10 +90,18 @@
 #  undef HELP_KEY
 #else // _WIN32
 #  include <sys/types.h>
+#  include <sys/mman.h>
+#  include <sys/socket.h>
 #  include <sys/stat.h>
 #  include <sys/resource.h>
+#  include <arpa/inet.h>
 #  include <dirent.h>
 #  include <errno.h>
+#  include <fcntl.h>
+#  include <netinet/in.h>
+#  include <netinet/tcp.h>
+#  include <poll.h>
+#  include <pthread.h>
 #  include <pwd.h>
 #  include <stdint.h>
 #  include <unistd.h>
@@ -107,13 +137,18 @@ static int& pout(bool check = true) {
 
 #include "platform.h"
 #include <algorithm>
+#include <atomic>
 #include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <deque>
 #include <ios>
 #include <signal.h>
 #include <sstream>
@@ -121,6 +156,7 @@ static int& pout(bool check = true) {
 #include <vector>
 #include "private/consolestreambuf.h"
 #include "private/forwardingstreambuf.h"
+#include "private/inprocessbackend.h"
 #include "private/version.h"
 
 #define __DONT_ENABLE_GRAPHICAL_CONSOLE
@@ -134,6 +170,7 @@ static int& pout(bool check = true) {
 #include "gtimer.h"
 #include "gtypes.h"
 #include "hashmap.h"
+#include "hashset.h"
 #include "queue.h"
 #include "stack.h"
 #include "strlib.h"
@@ -147,14 +184,54 @@ static int& pout(bool check = true) {
 // related: similar constant in Java back-end stanford.spl.SplPipeDecoder.java
 static const size_t PIPE_MAX_COMMAND_LENGTH = 2048;
 
+// size of each block read from the Java back-end pipe by getPipe
+static const size_t PIPE_READ_BUFFER_SIZE = 64 * 1024;
+
+// how long to wait for a back-end server to answer a session request before
+// launching a back-end of our own, in milliseconds
+static const int BACKEND_SERVER_TIMEOUT_MS = 2000;
+
+// number of bytes of outgoing commands that putPipe will hold before
+// writing them to the Java back-end in a single call
+static const size_t PIPE_WRITE_BUFFER_SIZE = 64 * 1024;
+
+// opcodes of frames sent in the binary pipe protocol (see PipeFrame);
+// related: same constants in Java back-end stanford.spl.SplBinaryPipeDecoder.java
+enum PipeOpcode {
+    PIPE_OP_TEXT_COMMAND = 0,
+    PIPE_OP_GBUFFEREDIMAGE_SETRGB = 1,
+    PIPE_OP_GOBJECT_SETLOCATION = 2,
+    PIPE_OP_GPOLYGON_ADDVERTEX = 3
+};
+
+// per-command pipe statistics (see setPipeStatsEnabled)
+struct PipeStatsState {
+    bool enabled;
+    HashMap<std::string, stanfordcpplib::PipeCommandStats> commands;
+    std::string lastCommand;                 // name of most recently sent command
+    std::string waitingFor;                  // command whose reply getResult awaits
+    HashMap<int, std::string> requestCommands;   // command of each tagged request
+};
+
 /* Private data */
 static Queue<GEvent> eventQueue;
+static int lastEventMask = -1;   // mask most recently sent to GEvent.getNextEvent/waitForEvent
 static HashMap<std::string, GTimerData*> timerTable;
 static HashMap<std::string, GWindowData*> windowTable;
 static HashMap<std::string, GObject*> sourceTable;
+static HashMap<int, std::string> asyncResults;   // replies to tagged requests, by request ID
+static HashSet<int> asyncErrors;                 // IDs in asyncResults whose reply is an error
 static std::ofstream logfile;
 static stanfordcpplib::ConsoleStreambuf* cinout_new_buf = NULL;
 
+// running totals for getPipeReadStats; the pipe reader thread updates them
+// while the caller's thread reads them, so each counter is atomic
+static struct {
+    std::atomic<long> bytes;
+    std::atomic<long> lines;
+    std::atomic<long> syscalls;
+} pipeReadStats = {{0}, {0}, {0}};
+
 #ifdef _WIN32
 static HANDLE rdFromJBE = NULL;
 static HANDLE wrFromJBE = NULL;
@@ -169,10 +246,13 @@ static pid_t javaBackEndPid;
 /* static function prototypes */
 static std::string getJavaCommand();
 static std::string getPipe();
-static std::string getResult(bool consumeAcks = false, const std::string& caller = "");
+static std::string getInProcessLine();
+static std::string getPipeLine(bool allowEvents);
+static std::string getResult(bool consumeAcks = false, const std::string& caller = "", int requestId = -1);
 static std::string getSplJarPath();
 static void getStatus();
 static void initPipe();
+static void initPipeProtocol();
 static GEvent parseActionEvent(TokenScanner& scanner, EventType type);
 static GEvent parseEvent(std::string line);
 static GEvent parseKeyEvent(TokenScanner& scanner, EventType type);
@@ -181,15 +261,133 @@ static GEvent parseServerEvent(TokenScanner& scanner, EventType type);
 static GEvent parseTableEvent(TokenScanner& scanner, EventType type);
 static GEvent parseTimerEvent(TokenScanner& scanner, EventType type);
 static GEvent parseWindowEvent(TokenScanner& scanner, EventType type);
+static bool& pipeIsBinary();
+static bool pipeHasRequestIds();
+static bool pipeHasSharedPixels();
+static bool pipeHasReaderThread();
+static void pollPipeEvents();
+static bool& backEndStarted();
+static void ensureBackEndStarted();
+static std::string& pipeOutBuffer();
+static void flushPipeIfFull();
+static void flushPipeAtExit();
+static std::string pipeOpcodeName(PipeOpcode opcode);
+static PipeStatsState& pipeStats();
+static void printPipeStatsAtExit();
 static std::string& programName();
+static void bufferPipeLine(const std::string& line);
+static void countPipeLineReceived(const std::string& line);
+static void backEndError(const std::string& message);
 static void putPipe(std::string line);
 static void putPipeLongString(std::string line);
+static int putPipeRequest(const std::string& line);
+static std::string readLongResult();
+static void recordPipeCommand(const std::string& command, size_t bytes);
+static int* sharedPixels(int pixelCount, std::string& path);
+static int& sharedPixelsRequestId();
+#ifndef _WIN32
+static std::string backEndServerFile();
+static bool connectBackEndServer();
+static void startPipeReaderThread();
+#endif // _WIN32
+static std::string pointerToId(const void* p);
 static int scanChar(TokenScanner& scanner);
 static GDimension scanDimension(const std::string& str);
 static double scanDouble(TokenScanner& scanner);
 static int scanInt(TokenScanner& scanner);
 static Point scanPoint(const std::string& str);
 static GRectangle scanRectangle(const std::string& str);
+static void waitForSharedPixels();
+static void writePipe(const char* data, size_t length);
+
+
+/*
+ * One frame of the binary pipe protocol, written straight into the
+ * outgoing command buffer: a 4-byte payload length, a 2-byte opcode, and
+ * the opcode's arguments.  Numbers are sent in native byte order since
+ * both processes run on the same machine; strings are a 4-byte length
+ * followed by their bytes.  Call send() once all arguments are added.
+ */
+class PipeFrame {
+public:
+    PipeFrame(PipeOpcode opcode) : buffer(pipeOutBuffer()), start(buffer.length()), opcode(opcode) {
+        putRaw<uint32_t>(0);   // length; filled in by send()
+        putRaw<uint16_t>((uint16_t) opcode);
+    }
+
+    void putDouble(double value) {
+        putRaw<double>(value);
+    }
+
+    void putInt(int value) {
+        putRaw<int32_t>((int32_t) value);
+    }
+
+    void putString(const std::string& s) {
+        putRaw<uint32_t>((uint32_t) s.length());
+        buffer.append(s);
+    }
+
+    void send() {
+        uint32_t length = (uint32_t) (buffer.length() - start - sizeof(uint32_t));
+        memcpy(&buffer[start], &length, sizeof(length));
+        if (opcode != PIPE_OP_TEXT_COMMAND && pipeStats().enabled) {
+            // text commands were already counted by putPipe
+            recordPipeCommand(pipeOpcodeName(opcode), buffer.length() - start);
+        }
+        flushPipeIfFull();
+    }
+
+private:
+    template <typename T>
+    void putRaw(T value) {
+        buffer.append((const char*) &value, sizeof(value));
+    }
+
+    std::string& buffer;
+    size_t start;   // index of this frame's first byte in buffer
+    PipeOpcode opcode;
+};
+
+/*
+ * Charges the time from its creation to its destruction to the command
+ * whose reply getResult is waiting for, if pipe statistics are enabled.
+ * Nothing is charged unless getResult had to read the pipe, since replies
+ * to tagged requests may already have arrived.
+ */
+class PipeWaitTimer {
+public:
+    PipeWaitTimer(int requestId) : enabled(pipeStats().enabled), readPipe(false) {
+        if (!enabled) {
+            return;
+        }
+        PipeStatsState& state = pipeStats();
+        state.waitingFor = state.lastCommand;
+        if (requestId >= 0 && state.requestCommands.containsKey(requestId)) {
+            state.waitingFor = state.requestCommands.get(requestId);
+            state.requestCommands.remove(requestId);
+        }
+        start = std::chrono::steady_clock::now();
+    }
+
+    ~PipeWaitTimer() {
+        if (enabled && readPipe && pipeStats().enabled) {
+            long micros = (long) std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+            PipeStatsState& state = pipeStats();
+            state.commands[state.waitingFor].waits.record(micros);
+        }
+    }
+
+    void readingPipe() {
+        readPipe = true;
+    }
+
+private:
+    bool enabled;
+    bool readPipe;
+    std::chrono::steady_clock::time_point start;
+};
 
 
 /* Implementation of the Platform class */
@@ -506,16 +704,22 @@ std::string Platform::os_getLastError() {
 #endif // _WIN32
 }
 
+static bool resultToBool(const std::string& result) {
+    return result == "true";
+}
+
 bool Platform::regex_match(std::string s, std::string regexp) {
+    return regex_matchAsync(s, regexp).get();
+}
+
+PlatformFuture<bool> Platform::regex_matchAsync(std::string s, std::string regexp) {
     std::ostringstream os;
     os << "Regex.match(";
     writeQuotedString(os, urlEncode(s));
     os << ",";
     writeQuotedString(os, urlEncode(regexp));
     os << ")";
-    putPipe(os.str());
-    std::string result = getResult();
-    return (result == "true");
+    return PlatformFuture<bool>(putPipeRequest(os.str()), resultToBool);
 }
 
 int Platform::regex_matchCount(std::string s, std::string regexp) {
@@ -641,6 +845,7 @@ void Platform::gwindow_repaint(const GWindow& gw) {
     std::ostringstream os;
     os << "GWindow.repaint(\"" << gw.gwd << "\")";
     putPipe(os.str());
+    flushPipe();   // repaint should show everything drawn so far
 }
 
 void Platform::gwindow_saveCanvasPixels(const GWindow& gw, const std::string& filename) {
@@ -985,13 +1190,19 @@ bool Platform::gobject_contains(const GObject* gobj, double x, double y) {
 
 // Move this computation into gobjects.cpp
 
+static GRectangle resultToBounds(const std::string& result) {
+    if (!startsWith(result, "GRectangle(")) error(result);
+    return scanRectangle(result);
+}
+
 GRectangle Platform::gobject_getBounds(const GObject* gobj) {
+    return gobject_getBoundsAsync(gobj).get();
+}
+
+PlatformFuture<GRectangle> Platform::gobject_getBoundsAsync(const GObject* gobj) {
     std::ostringstream os;
     os << "GObject.getBounds(\"" << gobj << "\")";
-    putPipe(os.str());
-     std::string result = getResult();
-    if (!startsWith(result, "GRectangle(")) error(result);
-    return scanRectangle(result);
+    return PlatformFuture<GRectangle>(putPipeRequest(os.str()), resultToBounds);
 }
 
 void Platform::gobject_setLineWidth(GObject* gobj, double lineWidth) {
@@ -1001,6 +1212,14 @@ void Platform::gobject_setLineWidth(GObject* gobj, double lineWidth) {
 }
 
 void Platform::gobject_setLocation(GObject* gobj, double x, double y) {
+    if (pipeIsBinary()) {
+        PipeFrame frame(PIPE_OP_GOBJECT_SETLOCATION);
+        frame.putString(pointerToId(gobj));
+        frame.putDouble(x);
+        frame.putDouble(y);
+        frame.send();
+        return;
+    }
     std::ostringstream os;
     os << "GObject.setLocation(\"" << gobj << "\", " << x << ", " << y << ")";
     putPipe(os.str());
@@ -1229,13 +1448,55 @@ void Platform::gbufferedimage_fillRegion(GObject* gobj, double x, double y, doub
     putPipe(os.str());
 }
 
+static std::string resultToString(const std::string& result) {
+    return result;
+}
+
 std::string Platform::gbufferedimage_load(GObject* gobj, const std::string& filename) {
+    return gbufferedimage_loadAsync(gobj, filename).get();
+}
+
+bool Platform::gbufferedimage_loadShared(GObject* gobj, const std::string& filename, Grid<int>& pixels) {
+    std::string path;
+    if (!pipeHasSharedPixels() || !sharedPixels(0, path)) {
+        return false;
+    }
+    waitForSharedPixels();
     std::ostringstream os;
-    os << "GBufferedImage.load(\"" << gobj << "\", ";
+    os << "GBufferedImage.loadShared(\"" << gobj << "\", ";
     writeQuotedString(os, filename);
+    os << ", ";
+    writeQuotedString(os, path);
     os << ")";
     putPipe(os.str());
-    return getResult();
+    std::string result = getResult();
+    if (!startsWith(result, "GDimension(")) {
+        error("GBufferedImage::load: " + result);
+    }
+    GDimension size = scanDimension(result);
+    int width = (int) size.getWidth();
+    int height = (int) size.getHeight();
+
+    // the back-end has grown the file if the image did not fit
+    int* shared = sharedPixels(width * height, path);
+    if (!shared) {
+        error("GBufferedImage::load: unable to map pixels shared with Java back-end");
+    }
+    if (pixels.numRows() != height || pixels.numCols() != width) {
+        pixels.resize(height, width, /* retain */ false);
+    }
+    for (int& rgb : pixels) {
+        rgb = *shared++;
+    }
+    return true;
+}
+
+PlatformFuture<std::string> Platform::gbufferedimage_loadAsync(GObject* gobj, const std::string& filename) {
+    std::ostringstream os;
+    os << "GBufferedImage.load(\"" << gobj << "\", ";
+    writeQuotedString(os, filename);
+    os << ")";
+    return PlatformFuture<std::string>(putPipeRequest(os.str()), resultToString);
 }
 
 void Platform::gbufferedimage_resize(GObject* gobj, double width, double height, bool retain) {
@@ -1256,6 +1517,15 @@ std::string Platform::gbufferedimage_save(const GObject* const gobj, const std::
 
 void Platform::gbufferedimage_setRGB(GObject* gobj, double x, double y,
                                      int rgb) {
+    if (pipeIsBinary()) {
+        PipeFrame frame(PIPE_OP_GBUFFEREDIMAGE_SETRGB);
+        frame.putString(pointerToId(gobj));
+        frame.putInt((int) x);
+        frame.putInt((int) y);
+        frame.putInt(rgb);
+        frame.send();
+        return;
+    }
     std::ostringstream os;
     os << "GBufferedImage.setRGB(\"" << gobj << "\", " << (int) x << ", "
        << (int) y << ", " << rgb << ")";
@@ -1269,15 +1539,47 @@ void Platform::gbufferedimage_updateAllPixels(GObject* gobj,
     putPipe(os.str());
 }
 
-GDimension Platform::gimage_constructor(GObject* gobj, std::string filename) {
+bool Platform::gbufferedimage_updateAllPixelsShared(GObject* gobj, const Grid<int>& pixels) {
+    if (!pipeHasSharedPixels()) {
+        return false;
+    }
+
+    // the back-end may still be reading the previous frame
+    waitForSharedPixels();
+    std::string path;
+    int* shared = sharedPixels(pixels.size(), path);
+    if (!shared) {
+        return false;
+    }
+    for (int rgb : pixels) {
+        *shared++ = rgb;
+    }
+
+    // only a short command goes through the pipe; its reply is not needed
+    // until the shared memory is about to be reused
     std::ostringstream os;
-    os << "GImage.create(\"" << gobj << "\", \"" << filename << "\")";
-    putPipe(os.str());
-    std::string result = getResult();
+    os << "GBufferedImage.updateAllPixelsShared(\"" << gobj << "\", ";
+    writeQuotedString(os, path);
+    os << ", " << pixels.numCols() << ", " << pixels.numRows() << ")";
+    sharedPixelsRequestId() = putPipeRequest(os.str());
+    return true;
+}
+
+static GDimension resultToImageSize(const std::string& result) {
     if (!startsWith(result, "GDimension(")) error("GImage::constructor: " + result);
     return scanDimension(result);
 }
 
+GDimension Platform::gimage_constructor(GObject* gobj, std::string filename) {
+    return gimage_constructorAsync(gobj, filename).get();
+}
+
+PlatformFuture<GDimension> Platform::gimage_constructorAsync(GObject* gobj, std::string filename) {
+    std::ostringstream os;
+    os << "GImage.create(\"" << gobj << "\", \"" << filename << "\")";
+    return PlatformFuture<GDimension>(putPipeRequest(os.str()), resultToImageSize);
+}
+
 void Platform::gpolygon_constructor(GObject* gobj) {
     std::ostringstream os;
     os << "GPolygon.create(\"" << gobj << "\")";
@@ -1285,8 +1587,16 @@ void Platform::gpolygon_constructor(GObject* gobj) {
 }
 
 void Platform::gpolygon_addVertex(GObject* gobj, double x, double y) {
-    std::ostringstream os;
     if (x >= 0 && y >= 0) {
+        if (pipeIsBinary()) {
+            PipeFrame frame(PIPE_OP_GPOLYGON_ADDVERTEX);
+            frame.putString(pointerToId(gobj));
+            frame.putDouble(x);
+            frame.putDouble(y);
+            frame.send();
+            return;
+        }
+        std::ostringstream os;
         os << "GPolygon.addVertex(\"" << gobj << "\", " << x << ", " << y << ")";
         putPipe(os.str());
     } else {
@@ -1679,16 +1989,22 @@ GDimension Platform::glabel_getSize(const GObject* gobj) {
 }
 
 GEvent Platform::gevent_getNextEvent(int mask) {
-    if (eventQueue.isEmpty()) {
+    pollPipeEvents();
+    // once the back-end knows our mask, it sends matching events on its own
+    // and the reader thread collects them, so no round trip is needed
+    if (eventQueue.isEmpty() && (!pipeHasReaderThread() || mask != lastEventMask)) {
+        lastEventMask = mask;
         putPipe("GEvent.getNextEvent(" + integerToString(mask) + ")");
         getResult();
-        if (eventQueue.isEmpty()) return GEvent();
     }
+    if (eventQueue.isEmpty()) return GEvent();
     return eventQueue.dequeue();
 }
 
 GEvent Platform::gevent_waitForEvent(int mask) {
+    pollPipeEvents();
     while (eventQueue.isEmpty()) {
+        lastEventMask = mask;
         putPipe("GEvent.waitForEvent(" + integerToString(mask) + ")");
 
         // BUGBUG: Marty changing to consume ACKs because it was skipping an
@@ -1708,12 +2024,16 @@ bool Platform::jbeconsole_isBlocked() {
 }
 
 void Platform::gwindow_exitGraphics(bool abortBlockedConsoleIO) {
-    if (abortBlockedConsoleIO && jbeconsole_isBlocked()) {
+    if (!backEndStarted()) {
+        // no windows to close; don't launch the back-end just to exit it
+        std::exit(0);
+    } else if (abortBlockedConsoleIO && jbeconsole_isBlocked()) {
         // graphical console is blocked waiting for an I/O read;
         // won't be able to exit graphics in the JBE anyway; just exit
         std::exit(0);
     } else {
         putPipe("GWindow.exitGraphics()");
+        flushPipe();
         std::exit(0);
     }
 }
@@ -2085,13 +2405,13 @@ Platform* getPlatform() {
 static void putPipeLongString(std::string line) {
     // break into chunks
     // precondition: line does not contain substring "LongCommand.end()"
-    putPipe("LongCommand.begin()");
+    bufferPipeLine("LongCommand.begin()");
     size_t len = line.length();
     for (size_t i = 0; i < len; i += PIPE_MAX_COMMAND_LENGTH) {
         std::string chunk = line.substr(i, std::min(PIPE_MAX_COMMAND_LENGTH, len - i));
-        putPipe(chunk);
+        bufferPipeLine(chunk);
     }
-    putPipe("LongCommand.end()");
+    bufferPipeLine("LongCommand.end()");
 }
 
 void parseArgs(int argc, char** argv) {
@@ -2216,18 +2536,9 @@ static void initPipe() {
 }
 
 // Windows implementation; see Unix implementation elsewhere in this file
-static void putPipe(std::string line) {
-    if (line.length() > PIPE_MAX_COMMAND_LENGTH) {
-        putPipeLongString(line);
-        return;
-    }
-    
+static void writePipe(const char* data, size_t length) {
     DWORD nch;
-#ifdef PIPE_DEBUG
-    fprintf(stderr, "putPipe(\"%s\")\n", line.c_str());  fflush(stderr);
-#endif // PIPE_DEBUG
-    if (!WinCheck(WriteFile(wrToJBE, line.c_str(), line.length(), &nch, NULL))) return;
-    if (!WinCheck(WriteFile(wrToJBE, "\n", 1, &nch, NULL))) return;
+    if (!WinCheck(WriteFile(wrToJBE, data, length, &nch, NULL))) return;
     WinCheck(FlushFileBuffers(wrToJBE));
 }
 
@@ -2244,15 +2555,18 @@ static std::string getPipe() {
     while (charsRead < charsReadMax) {
         char ch;
         WINBOOL readFileResult = WinCheck(ReadFile(rdFromJBE, &ch, 1, &nch, NULL));
+        pipeReadStats.syscalls.fetch_add(1, std::memory_order_relaxed);
         if (readFileResult == 0) {
             break;   // failed to read from subprocess
         }
+        pipeReadStats.bytes.fetch_add(1, std::memory_order_relaxed);
         if (ch == '\n' || ch == '\r') {
             break;
         }
         line += ch;
         charsRead++;
     }
+    pipeReadStats.lines.fetch_add(1, std::memory_order_relaxed);
 
 #ifdef PIPE_DEBUG
     fprintf(stderr, "getPipe(): returned \"%s\"\n", line.c_str());  fflush(stderr);
@@ -2260,6 +2574,38 @@ static std::string getPipe() {
     return line;
 }
 
+// Windows implementation; see Unix implementation elsewhere in this file
+// (no reader thread on Windows; lines are read directly as they are needed)
+static std::string getPipeLine(bool /* allowEvents */) {
+    if (stanfordcpplib::InProcessBackEnd::isEnabled()) {
+        return getInProcessLine();
+    }
+    return getPipe();
+}
+
+// Windows implementation; see Unix implementation elsewhere in this file
+static bool pipeHasReaderThread() {
+    return false;
+}
+
+// Windows implementation; see Unix implementation elsewhere in this file
+static void pollPipeEvents() {
+    // empty; events are parsed by getResult as they are read
+}
+
+// Windows implementation; see Unix implementation elsewhere in this file
+// (no shared pixel file on Windows; pixels always travel as Base64 text)
+static int* sharedPixels(int /* pixelCount */, std::string& /* path */) {
+    return NULL;
+}
+
+namespace stanfordcpplib {
+// Windows implementation; see Unix implementation elsewhere in this file
+void removeSharedPixelFile() {
+    // empty
+}
+} // namespace stanfordcpplib
+
 #else // not WIN32
 
 /* Linux/Mac implementation of interface to Java back end */
@@ -2288,8 +2634,130 @@ static void sigPipeHandler(int /*signum*/) {
 }
 #endif // SPL_HEADLESS_MODE
 
+/*
+ * Returns the file in which a back-end server started by
+ * "java -jar spl.jar -server" publishes its port and access token,
+ * or "" if programs should not look for a server.
+ * A server is used if the library is compiled with SPL_BACKEND_SERVER
+ * defined, or if the SPL_BACKEND_SERVER environment variable is set,
+ * either to the server's file or to 1 for the default file; the default
+ * must match BackEndServer.getDefaultInfoFile in the Java back-end.
+ */
+// Unix implementation; see Windows implementation elsewhere in this file
+static std::string backEndServerFile() {
+    char* setting = getenv("SPL_BACKEND_SERVER");
+    std::string value = setting ? setting : "";
+#ifdef SPL_BACKEND_SERVER
+    if (value.empty()) {
+        value = "1";
+    }
+#endif // SPL_BACKEND_SERVER
+    if (value.empty() || value == "0") {
+        return "";
+    } else if (value != "1") {
+        return value;
+    }
+    char* tmpdir = getenv("TMPDIR");
+    std::string dir = (tmpdir && *tmpdir) ? tmpdir : "/tmp";
+    if (!endsWith(dir, "/")) {
+        dir += "/";
+    }
+    struct passwd* user = getpwuid(getuid());
+    return dir + "spl-backend-" + (user ? user->pw_name : "");
+}
+
+/*
+ * Reads the port and token from a back-end server's info file.
+ * Returns false if the file cannot be read, or if it is not a regular file
+ * that belongs to the current user and that no one else can read or write;
+ * anyone able to plant the file could point the program at their own server.
+ */
+// Unix implementation; see Windows implementation elsewhere in this file
+static bool readBackEndServerFile(const std::string& infoFile, int& port, std::string& token) {
+    int fd = open(infoFile.c_str(), O_RDONLY | O_NOFOLLOW);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    char buffer[128];
+    ssize_t length = -1;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)
+            && info.st_uid == getuid() && (info.st_mode & 077) == 0) {
+        length = read(fd, buffer, sizeof(buffer) - 1);
+    }
+    close(fd);
+    if (length <= 0) {
+        return false;
+    }
+    std::istringstream input(std::string(buffer, length));
+    return (input >> port >> token) && port > 0 && port <= 65535;
+}
+
+/*
+ * Tries to start a session with a back-end server and use its connection
+ * as the pipe.  Returns false, leaving the pipe unset, if no server is
+ * configured or running, if its info file is not safe to trust, or if it
+ * does not accept the session; a server already serving another program
+ * answers "session:busy" at once.  initPipe then launches a back-end.
+ */
+// Unix implementation; see Windows implementation elsewhere in this file
+static bool connectBackEndServer() {
+    std::string infoFile = backEndServerFile();
+    int port = 0;
+    std::string token;
+    if (infoFile.empty() || !readBackEndServerFile(infoFile, port, token)) {
+        return false;
+    }
+
+    int sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock < 0) {
+        return false;
+    }
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons((uint16_t) port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(sock, (struct sockaddr*) &address, sizeof(address)) != 0) {
+        close(sock);
+        return false;
+    }
+    int noDelay = 1;   // commands are already batched by putPipe
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    std::string hello = "session " + token + " " + programName() + "\n";
+    std::string reply;
+    if (write(sock, hello.c_str(), hello.length()) == (ssize_t) hello.length()) {
+        // read the one-line reply a byte at a time, so that nothing after it
+        // is taken away from the pipe reader
+        struct pollfd pfd;
+        pfd.fd = sock;
+        pfd.events = POLLIN;
+        char ch = '\0';
+        while (poll(&pfd, 1, BACKEND_SERVER_TIMEOUT_MS) > 0 && read(sock, &ch, 1) == 1 && ch != '\n') {
+            reply += ch;
+        }
+    }
+    if (reply != "session:ok") {
+        close(sock);
+        return false;
+    }
+    pin(/* check */ false) = sock;
+    pout(/* check */ false) = dup(sock);
+    return true;
+}
+
 // Unix implementation; see Windows implementation elsewhere in this file
 static void initPipe() {
+    if (connectBackEndServer()) {
+        cppLibPid = getpid();
+#ifndef SPL_HEADLESS_MODE
+        signal(SIGPIPE, sigPipeHandler);
+#endif // SPL_HEADLESS_MODE
+        startPipeReaderThread();
+        return;
+    }
+
     std::string jarName = getSplJarPath();
     
     int toJBE[2], fromJBE[2];
@@ -2299,6 +2767,10 @@ static void initPipe() {
     if (pipe(fromJBE) != 0) {
         error("Unable to establish pipe from Java back-end; exiting.");
     }
+    // the back-end may start midway through the program; don't let the
+    // child inherit (and maybe write out again) any buffered output
+    fflush(stdout);
+    fflush(stderr);
     int child = fork();
     if (child == 0) {
         // we are the Java back-end process; launch external Java command
@@ -2362,42 +2834,97 @@ static void initPipe() {
 #ifndef SPL_HEADLESS_MODE
         signal(SIGPIPE, sigPipeHandler);
 #endif // SPL_HEADLESS_MODE
+
+        startPipeReaderThread();
     }
 }
 
 // Unix implementation; see Windows implementation elsewhere in this file
-static void putPipe(std::string line) {
-    if (line.length() > PIPE_MAX_COMMAND_LENGTH) {
-        putPipeLongString(line);
-        return;
+static void writePipe(const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t result = write(pout(), data, length);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LinCheck(errno);
+            return;
+        }
+        data += result;
+        length -= result;
     }
-#ifdef PIPE_DEBUG
-    fprintf(stderr, "putPipe(\"%s\")\n", line.c_str());  fflush(stderr);
-#endif
-    LinCheck(write(pout(), line.c_str(), line.length()));
-    LinCheck(write(pout(), "\n", 1));
 }
 
+/*
+ * Buffered reader for the pipe from the Java back-end.
+ * Pulls data from the pipe in large blocks and splits it into lines in
+ * user space, rather than making one read() system call per character.
+ * Bytes that follow the end of the current line stay buffered for the
+ * next call, so result:/result_long:/event: lines are seen one at a time
+ * exactly as before.
+ */
+class PipeReader {
+public:
+    PipeReader() : start(0), end(0) {
+        // empty
+    }
+
+    /*
+     * Reads the next line from the given file descriptor into 'line',
+     * without its trailing \n.  A line longer than maxLength characters is
+     * returned in pieces of maxLength characters each.
+     * Returns false if the pipe has been closed or could not be read.
+     */
+    bool readLine(int fd, std::string& line, size_t maxLength) {
+        line.clear();
+        while (true) {
+            // look for the end of the line in the data buffered so far
+            size_t length = std::min(end - start, maxLength - line.length());
+            const char* data = buffer + start;
+            const char* newline = (const char*) memchr(data, '\n', length);
+            if (newline) {
+                line.append(data, newline - data);
+                start += (newline - data) + 1;
+                pipeReadStats.lines.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            line.append(data, length);
+            start += length;
+            if (line.length() >= maxLength) {
+                pipeReadStats.lines.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+
+            // buffer is drained; refill it with as much as the pipe has ready
+            ssize_t result;
+            do {
+                result = read(fd, buffer, PIPE_READ_BUFFER_SIZE);
+                pipeReadStats.syscalls.fetch_add(1, std::memory_order_relaxed);
+            } while (result < 0 && errno == EINTR);
+            if (result <= 0) {
+                return false;
+            }
+            start = 0;
+            end = (size_t) result;
+            pipeReadStats.bytes.fetch_add(result, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    char buffer[PIPE_READ_BUFFER_SIZE];
+    size_t start;   // index of first unread byte in buffer
+    size_t end;     // index just past last valid byte in buffer
+};
+
 // Unix implementation; see Windows implementation elsewhere in this file
 static std::string getPipe() {
 #ifdef PIPE_DEBUG
     fprintf(stderr, "getPipe(): waiting ...\n");  fflush(stderr);
 #endif
-    std::string line = "";
-    int charsRead = 0;
-    int charsReadMax = PIPE_MAX_COMMAND_LENGTH + 100;
-    while (charsRead < charsReadMax) {
-        char ch;
-        ssize_t result = read(pin(), &ch, 1);
-        if (result <= 0) {
-            throw InterruptedIOException();
-            // break;   // failed to read from subprocess
-        }
-        if (ch == '\n') {
-            break;
-        }
-        line += ch;
-        charsRead++;
+    static PipeReader reader;
+    std::string line;
+    if (!reader.readLine(pin(), line, PIPE_MAX_COMMAND_LENGTH + 100)) {
+        throw InterruptedIOException();   // failed to read from subprocess
     }
 #ifdef PIPE_DEBUG
     fprintf(stderr, "getPipe(): \"%s\"\n", line.c_str());  fflush(stderr);
@@ -2405,60 +2932,773 @@ static std::string getPipe() {
     return line;
 }
 
-#endif // WIN32
+/*
+ * A bounded, lock-free queue for exactly one producer thread and one
+ * consumer thread.  Capacity must be a power of two.
+ * push returns false if the queue is full; pop returns false if it is empty.
+ */
+template <typename T>
+class SpscQueue {
+public:
+    SpscQueue(size_t capacity) : slots(capacity), mask(capacity - 1), head(0), tail(0) {
+        // empty
+    }
+
+    bool isEmpty() const {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
 
-static std::string getResult(bool consumeAcks, const std::string& caller) {
+    bool pop(T& value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = std::move(slots[h & mask]);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool push(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) > mask) {
+            return false;
+        }
+        slots[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> slots;
+    size_t mask;
+    std::atomic<size_t> head;   // next slot to pop; written only by consumer
+    std::atomic<size_t> tail;   // next slot to push; written only by producer
+};
+
+/*
+ * State shared between the pipe reader thread and the threads making
+ * Platform calls.  Event lines go through a lock-free queue; every other
+ * line (results, acks, and back-end error output) goes to resultLines.
+ * Events that arrive while the lock-free queue is full, as in a flood of
+ * mouse motion events that the program is not polling for, spill into
+ * overflowEvents, so the reader never stops reading the pipe; once any
+ * event has spilled, later ones spill too until the overflow is drained,
+ * which keeps events in order.
+ * Allocated once and never freed so that the reader thread can never see
+ * it destroyed during program exit.
+ */
+struct PipeReaderState {
+    PipeReaderState() : eventLines(4096), closed(false) {
+        pthread_mutex_init(&lock, NULL);
+        pthread_cond_init(&ready, NULL);
+    }
+
+    SpscQueue<std::string> eventLines;      // event text, without "event:"
+    std::deque<std::string> overflowEvents; // guarded by lock; newer than eventLines
+    std::deque<std::string> resultLines;    // guarded by lock
+    bool closed;                         // guarded by lock; true once pipe hits EOF
+    pthread_mutex_t lock;
+    pthread_cond_t ready;                // signaled when a line arrives or pipe closes
+};
+
+static PipeReaderState* pipeReaderState = NULL;
+
+/*
+ * Body of the thread that continuously drains the pipe from the Java
+ * back-end, so that events are collected as soon as they are sent rather
+ * than only when some call happens to read the pipe.
+ */
+static void* pipeReaderThread(void* /* arg */) {
+    PipeReaderState* state = pipeReaderState;
     while (true) {
-#ifdef PIPE_DEBUG
-        fprintf(stderr, "getResult(): calling getPipe() ...\n");  fflush(stderr);
-#endif
-        std::string line = getPipe();
-        
-        bool isResult        = startsWith(line, "result:");
-        bool isResultLong    = startsWith(line, "result_long:");
-        bool isEvent         = startsWith(line, "event:");
-        bool isAck           = startsWith(line, "result:___jbe___ack___");
-        bool hasACMException = line.find("acm.util.ErrorException") != std::string::npos;
-        bool hasException    = line.find("xception") != std::string::npos;
-        bool hasError        = line.find("Unexpected error") != std::string::npos;
+        std::string line;
+        try {
+            line = getPipe();
+        } catch (const InterruptedIOException&) {
+            pthread_mutex_lock(&state->lock);
+            state->closed = true;
+            pthread_cond_broadcast(&state->ready);
+            pthread_mutex_unlock(&state->lock);
+            return NULL;
+        }
 
-        if (isResultLong) {
-            // read a 'long' result (sent across multiple lines)
-            std::ostringstream os;
-            std::string nextLine = getPipe();
-            while (nextLine != "result_long:end") {
-                if (!startsWith(line, "result:___jbe___ack___")) {
-                    os << nextLine;
-#ifdef PIPE_DEBUG
-                    fprintf(stderr, "getResult(): appended line (length so far: %d)\n", (int) os.str().length());  fflush(stderr);
-#endif
-                }
-                nextLine = getPipe();
-            }
-            std::string result = os.str();
-#ifdef PIPE_DEBUG
-            fprintf(stderr, "getResult(): returning long string \"%s ... %s\" (length %d)\n",
-                    result.substr(0, 10).c_str(),
-                    result.substr(result.length() - 10, 10).c_str(),
-                    (int) result.length());  fflush(stderr);
-#endif
-            return result;
-        } else if (((isResult || isEvent) && hasACMException) ||
-                (!isResult && !isEvent && (hasException || hasError))) {
-            // an error message from the back-end; throw it here
-            std::ostringstream out;
-            if (isResult) {
-                line = line.substr(7);
-            } else if (isEvent) {
-                line = line.substr(6);
-            }
-            out << "ERROR emitted from Stanford Java back-end process:"
-                << std::endl << line;
-            error(out.str());
-        } else if (isResult) {
-            // a regular result
-            if (!isAck || !consumeAcks) {
-                std::string result = line.substr(7);
+        pthread_mutex_lock(&state->lock);
+        if (!startsWith(line, "event:")) {
+            state->resultLines.push_back(line);
+        } else if (!state->overflowEvents.empty() || !state->eventLines.push(line.substr(6))) {
+            state->overflowEvents.push_back(line.substr(6));
+        }
+        pthread_cond_broadcast(&state->ready);
+        pthread_mutex_unlock(&state->lock);
+    }
+}
+
+// Unix implementation; see Windows implementation elsewhere in this file
+static void startPipeReaderThread() {
+    pipeReaderState = new PipeReaderState();
+
+    // signals should go to the program's own threads, not to this one
+    sigset_t allSignals;
+    sigset_t oldSignals;
+    sigfillset(&allSignals);
+    pthread_sigmask(SIG_SETMASK, &allSignals, &oldSignals);
+    pthread_t thread;
+    int result = pthread_create(&thread, NULL, pipeReaderThread, NULL);
+    pthread_sigmask(SIG_SETMASK, &oldSignals, NULL);
+    if (result != 0) {
+        error("Unable to start thread to read from Java back-end; exiting.");
+    }
+    pthread_detach(thread);
+}
+
+/*
+ * Removes the oldest event line collected by the reader thread into line,
+ * returning false if there is none.  The lock-free queue holds the older
+ * events, so the overflow is only consulted once it is empty.
+ */
+static bool popEventLine(PipeReaderState* state, std::string& line) {
+    if (state->eventLines.pop(line)) {
+        return true;
+    }
+    pthread_mutex_lock(&state->lock);
+    bool found = !state->overflowEvents.empty();
+    if (found) {
+        line = std::move(state->overflowEvents.front());
+        state->overflowEvents.pop_front();
+    }
+    pthread_mutex_unlock(&state->lock);
+    return found;
+}
+
+/*
+ * Returns the next line from the Java back-end, waiting if necessary.
+ * If allowEvents is true, any event lines collected by the reader thread
+ * are returned first (with their "event:" prefix); otherwise only
+ * non-event lines are returned, which getResult needs while it assembles
+ * a multi-line result.
+ */
+// Unix implementation; see Windows implementation elsewhere in this file
+static std::string getPipeLine(bool allowEvents) {
+    if (stanfordcpplib::InProcessBackEnd::isEnabled()) {
+        return getInProcessLine();
+    }
+    PipeReaderState* state = pipeReaderState;
+    if (!state) {
+        return getPipe();   // reader thread not started; read directly
+    }
+    std::string line;
+    if (allowEvents && popEventLine(state, line)) {
+        return "event:" + line;
+    }
+    pthread_mutex_lock(&state->lock);
+    while (state->resultLines.empty() && !state->closed
+           && !(allowEvents && (!state->eventLines.isEmpty() || !state->overflowEvents.empty()))) {
+        pthread_cond_wait(&state->ready, &state->lock);
+    }
+    bool haveResult = !state->resultLines.empty();
+    if (haveResult) {
+        line = state->resultLines.front();
+        state->resultLines.pop_front();
+    }
+    pthread_mutex_unlock(&state->lock);
+
+    if (haveResult) {
+        return line;
+    } else if (allowEvents && popEventLine(state, line)) {
+        return "event:" + line;
+    } else {
+        throw InterruptedIOException();   // pipe from back-end has closed
+    }
+}
+
+// Unix implementation; see Windows implementation elsewhere in this file
+static bool pipeHasReaderThread() {
+    return pipeReaderState != NULL;
+}
+
+/*
+ * Parses any events that the reader thread has collected and adds them
+ * to the event queue, without waiting for anything from the back-end.
+ */
+// Unix implementation; see Windows implementation elsewhere in this file
+static void pollPipeEvents() {
+    if (!pipeReaderState) {
+        return;
+    }
+    std::string line;
+    while (popEventLine(pipeReaderState, line)) {
+        eventQueue.enqueue(parseEvent(line));
+    }
+}
+
+/*
+ * A file mapped into memory that the Java back-end maps as well, through
+ * which GBufferedImage pixels are passed as raw ints rather than as text.
+ * The file lives in /dev/shm where available so that it never touches disk,
+ * and is removed when the program exits, normally or not.
+ * It cannot be removed as soon as both sides have mapped it, because the
+ * back-end reopens it by name when it grows the file for a larger image.
+ */
+
+/*
+ * Name of the shared pixel file, or "" if there is none; kept in a plain
+ * char array so that a signal handler can remove the file.
+ */
+static char sharedPixelFilePath[64] = "";
+
+class SharedPixelFile {
+public:
+    SharedPixelFile() : fd(-1), data(NULL), capacity(0), failed(false) {
+        // empty
+    }
+
+    ~SharedPixelFile() {
+        if (data) {
+            munmap(data, capacity);
+        }
+        if (fd >= 0) {
+            close(fd);
+            // don't wait for the back-end's reply to the last frame: this runs
+            // during static destruction, when the pipe may already be gone.
+            // The back-end keeps its own mapping of the file, which outlives
+            // the name.
+            stanfordcpplib::removeSharedPixelFile();
+        }
+    }
+
+    /*
+     * Returns the start of the shared memory, made big enough for at least
+     * pixelCount ints, or NULL if the file cannot be created or mapped.
+     * If the back-end has grown the file, the larger file is mapped.
+     */
+    int* pixels(int pixelCount) {
+        if (fd < 0 && !open()) {
+            return NULL;
+        }
+        size_t needed = std::max(pixelCount, 1) * sizeof(int);
+        if (needed > capacity) {
+            struct stat info;
+            if (fstat(fd, &info) != 0) {
+                return NULL;
+            }
+            if ((size_t) info.st_size < needed) {
+                if (ftruncate(fd, needed) != 0) {
+                    return NULL;
+                }
+                info.st_size = needed;
+            }
+            if (data) {
+                munmap(data, capacity);
+                data = NULL;
+                capacity = 0;
+            }
+            void* mapped = mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapped == MAP_FAILED) {
+                return NULL;
+            }
+            data = mapped;
+            capacity = info.st_size;
+        }
+        return (int*) data;
+    }
+
+    const std::string& getPath() const {
+        return path;
+    }
+
+private:
+    bool open() {
+        if (failed) {
+            return false;
+        }
+        struct stat info;
+        std::string dir = (stat("/dev/shm", &info) == 0 && S_ISDIR(info.st_mode)) ? "/dev/shm" : "/tmp";
+        std::string pattern = dir + "/spl-pixels-XXXXXX";
+        std::vector<char> name(pattern.begin(), pattern.end());
+        name.push_back('\0');
+        fd = mkstemp(&name[0]);
+        if (fd < 0) {
+            failed = true;
+            return false;
+        }
+        path = &name[0];
+        snprintf(sharedPixelFilePath, sizeof(sharedPixelFilePath), "%s", path.c_str());
+        return true;
+    }
+
+    std::string path;
+    int fd;
+    void* data;
+    size_t capacity;
+    bool failed;   // true if the file could not be created; don't retry
+};
+
+/*
+ * Returns memory for pixelCount pixels shared with the Java back-end, and
+ * sets path to the name of the file by which the back-end can map it.
+ * Returns NULL if no shared memory is available.
+ */
+// Unix implementation; see Windows implementation elsewhere in this file
+static int* sharedPixels(int pixelCount, std::string& path) {
+    static SharedPixelFile __sharedPixelFile;
+    int* pixels = __sharedPixelFile.pixels(pixelCount);
+    path = __sharedPixelFile.getPath();
+    return pixels;
+}
+
+namespace stanfordcpplib {
+// Unix implementation; see Windows implementation elsewhere in this file
+void removeSharedPixelFile() {
+    if (sharedPixelFilePath[0] != '\0') {
+        unlink(sharedPixelFilePath);
+        sharedPixelFilePath[0] = '\0';
+    }
+}
+} // namespace stanfordcpplib
+
+#endif // WIN32
+
+/*
+ * Queues a command to be sent to the Java back-end.
+ * Commands are collected in an outgoing buffer and written in bulk when the
+ * buffer fills up, when the C++ side is about to wait for a reply in
+ * getResult, or when flushPipe is called, so that a long run of
+ * fire-and-forget commands costs only a few write calls.
+ */
+static void putPipe(std::string line) {
+    if (!backEndStarted()) {
+        ensureBackEndStarted();
+    }
+    if (pipeStats().enabled) {
+        recordPipeCommand(line, line.length() + 1);
+    }
+    if (stanfordcpplib::InProcessBackEnd::isEnabled()) {
+        stanfordcpplib::InProcessBackEnd::instance().execute(line);
+        return;
+    }
+    if (pipeIsBinary()) {
+        // binary frames carry a length, so long commands need no chunking
+        PipeFrame frame(PIPE_OP_TEXT_COMMAND);
+        frame.putString(line);
+        frame.send();
+        return;
+    }
+    if (line.length() > PIPE_MAX_COMMAND_LENGTH) {
+        putPipeLongString(line);
+        return;
+    }
+    bufferPipeLine(line);
+}
+
+/*
+ * Appends one line of the text protocol to the outgoing command buffer,
+ * writing the buffer to the pipe if it is full.
+ */
+static void bufferPipeLine(const std::string& line) {
+#ifdef PIPE_DEBUG
+    fprintf(stderr, "putPipe(\"%s\")\n", line.c_str());  fflush(stderr);
+#endif
+    std::string& buffer = pipeOutBuffer();
+    buffer += line;
+    buffer += '\n';
+    flushPipeIfFull();
+}
+
+/*
+ * Returns true if the Java back-end tags its replies with the request IDs
+ * that putPipeRequest attaches to commands.  Asks the back-end for its
+ * version the first time it is called.
+ */
+static bool pipeHasRequestIds() {
+    static int __pipeHasRequestIds = -1;   // -1 means unknown
+    if (__pipeHasRequestIds < 0) {
+        std::string jbeVersion = stanfordcpplib::getPlatform()->cpplib_getJavaBackEndVersion();
+        __pipeHasRequestIds = jbeVersion >= STANFORD_JAVA_BACKEND_REQUEST_ID_VERSION ? 1 : 0;
+    }
+    return __pipeHasRequestIds == 1;
+}
+
+/*
+ * Sends a command whose reply will be collected later through a
+ * PlatformFuture, and returns the request ID to wait on.
+ * The command is prefixed with "#ID " so that the back-end tags its reply
+ * with the same ID; this lets many requests be in flight at once.
+ * Back-ends too old to tag replies get the plain command, and its reply
+ * is awaited right away.
+ */
+static int putPipeRequest(const std::string& line) {
+    static int nextRequestId = 0;
+    int requestId = nextRequestId++;
+    if (pipeHasRequestIds()) {
+        putPipe("#" + integerToString(requestId) + " " + line);
+        if (pipeStats().enabled) {
+            pipeStats().requestCommands.put(requestId, pipeStats().lastCommand);
+        }
+    } else {
+        putPipe(line);
+        asyncResults.put(requestId, getResult());
+    }
+    return requestId;
+}
+
+/*
+ * Returns true if GBufferedImage pixels can be passed to and from the Java
+ * back-end through shared memory rather than as Base64 text.
+ */
+static bool pipeHasSharedPixels() {
+    static int __pipeHasSharedPixels = -1;   // -1 means unknown
+    if (__pipeHasSharedPixels < 0) {
+        std::string jbeVersion = stanfordcpplib::getPlatform()->cpplib_getJavaBackEndVersion();
+        __pipeHasSharedPixels = jbeVersion >= STANFORD_JAVA_BACKEND_SHARED_PIXELS_VERSION ? 1 : 0;
+    }
+    return __pipeHasSharedPixels == 1;
+}
+
+/*
+ * Request ID of the most recent updateAllPixelsShared command, or -1 if the
+ * back-end is known to be done with the shared pixel memory.
+ */
+static int& sharedPixelsRequestId() {
+    static int __sharedPixelsRequestId = -1;
+    return __sharedPixelsRequestId;
+}
+
+/*
+ * Waits until the Java back-end has finished copying the last frame out of
+ * the shared pixel memory, so that the memory can be reused.
+ * Throws an error if the back-end failed to copy that frame.
+ */
+static void waitForSharedPixels() {
+    int& requestId = sharedPixelsRequestId();
+    if (requestId >= 0) {
+        std::string result = stanfordcpplib::getAsyncResult(requestId);
+        requestId = -1;
+        if (result != "ok") {
+            error("GBufferedImage::updateAllPixels: " + result);
+        }
+    }
+}
+
+namespace stanfordcpplib {
+std::string getAsyncResult(int requestId) {
+    return getResult(/* consumeAcks */ false, /* caller */ "", requestId);
+}
+} // namespace stanfordcpplib
+
+/*
+ * Returns a reference to the flag that is true once the Java back-end has
+ * agreed to receive commands in the binary pipe protocol.
+ */
+static bool& pipeIsBinary() {
+    static bool __pipeIsBinary = false;
+    return __pipeIsBinary;
+}
+
+/*
+ * Switches the command channel to the binary pipe protocol if the program
+ * asked for it, either by defining SPL_BINARY_PIPE_PROTOCOL at compile time
+ * or by setting the environment variable SPL_PIPE_PROTOCOL to "binary".
+ * Stays with the text protocol if the Java back-end is too old to know it.
+ */
+static void initPipeProtocol() {
+    if (stanfordcpplib::InProcessBackEnd::isEnabled()) {
+        return;   // no pipe to speak binary over
+    }
+#ifndef SPL_BINARY_PIPE_PROTOCOL
+    char* protocol = getenv("SPL_PIPE_PROTOCOL");
+    if (protocol == NULL || std::string(protocol) != "binary") {
+        return;
+    }
+#endif // SPL_BINARY_PIPE_PROTOCOL
+    std::string jbeVersion = stanfordcpplib::getPlatform()->cpplib_getJavaBackEndVersion();
+    if (jbeVersion < STANFORD_JAVA_BACKEND_BINARY_PROTOCOL_VERSION) {
+        return;
+    }
+    // the back-end switches right after replying, so nothing may be sent
+    // between this command and its result
+    putPipe("StanfordCppLib.setPipeProtocol(\"binary\")");
+    if (getResult() == "ok") {
+        pipeIsBinary() = true;
+    }
+}
+
+/*
+ * Returns the ID string by which the Java back-end knows the object at
+ * the given address.  The text commands write pointers to an ostream, whose
+ * format differs between C++ libraries, so binary frames must use exactly
+ * the same formatting for the IDs of the two paths to match.
+ */
+static std::string pointerToId(const void* p) {
+    std::ostringstream os;
+    os << p;
+    return os.str();
+}
+
+/*
+ * Returns the buffer of commands queued by putPipe that have not yet been
+ * written to the Java back-end.
+ * The buffer is never deleted, because cout is flushed into it by the
+ * standard library after static objects have been destroyed.
+ */
+static std::string& pipeOutBuffer() {
+    static std::string* __pipeOutBuffer = new std::string();
+    return *__pipeOutBuffer;
+}
+
+/*
+ * Returns a reference to the flag that is true once the program is exiting,
+ * after which commands are written to the pipe as soon as they are queued,
+ * since nothing else will flush them.
+ */
+static bool& pipeIsExiting() {
+    static bool __pipeIsExiting = false;
+    return __pipeIsExiting;
+}
+
+/*
+ * Writes the queued commands to the pipe if the buffer is full, or at once
+ * if the program is exiting.
+ */
+static void flushPipeIfFull() {
+    if (pipeIsExiting() || pipeOutBuffer().length() >= PIPE_WRITE_BUFFER_SIZE) {
+        stanfordcpplib::flushPipe();
+    }
+}
+
+/*
+ * Sends any commands still buffered when the program ends, and any that
+ * are queued after that, such as console output flushed during exit.
+ */
+static void flushPipeAtExit() {
+    pipeIsExiting() = true;
+    stanfordcpplib::flushPipe();
+}
+
+/*
+ * Returns a reference to the flag that is true once the Java back-end
+ * (or the in-process stand-in) has been started by ensureBackEndStarted.
+ */
+static bool& backEndStarted() {
+    static bool __backEndStarted = false;
+    return __backEndStarted;
+}
+
+/*
+ * Launches the Java back-end and introduces the C++ library to it, unless
+ * that has already been done.  putPipe calls this before sending anything,
+ * so programs that use only collections, strings and files never pay for
+ * starting a JVM.
+ */
+static void ensureBackEndStarted() {
+    if (backEndStarted()) {
+        return;
+    }
+    backEndStarted() = true;   // set first; the calls below send commands
+    if (!stanfordcpplib::InProcessBackEnd::isEnabled()) {
+        initPipe();
+    }
+    stanfordcpplib::getPlatform()->cpplib_setCppLibraryVersion();
+    initPipeProtocol();
+}
+
+/*
+ * Returns the command name that pipe statistics use for frames of the
+ * given binary opcode, matching the name of the equivalent text command.
+ */
+static std::string pipeOpcodeName(PipeOpcode opcode) {
+    switch (opcode) {
+    case PIPE_OP_GBUFFEREDIMAGE_SETRGB:
+        return "GBufferedImage.setRGB";
+    case PIPE_OP_GOBJECT_SETLOCATION:
+        return "GObject.setLocation";
+    case PIPE_OP_GPOLYGON_ADDVERTEX:
+        return "GPolygon.addVertex";
+    default:
+        return "(text command)";
+    }
+}
+
+/*
+ * Returns the per-command pipe statistics, which start out enabled if the
+ * library was compiled with SPL_PIPE_STATS or SPL_PIPE_STATS=1 is set in
+ * the environment.
+ * Like the command buffer, the statistics are never deleted, since commands
+ * can still be counted while the program exits.
+ */
+static PipeStatsState& pipeStats() {
+    static PipeStatsState* __pipeStats = NULL;
+    if (!__pipeStats) {
+        __pipeStats = new PipeStatsState();
+#ifdef SPL_PIPE_STATS
+        __pipeStats->enabled = true;
+#else
+        char* stats = getenv("SPL_PIPE_STATS");
+        __pipeStats->enabled = stats != NULL && std::string(stats) == "1";
+#endif // SPL_PIPE_STATS
+    }
+    return *__pipeStats;
+}
+
+static void printPipeStatsAtExit() {
+    // std::cerr may be redirected to the graphical console, which is gone by now
+    std::ostringstream out;
+    stanfordcpplib::printPipeStats(out);
+    fputs(out.str().c_str(), stderr);
+    fflush(stderr);
+}
+
+/*
+ * Counts one command sent to the back-end, of the given size in bytes.
+ * The command name is the text before its '(' (and after any "#ID " tag).
+ */
+static void recordPipeCommand(const std::string& command, size_t bytes) {
+    PipeStatsState& state = pipeStats();
+    size_t start = startsWith(command, "#") ? command.find(' ') + 1 : 0;
+    size_t paren = command.find('(', start);
+    state.lastCommand = command.substr(start, paren == std::string::npos ? paren : paren - start);
+    stanfordcpplib::PipeCommandStats& stats = state.commands[state.lastCommand];
+    stats.calls++;
+    stats.bytesSent += bytes;
+}
+
+/*
+ * Counts one line read from the back-end against the command whose reply
+ * getResult is waiting for, or against "(events)" if it is an event.
+ */
+static void countPipeLineReceived(const std::string& line) {
+    PipeStatsState& state = pipeStats();
+    if (!state.enabled) {
+        return;
+    }
+    if (startsWith(line, "event:")) {
+        stanfordcpplib::PipeCommandStats& stats = state.commands["(events)"];
+        stats.calls++;
+        stats.bytesReceived += line.length() + 1;
+    } else {
+        stanfordcpplib::PipeCommandStats& stats = state.commands[state.waitingFor];
+        stats.bytesReceived += line.length() + 1;
+        if (startsWith(line, "result:___jbe___ack___")) {
+            stats.ackWaits++;
+        }
+    }
+}
+
+namespace stanfordcpplib {
+void flushPipe() {
+    std::string& buffer = pipeOutBuffer();
+    if (!buffer.empty()) {
+        writePipe(buffer.c_str(), buffer.length());
+        buffer.clear();
+    }
+}
+} // namespace stanfordcpplib
+
+/*
+ * Reads the lines of a 'long' result (sent across multiple lines) up to
+ * the closing "result_long:end" line, and returns them joined together.
+ */
+static std::string readLongResult() {
+    std::ostringstream os;
+    std::string nextLine = getPipeLine(/* allowEvents */ false);
+    countPipeLineReceived(nextLine);
+    while (nextLine != "result_long:end") {
+        os << nextLine;
+#ifdef PIPE_DEBUG
+        fprintf(stderr, "getResult(): appended line (length so far: %d)\n", (int) os.str().length());  fflush(stderr);
+#endif
+        nextLine = getPipeLine(/* allowEvents */ false);
+        countPipeLineReceived(nextLine);
+    }
+    std::string result = os.str();
+#ifdef PIPE_DEBUG
+    fprintf(stderr, "getResult(): returning long string \"%s ... %s\" (length %d)\n",
+            result.substr(0, 10).c_str(),
+            result.substr(result.length() - 10, 10).c_str(),
+            (int) result.length());  fflush(stderr);
+#endif
+    return result;
+}
+
+/*
+ * Throws an ErrorException for an error message sent by the Java back-end.
+ */
+static void backEndError(const std::string& message) {
+    std::ostringstream out;
+    out << "ERROR emitted from Stanford Java back-end process:"
+        << std::endl << message;
+    error(out.str());
+}
+
+/*
+ * Waits for and returns the next result from the Java back-end, handling
+ * any events and back-end errors that arrive first.
+ * Results tagged with a request ID ("result#ID:") are set aside in
+ * asyncResults for their PlatformFuture.  If requestId is non-negative,
+ * waits for the result tagged with that ID instead of an untagged one;
+ * if that result is an error, it is thrown here rather than returned.
+ */
+static std::string getResult(bool consumeAcks, const std::string& caller, int requestId) {
+    // any queued commands must reach the back-end before we wait for its reply
+    stanfordcpplib::flushPipe();
+    PipeWaitTimer waitTimer(requestId);
+    while (true) {
+        if (requestId >= 0 && asyncResults.containsKey(requestId)) {
+            std::string result = asyncResults.get(requestId);
+            asyncResults.remove(requestId);
+            if (asyncErrors.contains(requestId)) {
+                asyncErrors.remove(requestId);
+                backEndError(result);
+            }
+            return result;
+        }
+#ifdef PIPE_DEBUG
+        fprintf(stderr, "getResult(): calling getPipe() ...\n");  fflush(stderr);
+#endif
+        waitTimer.readingPipe();
+        std::string line = getPipeLine(/* allowEvents */ true);
+        countPipeLineReceived(line);
+
+        bool isResult        = startsWith(line, "result:");
+        bool isResultLong    = startsWith(line, "result_long:");
+        bool isTagged        = startsWith(line, "result#") || startsWith(line, "result_long#");
+        bool isEvent         = startsWith(line, "event:");
+        bool isAck           = startsWith(line, "result:___jbe___ack___");
+        bool hasACMException = line.find("acm.util.ErrorException") != std::string::npos;
+        bool hasException    = line.find("xception") != std::string::npos;
+        bool hasError        = line.find("Unexpected error") != std::string::npos;
+
+        if (isTagged) {
+            // a reply to a request sent by putPipeRequest; save it for its future
+            size_t hash = line.find('#');
+            size_t colon = line.find(':', hash);
+            int id = stringToInteger(line.substr(hash + 1, colon - hash - 1));
+            if (startsWith(line, "result_long#")) {
+                asyncResults.put(id, readLongResult());
+            } else {
+                // an error is kept until its future asks for it, so that it
+                // is thrown from the call it belongs to
+                if (hasACMException) {
+                    asyncErrors.add(id);
+                }
+                asyncResults.put(id, line.substr(colon + 1));
+            }
+        } else if (isResultLong) {
+            return readLongResult();
+        } else if (((isResult || isEvent) && hasACMException) ||
+                (!isResult && !isEvent && (hasException || hasError))) {
+            // an error message from the back-end; throw it here
+            if (isResult) {
+                line = line.substr(7);
+            } else if (isEvent) {
+                line = line.substr(6);
+            }
+            backEndError(line);
+        } else if (isResult && requestId >= 0) {
+            // untagged acks are not what a future is waiting for; skip them
+        } else if (isResult) {
+            // a regular result
+            if (!isAck || !consumeAcks) {
+                std::string result = line.substr(7);
 #ifdef PIPE_DEBUG
                 fprintf(stderr, "getResult(): returning regular result (length %d): \"%s\"\n", (int) result.length(), result.c_str());  fflush(stderr);
 #endif
@@ -2580,6 +3820,18 @@ static std::string getSplJarPath() {
     return jarName;
 }
 
+/*
+ * Returns the next reply of the in-process back-end, which answers every
+ * command as soon as it is sent, so a missing reply would never come.
+ */
+static std::string getInProcessLine() {
+    std::string line;
+    if (!stanfordcpplib::InProcessBackEnd::instance().readLine(line)) {
+        error("in-process back-end: no reply to read; command not supported");
+    }
+    return line;
+}
+
 static void getStatus() {
     std::string result = getResult();
     if (result != "ok") {
@@ -2587,6 +3839,150 @@ static void getStatus() {
     }
 }
 
+namespace stanfordcpplib {
+PipeReadStats getPipeReadStats() {
+    PipeReadStats stats;
+    stats.bytes = pipeReadStats.bytes.load(std::memory_order_relaxed);
+    stats.lines = pipeReadStats.lines.load(std::memory_order_relaxed);
+    stats.syscalls = pipeReadStats.syscalls.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// values below this are bucketed exactly; above it, each power of two
+// is split into this many buckets
+static const int HISTOGRAM_SUB_BUCKETS = 16;
+static const int HISTOGRAM_SUB_BUCKET_BITS = 4;
+static const int HISTOGRAM_MAX_BITS = 40;   // about 12 days in microseconds
+
+LatencyHistogram::LatencyHistogram()
+        : buckets(HISTOGRAM_SUB_BUCKETS * (HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BUCKET_BITS + 1)),
+          count(0),
+          max(0),
+          total(0) {
+    // empty
+}
+
+void LatencyHistogram::record(long micros) {
+    if (micros < 0) {
+        micros = 0;
+    }
+    buckets[bucketIndex(micros)]++;
+    count++;
+    total += micros;
+    max = std::max(max, micros);
+}
+
+long LatencyHistogram::getCount() const {
+    return count;
+}
+
+long LatencyHistogram::getMax() const {
+    return max;
+}
+
+double LatencyHistogram::getMean() const {
+    return count == 0 ? 0.0 : (double) total / count;
+}
+
+long LatencyHistogram::getTotal() const {
+    return total;
+}
+
+long LatencyHistogram::getPercentile(double fraction) const {
+    long needed = (long) std::ceil(fraction * count);
+    long seen = 0;
+    for (int i = 0; i < (int) buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= needed && seen > 0) {
+            return std::min(bucketEnd(i), max);
+        }
+    }
+    return max;
+}
+
+int LatencyHistogram::bucketIndex(long micros) {
+    if (micros < HISTOGRAM_SUB_BUCKETS) {
+        return (int) micros;
+    }
+    int bits = 0;   // position of highest set bit
+    while ((micros >> (bits + 1)) != 0 && bits + 1 < HISTOGRAM_MAX_BITS) {
+        bits++;
+    }
+    int shift = bits - HISTOGRAM_SUB_BUCKET_BITS;
+    int sub = (int) std::min(micros >> shift, (long) 2 * HISTOGRAM_SUB_BUCKETS - 1) - HISTOGRAM_SUB_BUCKETS;
+    return HISTOGRAM_SUB_BUCKETS * (shift + 1) + sub;
+}
+
+long LatencyHistogram::bucketEnd(int index) {
+    if (index < HISTOGRAM_SUB_BUCKETS) {
+        return index;
+    }
+    int shift = index / HISTOGRAM_SUB_BUCKETS - 1;
+    long sub = index % HISTOGRAM_SUB_BUCKETS + HISTOGRAM_SUB_BUCKETS;
+    return ((sub + 1) << shift) - 1;
+}
+
+PipeCommandStats::PipeCommandStats()
+        : calls(0),
+          bytesSent(0),
+          bytesReceived(0),
+          ackWaits(0) {
+    // empty
+}
+
+void setPipeStatsEnabled(bool enabled) {
+    pipeStats().enabled = enabled;
+}
+
+bool isPipeStatsEnabled() {
+    return pipeStats().enabled;
+}
+
+std::vector<PipeCommandStats> getPipeCommandStats() {
+    std::vector<PipeCommandStats> result;
+    PipeStatsState& state = pipeStats();
+    for (const std::string& command : state.commands) {
+        result.push_back(state.commands[command]);
+        result.back().command = command;
+    }
+    std::sort(result.begin(), result.end(),
+              [](const PipeCommandStats& a, const PipeCommandStats& b) {
+        if (a.waits.getTotal() != b.waits.getTotal()) {
+            return a.waits.getTotal() > b.waits.getTotal();
+        }
+        return a.calls > b.calls;
+    });
+    return result;
+}
+
+void printPipeStats(std::ostream& out) {
+    std::vector<PipeCommandStats> stats = getPipeCommandStats();
+    out << "Pipe statistics (times in microseconds):" << std::endl;
+    out << std::left << std::setw(36) << "command" << std::right
+        << std::setw(9) << "calls" << std::setw(11) << "sent" << std::setw(11) << "received"
+        << std::setw(7) << "acks" << std::setw(8) << "waits" << std::setw(11) << "total"
+        << std::setw(9) << "mean" << std::setw(9) << "p50" << std::setw(9) << "p90"
+        << std::setw(9) << "p99" << std::setw(10) << "max" << std::endl;
+    for (const PipeCommandStats& s : stats) {
+        out << std::left << std::setw(36) << s.command << std::right
+            << std::setw(9) << s.calls << std::setw(11) << s.bytesSent
+            << std::setw(11) << s.bytesReceived << std::setw(7) << s.ackWaits
+            << std::setw(8) << s.waits.getCount() << std::setw(11) << s.waits.getTotal()
+            << std::setw(9) << (long) s.waits.getMean()
+            << std::setw(9) << s.waits.getPercentile(0.50)
+            << std::setw(9) << s.waits.getPercentile(0.90)
+            << std::setw(9) << s.waits.getPercentile(0.99)
+            << std::setw(10) << s.waits.getMax() << std::endl;
+    }
+}
+
+void resetPipeStats() {
+    PipeStatsState& state = pipeStats();
+    state.commands.clear();
+    state.requestCommands.clear();
+}
+} // namespace stanfordcpplib
+
 static std::string& programName() {
     static std::string __programName;
     return __programName;
@@ -2866,6 +4262,9 @@ void putConsole(const std::string& str, bool isStderr) {
 
     os << "," << std::boolalpha << isStderr << ")";
     putPipe(os.str());
+    if (isStderr) {
+        flushPipe();   // like cerr, error output is not held back
+    }
     echoConsole(str, isStderr);
 }
 
@@ -2895,6 +4294,7 @@ void echoConsole(const std::string&, bool) {
 
 void endLineConsole(bool isStderr) {
     putPipe("JBEConsole.println()");
+    flushPipe();   // console output is line-buffered, like a terminal
     echoConsole("\n", isStderr);
 }
 
@@ -2938,8 +4338,12 @@ void initializeStanfordCppLibrary() {
     setConsolePrintExceptions(true);
 #endif
 
-    initPipe();
-    getPlatform()->cpplib_setCppLibraryVersion();
+    // the back-end itself is started by ensureBackEndStarted when needed
+    pipeOutBuffer().reserve(PIPE_WRITE_BUFFER_SIZE);
+    atexit(flushPipeAtExit);
+    if (pipeStats().enabled) {
+        atexit(printPipeStatsAtExit);
+    }
 }
 
 /*
@@ -5,6 +5,13 @@
  * the platform-specific parts of the StanfordCPPLib package.  This file is
  * logically part of the implementation and is not interesting to clients.
  *
+ * @version 2016/10/04
+ * - added PipeReadStats and getPipeReadStats
+ * - added flushPipe
+ * - added PlatformFuture and Async variants of getBounds, GImage constructor,
+ *   GBufferedImage load, and regex match
+ * - added gbufferedimage_loadShared and gbufferedimage_updateAllPixelsShared
+ * - added per-command pipe statistics (PipeCommandStats, printPipeStats)
  * @version 2016/09/26
  * - added Note playing methods
  * @version 2016/08/02
@@ -32,14 +39,73 @@
 #ifndef _platform_h
 #define _platform_h
 
+#include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
+#include "error.h"
 #include "gevents.h"
+#include "grid.h"
 #include "gwindow.h"
 #include "point.h"
 #include "sound.h"
 
 namespace stanfordcpplib {
+
+/*
+ * Waits for the reply to the request with the given ID; used by PlatformFuture.
+ */
+std::string getAsyncResult(int requestId);
+
+/*
+ * The eventual result of a Platform call whose command was sent to the
+ * Java back-end without waiting for the reply.  Many such calls can be
+ * issued back to back and their results collected afterward with get(),
+ * which waits for the reply only if it has not arrived yet.
+ * Copies of a future share the same result.
+ */
+template <typename T>
+class PlatformFuture {
+public:
+    /*
+     * Creates an empty future so that futures can be stored in collections;
+     * calling get() on it is an error.
+     */
+    PlatformFuture() {
+        // empty
+    }
+
+    PlatformFuture(int requestId, T (*convert)(const std::string&))
+            : state(new State()) {
+        state->requestId = requestId;
+        state->convert = convert;
+        state->done = false;
+    }
+
+    /*
+     * Returns the result of the call, waiting for it if necessary.
+     */
+    T get() {
+        if (!state) {
+            error("PlatformFuture::get: future is not associated with a request");
+        }
+        if (!state->done) {
+            state->value = state->convert(getAsyncResult(state->requestId));
+            state->done = true;
+        }
+        return state->value;
+    }
+
+private:
+    struct State {
+        int requestId;
+        T (*convert)(const std::string&);
+        bool done;
+        T value;
+    };
+    std::shared_ptr<State> state;
+};
+
 class Platform {
 private:
     Platform();
@@ -93,10 +159,13 @@ public:
     void gbufferedimage_fill(GObject* gobj, int rgb);
     void gbufferedimage_fillRegion(GObject* gobj, double x, double y, double width, double height, int rgb);
     std::string gbufferedimage_load(GObject* gobj, const std::string& filename);
+    PlatformFuture<std::string> gbufferedimage_loadAsync(GObject* gobj, const std::string& filename);
+    bool gbufferedimage_loadShared(GObject* gobj, const std::string& filename, Grid<int>& pixels);
     void gbufferedimage_resize(GObject* gobj, double width, double height, bool retain = true);
     std::string gbufferedimage_save(const GObject* const gobj, const std::string& filename);
     void gbufferedimage_setRGB(GObject* gobj, double x, double y, int rgb);
     void gbufferedimage_updateAllPixels(GObject* gobj, const std::string& base64);
+    bool gbufferedimage_updateAllPixelsShared(GObject* gobj, const Grid<int>& pixels);
     void gbutton_constructor(GObject* gobj, std::string label);
     void gcheckbox_constructor(GObject* gobj, std::string label);
     bool gcheckbox_isSelected(GObject* gobj);
@@ -112,6 +181,7 @@ public:
     std::string gfilechooser_showOpenDialog(std::string currentDir);
     std::string gfilechooser_showSaveDialog(std::string currentDir);
     GDimension gimage_constructor(GObject* gobj, std::string filename);
+    PlatformFuture<GDimension> gimage_constructorAsync(GObject* gobj, std::string filename);
     GDimension ginteractor_getSize(GObject* gobj);
     bool ginteractor_isEnabled(GObject* gint);
     void ginteractor_setActionCommand(GObject* gobj, std::string cmd);
@@ -131,6 +201,7 @@ public:
     bool gobject_contains(const GObject* gobj, double x, double y);
     void gobject_delete(GObject* gobj);
     GRectangle gobject_getBounds(const GObject* gobj);
+    PlatformFuture<GRectangle> gobject_getBoundsAsync(const GObject* gobj);
     void gobject_remove(GObject* gobj);
     void gobject_rotate(GObject* gobj, double theta);
     void gobject_scale(GObject* gobj, double sx, double sy);
@@ -252,6 +323,7 @@ public:
     void note_play(const std::string& noteString);
     std::string os_getLastError();
     bool regex_match(std::string s, std::string regexp);
+    PlatformFuture<bool> regex_matchAsync(std::string s, std::string regexp);
     int regex_matchCount(std::string s, std::string regexp);
     int regex_matchCountWithLines(std::string s, std::string regexp, std::string& linesOut);
     std::string regex_replace(std::string s, std::string regexp, std::string replacement, int limit = -1);
@@ -265,6 +337,108 @@ public:
 /* free function to get a reference to the singleton Platform instance */
 Platform* getPlatform();
 
+/*
+ * Running totals of data read from the Java back-end pipe.
+ * Used to benchmark how many system calls each line of back-end output costs.
+ */
+struct PipeReadStats {
+    long bytes;      // bytes read from the pipe
+    long lines;      // lines handed to the result/event parser
+    long syscalls;   // read() (or ReadFile) calls made on the pipe
+};
+
+PipeReadStats getPipeReadStats();
+
+/*
+ * A histogram of latencies in microseconds, in the style of an HDR histogram:
+ * each power of two is split into 16 linear buckets, so any recorded value
+ * is known to within about 6% while the whole histogram stays a fixed size.
+ */
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    /* Adds one latency of the given number of microseconds. */
+    void record(long micros);
+
+    long getCount() const;
+    long getMax() const;
+    double getMean() const;
+    long getTotal() const;
+
+    /*
+     * Returns the latency below which the given fraction (0.0 - 1.0) of the
+     * recorded latencies fall, rounded up to the end of its bucket.
+     */
+    long getPercentile(double fraction) const;
+
+private:
+    static int bucketIndex(long micros);
+    static long bucketEnd(int index);
+
+    std::vector<long> buckets;
+    long count;
+    long max;
+    long total;
+};
+
+/*
+ * Running totals of pipe traffic for one kind of command sent to the Java
+ * back-end, such as "GObject.setLocation".  Replies are charged to the
+ * command that is waiting for them; event lines are charged to "(events)".
+ */
+struct PipeCommandStats {
+    std::string command;
+    long calls;                 // commands sent
+    long bytesSent;
+    long bytesReceived;
+    long ackWaits;              // acks read while waiting for a reply
+    LatencyHistogram waits;     // time blocked in getResult per reply, in us
+
+    PipeCommandStats();
+};
+
+/*
+ * Turns counting of per-command pipe statistics on or off.
+ * Counting starts on if the library is compiled with SPL_PIPE_STATS defined
+ * or the SPL_PIPE_STATS environment variable is set to 1; in that case the
+ * statistics are also printed to stderr when the program exits.
+ */
+void setPipeStatsEnabled(bool enabled);
+bool isPipeStatsEnabled();
+
+/*
+ * Returns the statistics counted so far, one entry per command name,
+ * ordered with the command that spent the most time waiting first.
+ */
+std::vector<PipeCommandStats> getPipeCommandStats();
+
+/*
+ * Prints the statistics counted so far as a table, one line per command.
+ */
+void printPipeStats(std::ostream& out = std::cerr);
+
+/*
+ * Discards the statistics counted so far.
+ */
+void resetPipeStats();
+
+/*
+ * Writes any commands buffered for the Java back-end to the pipe right away.
+ * Commands are otherwise sent in bulk when the buffer fills up, before any
+ * call that waits for a reply, at the end of each console line, and when
+ * the program exits.
+ */
+void flushPipe();
+
+/*
+ * Deletes the file through which GBufferedImage pixels are shared with the
+ * Java back-end, if one was created.  Called when the program exits, and
+ * from the library's signal and terminate handlers, which skip the normal
+ * exit path; only async-signal-safe calls are made.
+ */
+void removeSharedPixelFile();
+
 // functions to interact with the graphical console through the platform
 std::string getLineConsole();
 void initializeGraphicalConsole();
@@ -0,0 +1,471 @@
+/*
+ * File: ringbuffer.h
+ * ------------------
+ * This file exports the internal-use-only <code>RingBuffer</code> class,
+ * the growable circular array that stores the elements of a
+ * <code>Queue</code> or <code>Deque</code>.
+ * Clients should use those classes rather than this one.
+ *
+ * @version 2016/10/14
+ * - initial version
+ * @since 2016/10/14
+ */
+
+#ifndef _ringbuffer_h
+#define _ringbuffer_h
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+namespace stanfordcpplib {
+namespace collections {
+
+/*
+ * Class: RingBuffer<ValueType>
+ * ----------------------------
+ * A sequence of elements that can be added and removed at either end in
+ * constant time.  Element i from the front can be read directly, and the
+ * elements always lie in at most two contiguous runs of memory, so that
+ * bulk operations can copy or move whole runs at once.
+ *
+ * No operation checks its arguments; the collections built on this class
+ * report errors such as removing from an empty queue themselves.
+ */
+template <typename ValueType>
+class RingBuffer {
+public:
+    /*
+     * A contiguous run of elements, usable in a range-based for loop.
+     */
+    template <typename T>
+    struct Span {
+        T* data;
+        int size;
+
+        T* begin() const {
+            return data;
+        }
+
+        T* end() const {
+            return data + size;
+        }
+    };
+
+    RingBuffer() : elements(NULL), capacity(0), head(0), count(0) {
+        // empty
+    }
+
+    RingBuffer(const RingBuffer& src) : elements(NULL), capacity(0), head(0), count(0) {
+        appendCopies(src);
+    }
+
+    RingBuffer(RingBuffer&& src) noexcept
+            : elements(src.elements),
+              capacity(src.capacity),
+              head(src.head),
+              count(src.count) {
+        src.elements = NULL;
+        src.capacity = src.head = src.count = 0;
+    }
+
+    ~RingBuffer() {
+        clear();
+        AllocatorTraits::deallocate(allocator, elements, capacity);
+    }
+
+    RingBuffer& operator =(const RingBuffer& src) {
+        if (this != &src) {
+            clear();
+            appendCopies(src);
+        }
+        return *this;
+    }
+
+    RingBuffer& operator =(RingBuffer&& src) noexcept {
+        if (this != &src) {
+            clear();
+            AllocatorTraits::deallocate(allocator, elements, capacity);
+            elements = src.elements;
+            capacity = src.capacity;
+            head = src.head;
+            count = src.count;
+            src.elements = NULL;
+            src.capacity = src.head = src.count = 0;
+        }
+        return *this;
+    }
+
+    /*
+     * Returns the number of elements in the buffer.
+     */
+    int size() const {
+        return count;
+    }
+
+    /*
+     * Returns the element i places from the front, which must exist.
+     */
+    ValueType& operator [](int i) {
+        return elements[(head + i) & (capacity - 1)];
+    }
+
+    const ValueType& operator [](int i) const {
+        return elements[(head + i) & (capacity - 1)];
+    }
+
+    ValueType& front() {
+        return elements[head];
+    }
+
+    const ValueType& front() const {
+        return elements[head];
+    }
+
+    ValueType& back() {
+        return (*this)[count - 1];
+    }
+
+    const ValueType& back() const {
+        return (*this)[count - 1];
+    }
+
+    /*
+     * Returns the two runs that hold the elements from front to back.
+     * The second run is empty unless the elements wrap around the end
+     * of the array.
+     */
+    Span<ValueType> firstSpan() {
+        Span<ValueType> span = {elements + head, std::min(count, capacity - head)};
+        return span;
+    }
+
+    Span<const ValueType> firstSpan() const {
+        Span<const ValueType> span = {elements + head, std::min(count, capacity - head)};
+        return span;
+    }
+
+    Span<ValueType> secondSpan() {
+        Span<ValueType> span = {elements, count - std::min(count, capacity - head)};
+        return span;
+    }
+
+    Span<const ValueType> secondSpan() const {
+        Span<const ValueType> span = {elements, count - std::min(count, capacity - head)};
+        return span;
+    }
+
+    /*
+     * Constructs a new element at the back or the front from the given
+     * constructor arguments, which may refer to elements of this buffer.
+     */
+    template <typename... Args>
+    void emplaceBack(Args&&... args) {
+        int n = count;
+        if (n < capacity) {
+            AllocatorTraits::construct(allocator, elements + ((head + n) & (capacity - 1)),
+                                       std::forward<Args>(args)...);
+        } else {
+            // build the new element before the old ones move out from under args
+            int newCapacity = nextCapacity(n + 1);
+            ValueType* array = AllocatorTraits::allocate(allocator, newCapacity);
+            AllocatorTraits::construct(allocator, array + n, std::forward<Args>(args)...);
+            relocate(array, newCapacity);
+        }
+        count = n + 1;
+    }
+
+    template <typename... Args>
+    void emplaceFront(Args&&... args) {
+        if (count < capacity) {
+            int index = (head - 1) & (capacity - 1);
+            AllocatorTraits::construct(allocator, elements + index, std::forward<Args>(args)...);
+            head = index;
+        } else {
+            int newCapacity = nextCapacity(count + 1);
+            ValueType* array = AllocatorTraits::allocate(allocator, newCapacity);
+            AllocatorTraits::construct(allocator, array + newCapacity - 1, std::forward<Args>(args)...);
+            relocate(array, newCapacity);
+            head = newCapacity - 1;
+        }
+        count++;
+    }
+
+    /*
+     * Appends n elements read from the given iterator, growing the array
+     * at most once and filling the free space as at most two runs.
+     * The iterator may be one of this buffer's own, since those track
+     * their position by index and survive the array being replaced.
+     */
+    template <typename IteratorType>
+    void appendRange(IteratorType itr, int n) {
+        reserve(count + n);
+        int start = (head + count) & (capacity - 1);
+        int firstRun = std::min(n, capacity - start);
+        for (int i = 0; i < firstRun; i++, ++itr) {
+            AllocatorTraits::construct(allocator, elements + start + i, *itr);
+            count++;
+        }
+        for (int i = 0; i < n - firstRun; i++, ++itr) {
+            AllocatorTraits::construct(allocator, elements + i, *itr);
+            count++;
+        }
+    }
+
+    /*
+     * Removes the front or back element, which must exist, and returns it.
+     */
+    ValueType popFront() {
+        ValueType result = std::move(elements[head]);
+        AllocatorTraits::destroy(allocator, elements + head);
+        head = (head + 1) & (capacity - 1);
+        count--;
+        return result;
+    }
+
+    ValueType popBack() {
+        ValueType* last = &back();
+        ValueType result = std::move(*last);
+        AllocatorTraits::destroy(allocator, last);
+        count--;
+        return result;
+    }
+
+    /*
+     * Removes the first n elements, of which there must be at least n,
+     * and adds them in order to the end of out, moving each one.
+     */
+    template <typename CollectionType>
+    void popFrontInto(int n, CollectionType& out) {
+        int firstRun = std::min(n, capacity - head);
+        moveRun(elements + head, firstRun, out);
+        moveRun(elements, n - firstRun, out);
+        head = (head + n) & (capacity - 1);
+        count -= n;
+    }
+
+    /*
+     * Removes every element, keeping the array for reuse.
+     */
+    void clear() {
+        destroyRun(firstSpan());
+        destroyRun(secondSpan());
+        head = 0;
+        count = 0;
+    }
+
+    /*
+     * Makes room for at least n elements without further allocation.
+     */
+    void reserve(int n) {
+        if (n > capacity) {
+            int newCapacity = nextCapacity(n);
+            relocate(AllocatorTraits::allocate(allocator, newCapacity), newCapacity);
+        }
+    }
+
+    /*
+     * Iterator support
+     * ----------------
+     * Iterators refer to an element by its distance from the front, so
+     * they are random-access and stay meaningful while the array grows.
+     */
+    template <typename RingType, typename T>
+    class RingIterator : public std::iterator<std::random_access_iterator_tag, T> {
+    public:
+        RingIterator() : rp(NULL), index(0) {
+            // empty
+        }
+
+        RingIterator(RingType* rp, int index) : rp(rp), index(index) {
+            // empty
+        }
+
+        /* converts an iterator to a const_iterator */
+        template <typename OtherRingType, typename OtherT>
+        RingIterator(const RingIterator<OtherRingType, OtherT>& it) : rp(it.rp), index(it.index) {
+            // empty
+        }
+
+        RingIterator& operator ++() {
+            index++;
+            return *this;
+        }
+
+        RingIterator operator ++(int) {
+            RingIterator copy(*this);
+            index++;
+            return copy;
+        }
+
+        RingIterator& operator --() {
+            index--;
+            return *this;
+        }
+
+        RingIterator operator --(int) {
+            RingIterator copy(*this);
+            index--;
+            return copy;
+        }
+
+        RingIterator& operator +=(int k) {
+            index += k;
+            return *this;
+        }
+
+        RingIterator& operator -=(int k) {
+            index -= k;
+            return *this;
+        }
+
+        RingIterator operator +(int k) const {
+            return RingIterator(rp, index + k);
+        }
+
+        RingIterator operator -(int k) const {
+            return RingIterator(rp, index - k);
+        }
+
+        int operator -(const RingIterator& rhs) const {
+            return index - rhs.index;
+        }
+
+        bool operator ==(const RingIterator& rhs) const {
+            return rp == rhs.rp && index == rhs.index;
+        }
+
+        bool operator !=(const RingIterator& rhs) const {
+            return !(*this == rhs);
+        }
+
+        bool operator <(const RingIterator& rhs) const {
+            return index < rhs.index;
+        }
+
+        bool operator <=(const RingIterator& rhs) const {
+            return index <= rhs.index;
+        }
+
+        bool operator >(const RingIterator& rhs) const {
+            return index > rhs.index;
+        }
+
+        bool operator >=(const RingIterator& rhs) const {
+            return index >= rhs.index;
+        }
+
+        T& operator *() const {
+            return (*rp)[index];
+        }
+
+        T* operator ->() const {
+            return &(*rp)[index];
+        }
+
+        T& operator [](int k) const {
+            return (*rp)[index + k];
+        }
+
+    private:
+        RingType* rp;
+        int index;
+
+        template <typename OtherRingType, typename OtherT>
+        friend class RingIterator;
+    };
+
+    typedef RingIterator<RingBuffer, ValueType> iterator;
+    typedef RingIterator<const RingBuffer, const ValueType> const_iterator;
+
+    iterator begin() {
+        return iterator(this, 0);
+    }
+
+    const_iterator begin() const {
+        return const_iterator(this, 0);
+    }
+
+    iterator end() {
+        return iterator(this, count);
+    }
+
+    const_iterator end() const {
+        return const_iterator(this, count);
+    }
+
+private:
+    /* Constant definitions */
+    static const int INITIAL_CAPACITY = 16;   // must be a power of two
+
+    typedef std::allocator<ValueType> Allocator;
+    typedef std::allocator_traits<Allocator> AllocatorTraits;
+
+    /*
+     * The array is raw memory: only the count slots starting at head,
+     * wrapping around at the end, hold constructed elements.  The
+     * capacity is 0 or a power of two, so a position is reduced to a
+     * slot with a mask rather than a division.
+     */
+    Allocator allocator;
+    ValueType* elements;
+    int capacity;
+    int head;
+    int count;
+
+    /*
+     * Returns the capacity to grow to in order to hold n elements: at
+     * least double the current one, so that growth is amortized.
+     */
+    int nextCapacity(int n) const {
+        int newCapacity = std::max(capacity, INITIAL_CAPACITY / 2);
+        do {
+            newCapacity *= 2;
+        } while (newCapacity < n);
+        return newCapacity;
+    }
+
+    /*
+     * Moves the elements to the start of the given new array, in order,
+     * and frees the old one.
+     */
+    void relocate(ValueType* array, int newCapacity) {
+        int i = 0;
+        for (ValueType& value : firstSpan()) {
+            AllocatorTraits::construct(allocator, array + i++, std::move(value));
+        }
+        for (ValueType& value : secondSpan()) {
+            AllocatorTraits::construct(allocator, array + i++, std::move(value));
+        }
+        clear();
+        AllocatorTraits::deallocate(allocator, elements, capacity);
+        elements = array;
+        capacity = newCapacity;
+        count = i;
+    }
+
+    void appendCopies(const RingBuffer& src) {
+        appendRange(src.begin(), src.count);
+    }
+
+    void destroyRun(Span<ValueType> span) {
+        for (ValueType& value : span) {
+            AllocatorTraits::destroy(allocator, &value);
+        }
+    }
+
+    template <typename CollectionType>
+    void moveRun(ValueType* run, int n, CollectionType& out) {
+        for (int i = 0; i < n; i++) {
+            out.add(std::move(run[i]));
+        }
+        Span<ValueType> span = {run, n};
+        destroyRun(span);
+    }
+};
+
+} // namespace collections
+} // namespace stanfordcpplib
+
+#endif // _ringbuffer_h
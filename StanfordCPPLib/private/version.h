@@ -43,6 +43,40 @@
  */
 #define STANFORD_JAVA_BACKEND_MINIMUM_VERSION "2016/09/26"
 
+/*
+ * Minimum version of Java back-end spl.jar that understands the binary
+ * pipe protocol.  platform.cpp only switches to the binary protocol if
+ * spl.jar is at least this new, and otherwise keeps the text protocol.
+ *
+ * NOTE: This value and the other date values here all
+ *       *MUST* be zero-padded to YYYY/MM/DD format;
+ *       if month or day is < 10, insert a preceding 0
+ */
+#define STANFORD_JAVA_BACKEND_BINARY_PROTOCOL_VERSION "2016/10/06"
+
+/*
+ * Minimum version of Java back-end spl.jar that tags its replies with the
+ * request IDs sent by the C++ library.  With older versions, requests made
+ * through the Async Platform methods are completed one at a time.
+ *
+ * NOTE: This value and the other date values here all
+ *       *MUST* be zero-padded to YYYY/MM/DD format;
+ *       if month or day is < 10, insert a preceding 0
+ */
+#define STANFORD_JAVA_BACKEND_REQUEST_ID_VERSION "2016/10/10"
+
+/*
+ * Minimum version of Java back-end spl.jar that can read and write
+ * GBufferedImage pixels through a memory-mapped file shared with the
+ * C++ library.  With older versions, pixels are sent through the pipe
+ * as Base64 text.
+ *
+ * NOTE: This value and the other date values here all
+ *       *MUST* be zero-padded to YYYY/MM/DD format;
+ *       if month or day is < 10, insert a preceding 0
+ */
+#define STANFORD_JAVA_BACKEND_SHARED_PIXELS_VERSION "2016/10/12"
+
 namespace version {
 void ensureJavaBackEndVersion(std::string minVersion = "");
 void ensureProjectVersion(std::string minVersion = "");
@@ -5,6 +5,12 @@
  * in which values are ordinarily processed in a first-in/first-out
  * (FIFO) order.
  * 
+ * @version 2016/10/14
+ * - stored in a shared power-of-two ring buffer indexed with masks rather than %
+ * - added enqueueAll and dequeueN to add and remove many elements at once
+ * - added move constructor and move assignment operator
+ * - added add/enqueue overloads that move their argument, and emplace
+ * - dequeue and ring buffer growth move elements rather than copying them
  * @version 2016/09/24
  * - refactored to use collections.h utility functions
  * - added iterators begin(), end()
@@ -32,12 +38,13 @@
 
 #include <deque>
 #include <initializer_list>
-#include <iterator>
 #include <queue>
+#include <utility>
 #include "collections.h"
 #include "error.h"
 #include "hashcode.h"
 #include "vector.h"
+#include "private/ringbuffer.h"
 
 /*
  * Class: Queue<ValueType>
@@ -81,6 +88,7 @@ public:
      * A synonym for the enqueue method.
      */
     void add(const ValueType& value);
+    void add(ValueType&& value);
 
     /*
      * Method: back
@@ -106,13 +114,50 @@ public:
      */
     ValueType dequeue();
 
+    /*
+     * Method: dequeueN
+     * Usage: Vector<ValueType> first = queue.dequeueN(n);
+     * ---------------------------------------------------
+     * Removes the first <code>n</code> items in the queue and returns
+     * them in order.  The items are moved out of the queue a contiguous
+     * run at a time, which is faster than calling <code>dequeue</code>
+     * <code>n</code> times.
+     */
+    Vector<ValueType> dequeueN(int n);
+
+    /*
+     * Method: emplace
+     * Usage: queue.emplace(arg1, arg2, ...);
+     * --------------------------------------
+     * Adds a new element to the end of the queue, constructing it from
+     * the given constructor arguments rather than copying a value.
+     */
+    template <typename... Args>
+    void emplace(Args&&... args);
+
     /*
      * Method: enqueue
      * Usage: queue.enqueue(value);
      * ----------------------------
      * Adds <code>value</code> to the end of the queue.
+     * If the value is a temporary, it is moved into the queue
+     * rather than copied.
      */
     void enqueue(const ValueType& value);
+    void enqueue(ValueType&& value);
+
+    /*
+     * Method: enqueueAll
+     * Usage: queue.enqueueAll(collection);
+     * ------------------------------------
+     * Adds every element of the given collection, in its iteration order,
+     * to the end of the queue.  The queue grows at most once to make room
+     * for them.  The collection may be any that has <code>size</code>,
+     * <code>begin</code> and <code>end</code>, including this queue.
+     */
+    template <typename CollectionType>
+    void enqueueAll(const CollectionType& collection);
+    void enqueueAll(std::initializer_list<ValueType> list);
     
     /*
      * Method: equals
@@ -234,79 +279,44 @@ public:
     /*
      * Implementation notes: Queue data structure
      * ------------------------------------------
-     * The Queue class is implemented using a ring buffer.
+     * The Queue class is implemented using a ring buffer, shared with
+     * the Deque class and described in private/ringbuffer.h.
      */
 
 private:
     /* Instance variables */
-    Vector<ValueType> ringBuffer;
-    int count;
-    int capacity;
-    int head;
-    int tail;
+    stanfordcpplib::collections::RingBuffer<ValueType> elements;
 
-    /* Private functions */
-    void expandRingBufferCapacity();
-    int queueCompare(const Queue& queue2) const;
+public:
+    /*
+     * Copying and moving support
+     * --------------------------
+     * Queues are copied element by element.  A queue that is moved from is
+     * left empty with no ring buffer; the buffer is allocated again by
+     * the next enqueue.
+     */
+    Queue(const Queue& src) = default;
+    Queue& operator =(const Queue& src) = default;
+    Queue(Queue&& src) = default;
+    Queue& operator =(Queue&& src) = default;
 
     /*
      * Iterator support
      * ----------------
      * The classes in the StanfordCPPLib collection implement input
      * iterators so that they work symmetrically with respect to the
-     * corresponding STL classes.
+     * corresponding STL classes.  A queue's iterators are random-access
+     * but do not allow the elements to be modified.
      */
-    class iterator : public std::iterator<std::input_iterator_tag, ValueType> {
-    public:
-        iterator(const Queue* gp, int index) {
-            this->gp = gp;
-            this->index = index;
-        }
-
-        iterator(const iterator& it) {
-            this->gp = it.gp;
-            this->index = it.index;
-        }
-
-        iterator& operator ++() {
-            index = (index + 1) % gp->capacity;
-            return *this;
-        }
-
-        iterator operator ++(int) {
-            iterator copy(*this);
-            operator++();
-            return copy;
-        }
-
-        bool operator ==(const iterator& rhs) {
-            return gp == rhs.gp && index == rhs.index;
-        }
-
-        bool operator !=(const iterator& rhs) {
-            return !(*this == rhs);
-        }
-
-        const ValueType& operator *() {
-            return gp->ringBuffer[index];
-        }
-
-        ValueType* operator ->() {
-            return &gp->ringBuffer[index];
-        }
-
-    private:
-        const Queue* gp;
-        int index;
-    };
+    typedef typename stanfordcpplib::collections::RingBuffer<ValueType>::const_iterator iterator;
+    typedef iterator const_iterator;
 
-public:
     iterator begin() const {
-        return iterator(this, /* index */ head);
+        return elements.begin();
     }
 
     iterator end() const {
-        return iterator(this, /* index */ tail);
+        return elements.end();
     }
 };
 
@@ -326,32 +336,32 @@ public:
  * this implementation lets each index wrap around back to the
  * beginning as if the ends of the array of elements were joined
  * to form a circle.  This representation is called a ring buffer.
+ *
+ * The array's capacity is always a power of two, so wrapping an index
+ * around is a bitwise and with capacity - 1 rather than a division,
+ * and the elements always lie in at most two contiguous runs, which
+ * enqueueAll and dequeueN copy or move a run at a time.
  */
-static const int INITIAL_CAPACITY = 10;
 
 /*
  * Implementation notes: Queue constructor
  * ---------------------------------------
- * The constructor must allocate the array storage for the queue
- * elements and initialize the fields of the object.
+ * The ring buffer allocates no array until the first element is added.
  */
 template <typename ValueType>
 Queue<ValueType>::Queue() {
-    clear();
+    // empty
 }
 
 template <typename ValueType>
 Queue<ValueType>::Queue(std::initializer_list<ValueType> list) {
-    clear();
-    for (const ValueType& value : list) {
-        add(value);
-    }
+    enqueueAll(list);
 }
 
 /*
  * Implementation notes: ~Queue destructor
  * ---------------------------------------
- * All of the dynamic memory is allocated in the Vector class,
+ * All of the dynamic memory is allocated in the RingBuffer class,
  * so no work is required at this level.
  */
 template <typename ValueType>
@@ -364,21 +374,22 @@ void Queue<ValueType>::add(const ValueType& value) {
     enqueue(value);
 }
 
+template <typename ValueType>
+void Queue<ValueType>::add(ValueType&& value) {
+    enqueue(std::move(value));
+}
+
 template <typename ValueType>
 const ValueType& Queue<ValueType>::back() const {
-    if (count == 0) {
+    if (isEmpty()) {
         error("Queue::back: Attempting to read back of an empty queue");
     }
-    return ringBuffer[(tail + capacity - 1) % capacity];
+    return elements.back();
 }
 
 template <typename ValueType>
 void Queue<ValueType>::clear() {
-    capacity = INITIAL_CAPACITY;
-    ringBuffer = Vector<ValueType>(capacity);
-    head = 0;
-    tail = 0;
-    count = 0;
+    elements.clear();
 }
 
 /*
@@ -389,23 +400,49 @@ void Queue<ValueType>::clear() {
  */
 template <typename ValueType>
 ValueType Queue<ValueType>::dequeue() {
-    if (count == 0) {
+    if (isEmpty()) {
         error("Queue::dequeue: Attempting to dequeue an empty queue");
     }
-    ValueType result = ringBuffer[head];
-    head = (head + 1) % capacity;
-    count--;
+    return elements.popFront();
+}
+
+template <typename ValueType>
+Vector<ValueType> Queue<ValueType>::dequeueN(int n) {
+    if (n < 0 || n > size()) {
+        error("Queue::dequeueN: Attempting to dequeue " + integerToString(n)
+              + " elements from a queue of size " + integerToString(size()));
+    }
+    Vector<ValueType> result;
+    result.ensureCapacity(n);
+    elements.popFrontInto(n, result);
     return result;
 }
 
+template <typename ValueType>
+template <typename... Args>
+void Queue<ValueType>::emplace(Args&&... args) {
+    elements.emplaceBack(std::forward<Args>(args)...);
+}
+
 template <typename ValueType>
 void Queue<ValueType>::enqueue(const ValueType& value) {
-    if (count >= capacity - 1) {
-        expandRingBufferCapacity();
-    }
-    ringBuffer[tail] = value;
-    tail = (tail + 1) % capacity;
-    count++;
+    elements.emplaceBack(value);
+}
+
+template <typename ValueType>
+void Queue<ValueType>::enqueue(ValueType&& value) {
+    elements.emplaceBack(std::move(value));
+}
+
+template <typename ValueType>
+template <typename CollectionType>
+void Queue<ValueType>::enqueueAll(const CollectionType& collection) {
+    elements.appendRange(collection.begin(), (int) collection.size());
+}
+
+template <typename ValueType>
+void Queue<ValueType>::enqueueAll(std::initializer_list<ValueType> list) {
+    elements.appendRange(list.begin(), (int) list.size());
 }
 
 template <typename ValueType>
@@ -415,23 +452,23 @@ bool Queue<ValueType>::equals(const Queue<ValueType>& queue2) const {
 
 template <typename ValueType>
 const ValueType& Queue<ValueType>::front() const {
-    if (count == 0) {
+    if (isEmpty()) {
         error("Queue::front: Attempting to read front of an empty queue");
     }
-    return ringBuffer[head];
+    return elements.front();
 }
 
 template <typename ValueType>
 bool Queue<ValueType>::isEmpty() const {
-    return count == 0;
+    return elements.size() == 0;
 }
 
 template <typename ValueType>
 const ValueType& Queue<ValueType>::peek() const {
-    if (count == 0) {
+    if (isEmpty()) {
         error("Queue::peek: Attempting to peek at an empty queue");
     }
-    return ringBuffer.get(head);
+    return elements.front();
 }
 
 template <typename ValueType>
@@ -446,25 +483,17 @@ ValueType Queue<ValueType>::remove() {
 
 template <typename ValueType>
 int Queue<ValueType>::size() const {
-    return count;
+    return elements.size();
 }
 
 template <typename ValueType>
 std::queue<ValueType> Queue<ValueType>::toStlDeque() const {
-    std::deque<ValueType> result;
-    for (int i = 0; i < count; i++) {
-        result.push_back(ringBuffer[(head + i) % capacity]);
-    }
-    return result;
+    return toStlQueue();
 }
 
 template <typename ValueType>
 std::queue<ValueType> Queue<ValueType>::toStlQueue() const {
-    std::queue<ValueType> result;
-    for (int i = 0; i < count; i++) {
-        result.push(ringBuffer[(head + i) % capacity]);
-    }
-    return result;
+    return std::queue<ValueType>(std::deque<ValueType>(begin(), end()));
 }
 
 template <typename ValueType>
@@ -474,50 +503,6 @@ std::string Queue<ValueType>::toString() const {
     return os.str();
 }
 
-/*
- * Implementation notes: expandRingBufferCapacity
- * ----------------------------------------------
- * This private method doubles the capacity of the ringBuffer vector.
- * Note that this implementation also shifts all the elements back to
- * the beginning of the vector.
- */
-template <typename ValueType>
-void Queue<ValueType>::expandRingBufferCapacity() {
-    Vector<ValueType> copy = ringBuffer;
-    ringBuffer = Vector<ValueType>(2 * capacity);
-    for (int i = 0; i < count; i++) {
-        ringBuffer[i] = copy[(head + i) % capacity];
-    }
-    head = 0;
-    tail = count;
-    capacity *= 2;
-}
-
-template <typename ValueType>
-int Queue<ValueType>::queueCompare(const Queue& queue2) const {
-    if (this == &queue2) {
-        return 0;
-    }
-    
-    for (int i1 = 0, i2 = 0;
-         i1 < count && i2 < queue2.count;
-         i1++, i2++) {
-        if (ringBuffer[(head + i1) % capacity] < queue2.ringBuffer[(queue2.head + i2) % queue2.capacity]) {
-            return -1;
-        } else if (queue2.ringBuffer[(queue2.head + i2) % queue2.capacity] < ringBuffer[(head + i1) % capacity]) {
-            return 1;
-        }
-    }
-    
-    if (count < queue2.count) {
-        return -1;
-    } else if (count > queue2.count) {
-        return 1;
-    } else {
-        return 0;
-    }
-}
-
 template <typename ValueType>
 bool Queue<ValueType>::operator ==(const Queue& queue2) const {
     return equals(queue2);
@@ -530,36 +515,27 @@ bool Queue<ValueType>::operator !=(const Queue& queue2) const {
 
 template <typename ValueType>
 bool Queue<ValueType>::operator <(const Queue& queue2) const {
-    return queueCompare(queue2) < 0;
+    return stanfordcpplib::collections::compare(*this, queue2) < 0;
 }
 
 template <typename ValueType>
 bool Queue<ValueType>::operator <=(const Queue& queue2) const {
-    return queueCompare(queue2) <= 0;
+    return stanfordcpplib::collections::compare(*this, queue2) <= 0;
 }
 
 template <typename ValueType>
 bool Queue<ValueType>::operator >(const Queue& queue2) const {
-    return queueCompare(queue2) > 0;
+    return stanfordcpplib::collections::compare(*this, queue2) > 0;
 }
 
 template <typename ValueType>
 bool Queue<ValueType>::operator >=(const Queue& queue2) const {
-    return queueCompare(queue2) >= 0;
+    return stanfordcpplib::collections::compare(*this, queue2) >= 0;
 }
 
 template <typename ValueType>
 std::ostream& operator <<(std::ostream& os, const Queue<ValueType>& queue) {
-    os << "{";
-    if (!queue.isEmpty()) {
-        writeGenericValue(os, queue.ringBuffer[queue.head], /* forceQuotes */ true);
-        for (int i = 1; i < queue.count; i++) {
-            os << ", ";
-            writeGenericValue(os, queue.ringBuffer[(queue.head + i) % queue.capacity], /* forceQuotes */ true);
-        }
-    }
-    os << "}";
-    return os;
+    return stanfordcpplib::collections::writeIterable(os, queue.begin(), queue.end());
 }
 
 template <typename ValueType>
@@ -574,11 +550,7 @@ std::istream& operator >>(std::istream& is, Queue<ValueType>& queue) {
  */
 template <typename T>
 int hashCode(const Queue<T>& q) {
-    int code = hashSeed();
-    for (int i = 0; i < q.count; i++) {
-        code = hashMultiplier() * code + hashCode(q.ringBuffer[(q.head + i) % q.capacity]);
-    }
-    return int(code & hashMask());
+    return stanfordcpplib::collections::hashCodeCollection(q);
 }
 
 #include "private/init.h"   // ensure that Stanford C++ lib is initialized
@@ -4,6 +4,12 @@
  * This file exports the <code>Set</code> class, which implements a
  * collection for storing a set of distinct elements.
  * 
+ * @version 2016/10/14
+ * - added constructor taking a shared Arena for the set's elements
+ * - added range constructor and fromSorted, which build the set from
+ *   sorted input in linear time
+ * - addAll, removeAll and retainAll merge two sets of similar size in
+ *   linear time
  * @version 2016/09/24
  * - refactored to use collections.h utility functions
  * @version 2016/08/11
@@ -61,6 +67,30 @@ public:
      */
     Set(std::initializer_list<ValueType> list);
 
+    /*
+     * Constructor: Set
+     * Usage: Set<ValueType> set(begin, end);
+     * --------------------------------------
+     * Initializes a new set that stores the elements in the range from
+     * <code>begin</code> up to <code>end</code>, such as the elements of
+     * a Vector or a <code>std::set</code>.
+     * Elements that are already in ascending order are linked into a
+     * balanced tree in linear time; others are sorted first.
+     */
+    template <typename InputIterator>
+    Set(InputIterator begin, InputIterator end);
+
+    /*
+     * Constructor: Set
+     * Usage: Set<ValueType> set(arena);
+     * ---------------------------------
+     * Initializes an empty set that allocates its elements from the given
+     * arena, which may be shared with other maps and sets, rather than from
+     * an arena of its own.  The arena must outlive the set.
+     * See arena.h for details.
+     */
+    explicit Set(Arena& arena);
+
     /*
      * Destructor: ~Set
      * ----------------
@@ -86,6 +116,8 @@ public:
      * You can also pass an initializer list such as {1, 2, 3}.
      * Returns a reference to this set.
      * Identical in behavior to the += operator.
+     * When set2 is not much smaller than this set, the two are merged in
+     * a single pass over both, in time proportional to their total size.
      */
     Set<ValueType>& addAll(const Set<ValueType>& set);
     Set<ValueType>& addAll(std::initializer_list<ValueType> list);
@@ -138,6 +170,19 @@ public:
      */
     ValueType first() const;
 
+    /*
+     * Method: fromSorted
+     * Usage: Set<ValueType> set = Set<ValueType>::fromSorted(begin, end);
+     * -------------------------------------------------------------------
+     * Returns a new set holding the elements in the range from
+     * <code>begin</code> up to <code>end</code>, which must be in ascending
+     * order, as when they are read from a sorted file.  The set is built in
+     * time proportional to its size.  Throws an error if the elements are
+     * out of order.
+     */
+    template <typename InputIterator>
+    static Set fromSorted(InputIterator begin, InputIterator end);
+
     /*
      * Method: insert
      * Usage: set.insert(value);
@@ -212,6 +257,7 @@ public:
      * You can also pass an initializer list such as {1, 2, 3}.
      * Returns a reference to this set.
      * Identical in behavior to the -= operator.
+     * Like addAll, this merges the two sets in linear time when that is faster.
      */
     Set<ValueType>& removeAll(const Set<ValueType>& set);
     Set<ValueType>& removeAll(std::initializer_list<ValueType> list);
@@ -225,6 +271,7 @@ public:
      * You can also pass an initializer list such as {1, 2, 3}.
      * Returns a reference to this set.
      * Identical in behavior to the *= operator.
+     * Like addAll, this merges the two sets in linear time when that is faster.
      */
     Set<ValueType>& retainAll(const Set<ValueType>& set);
     Set<ValueType>& retainAll(std::initializer_list<ValueType> list);
@@ -405,6 +452,19 @@ private:
     Map<ValueType, bool> map;            /* Map used to store the element     */
     bool removeFlag;                     /* Flag to differentiate += and -=   */
 
+    /* Functors that make an element into a key and value for the map */
+    struct ElementKey {
+        const ValueType& operator ()(const ValueType& value) const {
+            return value;
+        }
+    };
+
+    struct ElementValue {
+        bool operator ()(const ValueType&) const {
+            return true;
+        }
+    };
+
 public:
     /*
      * Hidden features
@@ -499,8 +559,19 @@ Set<ValueType>::Set() : removeFlag(false) {
 }
 
 template <typename ValueType>
-Set<ValueType>::Set(std::initializer_list<ValueType> list) {
-    addAll(list);
+Set<ValueType>::Set(std::initializer_list<ValueType> list) : removeFlag(false) {
+    map.buildTree(list.begin(), list.end(), ElementKey(), ElementValue(), /* caller */ NULL);
+}
+
+template <typename ValueType>
+template <typename InputIterator>
+Set<ValueType>::Set(InputIterator begin, InputIterator end) : removeFlag(false) {
+    map.buildTree(begin, end, ElementKey(), ElementValue(), /* caller */ NULL);
+}
+
+template <typename ValueType>
+Set<ValueType>::Set(Arena& arena) : map(arena), removeFlag(false) {
+    /* Empty */
 }
 
 template <typename ValueType>
@@ -515,9 +586,7 @@ void Set<ValueType>::add(const ValueType& value) {
 
 template <typename ValueType>
 Set<ValueType>& Set<ValueType>::addAll(const Set& set2) {
-    for (const ValueType& value : set2) {
-        this->add(value);
-    }
+    map.putAll(set2.map);
     return *this;
 }
 
@@ -581,6 +650,14 @@ ValueType Set<ValueType>::first() const {
     return *begin();
 }
 
+template <typename ValueType>
+template <typename InputIterator>
+Set<ValueType> Set<ValueType>::fromSorted(InputIterator begin, InputIterator end) {
+    Set<ValueType> set;
+    set.map.buildTree(begin, end, ElementKey(), ElementValue(), "Set::fromSorted");
+    return set;
+}
+
 template <typename ValueType>
 void Set<ValueType>::insert(const ValueType& value) {
     map.put(value, true);
@@ -643,15 +720,11 @@ void Set<ValueType>::remove(const ValueType& value) {
 
 template <typename ValueType>
 Set<ValueType>& Set<ValueType>::removeAll(const Set& set2) {
-    Vector<ValueType> toRemove;
-    for (const ValueType& value : *this) {
-        if (set2.map.containsKey(value)) {
-            toRemove.add(value);
-        }
-    }
-    for (const ValueType& value : toRemove) {
-        remove(value);
+    if (&set2 == this) {
+        clear();
+        return *this;
     }
+    map.removeAll(set2.map);
     return *this;
 }
 
@@ -665,15 +738,7 @@ Set<ValueType>& Set<ValueType>::removeAll(std::initializer_list<ValueType> list)
 
 template <typename ValueType>
 Set<ValueType>& Set<ValueType>::retainAll(const Set& set2) {
-    Vector<ValueType> toRemove;
-    for (ValueType value : *this) {
-        if (!set2.map.containsKey(value)) {
-            toRemove.add(value);
-        }
-    }
-    for (ValueType value : toRemove) {
-        this->remove(value);
-    }
+    map.retainAll(set2.map);
     return *this;
 }
 
@@ -9,6 +9,17 @@
  * Grid is recommended for use over SparseGrid.
  * 
  * @author Marty Stepp
+ * @version 2016/10/14
+ * - reimplemented as a hash table of cells keyed on their packed
+ *   (row, col) position, with a row-major index of the cells that is
+ *   sorted lazily when the grid is scanned; get, set and isSet now take
+ *   O(1) time instead of two tree searches
+ * - scanning a grid that has changed is no longer safe from several
+ *   threads at once (see the class comment)
+ * - iteration, mapAll and hashCode visit only the cells that have been set,
+ *   in row-major order; iterators offer row() and col()
+ * - get no longer creates an entry for a cell that has not been set
+ * - randomElement now chooses evenly among the cells that have been set
  * @version 2016/09/24
  * - refactored to use collections.h utility functions
  * - added size() method
@@ -34,7 +45,10 @@
 #ifndef _sparsegrid_h
 #define _sparsegrid_h
 
+#include <algorithm>
+#include <deque>
 #include <initializer_list>
+#include <vector>
 #include "collections.h"
 #include "error.h"
 #include "hashcode.h"
@@ -47,6 +61,17 @@
  * Class: SparseGrid<ValueType>
  * ----------------------------
  * This class stores an indexed, two-dimensional array.
+ *
+ * Unlike the other collections, a SparseGrid may change its internal
+ * storage while it is only being read.  Cells set since the grid was last
+ * scanned are added to its row-major index by the next scan, meaning a
+ * loop over the grid, mapAll, toString, <code>&lt;&lt;</code>, hashCode,
+ * or a comparison, even though those methods are const.  So two threads
+ * must not scan the same grid at once unless it has already been scanned
+ * since its last change; get, isSet and the other methods that look up
+ * single cells never change it and are always safe to call together.
+ * Scans never move the cells themselves, so a reference to a cell's value
+ * stays valid until a resize removes that cell.
  */
 
 template <typename ValueType>
@@ -161,10 +186,10 @@ public:
      * Method: mapAll
      * Usage: grid.mapAll(fn);
      * -----------------------
-     * Calls the specified function on each element of the grid.  The
-     * elements are processed in <b><i>row-major order,</i></b> in which
-     * all the elements of row 0 are processed, followed by the elements
-     * in row 1, and so on.
+     * Calls the specified function on each element of the grid that has
+     * been set.  The elements are processed in <b><i>row-major order,</i></b>
+     * in which all the elements of row 0 are processed, followed by the
+     * elements in row 1, and so on.
      */
     void mapAll(void (*fn)(ValueType value)) const;
     void mapAll(void (*fn)(const ValueType& value)) const;
@@ -283,7 +308,8 @@ public:
      *   - Deep copying for the copy constructor and assignment operator
      *   - Iteration using the range-based for statement and STL iterators
      *
-     * The iteration forms process the grid in row-major order.
+     * The iteration forms process the cells that have been set, in
+     * row-major order.
      */
 
     /*
@@ -324,17 +350,47 @@ public:
 
     /*
      * Implementation notes: SparseGrid data structure
-     * -----------------------------------------
-     * The SparseGrid is internally managed as a dynamic array of elements.
-     * The array itself is one-dimensional, the logical separation into
-     * rows and columns is done by arithmetic computation.  The layout
-     * is in row-major order, which is to say that the entire first row
-     * is laid out contiguously, followed by the entire second row,
-     * and so on.
+     * -----------------------------------------------
+     * The cells that have been set are stored in a deque, and each one is
+     * found through an open-addressed hash table with linear probing, keyed
+     * on the cell's row and column packed into one 64-bit number.
+     *
+     * Scans in row-major order (iteration, mapAll, <<, comparisons) visit
+     * the cells sorted by row and then by column, the order of a compressed
+     * sparse row (CSR) matrix.  Rather than move the cells into that order,
+     * which would leave references to their values pointing at other cells,
+     * the grid keeps a vector of cell indexes in that order.  Cells set for
+     * the first time are appended to the deque; the next scan sorts their
+     * indexes and merges them into the ones before them.  A grid that is
+     * filled and then scanned pays for one sort, and when cells are set in
+     * row-major order to begin with, the scan only appends their indexes.
+     *
+     * Since the deque never moves its cells when one is added, a reference
+     * to a cell's value stays valid until a resize removes the cell.
      */
 
+    /* Constant definitions */
+    static const int INITIAL_CAPACITY = 16;          // must be a power of two
+    static const int MAX_LOAD_PERCENTAGE = 50;
+
+    /* Type definition for a cell that has been set */
+    struct Cell {
+        int row;
+        int col;
+        ValueType value;
+    };
+
+    /* Type definition for the slots of the hash table */
+    struct Slot {
+        unsigned long long key;   /* packed (row, col) of the cell            */
+        int index;                /* index of the cell in cells, or -1 if free */
+    };
+
     /* Instance variables */
-    Map<int, Map<int, ValueType> > elements;  // 2D map of the elements
+    mutable std::deque<Cell> cells;   // cells that have been set, in the order set
+    mutable std::vector<int> order;   // indexes of cells scanned so far, in row-major order
+    Slot* slots;                      // hash table of cell indexes
+    int capacity;                     // number of slots; 0 or a power of two
     int nRows;            // The number of rows in the grid
     int nCols;            // The number of columns in the grid
 
@@ -353,6 +409,153 @@ public:
                       std::string prefix) const;
     int gridCompare(const SparseGrid& grid2) const;
 
+    /*
+     * Returns the row and column packed into one number; packed positions
+     * sort in row-major order.
+     */
+    static unsigned long long pack(int row, int col) {
+        return ((unsigned long long) row << 32) | (unsigned int) col;
+    }
+
+    /*
+     * Scrambles a packed position so that neighboring cells land in
+     * unrelated slots.
+     */
+    static unsigned int hashOf(unsigned long long key) {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return (unsigned int) key;
+    }
+
+    /*
+     * Returns the index in cells of the cell at the given position,
+     * or -1 if that cell has not been set.
+     */
+    int findCell(int row, int col) const {
+        if (capacity == 0) {
+            return -1;
+        }
+        unsigned long long key = pack(row, col);
+        int mask = capacity - 1;
+        for (int i = hashOf(key) & mask; slots[i].index >= 0; i = (i + 1) & mask) {
+            if (slots[i].key == key) {
+                return slots[i].index;
+            }
+        }
+        return -1;
+    }
+
+    /*
+     * Adds a cell that has not been set before and returns it.
+     */
+    Cell& addCell(int row, int col, const ValueType& value) {
+        if ((long long) (cells.size() + 1) * 100 > (long long) capacity * MAX_LOAD_PERCENTAGE) {
+            rehash(capacity == 0 ? INITIAL_CAPACITY : capacity * 2);
+        }
+        Cell cell = {row, col, value};
+        cells.push_back(cell);
+        placeSlot(pack(row, col), (int) cells.size() - 1);
+        return cells.back();
+    }
+
+    /*
+     * Returns the cell at the given position, setting it to the default
+     * value for the type first if it has not been set.
+     */
+    Cell& cellAt(int row, int col) {
+        int index = findCell(row, col);
+        return (index >= 0) ? cells[index] : addCell(row, col, ValueType());
+    }
+
+    /*
+     * Returns the value at the given position, or the default value for
+     * the type if it has not been set.
+     */
+    const ValueType& valueAt(int row, int col) const {
+        static const ValueType EMPTY = ValueType();
+        int index = findCell(row, col);
+        return (index >= 0) ? cells[index].value : EMPTY;
+    }
+
+    void placeSlot(unsigned long long key, int index) const {
+        int mask = capacity - 1;
+        int i = hashOf(key) & mask;
+        while (slots[i].index >= 0) {
+            i = (i + 1) & mask;
+        }
+        slots[i].key = key;
+        slots[i].index = index;
+    }
+
+    /*
+     * Empties the hash table and enters every cell into it again, after
+     * the cells have moved.
+     */
+    void reindex() const {
+        for (int i = 0; i < capacity; i++) {
+            slots[i].index = -1;
+        }
+        int index = 0;
+        for (const Cell& cell : cells) {
+            placeSlot(pack(cell.row, cell.col), index++);
+        }
+    }
+
+    /*
+     * Replaces the hash table with one of the given capacity.
+     */
+    void rehash(int newCapacity) {
+        delete[] slots;
+        capacity = newCapacity;
+        slots = new Slot[capacity];
+        reindex();
+    }
+
+    void clearCells() {
+        cells.clear();
+        order.clear();
+        delete[] slots;
+        slots = NULL;
+        capacity = 0;
+    }
+
+    /*
+     * Returns the cell at the given position in row-major order; the grid
+     * must have been scanned since its last new cell was set.
+     */
+    Cell& orderedCell(int position) const {
+        return cells[order[position]];
+    }
+
+    /*
+     * Brings the row-major index up to date by sorting the indexes of the
+     * cells added since the last scan and merging them into the rest.  The
+     * cells themselves stay where they are.  This writes to the grid from
+     * const methods, which is why scans are not thread-safe (see the class
+     * comment).
+     */
+    void ensureOrdered() const {
+        int n = (int) cells.size();
+        int sortedCount = (int) order.size();
+        if (sortedCount == n) {
+            return;
+        }
+        for (int index = sortedCount; index < n; index++) {
+            order.push_back(index);
+        }
+        auto cellBefore = [this](int a, int b) {
+            return pack(cells[a].row, cells[a].col) < pack(cells[b].row, cells[b].col);
+        };
+        std::vector<int>::iterator tail = order.begin() + sortedCount;
+        if (!std::is_sorted(sortedCount > 0 ? tail - 1 : tail, order.end(), cellBefore)) {
+            std::sort(tail, order.end(), cellBefore);
+            std::inplace_merge(order.begin(), tail, order.end(), cellBefore);
+        }
+    }
+
     /*
      * Hidden features
      * ---------------
@@ -376,7 +579,16 @@ public:
      * are supported.
      */
     void deepCopy(const SparseGrid& grid) {
-        elements = grid.elements;
+        cells = grid.cells;
+        order = grid.order;
+        capacity = grid.capacity;
+        slots = NULL;
+        if (capacity > 0) {
+            slots = new Slot[capacity];
+            for (int i = 0; i < capacity; i++) {
+                slots[i] = grid.slots[i];
+            }
+        }
         nRows = grid.nRows;
         nCols = grid.nCols;
     }
@@ -384,6 +596,7 @@ public:
 public:
     SparseGrid& operator =(const SparseGrid& src) {
         if (this != &src) {
+            clearCells();
             deepCopy(src);
         }
         return *this;
@@ -398,7 +611,10 @@ public:
      * ----------------
      * The classes in the StanfordCPPLib collection implement input
      * iterators so that they work symmetrically with respect to the
-     * corresponding STL classes.
+     * corresponding STL classes.  A SparseGrid iterator visits only the
+     * cells that have been set, in row-major order, and can report the
+     * row and column of the cell it is on.  A cell that is set for the
+     * first time during an iteration may or may not be visited by it.
      */
     class iterator : public std::iterator<std::input_iterator_tag, ValueType> {
     public:
@@ -431,32 +647,39 @@ public:
             return !(*this == rhs);
         }
 
-        ValueType operator *() {
-            int row = index / gp->nCols;
-            int col = index % gp->nCols;
-            return gp->elements[row][col];
+        ValueType& operator *() {
+            return cell().value;
         }
 
-        // BUGBUG?: Does this work?
-        // Aren't I returning a pointer to a stack-allocated local int?
         ValueType* operator ->() {
-            int row = index / gp->nCols;
-            int col = index % gp->nCols;
-            std::cout << "itr opr-> row " << row << ", col " << col << std::endl;
-            return &gp->elements[row][col];
+            return &cell().value;
+        }
+
+        int row() const {
+            return cell().row;
+        }
+
+        int col() const {
+            return cell().col;
         }
 
     private:
+        Cell& cell() const {
+            return gp->orderedCell(index);
+        }
+
         const SparseGrid* gp;
         int index;
     };
 
     iterator begin() const {
+        ensureOrdered();
         return iterator(this, 0);
     }
 
     iterator end() const {
-        return iterator(this, nRows * nCols);
+        ensureOrdered();
+        return iterator(this, (int) order.size());
     }
 
     /*
@@ -473,12 +696,12 @@ public:
 
         ValueType& operator [](int col) {
             gp->checkIndexes(row, col, gp->nRows-1, gp->nCols-1, "operator [][]");
-            return gp->elements[row][col];
+            return gp->cellAt(row, col).value;
         }
 
         const ValueType& operator [](int col) const {
             gp->checkIndexes(row, col, gp->nRows-1, gp->nCols-1, "operator [][]");
-            return gp->elements[row][col];
+            return gp->cellAt(row, col).value;
         }
 
     private:
@@ -501,7 +724,7 @@ public:
 
         const ValueType operator [](int col) const {
             gp->checkIndexes(row, col, gp->nRows-1, gp->nCols-1, "operator [][]");
-            return gp->elements[row][col];
+            return gp->valueAt(row, col);
         }
 
     private:
@@ -518,6 +741,8 @@ public:
 
 template <typename ValueType>
 SparseGrid<ValueType>::SparseGrid() :
+    slots(NULL),
+    capacity(0),
     nRows(0),
     nCols(0)
 {
@@ -525,18 +750,30 @@ SparseGrid<ValueType>::SparseGrid() :
 }
 
 template <typename ValueType>
-SparseGrid<ValueType>::SparseGrid(int nRows, int nCols) {
+SparseGrid<ValueType>::SparseGrid(int nRows, int nCols) :
+    slots(NULL),
+    capacity(0),
+    nRows(0),
+    nCols(0)
+{
     resize(nRows, nCols);
 }
 
 template <typename ValueType>
-SparseGrid<ValueType>::SparseGrid(int nRows, int nCols, const ValueType& value) {
+SparseGrid<ValueType>::SparseGrid(int nRows, int nCols, const ValueType& value) :
+    slots(NULL),
+    capacity(0),
+    nRows(0),
+    nCols(0)
+{
     resize(nRows, nCols);
     fill(value);
 }
 
 template <typename ValueType>
 SparseGrid<ValueType>::SparseGrid(std::initializer_list<std::initializer_list<ValueType> > list) :
+    slots(NULL),
+    capacity(0),
     nRows(0),
     nCols(0)
 {
@@ -565,7 +802,7 @@ SparseGrid<ValueType>::SparseGrid(std::initializer_list<std::initializer_list<Va
 
 template <typename ValueType>
 SparseGrid<ValueType>::~SparseGrid() {
-    // empty
+    delete[] slots;
 }
 
 template <typename ValueType>
@@ -574,22 +811,14 @@ bool SparseGrid<ValueType>::equals(const SparseGrid<ValueType>& grid2) const {
     if (this == &grid2) {
         return true;
     }
-    if (nRows != grid2.nRows || nCols != grid2.nCols) {
+    if (nRows != grid2.nRows || nCols != grid2.nCols || size() != grid2.size()) {
         return false;
     }
-    for (int row = 0; row < nRows; row++) {
-        for (int col = 0; col < nCols; col++) {
-            if (isSet(row, col)) {
-                // I have data there; he must, too, and it must be the same data
-                if (!grid2.isSet(row, col) || get(row, col) != grid2.get(row, col)) {
-                    return false;
-                }
-            } else {
-                // I don't have data there; he must also not have it there
-                if (grid2.isSet(row, col)) {
-                    return false;
-                }
-            }
+    // same number of cells set, so each of mine must be set to the same data there
+    for (const Cell& cell : cells) {
+        int index = grid2.findCell(cell.row, cell.col);
+        if (index < 0 || cell.value != grid2.cells[index].value) {
+            return false;
         }
     }
     return true;
@@ -607,13 +836,13 @@ void SparseGrid<ValueType>::fill(const ValueType& value) {
 template <typename ValueType>
 ValueType SparseGrid<ValueType>::get(int row, int col) {
     checkIndexes(row, col, nRows-1, nCols-1, "get");
-    return elements[row][col];
+    return valueAt(row, col);
 }
 
 template <typename ValueType>
 const ValueType& SparseGrid<ValueType>::get(int row, int col) const {
     checkIndexes(row, col, nRows-1, nCols-1, "get");
-    return elements[row][col];
+    return valueAt(row, col);
 }
 
 template <typename ValueType>
@@ -628,46 +857,36 @@ bool SparseGrid<ValueType>::inBounds(int row, int col) const {
 
 template <typename ValueType>
 bool SparseGrid<ValueType>::isEmpty() const {
-    return elements.isEmpty();
+    return cells.empty();
 }
 
 template <typename ValueType>
 bool SparseGrid<ValueType>::isSet(int row, int col) const {
-    return inBounds(row, col) && elements.containsKey(row) &&
-            elements[row].containsKey(col);
+    return inBounds(row, col) && findCell(row, col) >= 0;
 }
 
 template <typename ValueType>
 void SparseGrid<ValueType>::mapAll(void (*fn)(ValueType value)) const {
-    for (int row = 0; row < nRows; row++) {
-        for (int col = 0; col < nCols; col++) {
-            if (isSet(row, col)) {
-                fn(get(row, col));
-            }
-        }
+    ensureOrdered();
+    for (int index : order) {
+        fn(cells[index].value);
     }
 }
 
 template <typename ValueType>
 void SparseGrid<ValueType>::mapAll(void (*fn)(const ValueType & value)) const {
-    for (int row = 0; row < nRows; row++) {
-        for (int col = 0; col < nCols; col++) {
-            if (isSet(row, col)) {
-                fn(get(row, col));
-            }
-        }
+    ensureOrdered();
+    for (int index : order) {
+        fn(cells[index].value);
     }
 }
 
 template <typename ValueType>
 template <typename FunctorType>
 void SparseGrid<ValueType>::mapAll(FunctorType fn) const {
-    for (int row = 0; row < nRows; row++) {
-        for (int col = 0; col < nCols; col++) {
-            if (isSet(row, col)) {
-                fn(get(row, col));
-            }
-        }
+    ensureOrdered();
+    for (int index : order) {
+        fn(cells[index].value);
     }
 }
 
@@ -693,43 +912,53 @@ void SparseGrid<ValueType>::resize(int nRows, int nCols, bool retain) {
     int oldnCols = this->nCols;
     this->nRows = nRows;
     this->nCols = nCols;
-    
+
     if (retain) {
         // if resizing to a smaller size, must evict any row/col entries
         // that exceed the new grid's bounds
         if (nRows < oldnRows || nCols < oldnCols) {
-            Map<int, Map<int, ValueType> > newElements;
-            for (int row : elements) {
-                if (row >= nRows) {
-                    break;   // don't add any entries beyond this row
+            // keep the scanned cells in row-major order, so that the new
+            // index of those is just 0, 1, 2, ...
+            std::deque<Cell> newCells;
+            for (int index : order) {
+                if (cells[index].row < nRows && cells[index].col < nCols) {
+                    newCells.push_back(cells[index]);
                 }
-                for (int col : elements[row]) {
-                    if (col >= nCols) {
-                        break;   // don't add any entries beyond this row
-                    }
-                    newElements[row][col] = elements[row][col];
+            }
+            int newSortedCount = (int) newCells.size();
+            for (int i = (int) order.size(), n = (int) cells.size(); i < n; i++) {
+                if (cells[i].row < nRows && cells[i].col < nCols) {
+                    newCells.push_back(cells[i]);
                 }
             }
-            elements = newElements;
+            cells.swap(newCells);
+            order.resize(newSortedCount);
+            for (int i = 0; i < newSortedCount; i++) {
+                order[i] = i;
+            }
+            if (capacity > 0) {
+                rehash(capacity);
+            }
         }
     } else {
-        elements.clear();
+        clearCells();
     }
 }
 
 template <typename ValueType>
 void SparseGrid<ValueType>::set(int row, int col, const ValueType& value) {
     checkIndexes(row, col, nRows-1, nCols-1, "set");
-    elements[row][col] = value;
+    int index = findCell(row, col);
+    if (index >= 0) {
+        cells[index].value = value;
+    } else {
+        addCell(row, col, value);
+    }
 }
 
 template <typename ValueType>
 int SparseGrid<ValueType>::size() const {
-    int count = 0;
-    for (Map<int, ValueType>& map : elements) {
-        count += map.size();
-    }
-    return count;
+    return (int) cells.size();
 }
 
 template <typename ValueType>
@@ -745,12 +974,12 @@ std::string SparseGrid<ValueType>::toString2D(
         std::string colSeparator, std::string rowSeparator) const {
     std::ostringstream os;
     os << rowStart;
-    int nRows = numRows();
+    ensureOrdered();
     int nCols = numCols();
-    for (int i = 0; i < nRows; i++) {
-        if (!elements.containsKey(i) || elements[i].isEmpty()) {
-            continue;
-        }
+    int next = 0;
+    int count = (int) cells.size();
+    while (next < count) {
+        int i = orderedCell(next).row;
         if (i > 0) {
             os << rowSeparator;
         }
@@ -759,8 +988,9 @@ std::string SparseGrid<ValueType>::toString2D(
             if (j > 0) {
                 os << colSeparator;
             }
-            if (isSet(i, j)) {
-                writeGenericValue(os, get(i, j), true);
+            if (next < count && orderedCell(next).row == i && orderedCell(next).col == j) {
+                writeGenericValue(os, orderedCell(next).value, true);
+                next++;
             }
         }
         os << rowEnd;
@@ -795,6 +1025,15 @@ void SparseGrid<ValueType>::checkIndexes(int row, int col,
     }
 }
 
+/*
+ * Implementation notes: gridCompare
+ * ---------------------------------
+ * Grids compare cell by cell in row-major order over the larger of their
+ * two sizes, stopping at the first cell that differs or that lies outside
+ * one grid but not the other, in which case the smaller grid comes first.
+ * Rather than visiting every cell, this walks the set cells of both grids
+ * in row-major order up to the first cell that lies outside one of them.
+ */
 template <typename ValueType>
 int SparseGrid<ValueType>::gridCompare(const SparseGrid& grid2) const {
     int h1 = height();
@@ -803,34 +1042,65 @@ int SparseGrid<ValueType>::gridCompare(const SparseGrid& grid2) const {
     int w2 = grid2.width();
     int rows = h1 > h2 ? h1 : h2;
     int cols = w1 > w2 ? w1 : w2;
-    for (int r = 0; r < rows; r++) {
-        for (int c = 0; c < cols; c++) {
-            if (r >= h1) {
-                return -1;
-            } else if (r >= h2) {
-                return 1;
-            }
-            
-            if (c >= w1) {
-                return -1;
-            } else if (c >= w2) {
-                return 1;
-            }
-            
-            if (!isSet(r, c) && grid2.isSet(r, c)) {
-                return -1;
-            } else if (isSet(r, c) && !grid2.isSet(r, c)) {
-                return 1;
-            }
-            
-            if (get(r, c) < grid2.get(r, c)) {
-                return -1;
-            } else if (grid2.get(r, c) < get(r, c)) {
-                return 1;
-            }
+    if (rows == 0 || cols == 0) {
+        return 0;
+    }
+
+    // find the first cell in row-major order that is outside one of the grids
+    int minRows = h1 < h2 ? h1 : h2;
+    int minCols = w1 < w2 ? w1 : w2;
+    int stopRow = rows;
+    int stopCol = 0;
+    if (minCols < cols) {
+        stopRow = 0;
+        stopCol = minCols;
+    }
+    if (minRows < stopRow || (minRows == stopRow && stopCol > 0)) {
+        stopRow = minRows;
+        stopCol = 0;
+    }
+    const unsigned long long NONE = ~0ULL;
+    unsigned long long stop = (stopRow < rows) ? pack(stopRow, stopCol) : NONE;
+
+    ensureOrdered();
+    grid2.ensureOrdered();
+    int i1 = 0;
+    int i2 = 0;
+    int n1 = (int) cells.size();
+    int n2 = (int) grid2.cells.size();
+    while (i1 < n1 || i2 < n2) {
+        const Cell* c1 = (i1 < n1) ? &orderedCell(i1) : NULL;
+        const Cell* c2 = (i2 < n2) ? &grid2.orderedCell(i2) : NULL;
+        unsigned long long k1 = c1 ? pack(c1->row, c1->col) : NONE;
+        unsigned long long k2 = c2 ? pack(c2->row, c2->col) : NONE;
+        if ((k1 < k2 ? k1 : k2) >= stop) {
+            break;
+        } else if (k1 < k2) {
+            return 1;
+        } else if (k2 < k1) {
+            return -1;
+        }
+
+        if (c1->value < c2->value) {
+            return -1;
+        } else if (c2->value < c1->value) {
+            return 1;
         }
+        i1++;
+        i2++;
+    }
+
+    if (stop == NONE) {
+        return 0;
+    } else if (stopRow >= h1) {
+        return -1;
+    } else if (stopRow >= h2) {
+        return 1;
+    } else if (stopCol >= w1) {
+        return -1;
+    } else {
+        return 1;
     }
-    return 0;
 }
 
 template <typename ValueType>
@@ -883,7 +1153,28 @@ bool SparseGrid<ValueType>::operator >=(const SparseGrid& grid2) const {
  */
 template <typename ValueType>
 std::ostream& operator <<(std::ostream& os, const SparseGrid<ValueType>& grid) {
-    os << grid.elements << ", " << grid.nRows << " x " << grid.nCols;
+    // written as a map from each row to a map from column to value
+    grid.ensureOrdered();
+    os << "{";
+    int lastRow = -1;
+    for (int index : grid.order) {
+        const typename SparseGrid<ValueType>::Cell& cell = grid.cells[index];
+        if (cell.row != lastRow) {
+            if (lastRow >= 0) {
+                os << "}, ";
+            }
+            os << cell.row << ":{";
+            lastRow = cell.row;
+        } else {
+            os << ", ";
+        }
+        os << cell.col << ":";
+        writeGenericValue(os, cell.value, /* forceQuotes */ true);
+    }
+    if (lastRow >= 0) {
+        os << "}";
+    }
+    os << "}, " << grid.nRows << " x " << grid.nCols;
     return os;
 }
 
@@ -892,7 +1183,8 @@ std::istream& operator >>(std::istream& is, SparseGrid<ValueType>& grid) {
     // "{...}, 4 x 3"
 
     // read "{...}" (map of elements)
-    if (!(is >> grid.elements)) {
+    Map<int, Map<int, ValueType> > elements;
+    if (!(is >> elements)) {
 #ifdef SPL_ERROR_ON_COLLECTION_PARSE
         error("SparseGrid::operator >>: Invalid elements");
 #endif
@@ -910,7 +1202,8 @@ std::istream& operator >>(std::istream& is, SparseGrid<ValueType>& grid) {
         return is;
     }
 
-    if (!(is >> grid.nRows)) {
+    int nRows;
+    if (!(is >> nRows)) {
 #ifdef SPL_ERROR_ON_COLLECTION_PARSE
         error("SparseGrid::operator >>: Invalid number of rows");
 #endif
@@ -921,13 +1214,28 @@ std::istream& operator >>(std::istream& is, SparseGrid<ValueType>& grid) {
     std::string x;
     is >> x;       // throw away 'x' token
 
-    if (!(is >> grid.nCols)) {
+    int nCols;
+    if (!(is >> nCols) || nRows < 0 || nCols < 0) {
 #ifdef SPL_ERROR_ON_COLLECTION_PARSE
         error("SparseGrid::operator >>: Invalid number of rows");
 #endif
         is.setstate(std::ios_base::failbit);
         return is;
     }
+
+    grid.resize(nRows, nCols);
+    for (int row : elements) {
+        for (int col : elements[row]) {
+            if (!grid.inBounds(row, col)) {
+#ifdef SPL_ERROR_ON_COLLECTION_PARSE
+                error("SparseGrid::operator >>: Element outside of grid");
+#endif
+                is.setstate(std::ios_base::failbit);
+                return is;
+            }
+            grid.set(row, col, elements[row][col]);
+        }
+    }
     return is;
 }
 
@@ -953,11 +1261,8 @@ const T& randomElement(const SparseGrid<T>& grid) {
         error("randomElement: empty sparse grid was passed");
     }
     
-    // pick a non-empty row, then pick a random element from it
-    // TODO: fix, this is NOT evenly distributed when rows/cols are unequal in size
-    int row = randomKey(grid.elements);
-    int col = randomKey(grid.elements[row]);
-    return grid.get(row, col);
+    int index = randomInteger(0, grid.size() - 1);
+    return grid.cells[index].value;
 }
 
 #include "private/init.h"   // ensure that Stanford C++ lib is initialized
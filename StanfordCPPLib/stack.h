@@ -4,6 +4,10 @@
  * This file exports the <code>Stack</code> class, which implements
  * a collection that processes values in a last-in/first-out (LIFO) order.
  * 
+ * @version 2016/10/14
+ * - added move constructor and move assignment operator
+ * - added add/push overloads that move their argument, and emplace
+ * - pop moves the top element out rather than copying it
  * @version 2016/09/24
  * - refactored to use collections.h utility functions
  * - made const iterators public
@@ -24,6 +28,7 @@
 #include <initializer_list>
 #include <iterator>
 #include <stack>
+#include <utility>
 #include "error.h"
 #include "hashcode.h"
 #include "vector.h"
@@ -72,6 +77,7 @@ public:
      * A synonym for the push method.
      */
     void add(const ValueType& value);
+    void add(ValueType&& value);
     
     /*
      * Method: clear
@@ -80,6 +86,16 @@ public:
      * Removes all elements from this stack.
      */
     void clear();
+
+    /*
+     * Method: emplace
+     * Usage: stack.emplace(arg1, arg2, ...);
+     * --------------------------------------
+     * Pushes a new element onto the top of this stack, constructing it
+     * from the given constructor arguments rather than copying a value.
+     */
+    template <typename... Args>
+    void emplace(Args&&... args);
     
     /*
      * Method: equals
@@ -122,8 +138,11 @@ public:
      * Usage: stack.push(value);
      * -------------------------
      * Pushes the specified value onto the top of this stack.
+     * If the value is a temporary, it is moved onto the stack
+     * rather than copied.
      */
     void push(const ValueType& value);
+    void push(ValueType&& value);
 
     /*
      * Method: remove
@@ -214,6 +233,19 @@ public:
      * underlying Vector class.
      */
 
+public:
+    /*
+     * Copying and moving support
+     * --------------------------
+     * Stacks copy and move by copying or moving their Vector.  These must
+     * be declared because the virtual destructor would otherwise make
+     * every move of a stack a copy.
+     */
+    Stack(const Stack& src) = default;
+    Stack(Stack&& src) = default;
+    Stack& operator =(const Stack& src) = default;
+    Stack& operator =(Stack&& src) = default;
+
     template <typename T>
     friend int hashCode(const Stack<T>& s);
     
@@ -307,11 +339,22 @@ void Stack<ValueType>::add(const ValueType& value) {
     push(value);
 }
 
+template <typename ValueType>
+void Stack<ValueType>::add(ValueType&& value) {
+    push(std::move(value));
+}
+
 template <typename ValueType>
 void Stack<ValueType>::clear() {
     elements.clear();
 }
 
+template <typename ValueType>
+template <typename... Args>
+void Stack<ValueType>::emplace(Args&&... args) {
+    elements.emplace_back(std::forward<Args>(args)...);
+}
+
 template <typename ValueType>
 bool Stack<ValueType>::equals(const Stack<ValueType>& stack2) const {
     return stanfordcpplib::collections::equals(*this, stack2);
@@ -335,7 +378,7 @@ ValueType Stack<ValueType>::pop() {
     if (isEmpty()) {
         error("Stack::pop: Attempting to pop an empty stack");
     }
-    ValueType top = elements[elements.size() - 1];
+    ValueType top = std::move(elements[elements.size() - 1]);
     elements.remove(elements.size() - 1);
     return top;
 }
@@ -345,6 +388,11 @@ void Stack<ValueType>::push(const ValueType& value) {
     elements.add(value);
 }
 
+template <typename ValueType>
+void Stack<ValueType>::push(ValueType&& value) {
+    elements.add(std::move(value));
+}
+
 template <typename ValueType>
 ValueType Stack<ValueType>::remove() {
     return pop();
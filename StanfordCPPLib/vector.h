@@ -4,6 +4,16 @@
  * This file exports the <code>Vector</code> class, which provides an
  * efficient, safe, convenient replacement for the array type in C++.
  *
+ * @version 2016/10/14
+ * - added data() for direct access to the elements
+ * - elements are stored in raw memory and constructed in place, so spare
+ *   capacity is no longer default-constructed and element types no longer
+ *   need a default constructor (unless Vector(n) or operator >> is used)
+ * - added optional Allocator template parameter
+ * - added move constructor and move assignment operator
+ * - added add/insert/push_back/set overloads that move their argument,
+ *   and emplace/emplace_back to construct elements in place
+ * - elements are moved rather than copied when the array grows or shifts
  * @version 2016/09/24
  * - refactored to use collections.h utility functions
  * @version 2016/08/12
@@ -37,8 +47,10 @@
 #include <initializer_list>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 #include "collections.h"
 #include "error.h"
@@ -54,8 +66,12 @@
  * also supports inserting and deleting elements.  It is similar in
  * function to the STL <code>vector</code> type, but is simpler both
  * to use and to implement.
+ *
+ * Like the STL <code>vector</code>, it takes an optional second template
+ * parameter, an allocator that obtains and releases the memory in which
+ * elements are stored; by default this memory comes from the heap.
  */
-template <typename ValueType>
+template <typename ValueType, typename Allocator = std::allocator<ValueType> >
 class Vector {
 public:
     /*
@@ -72,6 +88,12 @@ public:
     Vector();
     explicit Vector(int n, ValueType value = ValueType());
 
+    /*
+     * This constructor creates an empty vector whose memory will be
+     * obtained from the given allocator.
+     */
+    explicit Vector(const Allocator& allocator);
+
     /*
      * This constructor copies an STL vector.
      */
@@ -95,8 +117,11 @@ public:
      * Usage: vec.add(value);
      * ----------------------
      * Adds a new value to the end of this vector.
+     * If the value is a temporary, it is moved into the vector
+     * rather than copied.
      */
     void add(const ValueType& value);
+    void add(ValueType&& value);
 
     /*
      * Method: addAll
@@ -107,8 +132,8 @@ public:
      * Returns a reference to this vector.
      * Identical in behavior to the += operator.
      */
-    Vector<ValueType>& addAll(const Vector<ValueType>& v);
-    Vector<ValueType>& addAll(std::initializer_list<ValueType> list);
+    Vector& addAll(const Vector& v);
+    Vector& addAll(std::initializer_list<ValueType> list);
 
     /*
      * Method: clear
@@ -117,6 +142,18 @@ public:
      * Removes all elements from this vector.
      */
     void clear();
+
+    /*
+     * Method: data
+     * Usage: ValueType* p = vec.data();
+     * ---------------------------------
+     * Returns a pointer to the vector's elements, which are stored
+     * contiguously: element <code>i</code> is at <code>p[i]</code>.
+     * The pointer is valid until elements are added or removed or the
+     * vector is destroyed.
+     */
+    ValueType* data();
+    const ValueType* data() const;
     
     /*
      * Method: ensureCapacity
@@ -136,7 +173,30 @@ public:
      * values as the given other vector.
      * Identical in behavior to the == operator.
      */
-    bool equals(const Vector<ValueType>& v) const;
+    bool equals(const Vector& v) const;
+
+    /*
+     * Method: emplace
+     * Usage: vec.emplace(index, arg1, arg2, ...);
+     * -------------------------------------------
+     * Inserts a new element into this vector before the specified index,
+     * like <code>insert</code>, but constructs the element from the given
+     * constructor arguments rather than copying an existing value.
+     */
+    template <typename... Args>
+    void emplace(int index, Args&&... args);
+
+    /*
+     * Method: emplace_back
+     * Usage: vec.emplace_back(arg1, arg2, ...);
+     * -----------------------------------------
+     * Adds a new element to the end of this vector, constructing it from
+     * the given constructor arguments.  This method is provided to ensure
+     * compatibility with the <code>vector</code> class in the Standard
+     * Template Library.
+     */
+    template <typename... Args>
+    void emplace_back(Args&&... args);
     
     /*
      * Method: get
@@ -157,6 +217,7 @@ public:
      * up to and including the length of the vector.
      */
     void insert(int index, const ValueType& value);
+    void insert(int index, ValueType&& value);
 
     /*
      * Method: isEmpty
@@ -188,6 +249,7 @@ public:
      * with the <code>vector</code> class in the Standard Template Library.
      */
     void push_back(const ValueType& value);
+    void push_back(ValueType&& value);
 
     /*
      * Method: remove
@@ -208,6 +270,7 @@ public:
      * This method signals an error if the index is not in the array range.
      */
     void set(int index, const ValueType& value);
+    void set(int index, ValueType&& value);
     
     /*
      * Method: size
@@ -226,7 +289,7 @@ public:
      * Throws an error if the range (start .. start + length) is not contained
      * within the bounds of this vector, or if length is negative.
      */
-    Vector<ValueType> subList(int start, int length) const;
+    Vector subList(int start, int length) const;
 
     /*
      * Returns an STL vector object with the same elements as this Vector.
@@ -342,12 +405,19 @@ private:
      * The elements of the Vector are stored in a dynamic array of
      * the specified element type.  If the space in the array is ever
      * exhausted, the implementation doubles the array capacity.
+     * The array is raw memory from the allocator: only the first count
+     * slots hold constructed elements, and the spare slots after them
+     * are left unconstructed until an element is added there.
      */
 
+    /* Type definitions */
+    typedef std::allocator_traits<Allocator> AllocatorTraits;
+
     /* Instance variables */
     ValueType* elements;        /* A dynamic array of the elements   */
     int capacity;               /* The allocated size of the array   */
     int count;                  /* The number of elements in use     */
+    Allocator allocator;        /* Source of the array's memory      */
 
     /* Private methods */
 
@@ -364,6 +434,18 @@ private:
     void expandCapacity();
     void deepCopy(const Vector& src);
 
+    /*
+     * Moves the elements into a new array of the given capacity, which
+     * must be at least count, and frees the old array.
+     */
+    void reallocate(int newCapacity);
+
+    /*
+     * Destroys all elements and frees the array, leaving the vector empty
+     * with no capacity.
+     */
+    void destroyElements();
+
     /*
      * Hidden features
      * ---------------
@@ -379,10 +461,14 @@ public:
      * --------------------
      * This copy constructor and operator= are defined to make a deep copy,
      * making it possible to pass or return vectors by value and assign
-     * from one vector to another.
+     * from one vector to another.  Vectors that are about to be destroyed,
+     * such as those returned from functions, are moved instead: the new
+     * vector takes over the old one's array and the old one is left empty.
      */
     Vector(const Vector& src);
+    Vector(Vector&& src) noexcept;
     Vector& operator =(const Vector& src);
+    Vector& operator =(Vector&& src) noexcept;
 
     /*
      * Operator: ,
@@ -536,35 +622,49 @@ public:
  * and initializes the other fields of the object.  The
  * destructor frees the memory used for the array.
  */
-template <typename ValueType>
-Vector<ValueType>::Vector() {
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>::Vector() {
+    count = capacity = 0;
+    elements = NULL;
+}
+
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>::Vector(const Allocator& allocator)
+        : allocator(allocator) {
     count = capacity = 0;
     elements = NULL;
 }
 
-template <typename ValueType>
-Vector<ValueType>::Vector(int n, ValueType value) {
-    count = capacity = n;
-    elements = (n == 0) ? NULL : new ValueType[n];
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>::Vector(int n, ValueType value) {
+    if (n < 0) {
+        error("Vector::constructor: size cannot be negative");
+    }
+    count = capacity = 0;
+    elements = NULL;
+    ensureCapacity(n);
     for (int i = 0; i < n; i++) {
-        elements[i] = value;
+        AllocatorTraits::construct(allocator, elements + i, value);
     }
+    count = n;
 }
 
-template <typename ValueType>
-Vector<ValueType>::Vector(const std::vector<ValueType>& v) {
-    count = capacity = v.size();
-    elements = new ValueType[count];
-    for (int i = 0; i < count; i++) {
-        elements[i] = v[i];
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>::Vector(const std::vector<ValueType>& v) {
+    count = capacity = 0;
+    elements = NULL;
+    ensureCapacity(v.size());
+    for (const ValueType& value : v) {
+        AllocatorTraits::construct(allocator, elements + count, value);
+        count++;
     }
 }
 
-template <typename ValueType>
-Vector<ValueType>::Vector(std::initializer_list<ValueType> list) {
-    capacity = list.size();
-    count = 0;
-    elements = new ValueType[capacity];
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>::Vector(std::initializer_list<ValueType> list) {
+    count = capacity = 0;
+    elements = NULL;
+    ensureCapacity(list.size());
     addAll(list);
 }
 
@@ -574,17 +674,25 @@ Vector<ValueType>::Vector(std::initializer_list<ValueType> list) {
  * The constructor and assignment operators follow a standard paradigm,
  * as described in the associated textbook.
  */
-template <typename ValueType>
-Vector<ValueType>::Vector(const Vector& src) {
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>::Vector(const Vector& src)
+        : allocator(AllocatorTraits::select_on_container_copy_construction(src.allocator)) {
     deepCopy(src);
 }
 
-template <typename ValueType>
-Vector<ValueType>::~Vector() {
-    if (elements != NULL) {
-        delete[] elements;
-        elements = NULL;
-    }
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>::Vector(Vector&& src) noexcept
+        : allocator(std::move(src.allocator)) {
+    elements = src.elements;
+    capacity = src.capacity;
+    count = src.count;
+    src.elements = NULL;
+    src.capacity = src.count = 0;
+}
+
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>::~Vector() {
+    destroyElements();
 }
 
 /*
@@ -593,56 +701,94 @@ Vector<ValueType>::~Vector() {
  * The basic Vector methods are straightforward and should require
  * no detailed documentation.
  */
-template <typename ValueType>
-void Vector<ValueType>::add(const ValueType& value) {
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::add(const ValueType& value) {
     insert(count, value);
 }
 
-template <typename ValueType>
-Vector<ValueType>& Vector<ValueType>::addAll(const Vector<ValueType>& v) {
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::add(ValueType&& value) {
+    insert(count, std::move(value));
+}
+
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>& Vector<ValueType, Allocator>::addAll(const Vector<ValueType, Allocator>& v) {
     for (const ValueType& value : v) {
         add(value);
     }
     return *this;   // BUGFIX 2014/04/27
 }
 
-template <typename ValueType>
-Vector<ValueType>& Vector<ValueType>::addAll(std::initializer_list<ValueType> list) {
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>& Vector<ValueType, Allocator>::addAll(std::initializer_list<ValueType> list) {
     for (const ValueType& value : list) {
         add(value);
     }
     return *this;
 }
 
-template <typename ValueType>
-void Vector<ValueType>::clear() {
-    if (elements != NULL) {
-        delete[] elements;
-    }
-    count = capacity = 0;
-    elements = NULL;
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::clear() {
+    destroyElements();
+}
+
+template <typename ValueType, typename Allocator>
+ValueType* Vector<ValueType, Allocator>::data() {
+    return elements;
+}
+
+template <typename ValueType, typename Allocator>
+const ValueType* Vector<ValueType, Allocator>::data() const {
+    return elements;
 }
 
 // implementation note: This method is public so clients can guarantee a given
 // capacity.  Internal resizing is automatically done by expandCapacity.
 // See also: expandCapacity
-template <typename ValueType>
-void Vector<ValueType>::ensureCapacity(int cap) {
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::ensureCapacity(int cap) {
     if (cap >= 1 && capacity < cap) {
-        capacity = std::max(cap, capacity * 2);
-        ValueType* array = new ValueType[capacity];
+        reallocate(std::max(cap, capacity * 2));
+    }
+}
+
+template <typename ValueType, typename Allocator>
+template <typename... Args>
+void Vector<ValueType, Allocator>::emplace(int index, Args&&... args) {
+    checkIndex(index, 0, count, "emplace");
+    if (index == count) {
+        emplace_back(std::forward<Args>(args)...);
+    } else {
+        insert(index, ValueType(std::forward<Args>(args)...));
+    }
+}
+
+template <typename ValueType, typename Allocator>
+template <typename... Args>
+void Vector<ValueType, Allocator>::emplace_back(Args&&... args) {
+    if (count < capacity) {
+        AllocatorTraits::construct(allocator, elements + count, std::forward<Args>(args)...);
+    } else {
+        // construct the new element before moving the others, since the
+        // arguments may refer to elements of this vector
+        int newCapacity = std::max(1, capacity * 2);
+        ValueType* array = AllocatorTraits::allocate(allocator, newCapacity);
+        AllocatorTraits::construct(allocator, array + count, std::forward<Args>(args)...);
+        for (int i = 0; i < count; i++) {
+            AllocatorTraits::construct(allocator, array + i, std::move(elements[i]));
+            AllocatorTraits::destroy(allocator, elements + i);
+        }
         if (elements != NULL) {
-            for (int i = 0; i < count; i++) {
-                array[i] = elements[i];
-            }
-            delete[] elements;
+            AllocatorTraits::deallocate(allocator, elements, capacity);
         }
         elements = array;
+        capacity = newCapacity;
     }
+    count++;
 }
 
-template <typename ValueType>
-bool Vector<ValueType>::equals(const Vector<ValueType>& v) const {
+template <typename ValueType, typename Allocator>
+bool Vector<ValueType, Allocator>::equals(const Vector<ValueType, Allocator>& v) const {
     return stanfordcpplib::collections::equals(*this, v);
 }
 
@@ -653,21 +799,13 @@ bool Vector<ValueType>::equals(const Vector<ValueType>& v) const {
  * into the new array, and then frees the old one.
  * See also: ensureCapacity
  */
-template <typename ValueType>
-void Vector<ValueType>::expandCapacity() {
-    capacity = std::max(1, capacity * 2);
-    ValueType *array = new ValueType[capacity];
-    if (elements != NULL) {
-        for (int i = 0; i < count; i++) {
-            array[i] = elements[i];
-        }
-        delete[] elements;
-    }
-    elements = array;
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::expandCapacity() {
+    reallocate(std::max(1, capacity * 2));
 }
 
-template <typename ValueType>
-const ValueType& Vector<ValueType>::get(int index) const {
+template <typename ValueType, typename Allocator>
+const ValueType& Vector<ValueType, Allocator>::get(int index) const {
     checkIndex(index, 0, count-1, "get");
     return elements[index];
 }
@@ -677,23 +815,38 @@ const ValueType& Vector<ValueType>::get(int index) const {
  * -----------------------------------------
  * These methods must shift the existing elements in the array to
  * make room for a new element or to close up the space left by a
- * deleted one.
+ * deleted one.  Elements are moved, not copied, as they shift.
+ * A value passed by const reference is copied before anything moves,
+ * since it may refer to an element of this same vector.  The slot past
+ * the last element holds no object, so it is constructed rather than
+ * assigned, and the slot vacated by remove is destroyed.
  */
-template <typename ValueType>
-void Vector<ValueType>::insert(int index, const ValueType& value) {
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::insert(int index, const ValueType& value) {
+    checkIndex(index, 0, count, "insert");
+    insert(index, ValueType(value));
+}
+
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::insert(int index, ValueType&& value) {
     checkIndex(index, 0, count, "insert");
+    if (index == count) {
+        emplace_back(std::move(value));
+        return;
+    }
     if (count == capacity) {
         expandCapacity();
     }
-    for (int i = count; i > index; i--) {
-        elements[i] = elements[i - 1];
+    AllocatorTraits::construct(allocator, elements + count, std::move(elements[count - 1]));
+    for (int i = count - 1; i > index; i--) {
+        elements[i] = std::move(elements[i - 1]);
     }
-    elements[index] = value;
+    elements[index] = std::move(value);
     count++;
 }
 
-template <typename ValueType>
-bool Vector<ValueType>::isEmpty() const {
+template <typename ValueType, typename Allocator>
+bool Vector<ValueType, Allocator>::isEmpty() const {
     return count == 0;
 }
 
@@ -703,69 +856,81 @@ bool Vector<ValueType>::isEmpty() const {
  * The various versions of the mapAll function apply the function or
  * function object to each element in ascending index order.
  */
-template <typename ValueType>
-void Vector<ValueType>::mapAll(void (*fn)(ValueType)) const {
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::mapAll(void (*fn)(ValueType)) const {
     for (int i = 0; i < count; i++) {
         fn(elements[i]);
     }
 }
 
-template <typename ValueType>
-void Vector<ValueType>::mapAll(void (*fn)(const ValueType&)) const {
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::mapAll(void (*fn)(const ValueType&)) const {
     for (int i = 0; i < count; i++) {
         fn(elements[i]);
     }
 }
 
-template <typename ValueType>
+template <typename ValueType, typename Allocator>
 template <typename FunctorType>
-void Vector<ValueType>::mapAll(FunctorType fn) const {
+void Vector<ValueType, Allocator>::mapAll(FunctorType fn) const {
     for (int i = 0; i < count; i++) {
         fn(elements[i]);
     }
 }
 
-template <typename ValueType>
-void Vector<ValueType>::push_back(const ValueType& value) {
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::push_back(const ValueType& value) {
     insert(count, value);
 }
 
-template <typename ValueType>
-void Vector<ValueType>::remove(int index) {
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::push_back(ValueType&& value) {
+    insert(count, std::move(value));
+}
+
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::remove(int index) {
     checkIndex(index, 0, count-1, "remove");
     for (int i = index; i < count - 1; i++) {
-        elements[i] = elements[i + 1];
+        elements[i] = std::move(elements[i + 1]);
     }
     count--;
+    AllocatorTraits::destroy(allocator, elements + count);
 }
 
-template <typename ValueType>
-void Vector<ValueType>::set(int index, const ValueType& value) {
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::set(int index, const ValueType& value) {
     checkIndex(index, 0, count-1, "set");
     elements[index] = value;
 }
 
-template <typename ValueType>
-int Vector<ValueType>::size() const {
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::set(int index, ValueType&& value) {
+    checkIndex(index, 0, count-1, "set");
+    elements[index] = std::move(value);
+}
+
+template <typename ValueType, typename Allocator>
+int Vector<ValueType, Allocator>::size() const {
     return count;
 }
 
-template <typename ValueType>
-Vector<ValueType> Vector<ValueType>::subList(int start, int length) const {
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator> Vector<ValueType, Allocator>::subList(int start, int length) const {
     checkIndex(start, 0, count, "subList");
     checkIndex(start + length, 0, count, "subList");
     if (length < 0) {
         error("Vector::subList: length cannot be negative");
     }
-    Vector<ValueType> result;
+    Vector<ValueType, Allocator> result;
     for (int i = start; i < start + length; i++) {
         result.add(get(i));
     }
     return result;
 }
 
-template <typename ValueType>
-std::vector<ValueType> Vector<ValueType>::toStlVector() const {
+template <typename ValueType, typename Allocator>
+std::vector<ValueType> Vector<ValueType, Allocator>::toStlVector() const {
     std::vector<ValueType> v;
     for (int i = 0; i < count; i++) {
         v.push_back(elements[i]);
@@ -773,8 +938,8 @@ std::vector<ValueType> Vector<ValueType>::toStlVector() const {
     return v;
 }
 
-template <typename ValueType>
-std::string Vector<ValueType>::toString() const {
+template <typename ValueType, typename Allocator>
+std::string Vector<ValueType, Allocator>::toString() const {
     std::ostringstream os;
     os << *this;
     return os.str();
@@ -786,88 +951,100 @@ std::string Vector<ValueType>::toString() const {
  * The following code implements traditional array selection using
  * square brackets for the index.
  */
-template <typename ValueType>
-ValueType& Vector<ValueType>::operator [](int index) {
+template <typename ValueType, typename Allocator>
+ValueType& Vector<ValueType, Allocator>::operator [](int index) {
     checkIndex(index, 0, count-1, "operator []");
     return elements[index];
 }
-template <typename ValueType>
-const ValueType& Vector<ValueType>::operator [](int index) const {
+template <typename ValueType, typename Allocator>
+const ValueType& Vector<ValueType, Allocator>::operator [](int index) const {
     checkIndex(index, 0, count-1, "operator []");
     return elements[index];
 }
 
-template <typename ValueType>
-Vector<ValueType> Vector<ValueType>::operator +(const Vector& v2) const {
-    Vector<ValueType> result = *this;
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator> Vector<ValueType, Allocator>::operator +(const Vector& v2) const {
+    Vector<ValueType, Allocator> result = *this;
     return result.addAll(v2);
 }
 
-template <typename ValueType>
-Vector<ValueType> Vector<ValueType>::operator +(std::initializer_list<ValueType> list) const {
-    Vector<ValueType> result = *this;
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator> Vector<ValueType, Allocator>::operator +(std::initializer_list<ValueType> list) const {
+    Vector<ValueType, Allocator> result = *this;
     return result.addAll(list);
 }
 
-template <typename ValueType>
-Vector<ValueType>& Vector<ValueType>::operator +=(const Vector& v2) {
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>& Vector<ValueType, Allocator>::operator +=(const Vector& v2) {
     return addAll(v2);
 }
 
-template <typename ValueType>
-Vector<ValueType>& Vector<ValueType>::operator +=(std::initializer_list<ValueType> list) {
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>& Vector<ValueType, Allocator>::operator +=(std::initializer_list<ValueType> list) {
     return addAll(list);
 }
 
-template <typename ValueType>
-Vector<ValueType>& Vector<ValueType>::operator +=(const ValueType& value) {
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>& Vector<ValueType, Allocator>::operator +=(const ValueType& value) {
     add(value);
     return *this;
 }
 
-template <typename ValueType>
-bool Vector<ValueType>::operator ==(const Vector& v2) const {
+template <typename ValueType, typename Allocator>
+bool Vector<ValueType, Allocator>::operator ==(const Vector& v2) const {
     return equals(v2);
 }
 
-template <typename ValueType>
-bool Vector<ValueType>::operator !=(const Vector& v2) const {
+template <typename ValueType, typename Allocator>
+bool Vector<ValueType, Allocator>::operator !=(const Vector& v2) const {
     return !equals(v2);
 }
 
-template <typename ValueType>
-bool Vector<ValueType>::operator <(const Vector& v2) const {
+template <typename ValueType, typename Allocator>
+bool Vector<ValueType, Allocator>::operator <(const Vector& v2) const {
     return stanfordcpplib::collections::compare(*this, v2) < 0;
 }
 
-template <typename ValueType>
-bool Vector<ValueType>::operator <=(const Vector& v2) const {
+template <typename ValueType, typename Allocator>
+bool Vector<ValueType, Allocator>::operator <=(const Vector& v2) const {
     return stanfordcpplib::collections::compare(*this, v2) <= 0;
 }
 
-template <typename ValueType>
-bool Vector<ValueType>::operator >(const Vector& v2) const {
+template <typename ValueType, typename Allocator>
+bool Vector<ValueType, Allocator>::operator >(const Vector& v2) const {
     return stanfordcpplib::collections::compare(*this, v2) > 0;
 }
 
-template <typename ValueType>
-bool Vector<ValueType>::operator >=(const Vector& v2) const {
+template <typename ValueType, typename Allocator>
+bool Vector<ValueType, Allocator>::operator >=(const Vector& v2) const {
     return stanfordcpplib::collections::compare(*this, v2) >= 0;
 }
 
-template <typename ValueType>
-Vector<ValueType> & Vector<ValueType>::operator =(const Vector& src) {
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator> & Vector<ValueType, Allocator>::operator =(const Vector& src) {
     if (this != &src) {
-        if (elements != NULL) {
-            delete[] elements;
-        }
+        destroyElements();
         deepCopy(src);
     }
     return *this;
 }
 
-template <typename ValueType>
-void Vector<ValueType>::checkIndex(int index, int min, int max, std::string prefix) const {
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>& Vector<ValueType, Allocator>::operator =(Vector&& src) noexcept {
+    if (this != &src) {
+        destroyElements();
+        allocator = std::move(src.allocator);
+        elements = src.elements;
+        capacity = src.capacity;
+        count = src.count;
+        src.elements = NULL;
+        src.capacity = src.count = 0;
+    }
+    return *this;
+}
+
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::checkIndex(int index, int min, int max, std::string prefix) const {
     if (index < min || index > max) {
         std::ostringstream out;
         out << "Vector::" << prefix << ": index of " << index
@@ -887,13 +1064,41 @@ void Vector<ValueType>::checkIndex(int index, int min, int max, std::string pref
     }
 }
 
-template <typename ValueType>
-void Vector<ValueType>::deepCopy(const Vector& src) {
-    count = capacity = src.count;
-    elements = (capacity == 0) ? NULL : new ValueType[capacity];
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::deepCopy(const Vector& src) {
+    count = capacity = 0;
+    elements = NULL;
+    ensureCapacity(src.count);
+    for (int i = 0; i < src.count; i++) {
+        AllocatorTraits::construct(allocator, elements + i, src.elements[i]);
+    }
+    count = src.count;
+}
+
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::destroyElements() {
     for (int i = 0; i < count; i++) {
-        elements[i] = src.elements[i];
+        AllocatorTraits::destroy(allocator, elements + i);
     }
+    if (elements != NULL) {
+        AllocatorTraits::deallocate(allocator, elements, capacity);
+    }
+    count = capacity = 0;
+    elements = NULL;
+}
+
+template <typename ValueType, typename Allocator>
+void Vector<ValueType, Allocator>::reallocate(int newCapacity) {
+    ValueType* array = AllocatorTraits::allocate(allocator, newCapacity);
+    for (int i = 0; i < count; i++) {
+        AllocatorTraits::construct(allocator, array + i, std::move(elements[i]));
+        AllocatorTraits::destroy(allocator, elements + i);
+    }
+    if (elements != NULL) {
+        AllocatorTraits::deallocate(allocator, elements, capacity);
+    }
+    elements = array;
+    capacity = newCapacity;
 }
 
 /*
@@ -903,8 +1108,8 @@ void Vector<ValueType>::deepCopy(const Vector& src) {
  * then returning the vector by reference so that it is set for the next
  * value in the chain.
  */
-template <typename ValueType>
-Vector<ValueType>& Vector<ValueType>::operator ,(const ValueType& value) {
+template <typename ValueType, typename Allocator>
+Vector<ValueType, Allocator>& Vector<ValueType, Allocator>::operator ,(const ValueType& value) {
     add(value);
     return *this;
 }
@@ -916,13 +1121,13 @@ Vector<ValueType>& Vector<ValueType>::operator ,(const ValueType& value) {
  * strlib.h to read and write generic values in a way that treats strings
  * specially.
  */
-template <typename ValueType>
-std::ostream& operator <<(std::ostream& os, const Vector<ValueType>& vec) {
+template <typename ValueType, typename Allocator>
+std::ostream& operator <<(std::ostream& os, const Vector<ValueType, Allocator>& vec) {
     return stanfordcpplib::collections::writeCollection(os, vec);
 }
 
-template <typename ValueType>
-std::istream& operator >>(std::istream& is, Vector<ValueType>& vec) {
+template <typename ValueType, typename Allocator>
+std::istream& operator >>(std::istream& is, Vector<ValueType, Allocator>& vec) {
     ValueType element;
     return stanfordcpplib::collections::readCollection(is, vec, element, /* descriptor */ "Vector::operator >>");
 }
@@ -931,8 +1136,8 @@ std::istream& operator >>(std::istream& is, Vector<ValueType>& vec) {
  * Template hash function for vectors.
  * Requires the element type in the Vector to have a hashCode function.
  */
-template <typename ValueType>
-int hashCode(const Vector<ValueType>& vec) {
+template <typename ValueType, typename Allocator>
+int hashCode(const Vector<ValueType, Allocator>& vec) {
     return stanfordcpplib::collections::hashCodeCollection(vec);
 }
 
@@ -943,22 +1148,23 @@ int hashCode(const Vector<ValueType>& vec) {
  * Returns a randomly chosen element of the given vector.
  * Throws an error if the vector is empty.
  */
-template <typename T>
-const T& randomElement(const Vector<T>& vec) {
-    return stanfordcpplib::collections::randomElement(vec);
+template <typename T, typename Allocator>
+const T& randomElement(const Vector<T, Allocator>& vec) {
+    if (vec.isEmpty()) {
+        error("randomElement: empty collection was passed");
+    }
+    return vec[randomInteger(0, vec.size() - 1)];
 }
 
 /*
  * Randomly rearranges the elements of the given vector.
  */
-template <typename T>
-void shuffle(Vector<T>& v) {
+template <typename T, typename Allocator>
+void shuffle(Vector<T, Allocator>& v) {
     for (int i = 0, length = v.size(); i < length; i++) {
         int j = randomInteger(i, length - 1);
         if (i != j) {
-            T temp = v[i];
-            v[i] = v[j];
-            v[j] = temp;
+            std::swap(v[i], v[j]);
         }
     }
 }
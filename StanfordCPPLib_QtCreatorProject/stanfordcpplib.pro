@@ -185,6 +185,7 @@ unix:!macx {
     #QMAKE_CXXFLAGS += -Wno-dangling-field
     QMAKE_CXXFLAGS += -Wno-unused-const-variable
     LIBS += -ldl
+    LIBS += -lpthread   # for thread that reads from Java back-end pipe
 }
 
 # set up configuration flags used internally by the Stanford C++ libraries
@@ -227,6 +228,19 @@ DEFINES += PQUEUE_PRINT_IN_HEAP_ORDER
 # set the fail bit on the stream and exit, so that has been made the default.
 # DEFINES += SPL_ERROR_ON_STREAM_EXTRACT
 
+# run graphics headless inside the C++ program instead of launching the Java
+# back-end? (for autograders/batch runs; same as env var SPL_BACKEND=inprocess)
+# DEFINES += SPL_INPROCESS_BACKEND
+
+# connect to a running back-end server (java -jar spl.jar -server) rather than
+# launching Java for each run? (same as env var SPL_BACKEND_SERVER=1)
+# DEFINES += SPL_BACKEND_SERVER
+
+# seed hash functions randomly on each run, so that HashMap/HashSet resist
+# keys chosen to collide? (changes iteration order between runs;
+# same as env var SPL_HASH_SEED=random)
+# DEFINES += SPL_RANDOM_HASH_SEED
+
 # build-specific options (debug vs release)
 
 # make 'debug' target (default) use no optimization, generate debugger symbols,